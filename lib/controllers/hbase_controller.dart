@@ -71,6 +71,63 @@ class HBaseController extends GetxController {
     );
   }
   
+  bool get supportsResultSets => _hbaseService.supportsResultSets;
+
+  Future<int> openResultSet(
+    String tableName, {
+    String? startRow,
+    String? endRow,
+    String? filterPrefix,
+    int maxRows = 0,
+  }) async {
+    if (!isConnected.value) return -1;
+    return _hbaseService.openResultSet(
+      tableName,
+      startRow: startRow ?? '',
+      endRow: endRow ?? '',
+      filterPrefix: filterPrefix ?? '',
+      maxRows: maxRows,
+    );
+  }
+
+  Map<String, dynamic>? getResultInfo(int resultId) {
+    return _hbaseService.getResultInfo(resultId);
+  }
+
+  List<List<String?>> getResultRows(int resultId, int firstRow, int rowCount, int columnCount) {
+    return _hbaseService.getResultRows(resultId, firstRow, rowCount, columnCount: columnCount);
+  }
+
+  bool get supportsResultViews => _hbaseService.supportsResultViews;
+
+  bool get supportsResultFormats => _hbaseService.supportsResultFormats;
+
+  bool setResultFormats(int resultId, String spec) {
+    return _hbaseService.setResultFormats(resultId, spec);
+  }
+
+  int? setResultView(int resultId, String spec) {
+    return _hbaseService.setResultView(resultId, spec);
+  }
+
+  void releaseResultSet(int resultId) {
+    _hbaseService.releaseResultSet(resultId);
+  }
+
+  bool get supportsResultRefresh => _hbaseService.supportsResultRefresh;
+
+  int refreshResultSet(int resultId) {
+    return _hbaseService.refreshResultSet(resultId);
+  }
+
+  Map<String, dynamic>? getJobStatus(int jobId) {
+    return _hbaseService.getJobStatus(jobId);
+  }
+
+  void releaseJob(int jobId) {
+    _hbaseService.releaseJob(jobId);
+  }
+  
   Future<bool> executeCommand(String tableName, String command) async {
     if (!isConnected.value) return false;
     return _hbaseService.executeCommand(tableName, command);
@@ -1,3 +1,4 @@
+import 'dart:async';
 import 'package:flutter/material.dart';
 import 'package:get/get.dart';
 import 'package:hbaseguiv2/controllers/hbase_controller.dart';
@@ -15,32 +16,80 @@ class TableView extends StatefulWidget {
 class _TableViewState extends State<TableView> {
   final _startRowController = TextEditingController();
   final _endRowController = TextEditingController();
-  final _limitController = TextEditingController(text: '100');
+  // 限制的默认值：结果集数据留在原生层，可以缓存更多行；旧版原生库走getTableData，
+  // 整个结果解码为Dart对象，保持原来的100行
+  static const _legacyRowLimit = 100;
+  static const _resultSetRowLimit = 100000;
+  late final TextEditingController _limitController;
   final _filterPrefixController = TextEditingController();
   final _data = <Map<String, dynamic>>[].obs;
   final _isLoading = false.obs;
   final _columns = <String>{}.obs;
 
+  // 列式结果集（原生库支持时使用）：数据留在原生层，表格只取当前页
+  final _resultSource = Rx<_ResultSetSource?>(null);
+  final _resultColumns = <String>[].obs;
+  Timer? _resultTimer;
+  // 打开当前结果集时的表与查询条件，不变时查询按钮增量刷新而不是重新打开
+  String? _resultQuery;
+  int? _refreshJobId;
+
+  // 结果集视图：排序与过滤在原生层完成，表格只按视图顺序取页
+  final _viewFilterController = TextEditingController();
+  final _sortColumnIndex = Rx<int?>(null);
+  final _sortAscending = true.obs;
+
   @override
   void initState() {
     super.initState();
+    _limitController = TextEditingController(
+      text: '${widget.controller.supportsResultSets ? _resultSetRowLimit : _legacyRowLimit}',
+    );
     ever(widget.controller.selectedTable, (_) => _refreshData());
   }
 
+  String _queryKey(String table) {
+    return [
+      table,
+      _startRowController.text.trim(),
+      _endRowController.text.trim(),
+      _filterPrefixController.text.trim(),
+      _limitController.text.trim(),
+    ].join('\u0000');
+  }
+
   Future<void> _refreshData() async {
+    final table = widget.controller.selectedTable.value;
+    final source = _resultSource.value;
+    if (table != null && source != null && _resultQuery == _queryKey(table)) {
+      // 填充或刷新仍在进行时不需要再读一次
+      if (_resultTimer?.isActive ?? false) {
+        return;
+      }
+      if (_refreshResultSet(source)) {
+        return;
+      }
+    }
+
+    _closeResultSet();
     if (widget.controller.selectedTable.value == null) {
       _data.clear();
       _columns.clear();
       return;
     }
 
+    if (widget.controller.supportsResultSets) {
+      await _openResultSet();
+      return;
+    }
+
     _isLoading.value = true;
     try {
       final data = await widget.controller.getTableData(
         widget.controller.selectedTable.value!,
         startRow: _startRowController.text.trim(),
         endRow: _endRowController.text.trim(),
-        limit: int.tryParse(_limitController.text) ?? 100,
+        limit: int.tryParse(_limitController.text) ?? _legacyRowLimit,
         filterPrefix: _filterPrefixController.text.trim(),
       );
       
@@ -57,6 +106,179 @@ class _TableViewState extends State<TableView> {
     }
   }
 
+  Future<void> _openResultSet() async {
+    _isLoading.value = true;
+    try {
+      final resultId = await widget.controller.openResultSet(
+        widget.controller.selectedTable.value!,
+        startRow: _startRowController.text.trim(),
+        endRow: _endRowController.text.trim(),
+        filterPrefix: _filterPrefixController.text.trim(),
+        maxRows: int.tryParse(_limitController.text) ?? 0,
+      );
+      if (resultId < 0) {
+        _data.clear();
+        _columns.clear();
+        return;
+      }
+
+      final source = _ResultSetSource(widget.controller, resultId);
+      source.refreshInfo();
+      _resultColumns.value = source.columns;
+      _resultSource.value = source;
+      _resultQuery = _queryKey(widget.controller.selectedTable.value!);
+
+      // 后台填充期间定时刷新行数与列，填充完成后停止
+      _resultTimer = Timer.periodic(const Duration(milliseconds: 500), (timer) {
+        final filling = source.refreshInfo();
+        if (_resultColumns.length != source.columns.length) {
+          _resultColumns.value = source.columns;
+        }
+        if (!filling) {
+          timer.cancel();
+          _resultSource.refresh();
+        }
+      });
+    } finally {
+      _isLoading.value = false;
+    }
+  }
+
+  // 增量刷新：后台任务只扫描新写入的cell并合并（更新的值替换，新行追加在末尾），
+  // 结束后重新读取行数与列，设置了排序或过滤时重建视图。不支持时返回false，由调用方重新打开
+  bool _refreshResultSet(_ResultSetSource source) {
+    if (!widget.controller.supportsResultRefresh) {
+      return false;
+    }
+    final jobId = widget.controller.refreshResultSet(source.resultId);
+    if (jobId < 0) {
+      return false;
+    }
+    _refreshJobId = jobId;
+    _resultTimer = Timer.periodic(const Duration(milliseconds: 500), (timer) {
+      final status = widget.controller.getJobStatus(jobId);
+      final state = status?['state'];
+      if (state == 'queued' || state == 'running') {
+        return;
+      }
+      _finishRefresh();
+      if (state != 'succeeded') {
+        Get.snackbar('错误', '刷新结果集失败: ${status?['error'] ?? state}');
+        return;
+      }
+      source.invalidate();
+      _resultColumns.value = source.columns;
+      if (_sortColumnIndex.value != null || _viewFilterController.text.trim().isNotEmpty) {
+        _applyResultView();
+      }
+      _resultSource.refresh();
+    });
+    return true;
+  }
+
+  void _finishRefresh() {
+    _resultTimer?.cancel();
+    _resultTimer = null;
+    final jobId = _refreshJobId;
+    if (jobId != null) {
+      _refreshJobId = null;
+      widget.controller.releaseJob(jobId);
+    }
+  }
+
+  void _closeResultSet() {
+    _finishRefresh();
+    _resultQuery = null;
+    final source = _resultSource.value;
+    if (source != null) {
+      _resultSource.value = null;
+      _resultColumns.clear();
+      source.release();
+    }
+    _sortColumnIndex.value = null;
+    _sortAscending.value = true;
+  }
+
+  // 按当前排序列与过滤条件重建视图，两者都为空时恢复扫描顺序
+  void _applyResultView() {
+    final source = _resultSource.value;
+    if (source == null) {
+      return;
+    }
+    final parts = <String>[];
+    final sortIndex = _sortColumnIndex.value;
+    if (sortIndex != null) {
+      final column = sortIndex == 0 ? 'rowkey' : _resultColumns[sortIndex - 1];
+      parts.add('sort=$column');
+      parts.add('order=${_sortAscending.value ? 'asc' : 'desc'}');
+    }
+    final filter = _viewFilterController.text.trim();
+    if (filter.isNotEmpty) {
+      parts.add('filter=$filter');
+    }
+    if (!source.applyView(parts.join(';'))) {
+      Get.snackbar('错误', '排序或过滤失败，请检查过滤条件（格式：列|运算|值）');
+    }
+  }
+
+  static const _valueFormats = ['auto', 'text', 'binary', 'hex', 'long', 'int', 'double'];
+
+  // 列标题：列名 + 显示格式菜单，二进制数值等在原生层按格式解码
+  Widget _columnLabel(String column, _ResultSetSource source) {
+    if (!widget.controller.supportsResultFormats) {
+      return Text(column);
+    }
+    return Row(
+      mainAxisSize: MainAxisSize.min,
+      children: [
+        Flexible(child: Text(column, overflow: TextOverflow.ellipsis)),
+        PopupMenuButton<String>(
+          tooltip: '显示格式',
+          icon: const Icon(Icons.tune, size: 16),
+          initialValue: source.formatOf(column),
+          onSelected: (format) {
+            if (source.setFormat(column, format)) {
+              _resultSource.refresh();
+            }
+          },
+          itemBuilder: (context) => _valueFormats
+              .map((format) => PopupMenuItem(value: format, child: Text(format)))
+              .toList(),
+        ),
+      ],
+    );
+  }
+
+  void _sortResults(int columnIndex, bool ascending) {
+    _sortColumnIndex.value = columnIndex;
+    _sortAscending.value = ascending;
+    _applyResultView();
+  }
+
+  Widget _buildResultTable(_ResultSetSource source) {
+    if (source.complete && source.rowCount == 0) {
+      return const Center(child: Text('没有数据'));
+    }
+    final onSort = widget.controller.supportsResultViews ? _sortResults : null;
+    return PaginatedDataTable2(
+      columns: [
+        DataColumn2(label: _columnLabel('rowkey', source), size: ColumnSize.L, onSort: onSort),
+        ..._resultColumns.map((column) => DataColumn2(
+          label: _columnLabel(column, source),
+          size: ColumnSize.L,
+          onSort: onSort,
+        )),
+      ],
+      source: source,
+      sortColumnIndex: _sortColumnIndex.value,
+      sortAscending: _sortAscending.value,
+      rowsPerPage: _ResultSetSource.pageSize,
+      availableRowsPerPage: const [_ResultSetSource.pageSize],
+      minWidth: 160.0 * (_resultColumns.length + 1),
+      renderEmptyRowsInTheEnd: false,
+    );
+  }
+
   @override
   Widget build(BuildContext context) {
     return Column(
@@ -114,6 +336,18 @@ class _TableViewState extends State<TableView> {
             ],
           ),
         ),
+        if (widget.controller.supportsResultViews)
+          Padding(
+            padding: const EdgeInsets.fromLTRB(8, 0, 8, 8),
+            child: TextField(
+              controller: _viewFilterController,
+              decoration: const InputDecoration(
+                labelText: '结果过滤（列|运算|值，如 cf:age|gt|30，回车应用）',
+                border: OutlineInputBorder(),
+              ),
+              onSubmitted: (_) => _applyResultView(),
+            ),
+          ),
         Expanded(
           child: Obx(() {
             if (_isLoading.value) {
@@ -124,6 +358,11 @@ class _TableViewState extends State<TableView> {
               return const Center(child: Text('请选择一个表格'));
             }
 
+            final source = _resultSource.value;
+            if (source != null) {
+              return _buildResultTable(source);
+            }
+
             if (_data.isEmpty) {
               return const Center(child: Text('没有数据'));
             }
@@ -147,10 +386,130 @@ class _TableViewState extends State<TableView> {
 
   @override
   void dispose() {
+    _finishRefresh();
+    _resultSource.value?.release();
     _startRowController.dispose();
     _endRowController.dispose();
     _limitController.dispose();
     _filterPrefixController.dispose();
+    _viewFilterController.dispose();
     super.dispose();
   }
-} 
\ No newline at end of file
+}
+
+// 按页从原生结果集取数据，只缓存最近访问的若干页
+class _ResultSetSource extends DataTableSource {
+  static const pageSize = 100;
+  static const _maxCachedPages = 20;
+
+  final HBaseController controller;
+  final int resultId;
+  int _rowCount = 0;
+  bool _complete = false;
+  List<String> columns = const [];
+  final _pages = <int, List<List<String?>>>{};
+  final _formats = <String, String>{};
+
+  _ResultSetSource(this.controller, this.resultId);
+
+  bool get complete => _complete;
+
+  // 刷新行数与列，返回是否仍在填充
+  bool refreshInfo() {
+    final info = controller.getResultInfo(resultId);
+    if (info == null) {
+      _complete = true;
+      return false;
+    }
+    // 设置了视图时按视图行数显示
+    final rows = (info['viewRows'] ?? info['rows']) as int;
+    final newColumns = (info['columns'] as List<dynamic>).cast<String>();
+    final complete = info['complete'] as bool;
+    if (rows != _rowCount || newColumns.length != columns.length || complete != _complete) {
+      if (newColumns.length != columns.length) {
+        _pages.clear();
+      } else {
+        // 最后一页在填充期间可能不完整
+        _pages.remove(_rowCount ~/ pageSize);
+      }
+      _rowCount = rows;
+      columns = newColumns;
+      _complete = complete;
+      notifyListeners();
+    }
+    return !complete;
+  }
+
+  // 设置视图（排序/过滤），行号随之改变，已缓存的页全部作废
+  bool applyView(String spec) {
+    final rows = controller.setResultView(resultId, spec);
+    if (rows == null) {
+      return false;
+    }
+    _pages.clear();
+    refreshInfo();
+    notifyListeners();
+    return true;
+  }
+
+  // 增量刷新后已缓存的页可能有旧值，全部作废并重新读取行数与列
+  void invalidate() {
+    _pages.clear();
+    refreshInfo();
+    notifyListeners();
+  }
+
+  String formatOf(String column) => _formats[column] ?? 'auto';
+
+  // 修改列的显示格式，已缓存的页按旧格式渲染，全部作废
+  bool setFormat(String column, String format) {
+    if (!controller.setResultFormats(resultId, '$column=$format')) {
+      return false;
+    }
+    _formats[column] = format;
+    _pages.clear();
+    notifyListeners();
+    return true;
+  }
+
+  void release() {
+    _pages.clear();
+    controller.releaseResultSet(resultId);
+  }
+
+  @override
+  DataRow? getRow(int index) {
+    if (index >= _rowCount) {
+      return null;
+    }
+    final page = index ~/ pageSize;
+    // 重新插入以维持最近使用的顺序
+    final rows = _pages.remove(page) ??
+        controller.getResultRows(resultId, page * pageSize, pageSize, columns.length);
+    _pages[page] = rows;
+    if (_pages.length > _maxCachedPages) {
+      _pages.remove(_pages.keys.first);
+    }
+
+    final offset = index - page * pageSize;
+    if (offset >= rows.length) {
+      return null;
+    }
+    final row = rows[offset];
+    return DataRow2.byIndex(
+      index: index,
+      cells: List.generate(columns.length + 1, (column) => DataCell(
+        Text(column < row.length ? row[column] ?? '' : ''),
+      )),
+    );
+  }
+
+  @override
+  int get rowCount => _rowCount;
+
+  @override
+  bool get isRowCountApproximate => !_complete;
+
+  @override
+  int get selectedRowCount => 0;
+}
@@ -49,6 +49,59 @@ typedef Disconnect = void Function();
 typedef FreeStringNative = ffi.Void Function(ffi.Pointer<Utf8>);
 typedef FreeString = void Function(ffi.Pointer<Utf8>);
 
+// 列式结果集
+typedef OpenResultSetNative = ffi.Int64 Function(
+  ffi.Pointer<Utf8> tableName,
+  ffi.Pointer<Utf8> startRow,
+  ffi.Pointer<Utf8> endRow,
+  ffi.Pointer<Utf8> filterPrefix,
+  ffi.Int64 maxRows,
+);
+typedef OpenResultSet = int Function(
+  ffi.Pointer<Utf8> tableName,
+  ffi.Pointer<Utf8> startRow,
+  ffi.Pointer<Utf8> endRow,
+  ffi.Pointer<Utf8> filterPrefix,
+  int maxRows,
+);
+
+typedef GetResultInfoNative = ffi.Pointer<Utf8> Function(ffi.Int64 resultId);
+typedef GetResultInfo = ffi.Pointer<Utf8> Function(int resultId);
+
+typedef GetResultRowsNative = ffi.Pointer<Utf8> Function(
+  ffi.Int64 resultId,
+  ffi.Int64 firstRow,
+  ffi.Int32 rowCount,
+  ffi.Int32 firstColumn,
+  ffi.Int32 columnCount,
+);
+typedef GetResultRows = ffi.Pointer<Utf8> Function(
+  int resultId,
+  int firstRow,
+  int rowCount,
+  int firstColumn,
+  int columnCount,
+);
+
+typedef ReleaseResultSetNative = ffi.Void Function(ffi.Int64 resultId);
+typedef ReleaseResultSet = void Function(int resultId);
+
+typedef SetResultFormatsNative = ffi.Pointer<Utf8> Function(ffi.Int64 resultId, ffi.Pointer<Utf8> spec);
+typedef SetResultFormats = ffi.Pointer<Utf8> Function(int resultId, ffi.Pointer<Utf8> spec);
+
+typedef SetResultViewNative = ffi.Pointer<Utf8> Function(ffi.Int64 resultId, ffi.Pointer<Utf8> spec);
+typedef SetResultView = ffi.Pointer<Utf8> Function(int resultId, ffi.Pointer<Utf8> spec);
+
+typedef RefreshResultSetNative = ffi.Int64 Function(ffi.Int64 resultId);
+typedef RefreshResultSet = int Function(int resultId);
+
+// 后台任务
+typedef GetJobStatusNative = ffi.Pointer<Utf8> Function(ffi.Int64 jobId);
+typedef GetJobStatus = ffi.Pointer<Utf8> Function(int jobId);
+
+typedef ReleaseJobNative = ffi.Void Function(ffi.Int64 jobId);
+typedef ReleaseJob = void Function(int jobId);
+
 class HBaseService extends GetxService {
   static final HBaseService _instance = HBaseService._internal();
   factory HBaseService() => _instance;
@@ -61,6 +114,15 @@ class HBaseService extends GetxService {
   GetTables? _listTables;
   GetTableData? _getTableData;
   ExecuteCommand? _executeCommand;
+  OpenResultSet? _openResultSet;
+  GetResultInfo? _getResultInfo;
+  GetResultRows? _getResultRows;
+  ReleaseResultSet? _releaseResultSet;
+  SetResultView? _setResultView;
+  SetResultFormats? _setResultFormats;
+  RefreshResultSet? _refreshResultSet;
+  GetJobStatus? _getJobStatus;
+  ReleaseJob? _releaseJob;
 
   final isConnected = false.obs;
   String? zkQuorum;
@@ -190,6 +252,7 @@ class HBaseService extends GetxService {
         _getTableData = lib.lookupFunction<GetTableDataNative, GetTableData>('getTableData');
         _executeCommand = lib.lookupFunction<ExecuteCommandNative, ExecuteCommand>('executeCommand');
         _freeString = lib.lookupFunction<FreeStringNative, FreeString>('freeString');
+        _lookupResultSetFunctions(lib);
         
         // 初始化JVM
         if (_connect != null) {
@@ -240,6 +303,36 @@ class HBaseService extends GetxService {
     }
   }
 
+  // 列式结果集接口为可选：旧版本的动态库没有这些导出时退回到getTableData
+  void _lookupResultSetFunctions(ffi.DynamicLibrary lib) {
+    try {
+      _openResultSet = lib.lookupFunction<OpenResultSetNative, OpenResultSet>('openResultSet');
+      _getResultInfo = lib.lookupFunction<GetResultInfoNative, GetResultInfo>('getResultInfo');
+      _getResultRows = lib.lookupFunction<GetResultRowsNative, GetResultRows>('getResultRows');
+      _releaseResultSet = lib.lookupFunction<ReleaseResultSetNative, ReleaseResultSet>('releaseResultSet');
+    } catch (e) {
+      print('动态库不支持列式结果集，使用getTableData: $e');
+      _openResultSet = null;
+    }
+    try {
+      _setResultView = lib.lookupFunction<SetResultViewNative, SetResultView>('setResultView');
+    } catch (e) {
+      _setResultView = null;
+    }
+    try {
+      _setResultFormats = lib.lookupFunction<SetResultFormatsNative, SetResultFormats>('setResultFormats');
+    } catch (e) {
+      _setResultFormats = null;
+    }
+    try {
+      _refreshResultSet = lib.lookupFunction<RefreshResultSetNative, RefreshResultSet>('refreshResultSet');
+      _getJobStatus = lib.lookupFunction<GetJobStatusNative, GetJobStatus>('getJobStatus');
+      _releaseJob = lib.lookupFunction<ReleaseJobNative, ReleaseJob>('releaseJob');
+    } catch (e) {
+      _refreshResultSet = null;
+    }
+  }
+
   // Native方法是否可用
   bool get _isNativeMethodsAvailable {
     return _isLibraryLoaded &&
@@ -423,4 +516,189 @@ class HBaseService extends GetxService {
       return false;
     }
   }
+
+  // 是否可以使用列式结果集（真实模式且动态库支持）
+  bool get supportsResultSets {
+    return !isMockMode.value && _isNativeMethodsAvailable && _openResultSet != null && _freeString != null;
+  }
+
+  // 打开列式结果集，数据在后台扫描并保存在原生层，返回结果集ID，失败返回-1
+  Future<int> openResultSet(
+    String tableName, {
+    String startRow = '',
+    String endRow = '',
+    String filterPrefix = '',
+    int maxRows = 0,
+  }) async {
+    if (!supportsResultSets) {
+      print('【错误】Native方法不可用');
+      return -1;
+    }
+
+    final tableNamePtr = tableName.toNativeUtf8();
+    final startRowPtr = startRow.toNativeUtf8();
+    final endRowPtr = endRow.toNativeUtf8();
+    final filterPrefixPtr = filterPrefix.toNativeUtf8();
+
+    try {
+      return _openResultSet!(tableNamePtr, startRowPtr, endRowPtr, filterPrefixPtr, maxRows);
+    } catch (e, stackTrace) {
+      print('【错误】打开结果集失败: $e');
+      print('【错误】堆栈: $stackTrace');
+      return -1;
+    } finally {
+      malloc.free(tableNamePtr);
+      malloc.free(startRowPtr);
+      malloc.free(endRowPtr);
+      malloc.free(filterPrefixPtr);
+    }
+  }
+
+  // 结果集概况：rows（已到达的行数）、columns（列名）、complete（是否填充完成）
+  Map<String, dynamic>? getResultInfo(int resultId) {
+    if (!supportsResultSets) {
+      return null;
+    }
+    final resultPtr = _getResultInfo!(resultId);
+    if (resultPtr == ffi.nullptr) {
+      return null;
+    }
+    final result = resultPtr.toDartString();
+    _freeString!(resultPtr);
+
+    final Map<String, dynamic> info = jsonDecode(result);
+    if (info['status'] == 'error') {
+      print('【错误】获取结果集信息失败: ${info['message']}');
+      return null;
+    }
+    return info;
+  }
+
+  // 按视口读取结果集，每行为 [行键, 各列的值（无值为null）]。同步调用，只取可见部分
+  List<List<String?>> getResultRows(
+    int resultId,
+    int firstRow,
+    int rowCount, {
+    int firstColumn = 0,
+    required int columnCount,
+  }) {
+    if (!supportsResultSets) {
+      return [];
+    }
+    final resultPtr = _getResultRows!(resultId, firstRow, rowCount, firstColumn, columnCount);
+    if (resultPtr == ffi.nullptr) {
+      return [];
+    }
+    final result = resultPtr.toDartString();
+    _freeString!(resultPtr);
+
+    final Map<String, dynamic> page = jsonDecode(result);
+    final rows = page['rows'] as List<dynamic>?;
+    if (rows == null) {
+      print('【错误】读取结果集失败: ${page['message']}');
+      return [];
+    }
+    return rows.map((row) => (row as List<dynamic>).cast<String?>()).toList();
+  }
+
+  bool get supportsResultViews => supportsResultSets && _setResultView != null;
+
+  // 设置结果集视图（在桥接层过滤、排序，只生成行号排列），spec为空恢复扫描顺序。
+  // 成功返回视图行数，失败返回null
+  int? setResultView(int resultId, String spec) {
+    if (!supportsResultViews) {
+      return null;
+    }
+    final specPtr = spec.toNativeUtf8();
+    try {
+      final resultPtr = _setResultView!(resultId, specPtr);
+      if (resultPtr == ffi.nullptr) {
+        return null;
+      }
+      final result = resultPtr.toDartString();
+      _freeString!(resultPtr);
+
+      final Map<String, dynamic> view = jsonDecode(result);
+      if (view['status'] != 'success') {
+        print('【错误】设置结果集视图失败: ${view['message']}');
+        return null;
+      }
+      print('结果集视图: ${view['rows']} 行，耗时 ${view['elapsedMs']} 毫秒');
+      return view['rows'] as int;
+    } finally {
+      malloc.free(specPtr);
+    }
+  }
+
+  bool get supportsResultFormats => supportsResultSets && _setResultFormats != null;
+
+  // 设置列显示格式（auto/text/binary/hex/long/int/double），spec为 列=格式 列表，
+  // 列名可以是 family:qualifier、rowkey 或 *
+  bool setResultFormats(int resultId, String spec) {
+    if (!supportsResultFormats) {
+      return false;
+    }
+    final specPtr = spec.toNativeUtf8();
+    try {
+      final resultPtr = _setResultFormats!(resultId, specPtr);
+      if (resultPtr == ffi.nullptr) {
+        return false;
+      }
+      final result = resultPtr.toDartString();
+      _freeString!(resultPtr);
+
+      final Map<String, dynamic> status = jsonDecode(result);
+      if (status['status'] != 'success') {
+        print('【错误】设置列格式失败: ${status['message']}');
+        return false;
+      }
+      return true;
+    } finally {
+      malloc.free(specPtr);
+    }
+  }
+
+  void releaseResultSet(int resultId) {
+    if (_releaseResultSet != null) {
+      _releaseResultSet!(resultId);
+    }
+  }
+
+  bool get supportsResultRefresh => supportsResultSets && _refreshResultSet != null;
+
+  // 增量刷新结果集（只扫描新写入的cell并合并），返回刷新任务ID，失败返回-1。
+  // 用getJobStatus等待任务结束，结束后用releaseJob释放任务记录
+  int refreshResultSet(int resultId) {
+    if (!supportsResultRefresh) {
+      return -1;
+    }
+    return _refreshResultSet!(resultId);
+  }
+
+  // 后台任务进度：state（queued/running/succeeded/failed/cancelled/deadlineExceeded）、
+  // result（任务结果）、error（失败原因）等，任务不存在时返回null
+  Map<String, dynamic>? getJobStatus(int jobId) {
+    if (!supportsResultRefresh) {
+      return null;
+    }
+    final resultPtr = _getJobStatus!(jobId);
+    if (resultPtr == ffi.nullptr) {
+      return null;
+    }
+    final result = resultPtr.toDartString();
+    _freeString!(resultPtr);
+
+    final Map<String, dynamic> status = jsonDecode(result);
+    if (status['status'] == 'error') {
+      print('【错误】获取任务状态失败: ${status['message']}');
+      return null;
+    }
+    return status;
+  }
+
+  void releaseJob(int jobId) {
+    if (_releaseJob != null) {
+      _releaseJob!(jobId);
+    }
+  }
 } 
\ No newline at end of file
@@ -0,0 +1,158 @@
+// 桥接层热点路径的性能基准测试（Google Benchmark）
+//
+// 运行方式：
+//   cmake -S . -B build -DHBASE_BRIDGE_BUILD_BENCH=ON && cmake --build build
+//   export HBASE_BRIDGE_CLASSPATH=<java-bridge.jar及依赖>
+//   ./build/bridge_bench --benchmark_out=bridge_bench.json --benchmark_out_format=json
+// 或直接 cmake --build build --target run_bridge_bench，结果写入 build/bridge_bench.json，
+// 可用 Google Benchmark 自带的 tools/compare.py 对比两次提交的结果。
+//
+// 默认连接内置的内存后端（memory://），不需要HBase集群；
+// 设置 HBASE_BRIDGE_BENCH_QUORUM 可改为针对真实集群运行。
+
+#include "hbase_bridge.h"
+#include "jni_support.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+
+namespace {
+
+const char* benchQuorum() {
+    const char* quorum = getenv("HBASE_BRIDGE_BENCH_QUORUM");
+    return quorum != nullptr ? quorum : "memory://bench";
+}
+
+// JVM与连接在整个进程内只建立一次
+bool ensureConnected() {
+    static int state = 0; // 0=未初始化 1=成功 -1=失败
+    if (state == 0) {
+        state = (initJVM() && connect(benchQuorum(), "/hbase")) ? 1 : -1;
+    }
+    return state == 1;
+}
+
+// 为每种行数/单元大小组合准备一张表，每行4个单元（通过生成器批量写入）
+std::string ensureTable(int rows, int cellSize) {
+    static std::set<std::string> populated;
+    std::string table = "bench_r" + std::to_string(rows) + "_c" + std::to_string(cellSize);
+    if (populated.count(table) != 0) {
+        return table;
+    }
+
+    std::string spec = "rows=" + std::to_string(rows) + ";qualifiers=4;values=fixed:" + std::to_string(cellSize);
+    const char* result = generateTable(table.c_str(), spec.c_str());
+    freeString(result);
+    populated.insert(table);
+    return table;
+}
+
+// 桥接层现有调用方式：每次调用都FindClass + GetStaticMethodID
+void BM_JniCallWithLookup(benchmark::State& state) {
+    if (!ensureConnected()) {
+        state.SkipWithError("无法初始化JVM");
+        return;
+    }
+    JNIEnv* env = bridge::currentEnv();
+    for (auto _ : state) {
+        jclass systemClass = env->FindClass("java/lang/System");
+        jmethodID nanoTime = env->GetStaticMethodID(systemClass, "nanoTime", "()J");
+        benchmark::DoNotOptimize(env->CallStaticLongMethod(systemClass, nanoTime));
+        env->DeleteLocalRef(systemClass);
+    }
+}
+BENCHMARK(BM_JniCallWithLookup);
+
+// 缓存类与方法ID后的纯JNI调用开销
+void BM_JniCallCached(benchmark::State& state) {
+    if (!ensureConnected()) {
+        state.SkipWithError("无法初始化JVM");
+        return;
+    }
+    JNIEnv* env = bridge::currentEnv();
+    jclass systemClass = env->FindClass("java/lang/System");
+    jmethodID nanoTime = env->GetStaticMethodID(systemClass, "nanoTime", "()J");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(env->CallStaticLongMethod(systemClass, nanoTime));
+    }
+    env->DeleteLocalRef(systemClass);
+}
+BENCHMARK(BM_JniCallCached);
+
+// C字符串 -> Java字符串 -> C字符串（桥接层参数与结果的往返）
+void BM_StringMarshalling(benchmark::State& state) {
+    if (!ensureConnected()) {
+        state.SkipWithError("无法初始化JVM");
+        return;
+    }
+    JNIEnv* env = bridge::currentEnv();
+    std::string text(state.range(0), 'x');
+    for (auto _ : state) {
+        jstring javaString = env->NewStringUTF(text.c_str());
+        const char* chars = env->GetStringUTFChars(javaString, nullptr);
+        char* copy = strdup(chars);
+        env->ReleaseStringUTFChars(javaString, chars);
+        env->DeleteLocalRef(javaString);
+        benchmark::DoNotOptimize(copy);
+        free(copy);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringMarshalling)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+// 整个getTableData调用：扫描 + Java层结果编码 + 结果复制到C++
+void BM_GetTableData(benchmark::State& state) {
+    if (!ensureConnected()) {
+        state.SkipWithError("无法连接到基准测试后端");
+        return;
+    }
+    int rows = (int)state.range(0);
+    int cellSize = (int)state.range(1);
+    std::string table = ensureTable(rows, cellSize);
+
+    size_t resultBytes = 0;
+    for (auto _ : state) {
+        const char* result = getTableData(table.c_str(), "", "", rows, "");
+        if (result == nullptr) {
+            state.SkipWithError("getTableData返回空");
+            return;
+        }
+        resultBytes = strlen(result);
+        freeString(result);
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.SetBytesProcessed(state.iterations() * resultBytes);
+    state.counters["result_bytes"] = (double)resultBytes;
+}
+BENCHMARK(BM_GetTableData)
+    ->ArgNames({"rows", "cell_bytes"})
+    ->ArgsProduct({{100, 1000, 10000}, {16, 1024}})
+    ->Unit(benchmark::kMillisecond);
+
+// 单行点查（executeCommand get）的往返延迟
+void BM_PointGet(benchmark::State& state) {
+    if (!ensureConnected()) {
+        state.SkipWithError("无法连接到基准测试后端");
+        return;
+    }
+    std::string table = ensureTable(1000, (int)state.range(0));
+    char rowKey[32];
+    int i = 0;
+    for (auto _ : state) {
+        snprintf(rowKey, sizeof(rowKey), "row%012d", (i++ * 7919) % 1000);
+        const char* result = executeCommand(table.c_str(), "get", rowKey, "cf", nullptr, nullptr);
+        benchmark::DoNotOptimize(result);
+        freeString(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointGet)->ArgName("cell_bytes")->Arg(16)->Arg(1024)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
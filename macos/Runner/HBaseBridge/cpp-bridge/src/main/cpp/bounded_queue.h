@@ -0,0 +1,82 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace bridge {
+
+// 有界阻塞队列，用于生产者/消费者流水线之间传递批次。
+// 队列满时push阻塞，从而把内存占用限制在 容量 x 批次大小 以内。
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity), closed_(false) {}
+
+    // 队列关闭后返回false
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    // 队列已关闭且为空时返回false
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    // 不再接受新元素，已入队的元素仍可取出
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+    // 关闭并丢弃未处理的元素（取消时使用）
+    void abort() {
+        abort([](T&) {});
+    }
+
+    // 同上，丢弃前对每个元素调用discard（例如归还元素占用的内存预算）
+    template <typename Discard>
+    void abort(Discard discard) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        for (typename std::deque<T>::iterator it = items_.begin(); it != items_.end(); ++it) {
+            discard(*it);
+        }
+        items_.clear();
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+private:
+    BoundedQueue(const BoundedQueue&);
+    BoundedQueue& operator=(const BoundedQueue&);
+
+    const size_t capacity_;
+    bool closed_;
+    std::deque<T> items_;
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+};
+
+} // namespace bridge
+
+#endif // BOUNDED_QUEUE_H
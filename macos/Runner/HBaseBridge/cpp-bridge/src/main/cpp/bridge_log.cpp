@@ -0,0 +1,249 @@
+#include "bridge_log.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <time.h>
+#include <sys/time.h>
+
+namespace bridge {
+namespace log {
+
+namespace {
+
+// 队列槽位数（必须是2的幂）与单条消息最大长度，超长消息会被截断
+const size_t kQueueCapacity = 2048;
+const size_t kMaxMessageLength = 480;
+
+const char* const kLevelNames[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "OFF"};
+
+struct Slot {
+    std::atomic<size_t> sequence;
+    Level level;
+    int64_t timeMicros;
+    uint32_t length;
+    char text[kMaxMessageLength];
+};
+
+// 有界多生产者队列（Vyukov算法），生产者之间只通过CAS竞争位置
+class MessageQueue {
+public:
+    MessageQueue() : slots_(new Slot[kQueueCapacity]), enqueuePos_(0), dequeuePos_(0) {
+        for (size_t i = 0; i < kQueueCapacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(Level level, const std::string& message) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[pos & (kQueueCapacity - 1)];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // 队列已满
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        slot->level = level;
+        slot->timeMicros = (int64_t)now.tv_sec * 1000000 + now.tv_usec;
+        slot->length = (uint32_t)(message.size() < kMaxMessageLength ? message.size() : kMaxMessageLength);
+        memcpy(slot->text, message.data(), slot->length);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // front/pop 仅由后台写线程调用
+    Slot* front() {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Slot* slot = &slots_[pos & (kQueueCapacity - 1)];
+        size_t seq = slot->sequence.load(std::memory_order_acquire);
+        return seq == pos + 1 ? slot : nullptr;
+    }
+
+    void pop(Slot* slot) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        slot->sequence.store(pos + kQueueCapacity, std::memory_order_release);
+        dequeuePos_.store(pos + 1, std::memory_order_relaxed);
+    }
+
+    bool empty() {
+        return front() == nullptr;
+    }
+
+private:
+    Slot* slots_;
+    std::atomic<size_t> enqueuePos_;
+    std::atomic<size_t> dequeuePos_;
+};
+
+Level initialLevel() {
+    const char* env = getenv("HBASE_BRIDGE_LOG_LEVEL");
+    if (env == nullptr) {
+        return LEVEL_WARN;
+    }
+    for (int i = LEVEL_TRACE; i <= LEVEL_OFF; ++i) {
+        if (strcasecmp(env, kLevelNames[i]) == 0) {
+            return (Level)i;
+        }
+    }
+    return LEVEL_WARN;
+}
+
+std::atomic<int> levelValue(initialLevel());
+// droppedTotal 为累计值；droppedPending 为尚未提示过的条数，由写线程输出提示后清零
+std::atomic<uint64_t> droppedTotal(0);
+std::atomic<uint64_t> droppedPending(0);
+
+// 后台写线程状态；对象有意不析构，避免进程退出时与写线程竞争
+struct Writer {
+    MessageQueue queue;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable drained;
+    std::atomic<bool> sleeping;
+    FILE* output;
+
+    Writer() : sleeping(false), output(stderr) {}
+};
+
+Writer* writer = nullptr;
+std::once_flag writerOnce;
+
+void writeSlot(FILE* out, const Slot* slot) {
+    time_t seconds = (time_t)(slot->timeMicros / 1000000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char prefix[64];
+    int n = snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%03d [%s] [hbase_bridge] ",
+                     local.tm_hour, local.tm_min, local.tm_sec, (int)(slot->timeMicros % 1000000 / 1000),
+                     kLevelNames[slot->level]);
+    fwrite(prefix, 1, (size_t)n, out);
+    fwrite(slot->text, 1, slot->length, out);
+    fputc('\n', out);
+}
+
+void writerLoop() {
+    for (;;) {
+        Slot* slot;
+        bool wrote = false;
+        while ((slot = writer->queue.front()) != nullptr) {
+            {
+                std::lock_guard<std::mutex> lock(writer->mutex);
+                writeSlot(writer->output, slot);
+            }
+            writer->queue.pop(slot);
+            wrote = true;
+        }
+
+        std::unique_lock<std::mutex> lock(writer->mutex);
+        if (wrote) {
+            fflush(writer->output);
+            uint64_t lost = droppedPending.exchange(0);
+            if (lost > 0) {
+                fprintf(writer->output, "[hbase_bridge] 日志队列已满，丢弃了 %llu 条日志\n", (unsigned long long)lost);
+                fflush(writer->output);
+            }
+        }
+        writer->drained.notify_all();
+        writer->sleeping.store(true);
+        if (writer->queue.empty()) {
+            writer->wakeup.wait_for(lock, std::chrono::milliseconds(50));
+        }
+        writer->sleeping.store(false);
+    }
+}
+
+void flushAtExit() {
+    flush(200);
+}
+
+Writer* ensureWriter() {
+    std::call_once(writerOnce, []() {
+        writer = new Writer();
+        std::thread(writerLoop).detach();
+        atexit(flushAtExit);
+    });
+    return writer;
+}
+
+} // namespace
+
+bool isEnabled(Level level) {
+    return (int)level >= levelValue.load(std::memory_order_relaxed);
+}
+
+Level currentLevel() {
+    return (Level)levelValue.load(std::memory_order_relaxed);
+}
+
+void setLevel(Level level) {
+    if (level < LEVEL_TRACE || level > LEVEL_OFF) {
+        return;
+    }
+    levelValue.store((int)level);
+}
+
+void write(Level level, const std::string& message) {
+    Writer* w = ensureWriter();
+    if (!w->queue.tryPush(level, message)) {
+        droppedTotal.fetch_add(1, std::memory_order_relaxed);
+        droppedPending.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // 写线程空闲时才唤醒；WARN以上的日志总是立即唤醒，保证错误及时可见
+    if (level >= LEVEL_WARN || w->sleeping.load(std::memory_order_relaxed)) {
+        w->wakeup.notify_one();
+    }
+}
+
+bool setOutputFile(const std::string& path) {
+    Writer* w = ensureWriter();
+    FILE* file = stderr;
+    if (!path.empty()) {
+        file = fopen(path.c_str(), "a");
+        if (file == nullptr) {
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(w->mutex);
+    if (w->output != stderr) {
+        fclose(w->output);
+    }
+    w->output = file;
+    return true;
+}
+
+void flush(int timeoutMs) {
+    Writer* w = ensureWriter();
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::unique_lock<std::mutex> lock(w->mutex);
+    while (!w->queue.empty()) {
+        w->wakeup.notify_one();
+        if (w->drained.wait_until(lock, deadline) == std::cv_status::timeout) {
+            break;
+        }
+    }
+}
+
+uint64_t droppedCount() {
+    return droppedTotal.load(std::memory_order_relaxed);
+}
+
+} // namespace log
+} // namespace bridge
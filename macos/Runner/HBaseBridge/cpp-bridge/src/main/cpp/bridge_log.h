@@ -0,0 +1,61 @@
+#ifndef BRIDGE_LOG_H
+#define BRIDGE_LOG_H
+
+#include <stdint.h>
+#include <sstream>
+#include <string>
+
+// 异步分级日志：调用线程只把消息写入无锁环形队列，由后台线程统一输出。
+// 队列写满时直接丢弃消息（并计数），绝不阻塞桥接调用。
+// 默认级别为WARN，可通过 setLogLevel() 或环境变量 HBASE_BRIDGE_LOG_LEVEL 调整。
+
+namespace bridge {
+namespace log {
+
+enum Level {
+    LEVEL_TRACE = 0,
+    LEVEL_DEBUG = 1,
+    LEVEL_INFO = 2,
+    LEVEL_WARN = 3,
+    LEVEL_ERROR = 4,
+    LEVEL_OFF = 5
+};
+
+// 当前级别是否会输出
+bool isEnabled(Level level);
+
+Level currentLevel();
+void setLevel(Level level);
+
+// 写入一条日志（非阻塞）
+void write(Level level, const std::string& message);
+
+// 日志输出到文件（追加），传空串恢复为stderr
+bool setOutputFile(const std::string& path);
+
+// 等待后台线程把已入队的日志写完，最多等待timeoutMs毫秒
+void flush(int timeoutMs);
+
+// 因队列已满被丢弃的日志条数
+uint64_t droppedCount();
+
+} // namespace log
+} // namespace bridge
+
+// 先判断级别再格式化，关闭的级别不会产生任何字符串拼接开销
+#define BRIDGE_LOG(level, expr)                                         \
+    do {                                                                \
+        if (bridge::log::isEnabled(level)) {                            \
+            std::ostringstream bridgeLogStream_;                        \
+            bridgeLogStream_ << expr;                                   \
+            bridge::log::write(level, bridgeLogStream_.str());          \
+        }                                                               \
+    } while (0)
+
+#define BRIDGE_LOG_TRACE(expr) BRIDGE_LOG(bridge::log::LEVEL_TRACE, expr)
+#define BRIDGE_LOG_DEBUG(expr) BRIDGE_LOG(bridge::log::LEVEL_DEBUG, expr)
+#define BRIDGE_LOG_INFO(expr) BRIDGE_LOG(bridge::log::LEVEL_INFO, expr)
+#define BRIDGE_LOG_WARN(expr) BRIDGE_LOG(bridge::log::LEVEL_WARN, expr)
+#define BRIDGE_LOG_ERROR(expr) BRIDGE_LOG(bridge::log::LEVEL_ERROR, expr)
+
+#endif // BRIDGE_LOG_H
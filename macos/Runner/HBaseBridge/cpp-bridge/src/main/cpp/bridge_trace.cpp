@@ -0,0 +1,336 @@
+#include "bridge_trace.h"
+#include "jni_support.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace bridge {
+namespace trace {
+
+namespace {
+
+// 每个线程的环形缓冲区容量，写满后覆盖最旧的事件
+const size_t kRingCapacity = 16384;
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    uint64_t startNanos;
+    uint64_t durationNanos;
+    uint64_t requestId;
+};
+
+// 单线程写入的环形缓冲区；导出时由其他线程读取，用一个几乎不会竞争的自旋锁保护
+class ThreadRing {
+public:
+    ThreadRing(uint32_t tid, const std::string& threadName)
+        : tid_(tid), threadName_(threadName), events_(kRingCapacity), head_(0), exited_(false) {
+        lock_.clear();
+    }
+
+    void push(const TraceEvent& event) {
+        while (lock_.test_and_set(std::memory_order_acquire)) {
+        }
+        events_[head_ % kRingCapacity] = event;
+        ++head_;
+        lock_.clear(std::memory_order_release);
+    }
+
+    void drain(std::vector<TraceEvent>* out) {
+        while (lock_.test_and_set(std::memory_order_acquire)) {
+        }
+        uint64_t count = head_ < kRingCapacity ? head_ : kRingCapacity;
+        for (uint64_t i = head_ - count; i < head_; ++i) {
+            out->push_back(events_[i % kRingCapacity]);
+        }
+        head_ = 0;
+        lock_.clear(std::memory_order_release);
+    }
+
+    bool empty() {
+        while (lock_.test_and_set(std::memory_order_acquire)) {
+        }
+        bool result = head_ == 0;
+        lock_.clear(std::memory_order_release);
+        return result;
+    }
+
+    uint32_t tid() const { return tid_; }
+    const std::string& threadName() const { return threadName_; }
+
+    // 所属线程已退出，不会再写入
+    bool exited() const { return exited_.load(); }
+    void markExited() { exited_.store(true); }
+
+private:
+    uint32_t tid_;
+    std::string threadName_;
+    std::vector<TraceEvent> events_;
+    uint64_t head_;
+    std::atomic_flag lock_;
+    std::atomic<bool> exited_;
+};
+
+std::atomic<bool> enabledFlag(getenv("HBASE_BRIDGE_TRACE") != nullptr);
+std::atomic<uint64_t> nextRequestId(1);
+std::atomic<uint32_t> nextThreadId(1);
+
+// 线程退出后缓冲区仍由注册表持有，保证导出时事件不丢失；下一次导出取走事件后释放
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadRing> > registry;
+
+// 释放注册表中的缓冲区，调用方持有registryMutex
+void eraseRing(ThreadRing* ring) {
+    for (size_t i = 0; i < registry.size(); ++i) {
+        if (registry[i].get() == ring) {
+            registry.erase(registry.begin() + i);
+            return;
+        }
+    }
+}
+
+// 线程退出时登记缓冲区的去向：没有未导出的事件时直接释放，否则留到下一次flushToFile
+struct RingOwner {
+    ThreadRing* ring;
+
+    RingOwner() : ring(nullptr) {}
+
+    ~RingOwner() {
+        if (ring == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (ring->empty()) {
+            eraseRing(ring);
+        } else {
+            ring->markExited();
+        }
+    }
+};
+
+thread_local RingOwner localRing;
+thread_local uint64_t localRequestId = 0;
+
+const std::chrono::steady_clock::time_point clockBase = std::chrono::steady_clock::now();
+
+ThreadRing* currentRing() {
+    if (localRing.ring == nullptr) {
+        char name[64] = {0};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        uint32_t tid = nextThreadId.fetch_add(1);
+        std::string threadName = name[0] != '\0' ? std::string(name) : "native-" + std::to_string(tid);
+
+        std::unique_ptr<ThreadRing> ring(new ThreadRing(tid, threadName));
+        localRing.ring = ring.get();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::move(ring));
+    }
+    return localRing.ring;
+}
+
+// 通知Java层当前线程的请求ID与线程ID，使Java事件与C++事件落在同一条轨道上
+void propagateRequest(uint64_t requestId) {
+    JNIEnv* env = currentEnv();
+    if (env == nullptr) {
+        return;
+    }
+    jclass traceClass = bridgeClass(env, "BridgeTrace");
+    if (traceClass == nullptr) {
+        return;
+    }
+    jmethodID setRequest = env->GetStaticMethodID(traceClass, "setRequest", "(JI)V");
+    if (setRequest == nullptr) {
+        clearPendingException(env, "BridgeTrace.setRequest");
+        return;
+    }
+    env->CallStaticVoidMethod(traceClass, setRequest, (jlong)requestId, (jint)currentRing()->tid());
+    clearPendingException(env, "BridgeTrace.setRequest");
+}
+
+std::string drainJavaEvents(int pid) {
+    JNIEnv* env = currentEnv();
+    if (env == nullptr) {
+        return std::string();
+    }
+    jclass traceClass = bridgeClass(env, "BridgeTrace");
+    if (traceClass == nullptr) {
+        return std::string();
+    }
+    jmethodID drainJson = env->GetStaticMethodID(traceClass, "drainJson", "(I)Ljava/lang/String;");
+    if (drainJson == nullptr) {
+        clearPendingException(env, "BridgeTrace.drainJson");
+        return std::string();
+    }
+    jstring result = (jstring)env->CallStaticObjectMethod(traceClass, drainJson, (jint)pid);
+    if (clearPendingException(env, "BridgeTrace.drainJson") || result == nullptr) {
+        return std::string();
+    }
+    std::string events = toStdString(env, result);
+    env->DeleteLocalRef(result);
+    return events;
+}
+
+void appendEscaped(std::ostringstream& out, const std::string& text) {
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+}
+
+} // namespace
+
+bool isEnabled() {
+    return enabledFlag.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool enabled) {
+    enabledFlag.store(enabled);
+    syncJava();
+}
+
+void syncJava() {
+    JNIEnv* env = currentEnv();
+    if (env == nullptr) {
+        return;
+    }
+    jclass traceClass = bridgeClass(env, "BridgeTrace");
+    if (traceClass == nullptr) {
+        return;
+    }
+    jmethodID enable = env->GetStaticMethodID(traceClass, "enable", "(ZJ)V");
+    if (enable == nullptr) {
+        clearPendingException(env, "BridgeTrace.enable");
+        return;
+    }
+    // 传入本地时钟读数，Java层据此换算System.nanoTime()的偏移量
+    env->CallStaticVoidMethod(traceClass, enable, (jboolean)(isEnabled() ? JNI_TRUE : JNI_FALSE), (jlong)nowNanos());
+    clearPendingException(env, "BridgeTrace.enable");
+}
+
+uint64_t nowNanos() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - clockBase).count();
+}
+
+uint64_t currentRequestId() {
+    return localRequestId;
+}
+
+bool flushToFile(const std::string& path) {
+    int pid = (int)getpid();
+
+    struct DrainedRing {
+        uint32_t tid;
+        std::string threadName;
+        std::vector<TraceEvent> events;
+    };
+    std::vector<DrainedRing> drained;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (size_t i = 0; i < registry.size(); ++i) {
+            DrainedRing ring;
+            ring.tid = registry[i]->tid();
+            ring.threadName = registry[i]->threadName();
+            registry[i]->drain(&ring.events);
+            drained.push_back(ring);
+        }
+        // 已退出线程的缓冲区事件已取走，不会再有写入
+        for (size_t i = registry.size(); i > 0; --i) {
+            if (registry[i - 1]->exited()) {
+                registry.erase(registry.begin() + (i - 1));
+            }
+        }
+    }
+
+    std::ostringstream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+        << ",\"tid\":0,\"args\":{\"name\":\"hbase_bridge\"}}";
+
+    for (size_t i = 0; i < drained.size(); ++i) {
+        const DrainedRing& ring = drained[i];
+        out << ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << ring.tid
+            << ",\"args\":{\"name\":\"";
+        appendEscaped(out, ring.threadName);
+        out << "\"}}";
+
+        const std::vector<TraceEvent>& events = ring.events;
+        for (size_t j = 0; j < events.size(); ++j) {
+            const TraceEvent& e = events[j];
+            out << ",{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\""
+                << ",\"ts\":" << (e.startNanos / 1000) << "." << (e.startNanos % 1000 / 100)
+                << ",\"dur\":" << (e.durationNanos / 1000) << "." << (e.durationNanos % 1000 / 100)
+                << ",\"pid\":" << pid << ",\"tid\":" << ring.tid
+                << ",\"args\":{\"request_id\":" << e.requestId << "}}";
+        }
+    }
+
+    std::string javaEvents = drainJavaEvents(pid);
+    if (!javaEvents.empty()) {
+        out << "," << javaEvents;
+    }
+    out << "]}";
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    std::string json = out.str();
+    bool ok = fwrite(json.data(), 1, json.size(), file) == json.size();
+    ok = fclose(file) == 0 && ok;
+    return ok;
+}
+
+Span::Span(const char* name, const char* category)
+    : name_(name), category_(category), start_(isEnabled() ? nowNanos() : 0), requestId_(localRequestId) {
+}
+
+Span::~Span() {
+    if (start_ == 0 || !isEnabled()) {
+        return;
+    }
+    TraceEvent event;
+    event.name = name_;
+    event.category = category_;
+    event.startNanos = start_;
+    event.durationNanos = nowNanos() - start_;
+    event.requestId = requestId_;
+    currentRing()->push(event);
+}
+
+static uint64_t beginRequest() {
+    uint64_t previous = localRequestId;
+    if (isEnabled()) {
+        localRequestId = nextRequestId.fetch_add(1);
+        propagateRequest(localRequestId);
+    }
+    return previous;
+}
+
+RequestScope::RequestScope(const char* name)
+    : previousRequestId_(beginRequest()), span_(name, "bridge") {
+}
+
+RequestScope::~RequestScope() {
+    localRequestId = previousRequestId_;
+    if (previousRequestId_ != 0 && isEnabled()) {
+        propagateRequest(previousRequestId_);
+    }
+}
+
+} // namespace trace
+} // namespace bridge
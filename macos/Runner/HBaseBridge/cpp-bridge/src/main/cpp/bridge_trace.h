@@ -0,0 +1,65 @@
+#ifndef BRIDGE_TRACE_H
+#define BRIDGE_TRACE_H
+
+#include <stdint.h>
+#include <string>
+
+// 可选的调用链追踪：C++层与Java层共享请求ID，事件写入每线程环形缓冲区，
+// 可导出为Chrome trace / Perfetto可读取的JSON文件。
+// 未开启时Span只做一次原子读，几乎没有开销。
+
+namespace bridge {
+namespace trace {
+
+// 是否开启追踪（也可通过环境变量 HBASE_BRIDGE_TRACE=1 开启）
+bool isEnabled();
+
+// 开启/关闭追踪，并同步到Java层
+void setEnabled(bool enabled);
+
+// 将当前开关状态与时钟基准同步到Java层（JVM创建后调用）
+void syncJava();
+
+// 追踪时钟，单位纳秒，进程内单调递增
+uint64_t nowNanos();
+
+// 当前线程正在处理的请求ID，0表示不在请求内
+uint64_t currentRequestId();
+
+// 导出所有线程（含Java层）的事件到文件并清空缓冲区
+bool flushToFile(const std::string& path);
+
+// 记录一段耗时，析构时写入当前线程的环形缓冲区
+class Span {
+public:
+    explicit Span(const char* name, const char* category = "native");
+    ~Span();
+
+private:
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    const char* name_;
+    const char* category_;
+    uint64_t start_;
+    uint64_t requestId_;
+};
+
+// 一次桥接调用：分配新的请求ID并告知Java层，同时记录整个调用的Span
+class RequestScope {
+public:
+    explicit RequestScope(const char* name);
+    ~RequestScope();
+
+private:
+    RequestScope(const RequestScope&) = delete;
+    RequestScope& operator=(const RequestScope&) = delete;
+
+    uint64_t previousRequestId_;
+    Span span_;
+};
+
+} // namespace trace
+} // namespace bridge
+
+#endif // BRIDGE_TRACE_H
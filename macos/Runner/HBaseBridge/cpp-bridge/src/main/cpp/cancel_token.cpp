@@ -0,0 +1,150 @@
+#include "cancel_token.h"
+#include "jni_support.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace bridge {
+namespace cancel {
+
+namespace {
+
+std::atomic<int64_t> nextTokenId(1);
+
+std::mutex registryMutex;
+std::map<int64_t, std::shared_ptr<Token> > registry;
+
+thread_local const Token* currentToken = nullptr;
+
+int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 调用HBaseBridge上签名为(J...)V的静态方法；JVM未创建时不需要通知
+void callJava(const char* method, const char* signature, int64_t id, int64_t argument, bool withArgument) {
+    JNIEnv* env = currentEnv();
+    if (env == nullptr) {
+        return;
+    }
+    jclass hbaseBridge = bridgeClass(env, "HBaseBridge");
+    if (hbaseBridge == nullptr) {
+        return;
+    }
+    jmethodID methodId = env->GetStaticMethodID(hbaseBridge, method, signature);
+    if (methodId == nullptr) {
+        clearPendingException(env, method);
+        return;
+    }
+    if (withArgument) {
+        env->CallStaticVoidMethod(hbaseBridge, methodId, (jlong)id, (jlong)argument);
+    } else {
+        env->CallStaticVoidMethod(hbaseBridge, methodId, (jlong)id);
+    }
+    clearPendingException(env, method);
+}
+
+} // namespace
+
+const char* statusName(Status status) {
+    switch (status) {
+    case STATUS_OK: return "ok";
+    case STATUS_ERROR: return "error";
+    case STATUS_CANCELLED: return "cancelled";
+    case STATUS_DEADLINE_EXCEEDED: return "deadlineExceeded";
+    }
+    return "unknown";
+}
+
+std::string statusMessage(Status status) {
+    switch (status) {
+    case STATUS_CANCELLED: return "操作已取消";
+    case STATUS_DEADLINE_EXCEEDED: return "操作超过截止时间";
+    default: return std::string();
+    }
+}
+
+Token::Token() : id_(nextTokenId.fetch_add(1)), cancelled_(false), released_(false), deadlineNanos_(0) {
+}
+
+void Token::cancel() {
+    if (cancelled_.exchange(true) || status() != STATUS_CANCELLED) {
+        return; // 已取消或已超时
+    }
+    // 已释放的令牌在Java层没有登记的扫描，不再通知（否则Java层会重新创建登记）
+    if (!released_.load()) {
+        callJava("abortOperation", "(JJ)V", id_, STATUS_CANCELLED, true);
+    }
+}
+
+void Token::setDeadline(int64_t timeoutMs) {
+    deadlineNanos_ = timeoutMs > 0 ? steadyNanos() + timeoutMs * 1000000 : 0;
+    // Java层按同样的时间启动定时器，到时关闭登记的扫描
+    if (!released_.load()) {
+        callJava("setOperationDeadline", "(JJ)V", id_, timeoutMs > 0 ? timeoutMs : 0, true);
+    }
+}
+
+Status Token::status() const {
+    // 截止时间优先：超时后再取消仍报告超时
+    int64_t deadline = deadlineNanos_.load(std::memory_order_relaxed);
+    if (deadline != 0 && steadyNanos() >= deadline) {
+        return STATUS_DEADLINE_EXCEEDED;
+    }
+    return cancelled_.load(std::memory_order_relaxed) ? STATUS_CANCELLED : STATUS_OK;
+}
+
+void Token::release() {
+    if (released_.exchange(true)) {
+        return;
+    }
+    callJava("releaseOperation", "(J)V", id_, 0, false);
+}
+
+std::shared_ptr<Token> create(int64_t timeoutMs) {
+    std::shared_ptr<Token> token = std::make_shared<Token>();
+    if (timeoutMs > 0) {
+        token->setDeadline(timeoutMs);
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry[token->id()] = token;
+    return token;
+}
+
+std::shared_ptr<Token> find(int64_t id) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::map<int64_t, std::shared_ptr<Token> >::iterator it = registry.find(id);
+    return it != registry.end() ? it->second : std::shared_ptr<Token>();
+}
+
+void release(int64_t id) {
+    std::shared_ptr<Token> token;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::map<int64_t, std::shared_ptr<Token> >::iterator it = registry.find(id);
+        if (it == registry.end()) {
+            return;
+        }
+        token = it->second;
+        registry.erase(it);
+    }
+    token->release();
+}
+
+const Token* current() {
+    return currentToken;
+}
+
+TokenScope::TokenScope(const Token* token) : previous_(currentToken) {
+    if (token != nullptr) {
+        currentToken = token;
+    }
+}
+
+TokenScope::~TokenScope() {
+    currentToken = previous_;
+}
+
+} // namespace cancel
+} // namespace bridge
@@ -0,0 +1,90 @@
+#ifndef CANCEL_TOKEN_H
+#define CANCEL_TOKEN_H
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <string>
+
+// 操作的取消令牌与截止时间。每个后台任务自带一个令牌（见job_registry.h），
+// 同步调用（如queryTableData）使用createOperation创建的令牌。
+//
+// 令牌与Java层的OperationTokens共享ID：扫描会话打开时登记在令牌下，
+// 取消或到达截止时间时Java层立即关闭这些ResultScanner，阻塞在RPC中的扫描也会尽快返回，
+// C++层的批次循环在下一个批次之前看到令牌状态后结束。
+
+namespace bridge {
+namespace cancel {
+
+// 操作结果码，同步调用的返回JSON与任务进度JSON中的"code"
+enum Status {
+    STATUS_OK = 0,
+    STATUS_ERROR = -1,
+    STATUS_CANCELLED = -2,
+    STATUS_DEADLINE_EXCEEDED = -3
+};
+
+// "ok" / "error" / "cancelled" / "deadlineExceeded"
+const char* statusName(Status status);
+
+// 取消与超时的错误说明
+std::string statusMessage(Status status);
+
+class Token {
+public:
+    Token();
+
+    int64_t id() const { return id_; }
+
+    // 取消操作，并通知Java层关闭登记的扫描
+    void cancel();
+
+    // 从现在起timeoutMs毫秒后超时，<=0表示不限
+    void setDeadline(int64_t timeoutMs);
+
+    // STATUS_OK、STATUS_CANCELLED或STATUS_DEADLINE_EXCEEDED
+    Status status() const;
+    bool isAborted() const { return status() != STATUS_OK; }
+
+    // 操作结束，释放Java层为该令牌保留的登记与定时器；之后的cancel与setDeadline只改变C++层的状态
+    void release();
+
+private:
+    Token(const Token&);
+    Token& operator=(const Token&);
+
+    const int64_t id_;
+    std::atomic<bool> cancelled_;
+    std::atomic<bool> released_;
+    std::atomic<int64_t> deadlineNanos_; // steady_clock时间，0为不限
+};
+
+// 创建登记的令牌（供按ID取消），timeoutMs<=0表示不限
+std::shared_ptr<Token> create(int64_t timeoutMs);
+
+// 查找登记的令牌，不存在时返回空指针
+std::shared_ptr<Token> find(int64_t id);
+
+// 取消登记并释放Java层的登记
+void release(int64_t id);
+
+// 当前线程正在执行的操作的令牌，没有时为nullptr
+const Token* current();
+
+// 在作用域内把令牌绑定到当前线程，token为nullptr时保持不变
+class TokenScope {
+public:
+    explicit TokenScope(const Token* token);
+    ~TokenScope();
+
+private:
+    TokenScope(const TokenScope&);
+    TokenScope& operator=(const TokenScope&);
+
+    const Token* previous_;
+};
+
+} // namespace cancel
+} // namespace bridge
+
+#endif // CANCEL_TOKEN_H
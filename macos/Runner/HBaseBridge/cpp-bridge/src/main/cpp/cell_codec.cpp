@@ -0,0 +1,146 @@
+#include "cell_codec.h"
+#include <cstring>
+
+namespace bridge {
+namespace codec {
+
+BatchWriter::BatchWriter() : cellCount_(0), lastRowOffset_(0), lastRowLength_(0) {
+    clear();
+}
+
+void BatchWriter::clear() {
+    buffer_.clear();
+    cellCount_ = 0;
+    lastRowOffset_ = 0;
+    lastRowLength_ = 0;
+    putU32(BATCH_MAGIC);
+    putU32(0);
+}
+
+void BatchWriter::putU32(uint32_t v) {
+    uint8_t bytes[4] = {(uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v};
+    buffer_.insert(buffer_.end(), bytes, bytes + 4);
+}
+
+void BatchWriter::putI64(int64_t v) {
+    uint64_t u = (uint64_t)v;
+    putU32((uint32_t)(u >> 32));
+    putU32((uint32_t)u);
+}
+
+void BatchWriter::putBytes(const char* data, size_t length) {
+    buffer_.insert(buffer_.end(), (const uint8_t*)data, (const uint8_t*)data + length);
+}
+
+void BatchWriter::add(const char* row, size_t rowLength,
+                      const char* family, size_t familyLength,
+                      const char* qualifier, size_t qualifierLength,
+                      int64_t timestamp, uint8_t type,
+                      const char* value, size_t valueLength) {
+    bool sameRow = cellCount_ > 0 && rowLength == lastRowLength_
+        && memcmp(&buffer_[lastRowOffset_], row, rowLength) == 0;
+    putU8(sameRow ? FLAG_SAME_ROW : 0);
+    if (!sameRow) {
+        putU32((uint32_t)rowLength);
+        lastRowOffset_ = buffer_.size();
+        lastRowLength_ = (uint32_t)rowLength;
+        putBytes(row, rowLength);
+    }
+    putU8((uint8_t)familyLength);
+    putBytes(family, familyLength);
+    putU32((uint32_t)qualifierLength);
+    putBytes(qualifier, qualifierLength);
+    putI64(timestamp);
+    putU8(type);
+    putU32((uint32_t)valueLength);
+    putBytes(value, valueLength);
+    ++cellCount_;
+}
+
+const std::vector<uint8_t>& BatchWriter::finish() {
+    buffer_[4] = (uint8_t)(cellCount_ >> 24);
+    buffer_[5] = (uint8_t)(cellCount_ >> 16);
+    buffer_[6] = (uint8_t)(cellCount_ >> 8);
+    buffer_[7] = (uint8_t)cellCount_;
+    return buffer_;
+}
+
+BatchReader::BatchReader(const uint8_t* data, size_t length)
+    : data_(data), length_(length), pos_(0), cellCount_(0), cellsRead_(0),
+      lastRow_(nullptr), lastRowLength_(0) {
+    if (!need(8)) {
+        return;
+    }
+    if (getU32() != BATCH_MAGIC) {
+        error_ = "单元格批次格式错误（magic不匹配）";
+        return;
+    }
+    cellCount_ = getU32();
+}
+
+bool BatchReader::need(size_t bytes) {
+    if (length_ - pos_ < bytes) {
+        error_ = "单元格批次数据不完整";
+        return false;
+    }
+    return true;
+}
+
+uint32_t BatchReader::getU32() {
+    const uint8_t* p = data_ + pos_;
+    pos_ += 4;
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+int64_t BatchReader::getI64() {
+    uint64_t high = getU32();
+    uint64_t low = getU32();
+    return (int64_t)((high << 32) | low);
+}
+
+bool BatchReader::next(CellView& cell) {
+    if (!error_.empty() || cellsRead_ >= cellCount_ || !need(1)) {
+        return false;
+    }
+    uint8_t flags = data_[pos_++];
+    if (flags & FLAG_SAME_ROW) {
+        if (lastRow_ == nullptr) {
+            error_ = "单元格批次格式错误（首个单元格缺少行键）";
+            return false;
+        }
+    } else {
+        if (!need(4)) return false;
+        lastRowLength_ = getU32();
+        if (!need(lastRowLength_)) return false;
+        lastRow_ = (const char*)data_ + pos_;
+        pos_ += lastRowLength_;
+    }
+    cell.row = lastRow_;
+    cell.rowLength = lastRowLength_;
+
+    if (!need(1)) return false;
+    cell.familyLength = data_[pos_++];
+    if (!need(cell.familyLength + 4)) return false;
+    cell.family = (const char*)data_ + pos_;
+    pos_ += cell.familyLength;
+    cell.qualifierLength = getU32();
+    if (!need(cell.qualifierLength + 8 + 1 + 4)) return false;
+    cell.qualifier = (const char*)data_ + pos_;
+    pos_ += cell.qualifierLength;
+    cell.timestamp = getI64();
+    cell.type = data_[pos_++];
+    cell.valueLength = getU32();
+    if (!need(cell.valueLength)) return false;
+    cell.value = (const char*)data_ + pos_;
+    pos_ += cell.valueLength;
+    cell.fullValueLength = cell.valueLength;
+    if (flags & FLAG_TRUNCATED) {
+        if (!need(4)) return false;
+        cell.fullValueLength = getU32();
+    }
+    ++cellsRead_;
+    return true;
+}
+
+} // namespace codec
+} // namespace bridge
@@ -0,0 +1,119 @@
+#ifndef CELL_CODEC_H
+#define CELL_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// C++层与Java层之间传递单元格批次的二进制格式（与Java层 CellCodec 对应），
+// 避免大批量数据经过JSON编码。所有整数均为大端序：
+//
+//   批次头: u32 magic('HBC1') u32 单元格数
+//   单元格: u8 flags
+//           [u32 行键长度 + 行键]          flags不含FLAG_SAME_ROW时出现
+//           u8 列族长度 + 列族
+//           u32 列限定符长度 + 列限定符
+//           i64 时间戳  u8 类型(KeyValue.Type编码，Put=4)
+//           u32 值长度 + 值
+//           [u32 完整值长度]               flags含FLAG_TRUNCATED时出现
+//
+// 同一行的连续单元格只写一次行键，宽行的批次体积基本只取决于列和值。
+
+namespace bridge {
+namespace codec {
+
+const uint32_t BATCH_MAGIC = 0x48424331; // "HBC1"
+
+const uint8_t FLAG_SAME_ROW = 0x01;  // 与上一个单元格同一行，省略行键
+const uint8_t FLAG_TRUNCATED = 0x02; // 值被截断，后面附带完整长度
+
+const uint8_t TYPE_PUT = 4;
+const uint8_t TYPE_DELETE = 8;
+const uint8_t TYPE_DELETE_COLUMN = 12;
+const uint8_t TYPE_DELETE_FAMILY = 14;
+
+const int64_t LATEST_TIMESTAMP = INT64_MAX;
+
+// 指向批次缓冲区内部的单元格视图，缓冲区释放后失效
+struct CellView {
+    const char* row;
+    uint32_t rowLength;
+    const char* family;
+    uint32_t familyLength;
+    const char* qualifier;
+    uint32_t qualifierLength;
+    int64_t timestamp;
+    uint8_t type;
+    const char* value;
+    uint32_t valueLength;
+    uint32_t fullValueLength; // 未截断时等于valueLength
+};
+
+// 追加式编码一个批次
+class BatchWriter {
+public:
+    BatchWriter();
+
+    void add(const char* row, size_t rowLength,
+             const char* family, size_t familyLength,
+             const char* qualifier, size_t qualifierLength,
+             int64_t timestamp, uint8_t type,
+             const char* value, size_t valueLength);
+
+    void add(const std::string& row, const std::string& family, const std::string& qualifier,
+             const std::string& value, int64_t timestamp = LATEST_TIMESTAMP) {
+        add(row.data(), row.size(), family.data(), family.size(), qualifier.data(), qualifier.size(),
+            timestamp, TYPE_PUT, value.data(), value.size());
+    }
+
+    uint32_t cellCount() const { return cellCount_; }
+    size_t size() const { return buffer_.size(); }
+    bool empty() const { return cellCount_ == 0; }
+
+    // 返回完整批次（回填单元格数），在下一次add/clear之前有效
+    const std::vector<uint8_t>& finish();
+
+    void clear();
+
+private:
+    void putU8(uint8_t v) { buffer_.push_back(v); }
+    void putU32(uint32_t v);
+    void putI64(int64_t v);
+    void putBytes(const char* data, size_t length);
+
+    std::vector<uint8_t> buffer_;
+    uint32_t cellCount_;
+    size_t lastRowOffset_; // 上一个单元格行键在buffer_中的位置
+    uint32_t lastRowLength_;
+};
+
+// 顺序解码一个批次，格式错误时next返回false并设置error()
+class BatchReader {
+public:
+    BatchReader(const uint8_t* data, size_t length);
+
+    uint32_t cellCount() const { return cellCount_; }
+    bool next(CellView& cell);
+    bool hasError() const { return !error_.empty(); }
+    const std::string& error() const { return error_; }
+
+private:
+    bool need(size_t bytes);
+    uint32_t getU32();
+    int64_t getI64();
+
+    const uint8_t* data_;
+    size_t length_;
+    size_t pos_;
+    uint32_t cellCount_;
+    uint32_t cellsRead_;
+    const char* lastRow_;
+    uint32_t lastRowLength_;
+    std::string error_;
+};
+
+} // namespace codec
+} // namespace bridge
+
+#endif // CELL_CODEC_H
@@ -0,0 +1,167 @@
+#ifndef HASH_UTIL_H
+#define HASH_UTIL_H
+
+#include "cell_codec.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// XXH64（与xxHash的XXH64结果一致），用于行、单元格内容的比较与校验。
+// 按小端读取输入，桥接层只在小端平台（x86_64/arm64）上构建。
+
+namespace bridge {
+namespace hash {
+
+class Xxh64 {
+public:
+    explicit Xxh64(uint64_t seed = 0) { reset(seed); }
+
+    void reset(uint64_t seed = 0) {
+        seed_ = seed;
+        acc_[0] = seed + PRIME1 + PRIME2;
+        acc_[1] = seed + PRIME2;
+        acc_[2] = seed;
+        acc_[3] = seed - PRIME1;
+        total_ = 0;
+        buffered_ = 0;
+    }
+
+    void update(const void* input, size_t length) {
+        const uint8_t* p = (const uint8_t*)input;
+        total_ += length;
+        if (buffered_ + length < 32) {
+            memcpy(buffer_ + buffered_, p, length);
+            buffered_ += length;
+            return;
+        }
+        if (buffered_ > 0) {
+            size_t fill = 32 - buffered_;
+            memcpy(buffer_ + buffered_, p, fill);
+            consume(buffer_);
+            p += fill;
+            length -= fill;
+            buffered_ = 0;
+        }
+        while (length >= 32) {
+            consume(p);
+            p += 32;
+            length -= 32;
+        }
+        memcpy(buffer_, p, length);
+        buffered_ = length;
+    }
+
+    // 按8字节小端写入整数（用于长度前缀、时间戳等）
+    void updateU64(uint64_t value) {
+        update(&value, sizeof(value));
+    }
+
+    uint64_t digest() const {
+        uint64_t h;
+        if (total_ >= 32) {
+            h = rotl(acc_[0], 1) + rotl(acc_[1], 7) + rotl(acc_[2], 12) + rotl(acc_[3], 18);
+            for (int i = 0; i < 4; ++i) {
+                h = (h ^ round(0, acc_[i])) * PRIME1 + PRIME4;
+            }
+        } else {
+            h = seed_ + PRIME5;
+        }
+        h += total_;
+
+        const uint8_t* p = buffer_;
+        size_t length = buffered_;
+        while (length >= 8) {
+            h ^= round(0, load64(p));
+            h = rotl(h, 27) * PRIME1 + PRIME4;
+            p += 8;
+            length -= 8;
+        }
+        if (length >= 4) {
+            h ^= (uint64_t)load32(p) * PRIME1;
+            h = rotl(h, 23) * PRIME2 + PRIME3;
+            p += 4;
+            length -= 4;
+        }
+        while (length > 0) {
+            h ^= (uint64_t)(*p) * PRIME5;
+            h = rotl(h, 11) * PRIME1;
+            ++p;
+            --length;
+        }
+        h ^= h >> 33;
+        h *= PRIME2;
+        h ^= h >> 29;
+        h *= PRIME3;
+        h ^= h >> 32;
+        return h;
+    }
+
+private:
+    static const uint64_t PRIME1 = 11400714785074694791ULL;
+    static const uint64_t PRIME2 = 14029467366897019727ULL;
+    static const uint64_t PRIME3 = 1609587929392839161ULL;
+    static const uint64_t PRIME4 = 9650029242287828579ULL;
+    static const uint64_t PRIME5 = 2870177450012600261ULL;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    static uint64_t round(uint64_t acc, uint64_t input) {
+        acc += input * PRIME2;
+        return rotl(acc, 31) * PRIME1;
+    }
+
+    static uint64_t load64(const uint8_t* p) {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint32_t load32(const uint8_t* p) {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    void consume(const uint8_t* block) {
+        for (int i = 0; i < 4; ++i) {
+            acc_[i] = round(acc_[i], load64(block + i * 8));
+        }
+    }
+
+    uint64_t seed_;
+    uint64_t acc_[4];
+    uint64_t total_;
+    uint8_t buffer_[32];
+    size_t buffered_;
+};
+
+inline uint64_t xxh64(const void* data, size_t length, uint64_t seed = 0) {
+    Xxh64 state(seed);
+    state.update(data, length);
+    return state.digest();
+}
+
+// 一行单元格内容的哈希：列族、列限定符、值都带长度前缀，timestamps为true时包含时间戳。
+// 行键不参与，需要时通过seed带入
+inline uint64_t row(const codec::CellView* cells, size_t count, bool timestamps, uint64_t seed = 0) {
+    Xxh64 state(seed);
+    for (size_t i = 0; i < count; ++i) {
+        const codec::CellView& cell = cells[i];
+        state.updateU64(cell.familyLength);
+        state.update(cell.family, cell.familyLength);
+        state.updateU64(cell.qualifierLength);
+        state.update(cell.qualifier, cell.qualifierLength);
+        state.updateU64(cell.fullValueLength);
+        state.update(cell.value, cell.valueLength);
+        if (timestamps) {
+            state.updateU64((uint64_t)cell.timestamp);
+        }
+    }
+    return state.digest();
+}
+
+} // namespace hash
+} // namespace bridge
+
+#endif // HASH_UTIL_H
@@ -1,14 +1,37 @@
 #include "hbase_bridge.h"
-#include <iostream>
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cancel_token.h"
+#include "jni_support.h"
+#include "json_util.h"
+#include "large_cell.h"
+#include "job_registry.h"
+#include "memory_budget.h"
+#include "point_read.h"
+#include "qos.h"
+#include "result_store.h"
+#include "scheduler.h"
+#include "snapshot_store.h"
+#include "table_aggregate.h"
+#include "table_checksum.h"
+#include "table_copy.h"
+#include "table_diff.h"
+#include "table_export.h"
+#include "table_generator.h"
+#include "table_import.h"
+#include "table_watch.h"
+#include <chrono>
 #include <string>
 #include <exception>
 #include <vector>
 #include <map>
 #include <cstdlib>
 #include <cstring>
+#include <cstdio>
 #include <unistd.h>
 #include <errno.h>
 #include <pthread.h>
+#include <sys/utsname.h>
 #include <jni.h>
 
 static JavaVM* jvm = nullptr;
@@ -21,37 +44,82 @@ JNIEnv* g_env = nullptr;
 jclass g_hbaseBridgeClass = nullptr;
 jobject g_hbaseBridgeInstance = nullptr;
 
+// Java层BridgeLog.nativeLog的实现：Java日志进入同一个异步队列
+static void JNICALL javaNativeLog(JNIEnv* env, jclass, jint level, jstring message) {
+    bridge::log::Level logLevel = (bridge::log::Level)level;
+    if (!bridge::log::isEnabled(logLevel)) {
+        return;
+    }
+    bridge::log::write(logLevel, "[java] " + bridge::toStdString(env, message));
+}
+
+// 同步日志级别到Java层；首次调用时注册nativeLog
+static void syncJavaLogging() {
+    static bool nativesRegistered = false;
+
+    JNIEnv* env = bridge::currentEnv();
+    if (env == nullptr) {
+        return;
+    }
+    jclass logClass = bridge::bridgeClass(env, "BridgeLog");
+    if (logClass == nullptr) {
+        return;
+    }
+    if (!nativesRegistered) {
+        JNINativeMethod methods[] = {
+            {const_cast<char*>("nativeLog"), const_cast<char*>("(ILjava/lang/String;)V"), (void*)javaNativeLog}
+        };
+        if (env->RegisterNatives(logClass, methods, 1) != JNI_OK) {
+            bridge::clearPendingException(env, "BridgeLog.RegisterNatives");
+            return;
+        }
+        nativesRegistered = true;
+    }
+    jmethodID attachNative = env->GetStaticMethodID(logClass, "attachNative", "(I)V");
+    if (attachNative == nullptr) {
+        bridge::clearPendingException(env, "BridgeLog.attachNative");
+        return;
+    }
+    env->CallStaticVoidMethod(logClass, attachNative, (jint)bridge::log::currentLevel());
+    bridge::clearPendingException(env, "BridgeLog.attachNative");
+}
+
 extern "C" {
 
 // 初始化JVM
 JNIEXPORT bool JNICALL initJVM() {
+    bridge::trace::RequestScope traceScope("initJVM");
     try {
-        std::cout << "【关键诊断】initJVM 函数开始执行，进程ID: " << getpid() << std::endl;
-        std::cout << "【关键诊断】系统信息: " << std::flush;
-        system("uname -a");
+        BRIDGE_LOG_DEBUG("【关键诊断】initJVM 函数开始执行，进程ID: " << getpid());
+        if (bridge::log::isEnabled(bridge::log::LEVEL_DEBUG)) {
+            struct utsname systemInfo;
+            if (uname(&systemInfo) == 0) {
+                BRIDGE_LOG_DEBUG("【关键诊断】系统信息: " << systemInfo.sysname << " " << systemInfo.release
+                    << " " << systemInfo.version << " " << systemInfo.machine);
+            }
+        }
         
         // 打印当前线程ID
-        std::cout << "【线程追踪】当前线程ID: " << pthread_self() << std::endl;
-        fflush(stdout);
+        BRIDGE_LOG_DEBUG("【线程追踪】当前线程ID: " << pthread_self());
         
         // 设置HADOOP_USER_NAME环境变量
-        std::cout << "尝试在JVM初始化前设置环境变量 HADOOP_USER_NAME=da_music" << std::endl;
+        BRIDGE_LOG_DEBUG("尝试在JVM初始化前设置环境变量 HADOOP_USER_NAME=da_music");
         if (setenv("HADOOP_USER_NAME", "da_music", 1) != 0) {
-            std::cerr << "在initJVM中设置环境变量失败: " << strerror(errno) << std::endl;
+            BRIDGE_LOG_WARN("在initJVM中设置环境变量失败: " << strerror(errno));
             // 继续执行
         } else {
-            std::cout << "在initJVM中成功设置环境变量 HADOOP_USER_NAME=da_music" << std::endl;
+            BRIDGE_LOG_DEBUG("在initJVM中成功设置环境变量 HADOOP_USER_NAME=da_music");
         }
         
         // 安全检查当前工作目录
         char cwd[1024];
         if (getcwd(cwd, sizeof(cwd)) != NULL) {
-            std::cout << "【诊断信息】当前工作目录: " << cwd << std::endl;
+            BRIDGE_LOG_DEBUG("【诊断信息】当前工作目录: " << cwd);
         }
         
         // 如果JVM已初始化，直接返回
         if (jvmInitialized && jvm != nullptr) {
-            std::cout << "JVM已经初始化，直接使用" << std::endl;
+            BRIDGE_LOG_DEBUG("JVM已经初始化，直接使用");
             return true;
         }
         
@@ -61,26 +129,30 @@ JNIEXPORT bool JNICALL initJVM() {
         
         // 查询已存在的JavaVMs
         if (JNI_GetCreatedJavaVMs(&jvm, 1, &vm_count) == JNI_OK && vm_count > 0 && jvm != nullptr) {
-            std::cout << "找到已存在的JVM实例，尝试使用" << std::endl;
+            BRIDGE_LOG_DEBUG("找到已存在的JVM实例，尝试使用");
             
             // 尝试附加到现有JVM
             jint attach_result = jvm->GetEnv((void**)&existing_env, JNI_VERSION_1_8);
             if (attach_result == JNI_EDETACHED) {
                 // 线程未附加到JVM，尝试附加
                 if (jvm->AttachCurrentThread((void**)&existing_env, nullptr) == JNI_OK && existing_env != nullptr) {
-                    std::cout << "成功附加到现有JVM" << std::endl;
+                    BRIDGE_LOG_INFO("成功附加到现有JVM");
                     jvmInitialized = true;
+                    syncJavaLogging();
+                    bridge::trace::syncJava();
                     return true;
                 }
             } else if (attach_result == JNI_OK && existing_env != nullptr) {
                 // 已附加到JVM
-                std::cout << "已经附加到现有JVM" << std::endl;
+                BRIDGE_LOG_INFO("已经附加到现有JVM");
                 jvmInitialized = true;
+                syncJavaLogging();
+                bridge::trace::syncJava();
                 return true;
             }
         }
         
-        std::cout << "需要创建新的JVM实例..." << std::endl;
+        BRIDGE_LOG_DEBUG("需要创建新的JVM实例...");
         
         // 尝试多个可能的路径
         std::vector<std::string> jarPaths = {
@@ -100,76 +172,103 @@ JNIEXPORT bool JNICALL initJVM() {
         std::string jarPath;
         bool jarFound = false;
         
+        // 环境变量可直接指定完整类路径（基准测试、开发调试时使用）
+        const char* classpathOverride = getenv("HBASE_BRIDGE_CLASSPATH");
+        if (classpathOverride != nullptr && classpathOverride[0] != '\0') {
+            BRIDGE_LOG_INFO("使用HBASE_BRIDGE_CLASSPATH指定的类路径: " << classpathOverride);
+            jarPath = classpathOverride;
+            jarFound = true;
+            jarPaths.clear();
+        }
+        
         for (const auto& path : jarPaths) {
-            std::cout << "尝试JAR路径: " << path << std::endl;
+            BRIDGE_LOG_DEBUG("尝试JAR路径: " << path);
             FILE* file = fopen(path.c_str(), "r");
             if (file) {
-                std::cout << "找到JAR文件: " << path << std::endl;
+                BRIDGE_LOG_DEBUG("找到JAR文件: " << path);
                 fclose(file);
                 jarPath = path;
                 jarFound = true;
                 break;
             } else {
-                std::cout << "未找到JAR文件: " << path << " (错误: " << strerror(errno) << ")" << std::endl;
+                BRIDGE_LOG_DEBUG("未找到JAR文件: " << path << " (错误: " << strerror(errno) << ")");
             }
         }
         
         if (!jarFound) {
-            std::cerr << "无法找到必要的JAR文件" << std::endl;
+            BRIDGE_LOG_ERROR("无法找到必要的JAR文件");
             return false;
         }
         
         // JVM初始化参数
         JavaVMInitArgs vm_args;
-        JavaVMOption options[12]; // 增加选项数量
+        std::vector<std::string> optionStrings;
         
         // 设置类路径
         std::string classpath = "-Djava.class.path=";
         classpath += jarPath;
-        options[0].optionString = const_cast<char*>(classpath.c_str());
+        optionStrings.push_back(classpath);
         
         // 设置其他JVM选项
-        options[1].optionString = const_cast<char*>("-Djava.library.path=.");
-        options[2].optionString = const_cast<char*>("-Dfile.encoding=UTF-8");
-        options[3].optionString = const_cast<char*>("-Xcheck:jni");
-        options[4].optionString = const_cast<char*>("-Xmx512m");
-        options[5].optionString = const_cast<char*>("-verbose:jni"); // 添加JNI详细日志
-        options[6].optionString = const_cast<char*>("-verbose:class"); // 添加类加载日志
+        optionStrings.push_back("-Djava.library.path=.");
+        optionStrings.push_back("-Dfile.encoding=UTF-8");
+        optionStrings.push_back("-Xmx512m");
+        
+        // JNI检查与类加载日志开销很大，只在DEBUG级别开启
+        if (bridge::log::isEnabled(bridge::log::LEVEL_DEBUG)) {
+            optionStrings.push_back("-Xcheck:jni");
+            optionStrings.push_back("-verbose:jni"); // 添加JNI详细日志
+            optionStrings.push_back("-verbose:class"); // 添加类加载日志
+        }
+        
+        // HBase客户端（slf4j-simple）的日志级别与桥接日志级别保持一致
+        static const char* const slf4jLevels[] = {"trace", "debug", "info", "warn", "error", "off"};
+        optionStrings.push_back(std::string("-Dorg.slf4j.simpleLogger.defaultLogLevel=") +
+            slf4jLevels[bridge::log::currentLevel()]);
         
         // 添加HADOOP_USER_NAME系统属性
-        std::string hadoopUserProp = "-DHADOOP_USER_NAME=da_music";
-        options[7].optionString = const_cast<char*>(hadoopUserProp.c_str());
+        optionStrings.push_back("-DHADOOP_USER_NAME=da_music");
         
         // 额外的Hadoop相关设置
-        options[8].optionString = const_cast<char*>("-Dhadoop.home.dir=/tmp");
-        options[9].optionString = const_cast<char*>("-Djava.security.krb5.realm=");
-        options[10].optionString = const_cast<char*>("-Djava.security.krb5.kdc=");
-        options[11].optionString = const_cast<char*>("-Djava.awt.headless=true");
+        optionStrings.push_back("-Dhadoop.home.dir=/tmp");
+        optionStrings.push_back("-Djava.security.krb5.realm=");
+        optionStrings.push_back("-Djava.security.krb5.kdc=");
+        optionStrings.push_back("-Djava.awt.headless=true");
+        
+        std::vector<JavaVMOption> options(optionStrings.size());
+        for (size_t i = 0; i < optionStrings.size(); ++i) {
+            options[i].optionString = const_cast<char*>(optionStrings[i].c_str());
+            options[i].extraInfo = nullptr;
+        }
         
         vm_args.version = JNI_VERSION_1_8;
-        vm_args.nOptions = 12; // 更新选项数量
-        vm_args.options = options;
+        vm_args.nOptions = (jint)options.size();
+        vm_args.options = options.data();
         vm_args.ignoreUnrecognized = JNI_TRUE;
         
-        std::cout << "【JVM初始化】创建JVM，类路径: " << classpath << std::endl;
-        std::cout << "【JVM初始化】HADOOP_USER_NAME设置为: da_music" << std::endl;
-        std::cout << "【JVM初始化】JVM版本: " << JNI_VERSION_1_8 << std::endl;
-        std::cout << "【JVM初始化】JVM选项数量: " << vm_args.nOptions << std::endl;
+        BRIDGE_LOG_DEBUG("【JVM初始化】创建JVM，类路径: " << classpath);
+        BRIDGE_LOG_DEBUG("【JVM初始化】HADOOP_USER_NAME设置为: da_music");
+        BRIDGE_LOG_DEBUG("【JVM初始化】JVM版本: " << JNI_VERSION_1_8);
+        BRIDGE_LOG_DEBUG("【JVM初始化】JVM选项数量: " << vm_args.nOptions);
         
         // 创建JVM
         JNIEnv* env;
-        jint res = JNI_CreateJavaVM(&jvm, (void**)&env, &vm_args);
+        jint res;
+        {
+            bridge::trace::Span span("jni.createJavaVM");
+            res = JNI_CreateJavaVM(&jvm, (void**)&env, &vm_args);
+        }
         if (res != JNI_OK) {
-            std::cerr << "【JVM初始化】创建JVM失败，错误码: " << res << std::endl;
+            BRIDGE_LOG_ERROR("【JVM初始化】创建JVM失败，错误码: " << res);
             return false;
         }
         
-        std::cout << "【JVM初始化】JVM创建成功" << std::endl;
+        BRIDGE_LOG_INFO("【JVM初始化】JVM创建成功");
         
         // 验证是否可以加载类
         jclass testClass = env->FindClass("java/lang/String");
         if (testClass == nullptr) {
-            std::cerr << "无法加载基本Java类，JVM配置有问题" << std::endl;
+            BRIDGE_LOG_ERROR("无法加载基本Java类，JVM配置有问题");
             if (env->ExceptionCheck()) {
                 env->ExceptionDescribe();
                 env->ExceptionClear();
@@ -178,12 +277,12 @@ JNIEXPORT bool JNICALL initJVM() {
             return false;
         }
         
-        std::cout << "基本Java类加载成功，尝试加载自定义类..." << std::endl;
+        BRIDGE_LOG_DEBUG("基本Java类加载成功，尝试加载自定义类...");
         
         // 尝试加载HBaseBridge类
         jclass hbaseBridgeClass = env->FindClass("com/hbasegui/bridge/HBaseBridge");
         if (hbaseBridgeClass == nullptr) {
-            std::cerr << "无法加载HBaseBridge类" << std::endl;
+            BRIDGE_LOG_ERROR("无法加载HBaseBridge类");
             if (env->ExceptionCheck()) {
                 env->ExceptionDescribe();
                 env->ExceptionClear();
@@ -193,7 +292,7 @@ JNIEXPORT bool JNICALL initJVM() {
             return false;
         }
         
-        std::cout << "HBaseBridge类加载成功，JVM环境正常" << std::endl;
+        BRIDGE_LOG_DEBUG("HBaseBridge类加载成功，JVM环境正常");
         
         // 检查环境变量是否成功设置在JVM中
         jclass systemClass = env->FindClass("java/lang/System");
@@ -206,11 +305,11 @@ JNIEXPORT bool JNICALL initJVM() {
                 
                 if (propValue != nullptr) {
                     const char* valueStr = env->GetStringUTFChars(propValue, nullptr);
-                    std::cout << "JVM中的HADOOP_USER_NAME属性值: " << valueStr << std::endl;
+                    BRIDGE_LOG_DEBUG("JVM中的HADOOP_USER_NAME属性值: " << valueStr);
                     env->ReleaseStringUTFChars(propValue, valueStr);
                     env->DeleteLocalRef(propValue);
                 } else {
-                    std::cout << "JVM中的HADOOP_USER_NAME属性未设置" << std::endl;
+                    BRIDGE_LOG_DEBUG("JVM中的HADOOP_USER_NAME属性未设置");
                     
                     // 尝试在JVM创建后设置
                     jmethodID setPropertyMethod = env->GetStaticMethodID(systemClass, "setProperty", 
@@ -219,7 +318,7 @@ JNIEXPORT bool JNICALL initJVM() {
                         jstring propNameSet = env->NewStringUTF("HADOOP_USER_NAME");
                         jstring propValueSet = env->NewStringUTF("da_music");
                         env->CallStaticObjectMethod(systemClass, setPropertyMethod, propNameSet, propValueSet);
-                        std::cout << "已在JVM创建后设置HADOOP_USER_NAME=da_music" << std::endl;
+                        BRIDGE_LOG_DEBUG("已在JVM创建后设置HADOOP_USER_NAME=da_music");
                         env->DeleteLocalRef(propNameSet);
                         env->DeleteLocalRef(propValueSet);
                     }
@@ -234,14 +333,16 @@ JNIEXPORT bool JNICALL initJVM() {
         env->DeleteLocalRef(testClass);
         
         jvmInitialized = true;
+        syncJavaLogging();
+        bridge::trace::syncJava();
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "JVM初始化过程中发生异常: " << e.what() << std::endl;
+        BRIDGE_LOG_ERROR("JVM初始化过程中发生异常: " << e.what());
         jvm = nullptr;
         jvmInitialized = false;
         return false;
     } catch (...) {
-        std::cerr << "JVM初始化过程中发生未知异常" << std::endl;
+        BRIDGE_LOG_ERROR("JVM初始化过程中发生未知异常");
         jvm = nullptr;
         jvmInitialized = false;
         return false;
@@ -249,22 +350,22 @@ JNIEXPORT bool JNICALL initJVM() {
 }
 
 JNIEXPORT bool JNICALL connect(const char* zkQuorum, const char* zkNode) {
+    bridge::trace::RequestScope traceScope("connect");
     try {
-        std::cout << "【关键诊断】connect 函数开始执行，进程ID: " << getpid() << std::endl;
-        std::cout << "【线程追踪】连接方法线程ID: " << pthread_self() << std::endl;
-        fflush(stdout);
+        BRIDGE_LOG_DEBUG("【关键诊断】connect 函数开始执行，进程ID: " << getpid());
+        BRIDGE_LOG_DEBUG("【线程追踪】连接方法线程ID: " << pthread_self());
         
         // 检查参数
         if (zkQuorum == nullptr || zkNode == nullptr) {
-            std::cerr << "C++ bridge: connect() 参数无效 (空指针)" << std::endl;
+            BRIDGE_LOG_ERROR("C++ bridge: connect() 参数无效 (空指针)");
             return false;
         }
         
         // 检查JVM状态
         if (!jvmInitialized || jvm == nullptr) {
-            std::cerr << "JVM未初始化，尝试初始化..." << std::endl;
+            BRIDGE_LOG_WARN("JVM未初始化，尝试初始化...");
             if (!initJVM()) {
-                std::cerr << "JVM初始化失败" << std::endl;
+                BRIDGE_LOG_ERROR("JVM初始化失败");
                 return false;
             }
         }
@@ -275,18 +376,18 @@ JNIEXPORT bool JNICALL connect(const char* zkQuorum, const char* zkNode) {
         
         if (getEnvResult == JNI_EDETACHED) {
             if (jvm->AttachCurrentThread((void**)&env, nullptr) != JNI_OK) {
-                std::cerr << "无法附加到JVM线程" << std::endl;
+                BRIDGE_LOG_ERROR("无法附加到JVM线程");
                 return false;
             }
         } else if (getEnvResult != JNI_OK) {
-            std::cerr << "无法获取JNIEnv" << std::endl;
+            BRIDGE_LOG_ERROR("无法获取JNIEnv");
             return false;
         }
         
         // 获取HBaseBridge类
         jclass bridgeClass = env->FindClass("com/hbasegui/bridge/HBaseBridge");
         if (bridgeClass == nullptr) {
-            std::cerr << "无法找到HBaseBridge类" << std::endl;
+            BRIDGE_LOG_ERROR("无法找到HBaseBridge类");
             if (env->ExceptionCheck()) {
                 env->ExceptionDescribe();
                 env->ExceptionClear();
@@ -298,7 +399,7 @@ JNIEXPORT bool JNICALL connect(const char* zkQuorum, const char* zkNode) {
         jmethodID connectMethod = env->GetStaticMethodID(bridgeClass, "connect", 
             "(Ljava/lang/String;Ljava/lang/String;)Z");
         if (connectMethod == nullptr) {
-            std::cerr << "无法找到connect方法" << std::endl;
+            BRIDGE_LOG_ERROR("无法找到connect方法");
             if (env->ExceptionCheck()) {
                 env->ExceptionDescribe();
                 env->ExceptionClear();
@@ -312,7 +413,7 @@ JNIEXPORT bool JNICALL connect(const char* zkQuorum, const char* zkNode) {
         jstring zkNodeStr = env->NewStringUTF(zkNode);
         
         if (zkQuorumStr == nullptr || zkNodeStr == nullptr) {
-            std::cerr << "无法创建Java字符串参数" << std::endl;
+            BRIDGE_LOG_ERROR("无法创建Java字符串参数");
             if (zkQuorumStr != nullptr) env->DeleteLocalRef(zkQuorumStr);
             if (zkNodeStr != nullptr) env->DeleteLocalRef(zkNodeStr);
             env->DeleteLocalRef(bridgeClass);
@@ -320,11 +421,15 @@ JNIEXPORT bool JNICALL connect(const char* zkQuorum, const char* zkNode) {
         }
         
         // 调用Java方法
-        jboolean result = env->CallStaticBooleanMethod(bridgeClass, connectMethod, zkQuorumStr, zkNodeStr);
+        jboolean result;
+        {
+            bridge::trace::Span span("jni.call");
+            result = env->CallStaticBooleanMethod(bridgeClass, connectMethod, zkQuorumStr, zkNodeStr);
+        }
         
         // 检查是否有异常发生
         if (env->ExceptionCheck()) {
-            std::cerr << "Java方法执行过程中发生异常" << std::endl;
+            BRIDGE_LOG_ERROR("Java方法执行过程中发生异常");
             env->ExceptionDescribe();
             env->ExceptionClear();
             env->DeleteLocalRef(zkQuorumStr);
@@ -340,19 +445,21 @@ JNIEXPORT bool JNICALL connect(const char* zkQuorum, const char* zkNode) {
         
         return result;
     } catch (const std::exception& e) {
-        std::cerr << "连接过程中发生异常: " << e.what() << std::endl;
+        BRIDGE_LOG_ERROR("连接过程中发生异常: " << e.what());
         return false;
     } catch (...) {
-        std::cerr << "连接过程中发生未知异常" << std::endl;
+        BRIDGE_LOG_ERROR("连接过程中发生未知异常");
         return false;
     }
 }
 
 JNIEXPORT const char* JNICALL getTables() {
+    bridge::trace::RequestScope traceScope("getTables");
+    bridge::sched::InteractiveScope interactiveScope;
     try {
         // 检查JVM状态
         if (!jvmInitialized || jvm == nullptr) {
-            std::cerr << "JVM未初始化" << std::endl;
+            BRIDGE_LOG_ERROR("JVM未初始化");
             return nullptr;
         }
         
@@ -362,18 +469,18 @@ JNIEXPORT const char* JNICALL getTables() {
         
         if (getEnvResult == JNI_EDETACHED) {
             if (jvm->AttachCurrentThread((void**)&env, nullptr) != JNI_OK) {
-                std::cerr << "无法附加到JVM线程" << std::endl;
+                BRIDGE_LOG_ERROR("无法附加到JVM线程");
                 return nullptr;
             }
         } else if (getEnvResult != JNI_OK) {
-            std::cerr << "无法获取JNIEnv" << std::endl;
+            BRIDGE_LOG_ERROR("无法获取JNIEnv");
             return nullptr;
         }
         
         // 获取HBaseBridge类
         jclass bridgeClass = env->FindClass("com/hbasegui/bridge/HBaseBridge");
         if (bridgeClass == nullptr) {
-            std::cerr << "无法找到HBaseBridge类" << std::endl;
+            BRIDGE_LOG_ERROR("无法找到HBaseBridge类");
             return nullptr;
         }
         
@@ -381,17 +488,21 @@ JNIEXPORT const char* JNICALL getTables() {
         jmethodID listTablesMethod = env->GetStaticMethodID(bridgeClass, "listTables", 
             "()Ljava/lang/String;");
         if (listTablesMethod == nullptr) {
-            std::cerr << "无法找到listTables方法" << std::endl;
+            BRIDGE_LOG_ERROR("无法找到listTables方法");
             env->DeleteLocalRef(bridgeClass);
             return nullptr;
         }
         
         // 调用Java方法
-        jstring result = (jstring)env->CallStaticObjectMethod(bridgeClass, listTablesMethod);
+        jstring result;
+        {
+            bridge::trace::Span span("jni.call");
+            result = (jstring)env->CallStaticObjectMethod(bridgeClass, listTablesMethod);
+        }
         
         // 检查是否有异常发生
         if (env->ExceptionCheck()) {
-            std::cerr << "Java方法执行过程中发生异常" << std::endl;
+            BRIDGE_LOG_ERROR("Java方法执行过程中发生异常");
             env->ExceptionDescribe();
             env->ExceptionClear();
             env->DeleteLocalRef(bridgeClass);
@@ -399,15 +510,16 @@ JNIEXPORT const char* JNICALL getTables() {
         }
         
         if (result == nullptr) {
-            std::cerr << "Java方法返回空" << std::endl;
+            BRIDGE_LOG_ERROR("Java方法返回空");
             env->DeleteLocalRef(bridgeClass);
             return nullptr;
         }
         
         // 转换Java字符串到C字符串
+        bridge::trace::Span copySpan("jni.result.copy");
         const char* cResult = env->GetStringUTFChars(result, nullptr);
         if (cResult == nullptr) {
-            std::cerr << "无法转换Java字符串到C字符串" << std::endl;
+            BRIDGE_LOG_ERROR("无法转换Java字符串到C字符串");
             env->DeleteLocalRef(result);
             env->DeleteLocalRef(bridgeClass);
             return nullptr;
@@ -423,25 +535,27 @@ JNIEXPORT const char* JNICALL getTables() {
         
         return copy;
     } catch (const std::exception& e) {
-        std::cerr << "获取表列表过程中发生异常: " << e.what() << std::endl;
+        BRIDGE_LOG_ERROR("获取表列表过程中发生异常: " << e.what());
         return nullptr;
     } catch (...) {
-        std::cerr << "获取表列表过程中发生未知异常" << std::endl;
+        BRIDGE_LOG_ERROR("获取表列表过程中发生未知异常");
         return nullptr;
     }
 }
 
 JNIEXPORT const char* JNICALL getTableData(const char* tableName, const char* startRow, const char* endRow, int limit, const char* filterPrefix) {
+    bridge::trace::RequestScope traceScope("getTableData");
+    bridge::sched::InteractiveScope interactiveScope;
     try {
         // 检查参数
         if (tableName == nullptr) {
-            std::cerr << "表名不能为空" << std::endl;
+            BRIDGE_LOG_ERROR("表名不能为空");
             return nullptr;
         }
         
         // 检查JVM状态
         if (!jvmInitialized || jvm == nullptr) {
-            std::cerr << "JVM未初始化" << std::endl;
+            BRIDGE_LOG_ERROR("JVM未初始化");
             return nullptr;
         }
         
@@ -451,18 +565,18 @@ JNIEXPORT const char* JNICALL getTableData(const char* tableName, const char* st
         
         if (getEnvResult == JNI_EDETACHED) {
             if (jvm->AttachCurrentThread((void**)&env, nullptr) != JNI_OK) {
-                std::cerr << "无法附加到JVM线程" << std::endl;
+                BRIDGE_LOG_ERROR("无法附加到JVM线程");
                 return nullptr;
             }
         } else if (getEnvResult != JNI_OK) {
-            std::cerr << "无法获取JNIEnv" << std::endl;
+            BRIDGE_LOG_ERROR("无法获取JNIEnv");
             return nullptr;
         }
         
         // 获取HBaseBridge类
         jclass bridgeClass = env->FindClass("com/hbasegui/bridge/HBaseBridge");
         if (bridgeClass == nullptr) {
-            std::cerr << "无法找到HBaseBridge类" << std::endl;
+            BRIDGE_LOG_ERROR("无法找到HBaseBridge类");
             return nullptr;
         }
         
@@ -470,7 +584,7 @@ JNIEXPORT const char* JNICALL getTableData(const char* tableName, const char* st
         jmethodID getTableDataMethod = env->GetStaticMethodID(bridgeClass, "getTableData", 
             "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;ILjava/lang/String;)Ljava/lang/String;");
         if (getTableDataMethod == nullptr) {
-            std::cerr << "无法找到getTableData方法" << std::endl;
+            BRIDGE_LOG_ERROR("无法找到getTableData方法");
             env->DeleteLocalRef(bridgeClass);
             return nullptr;
         }
@@ -482,18 +596,22 @@ JNIEXPORT const char* JNICALL getTableData(const char* tableName, const char* st
         jstring filterPrefixStr = filterPrefix ? env->NewStringUTF(filterPrefix) : nullptr;
         
         if (tableNameStr == nullptr) {
-            std::cerr << "无法创建Java字符串参数" << std::endl;
+            BRIDGE_LOG_ERROR("无法创建Java字符串参数");
             env->DeleteLocalRef(bridgeClass);
             return nullptr;
         }
         
         // 调用Java方法
-        jstring result = (jstring)env->CallStaticObjectMethod(bridgeClass, getTableDataMethod,
-            tableNameStr, startRowStr, endRowStr, limit, filterPrefixStr);
+        jstring result;
+        {
+            bridge::trace::Span span("jni.call");
+            result = (jstring)env->CallStaticObjectMethod(bridgeClass, getTableDataMethod,
+                tableNameStr, startRowStr, endRowStr, limit, filterPrefixStr);
+        }
         
         // 检查是否有异常发生
         if (env->ExceptionCheck()) {
-            std::cerr << "Java方法执行过程中发生异常" << std::endl;
+            BRIDGE_LOG_ERROR("Java方法执行过程中发生异常");
             env->ExceptionDescribe();
             env->ExceptionClear();
             env->DeleteLocalRef(tableNameStr);
@@ -505,7 +623,7 @@ JNIEXPORT const char* JNICALL getTableData(const char* tableName, const char* st
         }
         
         if (result == nullptr) {
-            std::cerr << "Java方法返回空" << std::endl;
+            BRIDGE_LOG_ERROR("Java方法返回空");
             env->DeleteLocalRef(tableNameStr);
             if (startRowStr) env->DeleteLocalRef(startRowStr);
             if (endRowStr) env->DeleteLocalRef(endRowStr);
@@ -515,9 +633,10 @@ JNIEXPORT const char* JNICALL getTableData(const char* tableName, const char* st
         }
         
         // 转换Java字符串到C字符串
+        bridge::trace::Span copySpan("jni.result.copy");
         const char* cResult = env->GetStringUTFChars(result, nullptr);
         if (cResult == nullptr) {
-            std::cerr << "无法转换Java字符串到C字符串" << std::endl;
+            BRIDGE_LOG_ERROR("无法转换Java字符串到C字符串");
             env->DeleteLocalRef(result);
             env->DeleteLocalRef(tableNameStr);
             if (startRowStr) env->DeleteLocalRef(startRowStr);
@@ -539,27 +658,29 @@ JNIEXPORT const char* JNICALL getTableData(const char* tableName, const char* st
         if (filterPrefixStr) env->DeleteLocalRef(filterPrefixStr);
         env->DeleteLocalRef(bridgeClass);
         
+        bridge::qos::chargeJson("", copy, true);
         return copy;
     } catch (const std::exception& e) {
-        std::cerr << "获取表数据过程中发生异常: " << e.what() << std::endl;
+        BRIDGE_LOG_ERROR("获取表数据过程中发生异常: " << e.what());
         return nullptr;
     } catch (...) {
-        std::cerr << "获取表数据过程中发生未知异常" << std::endl;
+        BRIDGE_LOG_ERROR("获取表数据过程中发生未知异常");
         return nullptr;
     }
 }
 
 const char* executeCommand(const char* tableName, const char* command, const char* rowKey, const char* family, const char* qualifier, const char* value) {
+    bridge::trace::RequestScope traceScope("executeCommand");
     try {
         // 检查参数
         if (tableName == nullptr || command == nullptr) {
-            std::cerr << "参数不能为空" << std::endl;
+            BRIDGE_LOG_ERROR("参数不能为空");
             return nullptr;
         }
         
         // 检查JVM状态
         if (!jvmInitialized || jvm == nullptr) {
-            std::cerr << "JVM未初始化" << std::endl;
+            BRIDGE_LOG_ERROR("JVM未初始化");
             return nullptr;
         }
         
@@ -569,18 +690,18 @@ const char* executeCommand(const char* tableName, const char* command, const cha
         
         if (getEnvResult == JNI_EDETACHED) {
             if (jvm->AttachCurrentThread((void**)&env, nullptr) != JNI_OK) {
-                std::cerr << "无法附加到JVM线程" << std::endl;
+                BRIDGE_LOG_ERROR("无法附加到JVM线程");
                 return nullptr;
             }
         } else if (getEnvResult != JNI_OK) {
-            std::cerr << "无法获取JNIEnv" << std::endl;
+            BRIDGE_LOG_ERROR("无法获取JNIEnv");
             return nullptr;
         }
         
         // 获取HBaseBridge类
         jclass bridgeClass = env->FindClass("com/hbasegui/bridge/HBaseBridge");
         if (bridgeClass == nullptr) {
-            std::cerr << "无法找到HBaseBridge类" << std::endl;
+            BRIDGE_LOG_ERROR("无法找到HBaseBridge类");
             return nullptr;
         }
         
@@ -588,7 +709,7 @@ const char* executeCommand(const char* tableName, const char* command, const cha
         jmethodID executeCommandMethod = env->GetStaticMethodID(bridgeClass, "executeCommand", 
             "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;");
         if (executeCommandMethod == nullptr) {
-            std::cerr << "无法找到executeCommand方法" << std::endl;
+            BRIDGE_LOG_ERROR("无法找到executeCommand方法");
             env->DeleteLocalRef(bridgeClass);
             return nullptr;
         }
@@ -602,7 +723,7 @@ const char* executeCommand(const char* tableName, const char* command, const cha
         jstring jValue = value ? env->NewStringUTF(value) : nullptr;
         
         if (jTableName == nullptr || jCommand == nullptr) {
-            std::cerr << "无法创建Java字符串参数" << std::endl;
+            BRIDGE_LOG_ERROR("无法创建Java字符串参数");
             if (jTableName) env->DeleteLocalRef(jTableName);
             if (jCommand) env->DeleteLocalRef(jCommand);
             if (jRowKey) env->DeleteLocalRef(jRowKey);
@@ -614,12 +735,16 @@ const char* executeCommand(const char* tableName, const char* command, const cha
         }
         
         // 调用Java方法
-        jstring result = (jstring)env->CallStaticObjectMethod(bridgeClass, executeCommandMethod,
-            jTableName, jCommand, jRowKey, jFamily, jQualifier, jValue);
+        jstring result;
+        {
+            bridge::trace::Span span("jni.call");
+            result = (jstring)env->CallStaticObjectMethod(bridgeClass, executeCommandMethod,
+                jTableName, jCommand, jRowKey, jFamily, jQualifier, jValue);
+        }
         
         // 检查是否有异常发生
         if (env->ExceptionCheck()) {
-            std::cerr << "Java方法执行过程中发生异常" << std::endl;
+            BRIDGE_LOG_ERROR("Java方法执行过程中发生异常");
             env->ExceptionDescribe();
             env->ExceptionClear();
             env->DeleteLocalRef(jTableName);
@@ -633,7 +758,7 @@ const char* executeCommand(const char* tableName, const char* command, const cha
         }
         
         if (result == nullptr) {
-            std::cerr << "Java方法返回空" << std::endl;
+            BRIDGE_LOG_ERROR("Java方法返回空");
             env->DeleteLocalRef(jTableName);
             env->DeleteLocalRef(jCommand);
             if (jRowKey) env->DeleteLocalRef(jRowKey);
@@ -645,9 +770,10 @@ const char* executeCommand(const char* tableName, const char* command, const cha
         }
         
         // 转换Java字符串到C字符串
+        bridge::trace::Span copySpan("jni.result.copy");
         const char* cResult = env->GetStringUTFChars(result, nullptr);
         if (cResult == nullptr) {
-            std::cerr << "无法转换Java字符串到C字符串" << std::endl;
+            BRIDGE_LOG_ERROR("无法转换Java字符串到C字符串");
             env->DeleteLocalRef(result);
             env->DeleteLocalRef(jTableName);
             env->DeleteLocalRef(jCommand);
@@ -673,12 +799,13 @@ const char* executeCommand(const char* tableName, const char* command, const cha
         if (jValue) env->DeleteLocalRef(jValue);
         env->DeleteLocalRef(bridgeClass);
         
+        bridge::qos::chargeJson("", copy, false);
         return copy;
     } catch (const std::exception& e) {
-        std::cerr << "执行命令过程中发生异常: " << e.what() << std::endl;
+        BRIDGE_LOG_ERROR("执行命令过程中发生异常: " << e.what());
         return nullptr;
     } catch (...) {
-        std::cerr << "执行命令过程中发生未知异常" << std::endl;
+        BRIDGE_LOG_ERROR("执行命令过程中发生未知异常");
         return nullptr;
     }
 }
@@ -686,7 +813,7 @@ const char* executeCommand(const char* tableName, const char* command, const cha
 // 初始化JNI环境
 bool initJNI() {
     if (g_jvm == nullptr) {
-        std::cout << "【C++桥接】初始化JNI环境..." << std::endl;
+        BRIDGE_LOG_DEBUG("【C++桥接】初始化JNI环境...");
         
         JavaVMOption options[1];
         options[0].optionString = const_cast<char*>("-Djava.class.path=../java-bridge/build/libs/java-bridge.jar");
@@ -699,18 +826,18 @@ bool initJNI() {
         
         jint result = JNI_CreateJavaVM(&g_jvm, (void**)&g_env, &vm_args);
         if (result != JNI_OK) {
-            std::cerr << "【C++桥接】创建Java虚拟机失败" << std::endl;
+            BRIDGE_LOG_ERROR("【C++桥接】创建Java虚拟机失败");
             return false;
         }
         
         // 加载HBaseBridge类
         g_hbaseBridgeClass = g_env->FindClass("com/hbasegui/bridge/HBaseBridge");
         if (g_hbaseBridgeClass == nullptr) {
-            std::cerr << "【C++桥接】找不到HBaseBridge类" << std::endl;
+            BRIDGE_LOG_ERROR("【C++桥接】找不到HBaseBridge类");
             return false;
         }
         
-        std::cout << "【C++桥接】JNI环境初始化成功" << std::endl;
+        BRIDGE_LOG_DEBUG("【C++桥接】JNI环境初始化成功");
         return true;
     }
     return true;
@@ -718,6 +845,7 @@ bool initJNI() {
 
 // 断开连接
 JNIEXPORT void JNICALL disconnect() {
+    bridge::trace::RequestScope traceScope("disconnect");
     try {
         if (jvm != nullptr) {
             JNIEnv* env;
@@ -741,8 +869,903 @@ JNIEXPORT void JNICALL disconnect() {
             }
         }
     } catch (...) {
-        std::cerr << "断开连接时发生异常" << std::endl;
+        BRIDGE_LOG_ERROR("断开连接时发生异常");
+    }
+}
+
+// 获取表的Region分布（JSON数组，每项包含start/end/server）
+JNIEXPORT const char* JNICALL getTableRegions(const char* tableName) {
+    bridge::trace::RequestScope traceScope("getTableRegions");
+    bridge::sched::InteractiveScope interactiveScope;
+    if (tableName == nullptr) {
+        BRIDGE_LOG_ERROR("表名不能为空");
+        return nullptr;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return nullptr;
+    }
+    JNIEnv* env = bridge::currentEnv();
+    if (env == nullptr) {
+        BRIDGE_LOG_ERROR("无法获取JNIEnv");
+        return nullptr;
+    }
+    bridge::JavaString tableNameStr(env, tableName);
+    return bridge::callStaticString("HBaseBridge", "getRegions", "(Ljava/lang/String;)Ljava/lang/String;",
+        tableNameStr.get());
+}
+
+// 按规格生成压测数据（规格格式见table_generator.h），返回JSON统计结果
+JNIEXPORT const char* JNICALL generateTable(const char* tableName, const char* spec) {
+    bridge::trace::RequestScope traceScope("generateTable");
+    if (tableName == nullptr || tableName[0] == '\0') {
+        return strdup(bridge::json::error("表名不能为空").c_str());
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        return strdup(bridge::json::error("JVM未初始化").c_str());
+    }
+
+    bridge::gen::Spec parsedSpec;
+    std::string error;
+    if (!bridge::gen::parseSpec(spec != nullptr ? spec : "", parsedSpec, error)) {
+        return strdup(bridge::json::error(error).c_str());
+    }
+
+    bridge::gen::Stats stats;
+    bool ok = bridge::gen::generate(tableName, parsedSpec, stats, error);
+    std::string result = ok ? "{\"status\":\"success\","
+        : "{\"status\":\"error\",\"message\":" + bridge::json::quote(error) + ",";
+    result += bridge::gen::statsJson(stats).substr(1);
+    return strdup(result.c_str());
+}
+
+// 启动后台生成任务，返回任务ID，参数无效时返回-1
+JNIEXPORT int64_t JNICALL startGenerate(const char* tableName, const char* spec) {
+    bridge::trace::RequestScope traceScope("startGenerate");
+    if (tableName == nullptr || tableName[0] == '\0') {
+        BRIDGE_LOG_ERROR("表名不能为空");
+        return -1;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+
+    bridge::gen::Spec parsedSpec;
+    std::string error;
+    if (!bridge::gen::parseSpec(spec != nullptr ? spec : "", parsedSpec, error)) {
+        BRIDGE_LOG_ERROR("生成规格无效: " << error);
+        return -1;
+    }
+
+    std::string table = tableName;
+    return bridge::jobs::start("generate", [table, parsedSpec](bridge::jobs::Job& job, std::string& error) {
+        return bridge::gen::runGenerate(table, parsedSpec, job, error);
+    });
+}
+
+// 启动后台导出任务，返回任务ID，参数无效时返回-1
+JNIEXPORT int64_t JNICALL startExport(const char* tableName, const char* startRow, const char* endRow,
+                                      const char* filterPrefix, const char* path, const char* format) {
+    bridge::trace::RequestScope traceScope("startExport");
+    if (tableName == nullptr || path == nullptr || path[0] == '\0') {
+        BRIDGE_LOG_ERROR("导出参数不能为空");
+        return -1;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+
+    bridge::ExportOptions options;
+    if (!bridge::parseExportFormat(format != nullptr ? format : "ndjson", options.format)) {
+        BRIDGE_LOG_ERROR("不支持的导出格式: " << format);
+        return -1;
+    }
+    options.range.tableName = tableName;
+    options.range.startRow = startRow != nullptr ? startRow : "";
+    options.range.stopRow = endRow != nullptr ? endRow : "";
+    options.range.prefix = filterPrefix != nullptr ? filterPrefix : "";
+    options.path = path;
+
+    return bridge::jobs::start("export", [options](bridge::jobs::Job& job, std::string& error) {
+        return bridge::runExport(options, job, error);
+    });
+}
+
+// 启动后台批量导入，返回任务ID（失败返回-1）
+JNIEXPORT int64_t JNICALL startImport(const char* tableName, const char* path, const char* options) {
+    bridge::trace::RequestScope traceScope("startImport");
+    if (tableName == nullptr || path == nullptr || path[0] == '\0') {
+        BRIDGE_LOG_ERROR("导入参数不能为空");
+        return -1;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+
+    bridge::ImportOptions importOptions;
+    importOptions.tableName = tableName;
+    importOptions.path = path;
+    std::string error;
+    if (!bridge::parseImportOptions(options != nullptr ? options : "", importOptions, error)) {
+        BRIDGE_LOG_ERROR("导入选项无效: " << error);
+        return -1;
+    }
+
+    return bridge::jobs::start("import", [importOptions](bridge::jobs::Job& job, std::string& error) {
+        return bridge::runImport(importOptions, job, error);
+    });
+}
+
+// 启动后台快照任务，返回任务ID（失败返回-1）
+JNIEXPORT int64_t JNICALL startSnapshot(const char* tableName, const char* startRow, const char* endRow,
+                                        const char* filterPrefix, const char* path) {
+    bridge::trace::RequestScope traceScope("startSnapshot");
+    if (tableName == nullptr || path == nullptr || path[0] == '\0') {
+        BRIDGE_LOG_ERROR("快照参数不能为空");
+        return -1;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+
+    bridge::ScanRange range;
+    range.tableName = tableName;
+    range.startRow = startRow != nullptr ? startRow : "";
+    range.stopRow = endRow != nullptr ? endRow : "";
+    range.prefix = filterPrefix != nullptr ? filterPrefix : "";
+    std::string snapshotPath = path;
+
+    return bridge::jobs::start("snapshot", [range, snapshotPath](bridge::jobs::Job& job, std::string& error) {
+        return bridge::snapshot::appendRange(snapshotPath, range, job, error);
+    });
+}
+
+// 从本地快照读取表数据（不访问集群）
+JNIEXPORT const char* JNICALL getSnapshotData(const char* path, const char* startRow, const char* endRow, int limit,
+                                              const char* filterPrefix) {
+    bridge::trace::RequestScope traceScope("getSnapshotData");
+    if (path == nullptr) {
+        return strdup(bridge::json::error("快照路径不能为空").c_str());
+    }
+    std::string json;
+    std::string error;
+    if (!bridge::snapshot::readRows(path, startRow != nullptr ? startRow : "", endRow != nullptr ? endRow : "",
+            filterPrefix != nullptr ? filterPrefix : "", limit, json, error)) {
+        BRIDGE_LOG_DEBUG("无法从快照读取: " << error);
+        return strdup(bridge::json::error(error).c_str());
+    }
+    return strdup(json.c_str());
+}
+
+// 快照新鲜度检查，已连接集群时同时检查扫描之后的写入
+JNIEXPORT const char* JNICALL checkSnapshot(const char* path, int maxAgeSeconds) {
+    bridge::trace::RequestScope traceScope("checkSnapshot");
+    if (path == nullptr) {
+        return strdup(bridge::json::error("快照路径不能为空").c_str());
+    }
+    return strdup(bridge::snapshot::checkFreshness(path, maxAgeSeconds, jvmInitialized && jvm != nullptr).c_str());
+}
+
+// 打开列式结果集，返回结果集ID（失败返回-1）
+JNIEXPORT int64_t JNICALL openResultSet(const char* tableName, const char* startRow, const char* endRow,
+                                        const char* filterPrefix, int64_t maxRows) {
+    bridge::trace::RequestScope traceScope("openResultSet");
+    if (tableName == nullptr) {
+        BRIDGE_LOG_ERROR("表名不能为空");
+        return -1;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+
+    bridge::ScanRange range;
+    range.tableName = tableName;
+    range.startRow = startRow != nullptr ? startRow : "";
+    range.stopRow = endRow != nullptr ? endRow : "";
+    range.prefix = filterPrefix != nullptr ? filterPrefix : "";
+    uint64_t rowLimit = maxRows > 0 ? (uint64_t)maxRows : 0;
+    std::shared_ptr<bridge::results::ResultStore> store = std::make_shared<bridge::results::ResultStore>();
+
+    int64_t id = bridge::jobs::start("results", [range, rowLimit, store](bridge::jobs::Job& job, std::string& error) {
+        return bridge::results::fill(*store, range, rowLimit, job, error);
+    });
+    if (id < 0) {
+        return -1;
+    }
+    bridge::results::put(id, store);
+    return id;
+}
+
+// 增量刷新结果集，返回刷新任务ID（失败返回-1）
+JNIEXPORT int64_t JNICALL refreshResultSet(int64_t resultId) {
+    bridge::trace::RequestScope traceScope("refreshResultSet");
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+    std::shared_ptr<bridge::results::ResultStore> store = bridge::results::find(resultId);
+    if (!store) {
+        BRIDGE_LOG_ERROR("结果集不存在: " << resultId);
+        return -1;
+    }
+    return bridge::jobs::start("results", [store](bridge::jobs::Job& job, std::string& error) {
+        return bridge::results::refresh(*store, job, error);
+    });
+}
+
+// 结果集概况（JSON）
+JNIEXPORT const char* JNICALL getResultInfo(int64_t resultId) {
+    std::shared_ptr<bridge::results::ResultStore> store = bridge::results::find(resultId);
+    if (!store) {
+        return strdup(bridge::json::error("结果集不存在: " + std::to_string((long long)resultId)).c_str());
+    }
+    return strdup(store->infoJson().c_str());
+}
+
+// 按视口读取结果集（JSON）
+JNIEXPORT const char* JNICALL getResultRows(int64_t resultId, int64_t firstRow, int rowCount, int firstColumn,
+                                            int columnCount) {
+    bridge::trace::RequestScope traceScope("getResultRows");
+    std::shared_ptr<bridge::results::ResultStore> store = bridge::results::find(resultId);
+    if (!store) {
+        return strdup(bridge::json::error("结果集不存在: " + std::to_string((long long)resultId)).c_str());
+    }
+    if (firstRow < 0 || rowCount < 0 || firstColumn < 0 || columnCount < 0) {
+        return strdup(bridge::json::error("视口参数不能为负数").c_str());
+    }
+    return strdup(store->rowsJson((uint64_t)firstRow, (uint32_t)rowCount, (uint32_t)firstColumn,
+        (uint32_t)columnCount).c_str());
+}
+
+// 启动后台聚合任务，结果在任务进度JSON的"result"中，返回任务ID（失败返回-1）
+JNIEXPORT int64_t JNICALL startAggregate(const char* tableName, const char* startRow, const char* endRow,
+                                         const char* filterPrefix, const char* column, const char* options) {
+    bridge::trace::RequestScope traceScope("startAggregate");
+    if (tableName == nullptr || column == nullptr || column[0] == '\0') {
+        BRIDGE_LOG_ERROR("聚合参数不能为空");
+        return -1;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+
+    bridge::AggregateOptions aggregateOptions;
+    aggregateOptions.range.tableName = tableName;
+    aggregateOptions.range.startRow = startRow != nullptr ? startRow : "";
+    aggregateOptions.range.stopRow = endRow != nullptr ? endRow : "";
+    aggregateOptions.range.prefix = filterPrefix != nullptr ? filterPrefix : "";
+    aggregateOptions.column = column;
+    std::string error;
+    if (!bridge::parseAggregateOptions(options != nullptr ? options : "", aggregateOptions, error)) {
+        BRIDGE_LOG_ERROR("聚合选项无效: " << error);
+        return -1;
+    }
+
+    return bridge::jobs::start("aggregate", [aggregateOptions](bridge::jobs::Job& job, std::string& error) {
+        return bridge::runAggregate(aggregateOptions, job, error);
+    });
+}
+
+// 以名称连接另一个集群（如容灾集群），对比等操作通过集群名访问它；同名的旧连接会被替换
+JNIEXPORT bool JNICALL connectPeer(const char* name, const char* zkQuorum, const char* zkNode) {
+    bridge::trace::RequestScope traceScope("connectPeer");
+    if (name == nullptr || name[0] == '\0' || zkQuorum == nullptr || zkNode == nullptr) {
+        BRIDGE_LOG_ERROR("集群连接参数不能为空");
+        return false;
+    }
+    if ((!jvmInitialized || jvm == nullptr) && !initJVM()) {
+        BRIDGE_LOG_ERROR("JVM初始化失败");
+        return false;
+    }
+    JNIEnv* env = bridge::currentEnv();
+    jclass hbaseBridge = env != nullptr ? bridge::bridgeClass(env, "HBaseBridge") : nullptr;
+    if (hbaseBridge == nullptr) {
+        BRIDGE_LOG_ERROR("无法找到HBaseBridge类");
+        return false;
+    }
+    jmethodID method = env->GetStaticMethodID(hbaseBridge, "connectPeer",
+        "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)Z");
+    if (method == nullptr) {
+        bridge::clearPendingException(env, "HBaseBridge.connectPeer");
+        BRIDGE_LOG_ERROR("无法找到connectPeer方法");
+        return false;
+    }
+    bridge::JavaString nameStr(env, name);
+    bridge::JavaString zkQuorumStr(env, zkQuorum);
+    bridge::JavaString zkNodeStr(env, zkNode);
+    jboolean result = env->CallStaticBooleanMethod(hbaseBridge, method, nameStr.get(), zkQuorumStr.get(),
+        zkNodeStr.get());
+    if (bridge::clearPendingException(env, "HBaseBridge.connectPeer")) {
+        return false;
+    }
+    return result == JNI_TRUE;
+}
+
+// 断开connectPeer建立的集群连接
+JNIEXPORT void JNICALL disconnectPeer(const char* name) {
+    bridge::trace::RequestScope traceScope("disconnectPeer");
+    if (name == nullptr || !jvmInitialized || jvm == nullptr) {
+        return;
+    }
+    JNIEnv* env = bridge::currentEnv();
+    jclass hbaseBridge = env != nullptr ? bridge::bridgeClass(env, "HBaseBridge") : nullptr;
+    if (hbaseBridge == nullptr) {
+        return;
+    }
+    jmethodID method = env->GetStaticMethodID(hbaseBridge, "disconnectPeer", "(Ljava/lang/String;)V");
+    if (method == nullptr) {
+        bridge::clearPendingException(env, "HBaseBridge.disconnectPeer");
+        return;
+    }
+    bridge::JavaString nameStr(env, name);
+    env->CallStaticVoidMethod(hbaseBridge, method, nameStr.get());
+    bridge::clearPendingException(env, "HBaseBridge.disconnectPeer");
+}
+
+// 启动后台表对比，差异写入options中的path，统计在任务进度JSON的"result"中，返回任务ID（失败返回-1）
+JNIEXPORT int64_t JNICALL startDiff(const char* sourceTable, const char* targetTable, const char* startRow,
+                                    const char* endRow, const char* filterPrefix, const char* options) {
+    bridge::trace::RequestScope traceScope("startDiff");
+    if (sourceTable == nullptr || sourceTable[0] == '\0') {
+        BRIDGE_LOG_ERROR("对比的表名不能为空");
+        return -1;
     }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+
+    bridge::DiffOptions diffOptions;
+    diffOptions.source.tableName = sourceTable;
+    diffOptions.source.startRow = startRow != nullptr ? startRow : "";
+    diffOptions.source.stopRow = endRow != nullptr ? endRow : "";
+    diffOptions.source.prefix = filterPrefix != nullptr ? filterPrefix : "";
+    diffOptions.target = diffOptions.source;
+    if (targetTable != nullptr && targetTable[0] != '\0') {
+        diffOptions.target.tableName = targetTable;
+    }
+    std::string error;
+    if (!bridge::parseDiffOptions(options != nullptr ? options : "", diffOptions, error)) {
+        BRIDGE_LOG_ERROR("对比选项无效: " << error);
+        return -1;
+    }
+
+    return bridge::jobs::start("diff", [diffOptions](bridge::jobs::Job& job, std::string& error) {
+        return bridge::runDiff(diffOptions, job, error);
+    });
+}
+
+// 启动后台校验树计算，概要在任务进度JSON的"result"中，完整的树写入options中的path，返回任务ID（失败返回-1）
+JNIEXPORT int64_t JNICALL startChecksum(const char* tableName, const char* startRow, const char* endRow,
+                                        const char* filterPrefix, const char* options) {
+    bridge::trace::RequestScope traceScope("startChecksum");
+    if (tableName == nullptr || tableName[0] == '\0') {
+        BRIDGE_LOG_ERROR("校验的表名不能为空");
+        return -1;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+
+    bridge::ChecksumOptions checksumOptions;
+    checksumOptions.range.tableName = tableName;
+    checksumOptions.range.startRow = startRow != nullptr ? startRow : "";
+    checksumOptions.range.stopRow = endRow != nullptr ? endRow : "";
+    checksumOptions.range.prefix = filterPrefix != nullptr ? filterPrefix : "";
+    std::string error;
+    if (!bridge::parseChecksumOptions(options != nullptr ? options : "", checksumOptions, error)) {
+        BRIDGE_LOG_ERROR("校验选项无效: " << error);
+        return -1;
+    }
+
+    return bridge::jobs::start("checksum", [checksumOptions](bridge::jobs::Job& job, std::string& error) {
+        return bridge::runChecksum(checksumOptions, job, error);
+    });
+}
+
+// 对比两个校验树文件，返回JSON
+JNIEXPORT const char* JNICALL compareChecksums(const char* pathA, const char* pathB, int maxRanges) {
+    bridge::trace::RequestScope traceScope("compareChecksums");
+    if (pathA == nullptr || pathB == nullptr) {
+        return strdup(bridge::json::error("校验树文件路径不能为空").c_str());
+    }
+    std::string json;
+    std::string error;
+    if (!bridge::compareChecksumFiles(pathA, pathB, maxRanges > 0 ? (uint32_t)maxRanges : 1000, json, error)) {
+        return strdup(bridge::json::error(error).c_str());
+    }
+    return strdup(json.c_str());
+}
+
+// 启动后台表复制（可跨集群），返回任务ID（失败返回-1）
+JNIEXPORT int64_t JNICALL startCopy(const char* sourceTable, const char* targetTable, const char* startRow,
+                                    const char* endRow, const char* filterPrefix, const char* options) {
+    bridge::trace::RequestScope traceScope("startCopy");
+    if (sourceTable == nullptr || sourceTable[0] == '\0') {
+        BRIDGE_LOG_ERROR("复制的表名不能为空");
+        return -1;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+
+    bridge::CopyOptions copyOptions;
+    copyOptions.source.tableName = sourceTable;
+    copyOptions.source.startRow = startRow != nullptr ? startRow : "";
+    copyOptions.source.stopRow = endRow != nullptr ? endRow : "";
+    copyOptions.source.prefix = filterPrefix != nullptr ? filterPrefix : "";
+    copyOptions.targetTable = targetTable != nullptr && targetTable[0] != '\0' ? targetTable : sourceTable;
+    std::string error;
+    if (!bridge::parseCopyOptions(options != nullptr ? options : "", copyOptions, error)) {
+        BRIDGE_LOG_ERROR("复制选项无效: " << error);
+        return -1;
+    }
+
+    return bridge::jobs::start("copy", [copyOptions](bridge::jobs::Job& job, std::string& error) {
+        return bridge::runCopy(copyOptions, job, error);
+    });
+}
+
+// 开始监视表的新写入，返回监视ID（失败返回-1）
+JNIEXPORT int64_t JNICALL startWatch(const char* tableName, const char* startRow, const char* endRow,
+                                     const char* filterPrefix, const char* options) {
+    bridge::trace::RequestScope traceScope("startWatch");
+    if (tableName == nullptr || tableName[0] == '\0') {
+        BRIDGE_LOG_ERROR("监视的表名不能为空");
+        return -1;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return -1;
+    }
+
+    bridge::watch::WatchOptions watchOptions;
+    watchOptions.range.tableName = tableName;
+    watchOptions.range.startRow = startRow != nullptr ? startRow : "";
+    watchOptions.range.stopRow = endRow != nullptr ? endRow : "";
+    watchOptions.range.prefix = filterPrefix != nullptr ? filterPrefix : "";
+    std::string error;
+    if (!bridge::watch::parseWatchOptions(options != nullptr ? options : "", watchOptions, error)) {
+        BRIDGE_LOG_ERROR("监视选项无效: " << error);
+        return -1;
+    }
+    return bridge::watch::start(watchOptions);
+}
+
+// 读取监视到的新写入，返回JSON
+JNIEXPORT const char* JNICALL pollWatch(int64_t watchId, int64_t afterSeq, int maxEvents, int waitMs) {
+    std::string json;
+    std::string error;
+    if (!bridge::watch::poll(watchId, afterSeq > 0 ? (uint64_t)afterSeq : 0,
+                             maxEvents > 0 ? (uint32_t)maxEvents : 1000, waitMs, json, error)) {
+        return strdup(bridge::json::error(error).c_str());
+    }
+    return strdup(json.c_str());
+}
+
+// 停止监视
+JNIEXPORT bool JNICALL stopWatch(int64_t watchId) {
+    return bridge::watch::stop(watchId);
+}
+
+// 设置限速（替换全部已有限速），返回JSON
+JNIEXPORT const char* JNICALL setRateLimits(const char* spec) {
+    bridge::trace::RequestScope traceScope("setRateLimits");
+    std::string error;
+    if (!bridge::qos::setLimits(spec != nullptr ? spec : "", error)) {
+        BRIDGE_LOG_ERROR("限速设置无效: " << error);
+        return strdup(bridge::json::error(error).c_str());
+    }
+    return strdup("{\"status\":\"success\"}");
+}
+
+// 各操作类别与连接的流量统计，返回JSON
+JNIEXPORT const char* JNICALL getRateStats() {
+    bridge::trace::RequestScope traceScope("getRateStats");
+    return strdup(bridge::qos::statsJson().c_str());
+}
+
+// 配置优先级调度（并发上限、让出时间、任务kind的优先级），返回JSON
+JNIEXPORT const char* JNICALL setSchedulerConfig(const char* spec) {
+    bridge::trace::RequestScope traceScope("setSchedulerConfig");
+    std::string error;
+    if (!bridge::sched::configure(spec != nullptr ? spec : "", error)) {
+        BRIDGE_LOG_ERROR("调度配置无效: " << error);
+        return strdup(bridge::json::error(error).c_str());
+    }
+    return strdup("{\"status\":\"success\"}");
+}
+
+// 各优先级的并发、排队与让出统计，返回JSON
+JNIEXPORT const char* JNICALL getSchedulerStats() {
+    bridge::trace::RequestScope traceScope("getSchedulerStats");
+    return strdup(bridge::sched::statsJson().c_str());
+}
+
+// 创建可取消的操作，返回操作ID
+JNIEXPORT int64_t JNICALL createOperation(int64_t timeoutMs) {
+    return bridge::cancel::create(timeoutMs)->id();
+}
+
+// 取消操作
+JNIEXPORT bool JNICALL cancelOperation(int64_t operationId) {
+    std::shared_ptr<bridge::cancel::Token> token = bridge::cancel::find(operationId);
+    if (!token) {
+        return false;
+    }
+    token->cancel();
+    return true;
+}
+
+// 释放操作
+JNIEXPORT void JNICALL releaseOperation(int64_t operationId) {
+    bridge::cancel::release(operationId);
+}
+
+// 同步操作的失败结果，code见cancel_token.h
+static std::string operationStatusJson(bridge::cancel::Status status, const std::string& message) {
+    return "{\"code\":" + std::to_string((int)status) + ",\"status\":\"" + bridge::cancel::statusName(status)
+        + "\",\"error\":" + bridge::json::quote(message) + "}";
+}
+
+// 可取消的表数据查询，返回带code的JSON
+JNIEXPORT const char* JNICALL queryTableData(const char* tableName, const char* startRow, const char* endRow,
+                                            int limit, const char* filterPrefix, int64_t operationId) {
+    bridge::trace::RequestScope traceScope("queryTableData");
+    if (tableName == nullptr || tableName[0] == '\0') {
+        return strdup(operationStatusJson(bridge::cancel::STATUS_ERROR, "表名不能为空").c_str());
+    }
+    std::shared_ptr<bridge::cancel::Token> token;
+    if (operationId > 0) {
+        token = bridge::cancel::find(operationId);
+        if (!token) {
+            return strdup(operationStatusJson(bridge::cancel::STATUS_ERROR,
+                "操作不存在: " + std::to_string((long long)operationId)).c_str());
+        }
+        if (token->isAborted()) {
+            return strdup(operationStatusJson(token->status(), bridge::cancel::statusMessage(token->status())).c_str());
+        }
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        return strdup(operationStatusJson(bridge::cancel::STATUS_ERROR, "JVM未初始化").c_str());
+    }
+    JNIEnv* env = bridge::currentEnv();
+    if (env == nullptr) {
+        return strdup(operationStatusJson(bridge::cancel::STATUS_ERROR, "无法获取JNIEnv").c_str());
+    }
+    bridge::sched::InteractiveScope interactiveScope;
+    bridge::cancel::TokenScope tokenScope(token.get());
+    bridge::JavaString tableNameStr(env, tableName);
+    bridge::JavaString startRowStr(env, startRow);
+    bridge::JavaString endRowStr(env, endRow);
+    bridge::JavaString filterPrefixStr(env, filterPrefix);
+    // Java层返回完整的JSON（含code），取消与超时由Java层关闭扫描器后报告
+    char* result = bridge::callStaticString("HBaseBridge", "queryTableData",
+        "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;ILjava/lang/String;J)Ljava/lang/String;",
+        tableNameStr.get(), startRowStr.get(), endRowStr.get(), (jint)limit, filterPrefixStr.get(),
+        (jlong)(token ? token->id() : 0));
+    if (result == nullptr) {
+        if (token && token->isAborted()) {
+            return strdup(operationStatusJson(token->status(), bridge::cancel::statusMessage(token->status())).c_str());
+        }
+        return strdup(operationStatusJson(bridge::cancel::STATUS_ERROR, "查询表数据失败，表名: "
+            + std::string(tableName)).c_str());
+    }
+    bridge::qos::chargeJson("", result, true);
+    return result;
+}
+
+// 读取一行（经过对冲与重试），返回JSON
+JNIEXPORT const char* JNICALL getRow(const char* tableName, const char* rowKey, const char* family,
+                                    const char* qualifier) {
+    bridge::trace::RequestScope traceScope("getRow");
+    if (tableName == nullptr || rowKey == nullptr) {
+        BRIDGE_LOG_ERROR("表名与行键不能为空");
+        return nullptr;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return nullptr;
+    }
+    JNIEnv* env = bridge::currentEnv();
+    if (env == nullptr) {
+        BRIDGE_LOG_ERROR("无法获取JNIEnv");
+        return nullptr;
+    }
+    bridge::sched::InteractiveScope interactiveScope;
+    bridge::JavaString tableNameStr(env, tableName);
+    bridge::JavaString rowKeyStr(env, rowKey);
+    bridge::JavaString familyStr(env, family);
+    bridge::JavaString qualifierStr(env, qualifier);
+    char* result = bridge::callStaticString("HBaseBridge", "getRow",
+        "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;",
+        tableNameStr.get(), rowKeyStr.get(), familyStr.get(), qualifierStr.get());
+    bridge::qos::chargeJson("", result, false);
+    return result;
+}
+
+// 按列分页读取一行（宽行），返回JSON
+JNIEXPORT const char* JNICALL getRowColumns(const char* tableName, const char* rowKey, const char* family,
+                                           const char* cursor, int limit) {
+    bridge::trace::RequestScope traceScope("getRowColumns");
+    if (tableName == nullptr || rowKey == nullptr) {
+        BRIDGE_LOG_ERROR("表名与行键不能为空");
+        return nullptr;
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return nullptr;
+    }
+    JNIEnv* env = bridge::currentEnv();
+    if (env == nullptr) {
+        BRIDGE_LOG_ERROR("无法获取JNIEnv");
+        return nullptr;
+    }
+    bridge::sched::InteractiveScope interactiveScope;
+    bridge::JavaString tableNameStr(env, tableName);
+    bridge::JavaString rowKeyStr(env, rowKey);
+    bridge::JavaString familyStr(env, family);
+    bridge::JavaString cursorStr(env, cursor);
+    char* result = bridge::callStaticString("HBaseBridge", "getRowColumns",
+        "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;I)Ljava/lang/String;",
+        tableNameStr.get(), rowKeyStr.get(), familyStr.get(), cursorStr.get(), (jint)limit);
+    bridge::qos::chargeJson("", result, false);
+    return result;
+}
+
+// 带版本与时间范围读取表数据，每个单元格带时间戳，返回JSON数组
+JNIEXPORT const char* JNICALL getTableVersions(const char* tableName, const char* startRow, const char* endRow,
+                                              int limit, const char* filterPrefix, const char* options) {
+    bridge::trace::RequestScope traceScope("getTableVersions");
+    if (tableName == nullptr) {
+        BRIDGE_LOG_ERROR("表名不能为空");
+        return strdup(bridge::json::error("表名不能为空").c_str());
+    }
+    bridge::ScanRange range;
+    std::string error;
+    if (!bridge::parseVersionOptions(options != nullptr ? options : "", range, error)) {
+        BRIDGE_LOG_ERROR(error);
+        return strdup(bridge::json::error(error).c_str());
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return strdup(bridge::json::error("JVM未初始化").c_str());
+    }
+    JNIEnv* env = bridge::currentEnv();
+    if (env == nullptr) {
+        BRIDGE_LOG_ERROR("无法获取JNIEnv");
+        return strdup(bridge::json::error("无法获取JNIEnv").c_str());
+    }
+    bridge::sched::InteractiveScope interactiveScope;
+    bridge::JavaString tableNameStr(env, tableName);
+    bridge::JavaString startRowStr(env, startRow);
+    bridge::JavaString endRowStr(env, endRow);
+    bridge::JavaString filterPrefixStr(env, filterPrefix);
+    char* result = bridge::callStaticString("HBaseBridge", "getTableVersions",
+        "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;ILjava/lang/String;IJJ)Ljava/lang/String;",
+        tableNameStr.get(), startRowStr.get(), endRowStr.get(), (jint)limit, filterPrefixStr.get(),
+        (jint)range.maxVersions, (jlong)range.minTime, (jlong)range.maxTime);
+    bridge::qos::chargeJson("", result, true);
+    return result;
+}
+
+// 带版本与时间范围读取一行，返回JSON
+JNIEXPORT const char* JNICALL getRowVersions(const char* tableName, const char* rowKey, const char* family,
+                                            const char* qualifier, const char* options) {
+    bridge::trace::RequestScope traceScope("getRowVersions");
+    if (tableName == nullptr || rowKey == nullptr) {
+        BRIDGE_LOG_ERROR("表名与行键不能为空");
+        return strdup(bridge::json::error("表名与行键不能为空").c_str());
+    }
+    bridge::ScanRange range;
+    std::string error;
+    if (!bridge::parseVersionOptions(options != nullptr ? options : "", range, error)) {
+        BRIDGE_LOG_ERROR(error);
+        return strdup(bridge::json::error(error).c_str());
+    }
+    if (!jvmInitialized || jvm == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化");
+        return strdup(bridge::json::error("JVM未初始化").c_str());
+    }
+    JNIEnv* env = bridge::currentEnv();
+    if (env == nullptr) {
+        BRIDGE_LOG_ERROR("无法获取JNIEnv");
+        return strdup(bridge::json::error("无法获取JNIEnv").c_str());
+    }
+    bridge::sched::InteractiveScope interactiveScope;
+    bridge::JavaString tableNameStr(env, tableName);
+    bridge::JavaString rowKeyStr(env, rowKey);
+    bridge::JavaString familyStr(env, family);
+    bridge::JavaString qualifierStr(env, qualifier);
+    char* result = bridge::callStaticString("HBaseBridge", "getRowVersions",
+        "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;IJJ)Ljava/lang/String;",
+        tableNameStr.get(), rowKeyStr.get(), familyStr.get(), qualifierStr.get(),
+        (jint)range.maxVersions, (jlong)range.minTime, (jlong)range.maxTime);
+    bridge::qos::chargeJson("", result, false);
+    return result;
+}
+
+// 设置单行读取的对冲与重试，返回JSON
+JNIEXPORT const char* JNICALL setPointReadOptions(const char* options) {
+    bridge::trace::RequestScope traceScope("setPointReadOptions");
+    std::string error;
+    if (!bridge::setPointReadOptions(options != nullptr ? options : "", error)) {
+        BRIDGE_LOG_ERROR("单行读取选项无效: " << error);
+        return strdup(bridge::json::error(error).c_str());
+    }
+    return strdup("{\"status\":\"success\"}");
+}
+
+// 单行读取的统计：请求数、主副本/副本胜出次数、对冲与重试次数、延迟百分位，返回JSON
+JNIEXPORT const char* JNICALL getPointReadStats() {
+    bridge::trace::RequestScope traceScope("getPointReadStats");
+    if (!jvmInitialized || jvm == nullptr) {
+        return strdup(bridge::json::error("JVM未初始化").c_str());
+    }
+    return bridge::callStaticString("HBaseBridge", "getPointReadStats", "()Ljava/lang/String;");
+}
+
+// 设置扫描数据的内存预算（全局、单个操作、溢出与Java层单次查询上限），返回JSON
+JNIEXPORT const char* JNICALL setMemoryBudget(const char* spec) {
+    bridge::trace::RequestScope traceScope("setMemoryBudget");
+    std::string error;
+    if (!bridge::mem::setBudget(spec != nullptr ? spec : "", error)) {
+        BRIDGE_LOG_ERROR("内存预算无效: " << error);
+        return strdup(bridge::json::error(error).c_str());
+    }
+    return strdup("{\"status\":\"success\"}");
+}
+
+// 桥接层的内存预算使用情况与JVM堆的使用情况，返回JSON
+JNIEXPORT const char* JNICALL getMemoryStats() {
+    bridge::trace::RequestScope traceScope("getMemoryStats");
+    std::string json = "{\"native\":" + bridge::mem::statsJson() + ",\"jvm\":";
+    char* jvmStats = nullptr;
+    if (jvmInitialized && jvm != nullptr) {
+        jvmStats = bridge::callStaticString("HBaseBridge", "getJvmMemoryStats", "()Ljava/lang/String;");
+    }
+    json += jvmStats != nullptr ? jvmStats : "null";
+    json += '}';
+    free(jvmStats);
+    return strdup(json.c_str());
+}
+
+// 设置浏览接口中值的预览字节数（超过时截断并给出完整长度），返回JSON
+JNIEXPORT const char* JNICALL setValuePreview(int maxBytes) {
+    bridge::trace::RequestScope traceScope("setValuePreview");
+    std::string error;
+    if (!bridge::cells::setPreviewBytes(maxBytes > 0 ? (uint32_t)maxBytes : 0, error)) {
+        BRIDGE_LOG_ERROR("设置预览阈值失败: " << error);
+        return strdup(bridge::json::error(error).c_str());
+    }
+    return strdup("{\"status\":\"success\"}");
+}
+
+// 打开单元格供分块读取，返回单元格ID（不存在返回0，失败返回-1）
+JNIEXPORT int64_t JNICALL openCell(const char* tableName, const char* rowKey, const char* family,
+                                   const char* qualifier, int64_t* length) {
+    bridge::trace::RequestScope traceScope("openCell");
+    if (tableName == nullptr || rowKey == nullptr || family == nullptr || qualifier == nullptr) {
+        BRIDGE_LOG_ERROR("表名、行键与列不能为空");
+        return -1;
+    }
+    bridge::sched::InteractiveScope interactiveScope;
+    int64_t cellLength = 0;
+    std::string error;
+    int64_t id = bridge::cells::open(tableName, rowKey, family, qualifier, cellLength, error);
+    if (id < 0) {
+        BRIDGE_LOG_ERROR(error);
+    }
+    if (length != nullptr) {
+        *length = cellLength;
+    }
+    return id;
+}
+
+// 从单元格的offset处复制最多size字节到buffer，返回复制的字节数（末尾为0，失败为-1）
+JNIEXPORT int64_t JNICALL readCell(int64_t cellId, int64_t offset, uint8_t* buffer, int64_t size) {
+    std::string error;
+    int64_t copied = bridge::cells::read(cellId, offset, buffer, size, error);
+    if (copied < 0) {
+        BRIDGE_LOG_ERROR(error);
+    }
+    return copied;
+}
+
+// 关闭单元格
+JNIEXPORT void JNICALL closeCell(int64_t cellId) {
+    bridge::cells::close(cellId);
+}
+
+// 把单元格的完整值分块写入文件，返回写入的字节数（失败返回-1）
+JNIEXPORT int64_t JNICALL saveCell(const char* tableName, const char* rowKey, const char* family,
+                                   const char* qualifier, const char* path) {
+    bridge::trace::RequestScope traceScope("saveCell");
+    if (tableName == nullptr || rowKey == nullptr || family == nullptr || qualifier == nullptr || path == nullptr) {
+        BRIDGE_LOG_ERROR("表名、行键、列与文件路径不能为空");
+        return -1;
+    }
+    std::string error;
+    int64_t written = bridge::cells::save(tableName, rowKey, family, qualifier, path, error);
+    if (written < 0) {
+        BRIDGE_LOG_ERROR("保存单元格失败: " << error);
+    }
+    return written;
+}
+
+// 设置结果集的列显示格式，返回JSON
+JNIEXPORT const char* JNICALL setResultFormats(int64_t resultId, const char* spec) {
+    bridge::trace::RequestScope traceScope("setResultFormats");
+    std::shared_ptr<bridge::results::ResultStore> store = bridge::results::find(resultId);
+    if (!store) {
+        return strdup(bridge::json::error("结果集不存在: " + std::to_string((long long)resultId)).c_str());
+    }
+    std::string error;
+    if (!store->setFormats(spec ? spec : "", error)) {
+        return strdup(bridge::json::error(error).c_str());
+    }
+    return strdup("{\"status\":\"success\"}");
+}
+
+// 设置结果集视图（过滤、排序），返回JSON
+JNIEXPORT const char* JNICALL setResultView(int64_t resultId, const char* spec) {
+    bridge::trace::RequestScope traceScope("setResultView");
+    std::shared_ptr<bridge::results::ResultStore> store = bridge::results::find(resultId);
+    if (!store) {
+        return strdup(bridge::json::error("结果集不存在: " + std::to_string((long long)resultId)).c_str());
+    }
+    bridge::results::ViewSpec view;
+    std::string error;
+    if (!bridge::results::parseViewSpec(spec ? spec : "", view, error)) {
+        return strdup(bridge::json::error(error).c_str());
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64_t rows = 0;
+    if (!store->applyView(view, rows, error)) {
+        return strdup(bridge::json::error(error).c_str());
+    }
+    long long elapsed = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return strdup(("{\"status\":\"success\",\"rows\":" + std::to_string((unsigned long long)rows)
+        + ",\"elapsedMs\":" + std::to_string(elapsed) + "}").c_str());
+}
+
+// 释放结果集
+JNIEXPORT void JNICALL releaseResultSet(int64_t resultId) {
+    bridge::results::release(resultId);
+    bridge::jobs::release(resultId);
+}
+
+// 查询后台任务进度（JSON）
+JNIEXPORT const char* JNICALL getJobStatus(int64_t jobId) {
+    std::shared_ptr<bridge::jobs::Job> job = bridge::jobs::find(jobId);
+    if (!job) {
+        return strdup(bridge::json::error("任务不存在: " + std::to_string((long long)jobId)).c_str());
+    }
+    return strdup(job->toJson().c_str());
+}
+
+// 请求取消后台任务
+JNIEXPORT bool JNICALL cancelJob(int64_t jobId) {
+    return bridge::jobs::cancel(jobId);
+}
+
+// 设置后台任务的截止时间
+JNIEXPORT bool JNICALL setJobDeadline(int64_t jobId, int64_t timeoutMs) {
+    return bridge::jobs::setDeadline(jobId, timeoutMs);
+}
+
+// 释放任务记录（任务仍在运行时会先取消）
+JNIEXPORT void JNICALL releaseJob(int64_t jobId) {
+    bridge::jobs::release(jobId);
 }
 
 // 释放字符串内存
@@ -752,4 +1775,29 @@ JNIEXPORT void JNICALL freeString(const char* str) {
     }
 }
 
+// 设置日志级别（0=TRACE 1=DEBUG 2=INFO 3=WARN 4=ERROR 5=OFF），同步到Java层
+JNIEXPORT void JNICALL setLogLevel(int level) {
+    bridge::log::setLevel((bridge::log::Level)level);
+    syncJavaLogging();
+}
+
+// 日志输出到指定文件，传空指针或空串恢复为stderr
+JNIEXPORT bool JNICALL setLogFile(const char* path) {
+    return bridge::log::setOutputFile(path != nullptr ? path : "");
+}
+
+// 开启/关闭调用链追踪
+JNIEXPORT void JNICALL setTracingEnabled(bool enabled) {
+    bridge::trace::setEnabled(enabled);
+}
+
+// 将追踪事件导出为Chrome trace JSON文件
+JNIEXPORT bool JNICALL flushTrace(const char* path) {
+    if (path == nullptr) {
+        BRIDGE_LOG_ERROR("追踪文件路径不能为空");
+        return false;
+    }
+    return bridge::trace::flushToFile(path);
+}
+
 } // extern "C" 
\ No newline at end of file
@@ -2,11 +2,15 @@
 #define HBASE_BRIDGE_H
 
 #include <jni.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// 初始化JVM
+bool initJVM();
+
 // 连接HBase
 bool connect(const char* zkQuorum, const char* zkNode);
 
@@ -16,15 +20,237 @@ void disconnect();
 // 获取表列表
 const char* listTables();
 
-// 获取表数据
+// 获取表数据（每行最多1000列，超出的行带"columnsTruncated":true与"nextCursor"，剩余列用getRowColumns分页读取）
 const char* getTableData(const char* tableName, const char* startRow, const char* endRow, int limit, const char* filterPrefix);
 
 // 执行命令
 const char* executeCommand(const char* tableName, const char* command, const char* rowKey, const char* family, const char* qualifier, const char* value);
 
+// 获取表的Region分布（JSON数组：[{"start":..,"end":..,"server":..}]）
+const char* getTableRegions(const char* tableName);
+
+// 按规格生成可复现的压测数据，例如 "rows=1000000;qualifiers=1-200;values=lognormal:512:1.5;keys=zipf:1.2"
+// 规格项见table_generator.h；返回JSON：{"status":..,"rows":..,"cells":..,"bytes":..,"elapsedMs":..,"rowsPerSecond":..}
+const char* generateTable(const char* tableName, const char* spec);
+
+// 以后台任务生成压测数据，返回任务ID（规格无效返回-1）；进度与取消同其他任务，
+// 结束后任务的result为generateTable的统计字段
+int64_t startGenerate(const char* tableName, const char* spec);
+
+// 启动后台流式导出，format为 ndjson / csv / parquet，返回任务ID（失败返回-1）
+int64_t startExport(const char* tableName, const char* startRow, const char* endRow,
+                    const char* filterPrefix, const char* path, const char* format);
+
+// 启动后台批量导入（csv/tsv/ndjson文件），options为 key=value 列表（见table_import.h），返回任务ID（失败返回-1）
+int64_t startImport(const char* tableName, const char* path, const char* options);
+
+// 启动后台任务，把扫描范围追加保存到本地快照文件（path），返回任务ID（失败返回-1）
+int64_t startSnapshot(const char* tableName, const char* startRow, const char* endRow,
+                      const char* filterPrefix, const char* path);
+
+// 从本地快照读取表数据，参数与返回格式同getTableData；快照未覆盖该查询时返回 {"status":"error",...}
+const char* getSnapshotData(const char* path, const char* startRow, const char* endRow, int limit, const char* filterPrefix);
+
+// 快照新鲜度检查：返回各范围的扫描时间、大小与fresh（超过maxAgeSeconds或集群中有新写入为false）
+const char* checkSnapshot(const char* path, int maxAgeSeconds);
+
+// 启动后台聚合：按Region并行扫描column（family:qualifier）并在桥接层归约，
+// options为 ops=count,sum,min,max,avg;type=auto|long|int|double;threads=N（见table_aggregate.h），
+// 返回任务ID（失败返回-1），聚合值在getJobStatus的"result"中
+int64_t startAggregate(const char* tableName, const char* startRow, const char* endRow,
+                       const char* filterPrefix, const char* column, const char* options);
+
+// 以名称连接另一个集群（如容灾集群），之后可在对比等操作中通过集群名使用
+bool connectPeer(const char* name, const char* zkQuorum, const char* zkNode);
+
+// 断开connectPeer建立的集群连接
+void disconnectPeer(const char* name);
+
+// 启动后台表对比：sourceTable与targetTable（为空时同名，通常配合targetCluster跨集群）在同一范围内
+// 按Region并行扫描、按行键归并，options为 sourceCluster=..;targetCluster=..;columns=..;timestamps=..;path=..
+// 等（见table_diff.h），返回任务ID（失败返回-1），差异统计在getJobStatus的"result"中
+int64_t startDiff(const char* sourceTable, const char* targetTable, const char* startRow,
+                  const char* endRow, const char* filterPrefix, const char* options);
+
+// 启动后台校验树计算：按Region并行扫描，按行键哈希划分节点并逐层汇总哈希，
+// options为 cluster=..;columns=..;leafRows=..;fanout=..;path=.. 等（见table_checksum.h），
+// 返回任务ID（失败返回-1），根哈希与顶层节点在getJobStatus的"result"中
+int64_t startChecksum(const char* tableName, const char* startRow, const char* endRow,
+                      const char* filterPrefix, const char* options);
+
+// 对比两个校验树文件（可来自不同集群），只展开哈希不同的节点，
+// 返回 {"status":"success","equal":..,"ranges":[{"start":..,"end":..,"rows":[a,b]},..],"truncated":..}，
+// 最多列出maxRanges个差异范围（<=0时为1000）
+const char* compareChecksums(const char* pathA, const char* pathB, int maxRanges);
+
+// 启动后台表复制：sourceTable在范围内的数据写入targetTable（为空时同名，通常配合targetCluster跨集群），
+// 按Region并行扫描，经有界队列批量写入，options为 targetCluster=..;rowsPerSecond=..;bytesPerSecond=..;
+// checkpoint=.. 等（见table_copy.h），返回任务ID（失败返回-1）。用同一checkpoint重新启动可以续传
+int64_t startCopy(const char* sourceTable, const char* targetTable, const char* startRow,
+                  const char* endRow, const char* filterPrefix, const char* options);
+
+// 开始监视表的新写入：后台线程按间隔做时间范围扫描（范围与前缀同getTableData），
+// options为 interval=毫秒;coalesce=毫秒;lookback=毫秒;limit=行数;reverse=true 等（见table_watch.h），
+// 返回监视ID（失败返回-1）
+int64_t startWatch(const char* tableName, const char* startRow, const char* endRow, const char* filterPrefix,
+                   const char* options);
+
+// 读取监视到的新写入：afterSeq之后的最多maxEvents个事件（<=0时为1000），没有新事件时最多等待waitMs毫秒。
+// 返回 {"status":"success","events":[{"seq":..,"row":..,"column":..,"timestamp":..,"value":..},..],
+// "nextSeq":..,"dropped":..,"state":..,..}，nextSeq作为下一次的afterSeq；多个订阅方各自保存自己的seq
+const char* pollWatch(int64_t watchId, int64_t afterSeq, int maxEvents, int waitMs);
+
+// 停止监视，监视不存在时返回false
+bool stopWatch(int64_t watchId);
+
+// 设置访问集群的限速，spec为 类别.指标=每秒上限 或 @集群.指标=每秒上限（单独的@为主连接），
+// 指标为rows/bytes/rpcs，例如 export.bytes=20000000;@.rpcs=200（见qos.h）。每次调用替换全部限速，
+// 空串取消所有限速。getTableData、getRow、executeCommand等同步读写在返回后按结果估算计入
+// interactive与主连接，超出限速时在返回前等待。返回 {"status":"success"} 或错误JSON
+const char* setRateLimits(const char* spec);
+
+// 各操作类别与连接的累计流量、最近5秒的行/字节/请求速率、限速等待时间与当前限速（见qos.h）
+const char* getRateStats();
+
+// 配置优先级调度，spec为 interactive.slots=..;normal.slots=..;background.slots=..;yieldMs=..;
+// kind.<任务kind>=interactive|normal|background（见scheduler.h），只修改给出的项。
+// 返回 {"status":"success"} 或错误JSON
+const char* setSchedulerConfig(const char* spec);
+
+// 各优先级的并发上限、运行与排队数量、累计排队时间，以及后台任务为交互请求让出的次数与时间
+const char* getSchedulerStats();
+
+// 创建一个可取消的操作（取消令牌），timeoutMs>0时同时设置截止时间，返回操作ID。
+// 操作ID传给queryTableData等同步调用，可以在另一个线程中用cancelOperation取消，用完后releaseOperation
+int64_t createOperation(int64_t timeoutMs);
+
+// 取消操作：正在进行的扫描立即关闭，调用以code=-2返回；操作不存在时返回false
+bool cancelOperation(int64_t operationId);
+
+// 释放操作
+void releaseOperation(int64_t operationId);
+
+// 可取消的getTableData：operationId为createOperation返回的ID（0为不使用），
+// 返回 {"code":0,"status":"ok","rows":[...]}（超过内存预算的queryBytes时截断并带"truncated":true），取消或超时返回 {"code":-2|-3,"status":"cancelled|deadlineExceeded","error":..}，
+// 其他失败返回 {"code":-1,"status":"error","error":..}
+const char* queryTableData(const char* tableName, const char* startRow, const char* endRow, int limit,
+                           const char* filterPrefix, int64_t operationId);
+
+// 读取一行（family/qualifier为空时取整个列族/整行），按setPointReadOptions的设置对冲与重试，
+// 返回 {"status":"success","data":{"row":..,"families":{..}},"stale":..}（行不存在时没有data），失败返回nullptr
+const char* getRow(const char* tableName, const char* rowKey, const char* family, const char* qualifier);
+
+// 按列分页读取一行（适用于有大量列的宽行）：family为空时依次读取各列族，cursor为上一页的nextCursor（空为从头开始），
+// 每页最多limit列，服务端分块返回，整行不会一次性物化。返回 {"status":"success","row":..,
+// "columns":[{"family":..,"qualifier":..,"value":..,"timestamp":..},..],"nextCursor":..或null}，失败返回nullptr
+const char* getRowColumns(const char* tableName, const char* rowKey, const char* family, const char* cursor, int limit);
+
+// 带版本与时间范围读取表数据，options为 versions=N;minTime=毫秒;maxTime=毫秒 或 timestamp=毫秒（见scanner_reader.h）。
+// 返回JSON数组：[{"row":..,"cells":[{"family":..,"qualifier":..,"timestamp":..,"value":..},..]},..]，
+// 同一列的版本从新到旧；超过预览阈值的值带"length"（完整长度）。
+// 表名为空或选项无效时返回错误JSON，其他失败返回nullptr
+const char* getTableVersions(const char* tableName, const char* startRow, const char* endRow, int limit,
+                             const char* filterPrefix, const char* options);
+
+// 带版本与时间范围读取一行（family/qualifier为空时取整个列族/整行），options同getTableVersions，
+// 返回 {"status":"success","data":{"row":..,"cells":[..]}}（行不存在时没有data），选项无效返回错误JSON
+const char* getRowVersions(const char* tableName, const char* rowKey, const char* family, const char* qualifier,
+                           const char* options);
+
+// 设置单行读取的对冲与重试，options为 hedge=true;percentile=95;minHedgeMs=5;maxRetries=2;backoffMs=50;
+// maxBackoffMs=1000（见point_read.h），只修改给出的项。返回 {"status":"success"} 或错误JSON
+const char* setPointReadOptions(const char* options);
+
+// 单行读取统计：{"hedge":..,"hedgeThresholdMs":..,"requests":..,"primaryWins":..,"replicaWins":..,"hedged":..,
+// "staleResults":..,"retries":..,"failures":..,"p50Ms":..,"p95Ms":..,"p99Ms":..,"primaryP95Ms":..}
+const char* getPointReadStats();
+
+// 设置扫描数据的内存预算，spec为 global=字节;operation=字节;spill=true|false;spillDir=..;queryBytes=字节
+// （见memory_budget.h），只修改给出的项。导出与复制的扫描超出预算时等待下游写出，结果集超出预算时
+// 溢出到临时文件，getTableData/queryTableData超过queryBytes时截断。返回 {"status":"success"} 或错误JSON
+const char* setMemoryBudget(const char* spec);
+
+// 内存使用情况：{"native":{"global":{"limit":..,"used":..,"peak":..},"operationLimit":..,"spill":..,
+// "blockedMs":..,"spilledBytes":..,"operations":[..]},"jvm":{"heapUsed":..,"heapCommitted":..,"heapMax":..,
+// "queryBytes":..,"truncatedQueries":..}}，JVM未初始化时jvm为null
+const char* getMemoryStats();
+
+// 设置值的预览字节数（<=0不截断）：getTableData、queryTableData、getRow返回的行中超过阈值的值
+// 只保留前maxBytes字节，行内另有"truncated":{"family:qualifier":完整长度}，未调用时这些接口不截断；
+// getResultRows同样截断，未调用时阈值为65536（见large_cell.h）。
+// 返回 {"status":"success"} 或错误JSON
+const char* setValuePreview(int maxBytes);
+
+// 打开单元格（family:qualifier的最新版本）供分块读取，返回单元格ID并把完整长度写入length；
+// 单元格不存在返回0，失败返回-1。用完后closeCell
+int64_t openCell(const char* tableName, const char* rowKey, const char* family, const char* qualifier,
+                 int64_t* length);
+
+// 从offset开始复制最多size字节到buffer，返回复制的字节数（到达末尾为0），失败返回-1
+int64_t readCell(int64_t cellId, int64_t offset, uint8_t* buffer, int64_t size);
+
+// 关闭openCell打开的单元格
+void closeCell(int64_t cellId);
+
+// 把单元格的完整值分块写入path，返回写入的字节数，单元格不存在或失败返回-1
+int64_t saveCell(const char* tableName, const char* rowKey, const char* family, const char* qualifier,
+                 const char* path);
+
+// 打开列式结果集：后台扫描并缓存在桥接层（最多maxRows行，0表示不限），返回结果集ID（即填充任务ID，失败返回-1）
+int64_t openResultSet(const char* tableName, const char* startRow, const char* endRow,
+                      const char* filterPrefix, int64_t maxRows);
+
+// 增量刷新结果集：只扫描时间戳不早于已见最大时间戳的cell并合并到结果集中（更新的值替换，新列插入，新行追加在末尾），
+// 返回刷新任务ID（失败返回-1）。合并计数在getJobStatus的"result"中：
+// {"newRows":..,"newCells":..,"updatedCells":..,"skippedRows":..,"minTime":..}。删除不会被增量刷新看到
+int64_t refreshResultSet(int64_t resultId);
+
+// 结果集概况：{"rows":..,"columns":["cf:q",..],"complete":..,"bytes":..,"spilledBytes":..,"truncated":..,"maxTimestamp":..}
+const char* getResultInfo(int64_t resultId);
+
+// 按视口读取结果集：[firstRow, firstRow+rowCount) 行 × [firstColumn, firstColumn+columnCount) 列，
+// 返回 {"firstRow":..,"rows":[["行键","值"或null,..],..]}，超过预览阈值的值被截断，另有"truncated":[[行号,列号,完整长度],..]
+const char* getResultRows(int64_t resultId, int64_t firstRow, int rowCount, int firstColumn, int columnCount);
+
+// 设置结果集的列显示格式：spec为 列=格式 列表（列为family:qualifier、rowkey或*），
+// 格式 auto|text|binary|hex|long|int|double（见value_decoder.h），之后getResultRows按格式解码
+const char* setResultFormats(int64_t resultId, const char* spec);
+
+// 设置结果集视图：spec为 sort=列;order=asc|desc;filter=列|运算|值 等（见result_view.h），空串恢复扫描顺序。
+// 之后getResultRows按视图顺序返回，返回 {"status":"success","rows":视图行数,"elapsedMs":..}
+const char* setResultView(int64_t resultId, const char* spec);
+
+// 释放结果集（填充未完成时同时取消）
+void releaseResultSet(int64_t resultId);
+
+// 查询后台任务进度，返回JSON：{"id":..,"kind":..,"state":"queued|running|succeeded|failed|cancelled|deadlineExceeded",
+// "code":0|-1|-2|-3,"rows":..,...}
+const char* getJobStatus(int64_t jobId);
+
+// 请求取消后台任务，正在进行的扫描立即关闭
+bool cancelJob(int64_t jobId);
+
+// 设置后台任务的截止时间（从现在起timeoutMs毫秒，<=0取消限制），超时后任务结束为deadlineExceeded
+bool setJobDeadline(int64_t jobId, int64_t timeoutMs);
+
+// 释放已结束任务的记录
+void releaseJob(int64_t jobId);
+
 // 释放字符串内存
 void freeString(const char* str);
 
+// 设置日志级别（0=TRACE 1=DEBUG 2=INFO 3=WARN 4=ERROR 5=OFF），默认WARN
+void setLogLevel(int level);
+
+// 日志输出到指定文件，传空指针恢复为stderr
+bool setLogFile(const char* path);
+
+// 开启/关闭调用链追踪（C++与Java两层共享请求ID）
+void setTracingEnabled(bool enabled);
+
+// 将追踪事件导出为Chrome trace / Perfetto JSON文件并清空缓冲区
+bool flushTrace(const char* path);
+
 #ifdef __cplusplus
 }
 #endif
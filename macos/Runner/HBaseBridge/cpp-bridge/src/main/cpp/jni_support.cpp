@@ -0,0 +1,165 @@
+#include "jni_support.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+namespace bridge {
+
+static std::mutex classCacheMutex;
+static std::map<std::string, jclass> classCache;
+
+JNIEnv* currentEnv() {
+    JavaVM* vm = nullptr;
+    jsize vmCount = 0;
+    if (JNI_GetCreatedJavaVMs(&vm, 1, &vmCount) != JNI_OK || vmCount == 0 || vm == nullptr) {
+        return nullptr;
+    }
+
+    JNIEnv* env = nullptr;
+    jint getEnvResult = vm->GetEnv((void**)&env, JNI_VERSION_1_8);
+    if (getEnvResult == JNI_EDETACHED) {
+        if (vm->AttachCurrentThread((void**)&env, nullptr) != JNI_OK) {
+            return nullptr;
+        }
+    } else if (getEnvResult != JNI_OK) {
+        return nullptr;
+    }
+    return env;
+}
+
+void detachCurrentThread() {
+    JavaVM* vm = nullptr;
+    jsize vmCount = 0;
+    if (JNI_GetCreatedJavaVMs(&vm, 1, &vmCount) != JNI_OK || vmCount == 0 || vm == nullptr) {
+        return;
+    }
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv((void**)&env, JNI_VERSION_1_8) == JNI_OK) {
+        vm->DetachCurrentThread();
+    }
+}
+
+jclass bridgeClass(JNIEnv* env, const char* simpleName) {
+    std::string name = std::string("com/hbasegui/bridge/") + simpleName;
+
+    std::lock_guard<std::mutex> lock(classCacheMutex);
+    std::map<std::string, jclass>::iterator it = classCache.find(name);
+    if (it != classCache.end()) {
+        return it->second;
+    }
+
+    jclass localClass = env->FindClass(name.c_str());
+    if (localClass == nullptr) {
+        clearPendingException(env, name.c_str());
+        return nullptr;
+    }
+
+    // 全局引用在进程生命周期内保留，避免每次调用重复FindClass
+    jclass globalClass = (jclass)env->NewGlobalRef(localClass);
+    env->DeleteLocalRef(localClass);
+    classCache[name] = globalClass;
+    return globalClass;
+}
+
+bool clearPendingException(JNIEnv* env, const char* context) {
+    if (env == nullptr || !env->ExceptionCheck()) {
+        return false;
+    }
+    BRIDGE_LOG_ERROR("Java异常: " << context);
+    env->ExceptionDescribe();
+    env->ExceptionClear();
+    return true;
+}
+
+std::string toStdString(JNIEnv* env, jstring str) {
+    if (str == nullptr) {
+        return std::string();
+    }
+    const char* chars = env->GetStringUTFChars(str, nullptr);
+    if (chars == nullptr) {
+        return std::string();
+    }
+    std::string result(chars);
+    env->ReleaseStringUTFChars(str, chars);
+    return result;
+}
+
+JavaString::JavaString(JNIEnv* env, const char* str)
+    : env_(env), str_(str != nullptr ? env->NewStringUTF(str) : nullptr) {
+}
+
+JavaString::~JavaString() {
+    if (str_ != nullptr) {
+        env_->DeleteLocalRef(str_);
+    }
+}
+
+char* callStaticString(const char* className, const char* method, const char* signature, ...) {
+    JNIEnv* env = currentEnv();
+    if (env == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化，无法调用 " << className << "." << method);
+        return nullptr;
+    }
+    jclass clazz = bridgeClass(env, className);
+    if (clazz == nullptr) {
+        BRIDGE_LOG_ERROR("无法找到" << className << "类");
+        return nullptr;
+    }
+
+    // 方法ID随类的全局引用一直有效，按“类.方法签名”缓存
+    static std::mutex methodCacheMutex;
+    static std::map<std::string, jmethodID> methodCache;
+    std::string key = std::string(className) + "." + method + signature;
+    jmethodID methodId = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(methodCacheMutex);
+        std::map<std::string, jmethodID>::iterator it = methodCache.find(key);
+        if (it != methodCache.end()) {
+            methodId = it->second;
+        } else {
+            methodId = env->GetStaticMethodID(clazz, method, signature);
+            if (methodId == nullptr) {
+                clearPendingException(env, key.c_str());
+                BRIDGE_LOG_ERROR("无法找到" << method << "方法");
+                return nullptr;
+            }
+            methodCache[key] = methodId;
+        }
+    }
+
+    jstring result;
+    {
+        trace::Span span("jni.call");
+        va_list args;
+        va_start(args, signature);
+        result = (jstring)env->CallStaticObjectMethodV(clazz, methodId, args);
+        va_end(args);
+    }
+    if (clearPendingException(env, method)) {
+        if (result != nullptr) {
+            env->DeleteLocalRef(result);
+        }
+        return nullptr;
+    }
+    if (result == nullptr) {
+        BRIDGE_LOG_ERROR("Java方法返回空: " << method);
+        return nullptr;
+    }
+
+    trace::Span copySpan("jni.result.copy");
+    const char* chars = env->GetStringUTFChars(result, nullptr);
+    char* copy = chars != nullptr ? strdup(chars) : nullptr;
+    if (chars != nullptr) {
+        env->ReleaseStringUTFChars(result, chars);
+    } else {
+        BRIDGE_LOG_ERROR("无法转换Java字符串到C字符串");
+    }
+    env->DeleteLocalRef(result);
+    return copy;
+}
+
+} // namespace bridge
@@ -0,0 +1,46 @@
+#ifndef JNI_SUPPORT_H
+#define JNI_SUPPORT_H
+
+#include <jni.h>
+#include <string>
+
+namespace bridge {
+
+// 获取当前线程的JNIEnv，线程未附加时自动附加；JVM尚未创建时返回nullptr
+JNIEnv* currentEnv();
+
+// 工作线程退出前调用，解除与JVM的附加（未附加时无操作）
+void detachCurrentThread();
+
+// 获取 com/hbasegui/bridge 包下类的全局引用（进程内缓存），失败返回nullptr
+jclass bridgeClass(JNIEnv* env, const char* simpleName);
+
+// 检查并清除挂起的Java异常，发生异常时返回true
+bool clearPendingException(JNIEnv* env, const char* context);
+
+// Java字符串转换为std::string，null返回空串
+std::string toStdString(JNIEnv* env, jstring str);
+
+// 调用结束时自动释放的Java字符串参数，C字符串为nullptr时传null
+class JavaString {
+public:
+    JavaString(JNIEnv* env, const char* str);
+    ~JavaString();
+
+    jstring get() const { return str_; }
+
+private:
+    JavaString(const JavaString&);
+    JavaString& operator=(const JavaString&);
+
+    JNIEnv* env_;
+    jstring str_;
+};
+
+// 调用 com/hbasegui/bridge 包下类的静态方法（返回String），
+// 结果以strdup复制返回，由调用方通过freeString释放；任何失败返回nullptr
+char* callStaticString(const char* className, const char* method, const char* signature, ...);
+
+} // namespace bridge
+
+#endif // JNI_SUPPORT_H
@@ -0,0 +1,210 @@
+#include "job_registry.h"
+#include "bridge_log.h"
+#include "jni_support.h"
+#include "json_util.h"
+#include "qos.h"
+#include "scheduler.h"
+
+#include <cstdio>
+#include <map>
+
+namespace bridge {
+namespace jobs {
+
+namespace {
+
+std::mutex registryMutex;
+std::map<int64_t, std::shared_ptr<Job> > registry;
+int64_t nextJobId = 1;
+
+const char* stateName(State state) {
+    switch (state) {
+    case JOB_QUEUED: return "queued";
+    case JOB_RUNNING: return "running";
+    case JOB_SUCCEEDED: return "succeeded";
+    case JOB_FAILED: return "failed";
+    case JOB_CANCELLED: return "cancelled";
+    case JOB_DEADLINE_EXCEEDED: return "deadlineExceeded";
+    }
+    return "unknown";
+}
+
+cancel::Status stateCode(State state) {
+    switch (state) {
+    case JOB_FAILED: return cancel::STATUS_ERROR;
+    case JOB_CANCELLED: return cancel::STATUS_CANCELLED;
+    case JOB_DEADLINE_EXCEEDED: return cancel::STATUS_DEADLINE_EXCEEDED;
+    default: return cancel::STATUS_OK;
+    }
+}
+
+void runJob(std::shared_ptr<Job> job, JobBody body) {
+    if (!job->leaveQueue(JOB_RUNNING)) {
+        job->token().release(); // 排队期间已取消
+        return;
+    }
+    qos::ClassScope qosScope(*job);
+    std::string error;
+    bool ok = false;
+    try {
+        ok = body(*job, error);
+    } catch (const std::exception& e) {
+        error = e.what();
+    } catch (...) {
+        error = "未知异常";
+    }
+    if (job->isCancelRequested() && !ok && job->token().status() == cancel::STATUS_DEADLINE_EXCEEDED) {
+        job->finish(JOB_DEADLINE_EXCEEDED, cancel::statusMessage(cancel::STATUS_DEADLINE_EXCEEDED));
+        BRIDGE_LOG_WARN("任务 " << job->id() << "（" << job->kind() << "）超过截止时间");
+    } else if (job->isCancelRequested() && !ok) {
+        job->finish(JOB_CANCELLED, "");
+        BRIDGE_LOG_INFO("任务 " << job->id() << "（" << job->kind() << "）已取消");
+    } else if (ok) {
+        job->finish(JOB_SUCCEEDED, "");
+        BRIDGE_LOG_INFO("任务 " << job->id() << "（" << job->kind() << "）完成，行数: " << job->rows.load());
+    } else {
+        job->finish(JOB_FAILED, error);
+        BRIDGE_LOG_ERROR("任务 " << job->id() << "（" << job->kind() << "）失败: " << error);
+    }
+    job->token().release();
+    // 任务线程可能在主体中附加到了JVM
+    detachCurrentThread();
+}
+
+} // namespace
+
+Job::Job(int64_t id, const std::string& kind)
+    : rows(0), cells(0), bytesRead(0), bytesWritten(0), errors(0), totalRows(-1), totalBytes(-1),
+      id_(id), kind_(kind), start_(std::chrono::steady_clock::now()),
+      state_(JOB_QUEUED), elapsedMillis_(-1) {
+}
+
+void Job::setDetail(const std::string& detail) {
+    std::lock_guard<std::mutex> lock(textMutex_);
+    detail_ = detail;
+}
+
+void Job::setResult(const std::string& json) {
+    std::lock_guard<std::mutex> lock(textMutex_);
+    result_ = json;
+}
+
+bool Job::leaveQueue(State next) {
+    State expected = JOB_QUEUED;
+    return state_.compare_exchange_strong(expected, next);
+}
+
+void Job::finish(State state, const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(textMutex_);
+        error_ = error;
+    }
+    elapsedMillis_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+    state_ = state;
+}
+
+std::string Job::toJson() const {
+    State current = state_.load();
+    int64_t elapsed = elapsedMillis_.load();
+    if (current == JOB_QUEUED || current == JOB_RUNNING || elapsed < 0) {
+        elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+    }
+    uint64_t rowCount = rows.load();
+    char numbers[384];
+    snprintf(numbers, sizeof(numbers),
+        ",\"rows\":%llu,\"cells\":%llu,\"bytesRead\":%llu,\"bytesWritten\":%llu,\"errors\":%llu,"
+        "\"totalRows\":%lld,\"totalBytes\":%lld,\"elapsedMs\":%lld,\"rowsPerSecond\":%.0f,"
+        "\"readBytesPerSecond\":%.0f,\"writeBytesPerSecond\":%.0f",
+        (unsigned long long)rowCount, (unsigned long long)cells.load(),
+        (unsigned long long)bytesRead.load(), (unsigned long long)bytesWritten.load(),
+        (unsigned long long)errors.load(), (long long)totalRows.load(), (long long)totalBytes.load(),
+        (long long)elapsed,
+        elapsed > 0 ? rowCount * 1000.0 / elapsed : 0.0,
+        elapsed > 0 ? bytesRead.load() * 1000.0 / elapsed : 0.0,
+        elapsed > 0 ? bytesWritten.load() * 1000.0 / elapsed : 0.0);
+
+    std::string json = "{\"id\":" + std::to_string((long long)id_)
+        + ",\"kind\":" + json::quote(kind_)
+        + ",\"state\":\"" + stateName(current) + "\",\"code\":" + std::to_string((int)stateCode(current))
+        + numbers;
+    std::lock_guard<std::mutex> lock(textMutex_);
+    if (!detail_.empty()) {
+        json += ",\"detail\":" + json::quote(detail_);
+    }
+    if (!result_.empty()) {
+        json += ",\"result\":" + result_;
+    }
+    if (!error_.empty()) {
+        json += ",\"error\":" + json::quote(error_);
+    }
+    json += "}";
+    return json;
+}
+
+int64_t start(const std::string& kind, const JobBody& body) {
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        job = std::make_shared<Job>(nextJobId++, kind);
+        registry[job->id()] = job;
+    }
+    // 任务线程持有Job的引用，release之后线程仍可安全结束
+    sched::submit(sched::priorityOf(kind), std::bind(runJob, job, body));
+    return job->id();
+}
+
+std::shared_ptr<Job> find(int64_t id) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::map<int64_t, std::shared_ptr<Job> >::iterator it = registry.find(id);
+    return it != registry.end() ? it->second : std::shared_ptr<Job>();
+}
+
+bool cancel(int64_t id) {
+    std::shared_ptr<Job> job = find(id);
+    if (!job) {
+        return false;
+    }
+    State state = job->state();
+    if (state != JOB_QUEUED && state != JOB_RUNNING) {
+        return true; // 已结束，Java层的令牌也已释放
+    }
+    job->requestCancel();
+    if (job->leaveQueue(JOB_CANCELLED)) {
+        job->finish(JOB_CANCELLED, "");
+        BRIDGE_LOG_INFO("任务 " << job->id() << "（" << job->kind() << "）在排队时取消");
+    }
+    return true;
+}
+
+bool setDeadline(int64_t id, int64_t timeoutMs) {
+    std::shared_ptr<Job> job = find(id);
+    if (!job) {
+        return false;
+    }
+    job->token().setDeadline(timeoutMs);
+    return true;
+}
+
+void release(int64_t id) {
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::map<int64_t, std::shared_ptr<Job> >::iterator it = registry.find(id);
+        if (it == registry.end()) {
+            return;
+        }
+        job = it->second;
+        registry.erase(it);
+    }
+    if (job->state() == JOB_RUNNING) {
+        job->requestCancel();
+    } else if (job->leaveQueue(JOB_CANCELLED)) {
+        job->requestCancel();
+        job->finish(JOB_CANCELLED, "");
+    }
+}
+
+} // namespace jobs
+} // namespace bridge
@@ -0,0 +1,101 @@
+#ifndef JOB_REGISTRY_H
+#define JOB_REGISTRY_H
+
+#include "cancel_token.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// 后台任务（导出、导入等耗时操作）。任务按kind的优先级调度（见scheduler.h），
+// 在独立线程中运行，并发额度不足时先排队；调用方通过任务ID轮询进度JSON，也可以请求取消。
+
+namespace bridge {
+namespace jobs {
+
+enum State {
+    JOB_QUEUED,  // 等待调度额度（见scheduler.h）
+    JOB_RUNNING,
+    JOB_SUCCEEDED,
+    JOB_FAILED,
+    JOB_CANCELLED,
+    JOB_DEADLINE_EXCEEDED
+};
+
+class Job {
+public:
+    Job(int64_t id, const std::string& kind);
+
+    int64_t id() const { return id_; }
+    const std::string& kind() const { return kind_; }
+
+    // 进度计数，由任务线程更新
+    std::atomic<uint64_t> rows;
+    std::atomic<uint64_t> cells;
+    std::atomic<uint64_t> bytesRead;
+    std::atomic<uint64_t> bytesWritten;
+    std::atomic<uint64_t> errors;   // 跳过的错误记录数
+    std::atomic<int64_t> totalRows; // 未知时为-1
+    std::atomic<int64_t> totalBytes; // 输入总字节数，未知时为-1
+
+    // 请求了取消或已超过截止时间
+    bool isCancelRequested() const { return token_.isAborted(); }
+    void requestCancel() { token_.cancel(); }
+
+    // 任务的取消令牌，工作线程通过qos::ClassScope绑定
+    const cancel::Token& token() const { return token_; }
+    cancel::Token& token() { return token_; }
+
+    // 附加在进度JSON中的说明（例如输出文件路径）
+    void setDetail(const std::string& detail);
+
+    // 任务结果（JSON对象，例如聚合值），原样作为"result"附加在进度JSON中
+    void setResult(const std::string& json);
+
+    State state() const { return state_.load(); }
+    // 从queued转入next（running或cancelled），已不在队列中时返回false
+    bool leaveQueue(State next);
+    void finish(State state, const std::string& error);
+
+    std::string toJson() const;
+
+private:
+    const int64_t id_;
+    const std::string kind_;
+    const std::chrono::steady_clock::time_point start_;
+    cancel::Token token_;
+    std::atomic<State> state_;
+    std::atomic<int64_t> elapsedMillis_; // 结束时冻结
+    mutable std::mutex textMutex_;
+    std::string error_;
+    std::string detail_;
+    std::string result_;
+};
+
+// 任务主体：返回true表示成功；失败时写入error。取消由主体自行检查isCancelRequested
+typedef std::function<bool(Job& job, std::string& error)> JobBody;
+
+// 启动后台任务并返回任务ID
+int64_t start(const std::string& kind, const JobBody& body);
+
+// 查找任务，不存在时返回空指针
+std::shared_ptr<Job> find(int64_t id);
+
+// 请求取消，任务不存在时返回false
+bool cancel(int64_t id);
+
+// 设置任务的截止时间（从现在起timeoutMs毫秒，<=0取消限制），超时后按取消处理，
+// 任务结束状态为deadlineExceeded；任务不存在时返回false
+bool setDeadline(int64_t id, int64_t timeoutMs);
+
+// 释放已结束任务的记录；任务仍在运行时先请求取消
+void release(int64_t id);
+
+} // namespace jobs
+} // namespace bridge
+
+#endif // JOB_REGISTRY_H
@@ -0,0 +1,85 @@
+#ifndef JSON_UTIL_H
+#define JSON_UTIL_H
+
+#include <stddef.h>
+#include <string>
+
+namespace bridge {
+namespace json {
+
+// 生成带引号的JSON字符串，转义引号、反斜杠与控制字符
+inline std::string quote(const std::string& text) {
+    static const char hex[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(text.size() + 2);
+    out += '"';
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else if (c < 0x20) {
+            out += "\\u00";
+            out += hex[c >> 4];
+            out += hex[c & 0xf];
+        } else {
+            out += (char)c;
+        }
+    }
+    out += '"';
+    return out;
+}
+
+// 追加JSON字符串内容（不含引号），按UTF-8校验，非法字节替换为U+FFFD（与Java层Bytes.toString一致）
+inline void appendText(std::string& out, const char* data, size_t length) {
+    static const char hex[] = "0123456789abcdef";
+    const unsigned char* p = (const unsigned char*)data;
+    size_t i = 0;
+    while (i < length) {
+        unsigned char c = p[i];
+        if (c < 0x80) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += (char)c;
+            } else if (c < 0x20) {
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xf];
+            } else {
+                out += (char)c;
+            }
+            ++i;
+            continue;
+        }
+        size_t sequenceLength = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc2 ? 2 : 0;
+        bool valid = sequenceLength != 0 && c <= 0xf4 && i + sequenceLength <= length;
+        if (valid) {
+            // 第二个字节的范围排除过长编码、代理区与超出U+10FFFF的码点
+            unsigned char low = c == 0xe0 ? 0xa0 : c == 0xf0 ? 0x90 : 0x80;
+            unsigned char high = c == 0xed ? 0x9f : c == 0xf4 ? 0x8f : 0xbf;
+            valid = p[i + 1] >= low && p[i + 1] <= high;
+        }
+        for (size_t k = 2; valid && k < sequenceLength; ++k) {
+            valid = (p[i + k] & 0xc0) == 0x80;
+        }
+        if (valid) {
+            out.append(data + i, sequenceLength);
+            i += sequenceLength;
+        } else {
+            out += "\xef\xbf\xbd";
+            ++i;
+        }
+    }
+}
+
+// 通用的错误结果 {"status":"error","message":...}
+inline std::string error(const std::string& message) {
+    return "{\"status\":\"error\",\"message\":" + quote(message) + "}";
+}
+
+} // namespace json
+} // namespace bridge
+
+#endif // JSON_UTIL_H
@@ -0,0 +1,215 @@
+#include "large_cell.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "jni_support.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+namespace bridge {
+namespace cells {
+
+namespace {
+
+// 默认预览前64KB
+std::atomic<uint32_t> preview(64 << 10);
+
+// 写文件时每次从Java层复制的字节数
+const int64_t SAVE_CHUNK_BYTES = 1 << 20;
+
+jmethodID findMethod(JNIEnv* env, jclass hbaseBridge, const char* name, const char* signature, std::string& error) {
+    jmethodID method = env->GetStaticMethodID(hbaseBridge, name, signature);
+    if (method == nullptr) {
+        clearPendingException(env, name);
+        error = std::string("无法找到") + name + "方法";
+    }
+    return method;
+}
+
+// 获取JNIEnv与HBaseBridge类，失败时设置error
+jclass bridgeFor(JNIEnv*& env, std::string& error) {
+    env = currentEnv();
+    if (env == nullptr) {
+        error = "JVM未初始化";
+        return nullptr;
+    }
+    jclass hbaseBridge = bridgeClass(env, "HBaseBridge");
+    if (hbaseBridge == nullptr) {
+        error = "无法找到HBaseBridge类";
+    }
+    return hbaseBridge;
+}
+
+} // namespace
+
+uint32_t previewBytes() {
+    return preview.load(std::memory_order_relaxed);
+}
+
+bool setPreviewBytes(uint32_t bytes, std::string& error) {
+    JNIEnv* env = nullptr;
+    jclass hbaseBridge = bridgeFor(env, error);
+    if (hbaseBridge == nullptr) {
+        return false;
+    }
+    jmethodID method = findMethod(env, hbaseBridge, "configurePreview", "(I)V", error);
+    if (method == nullptr) {
+        return false;
+    }
+    env->CallStaticVoidMethod(hbaseBridge, method, (jint)bytes);
+    if (clearPendingException(env, "HBaseBridge.configurePreview")) {
+        error = "设置预览阈值失败";
+        return false;
+    }
+    preview = bytes;
+    return true;
+}
+
+uint32_t previewLength(const char* value, uint32_t length) {
+    uint32_t limit = previewBytes();
+    if (limit == 0 || length <= limit) {
+        return length;
+    }
+    // 与Java层LargeCells.previewLength相同：截断点是续字节（10xxxxxx）时退到字符的首字节之前
+    uint32_t cut = limit;
+    while (cut > 0 && limit - cut < 3 && ((unsigned char)value[cut] & 0xC0) == 0x80) {
+        --cut;
+    }
+    return ((unsigned char)value[cut] & 0xC0) == 0x80 ? limit : cut;
+}
+
+int64_t open(const std::string& tableName, const std::string& rowKey, const std::string& family,
+             const std::string& qualifier, int64_t& length, std::string& error) {
+    trace::Span span("cell.open");
+    length = 0;
+    JNIEnv* env = nullptr;
+    jclass hbaseBridge = bridgeFor(env, error);
+    if (hbaseBridge == nullptr) {
+        return -1;
+    }
+    jmethodID openMethod = findMethod(env, hbaseBridge, "openCell",
+        "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)J", error);
+    jmethodID lengthMethod = openMethod != nullptr
+        ? findMethod(env, hbaseBridge, "getCellLength", "(J)J", error) : nullptr;
+    if (lengthMethod == nullptr) {
+        return -1;
+    }
+    JavaString table(env, tableName.c_str());
+    JavaString row(env, rowKey.c_str());
+    JavaString familyStr(env, family.c_str());
+    JavaString qualifierStr(env, qualifier.c_str());
+    jlong id = env->CallStaticLongMethod(hbaseBridge, openMethod, table.get(), row.get(), familyStr.get(),
+                                         qualifierStr.get());
+    if (clearPendingException(env, "HBaseBridge.openCell") || id < 0) {
+        error = "读取单元格失败: " + tableName + " " + rowKey + " " + family + ":" + qualifier;
+        return -1;
+    }
+    if (id == 0) {
+        return 0;
+    }
+    length = env->CallStaticLongMethod(hbaseBridge, lengthMethod, id);
+    clearPendingException(env, "HBaseBridge.getCellLength");
+    return id;
+}
+
+int64_t read(int64_t cellId, int64_t offset, uint8_t* buffer, int64_t size, std::string& error) {
+    if (buffer == nullptr || size <= 0 || offset < 0) {
+        error = "缓冲区或偏移无效";
+        return -1;
+    }
+    JNIEnv* env = nullptr;
+    jclass hbaseBridge = bridgeFor(env, error);
+    if (hbaseBridge == nullptr) {
+        return -1;
+    }
+    jmethodID method = findMethod(env, hbaseBridge, "readCell", "(JJLjava/nio/ByteBuffer;)I", error);
+    if (method == nullptr) {
+        return -1;
+    }
+    // Java层直接复制到调用方的缓冲区，不经过中间的byte[]
+    jobject target = env->NewDirectByteBuffer(buffer, (jlong)size);
+    if (target == nullptr) {
+        clearPendingException(env, "NewDirectByteBuffer");
+        error = "无法创建直接缓冲区";
+        return -1;
+    }
+    jint copied = env->CallStaticIntMethod(hbaseBridge, method, (jlong)cellId, (jlong)offset, target);
+    env->DeleteLocalRef(target);
+    if (clearPendingException(env, "HBaseBridge.readCell") || copied < 0) {
+        error = "单元格不存在或已关闭: " + std::to_string((long long)cellId);
+        return -1;
+    }
+    return copied;
+}
+
+void close(int64_t cellId) {
+    std::string error;
+    JNIEnv* env = nullptr;
+    jclass hbaseBridge = bridgeFor(env, error);
+    if (hbaseBridge == nullptr) {
+        return;
+    }
+    jmethodID method = findMethod(env, hbaseBridge, "closeCell", "(J)V", error);
+    if (method != nullptr) {
+        env->CallStaticVoidMethod(hbaseBridge, method, (jlong)cellId);
+        clearPendingException(env, "HBaseBridge.closeCell");
+    }
+}
+
+int64_t save(const std::string& tableName, const std::string& rowKey, const std::string& family,
+             const std::string& qualifier, const std::string& path, std::string& error) {
+    trace::Span span("cell.save");
+    int64_t length = 0;
+    int64_t id = open(tableName, rowKey, family, qualifier, length, error);
+    if (id <= 0) {
+        if (id == 0) {
+            error = "单元格不存在: " + tableName + " " + rowKey + " " + family + ":" + qualifier;
+        }
+        return -1;
+    }
+    std::string partPath = path + ".part";
+    FILE* file = fopen(partPath.c_str(), "wb");
+    if (file == nullptr) {
+        close(id);
+        error = "无法创建文件: " + partPath;
+        return -1;
+    }
+    std::vector<uint8_t> chunk((size_t)std::min<int64_t>(SAVE_CHUNK_BYTES, std::max<int64_t>(length, 1)));
+    int64_t written = 0;
+    bool ok = true;
+    while (written < length) {
+        int64_t copied = read(id, written, chunk.data(), (int64_t)chunk.size(), error);
+        if (copied <= 0) {
+            if (copied == 0) {
+                error = "单元格在读取过程中变短";
+            }
+            ok = false;
+            break;
+        }
+        if (fwrite(chunk.data(), 1, (size_t)copied, file) != (size_t)copied) {
+            error = "写入文件失败: " + partPath;
+            ok = false;
+            break;
+        }
+        written += copied;
+    }
+    close(id);
+    if (fclose(file) != 0 && ok) {
+        error = "写入文件失败: " + partPath;
+        ok = false;
+    }
+    if (!ok || rename(partPath.c_str(), path.c_str()) != 0) {
+        remove(partPath.c_str());
+        if (ok) {
+            error = "无法重命名文件: " + partPath;
+        }
+        return -1;
+    }
+    BRIDGE_LOG_DEBUG("【单元格】已保存 " << written << " 字节到 " << path);
+    return written;
+}
+
+} // namespace cells
+} // namespace bridge
@@ -0,0 +1,43 @@
+#ifndef LARGE_CELL_H
+#define LARGE_CELL_H
+
+#include <stdint.h>
+#include <string>
+
+// 大值（如MOB列中数MB的值）的预览与按需读取。
+// 预览：结果集（getResultRows）中超过预览阈值（默认64KB）的值只返回前previewBytes字节，并同时给出完整长度，
+// 在渲染视口时截断。getTableData、queryTableData、getRow默认不截断，setPreviewBytes之后由Java层在编码JSON前
+// 按同一阈值截断。截断点落在UTF-8多字节字符中间时退到该字符之前。
+// 完整读取：打开一个单元格后按偏移分块复制到调用方的缓冲区，或由saveCell分块写入文件。
+// HBase的Get总是返回整个值，所以打开时值被取到Java层并保留到关闭，之后的分块读取不再访问集群。
+
+namespace bridge {
+namespace cells {
+
+// 预览阈值（字节），0表示不截断
+uint32_t previewBytes();
+
+// 设置预览阈值并同步到Java层
+bool setPreviewBytes(uint32_t bytes, std::string& error);
+
+// 长度为length的值截断到预览阈值后的长度（未超过阈值时为length），不切开UTF-8字符（最多退3字节）
+uint32_t previewLength(const char* value, uint32_t length);
+
+// 读取单元格（family:qualifier的最新版本）并保留在Java层，返回单元格ID，length为完整长度；
+// 单元格不存在时返回0，出错返回-1
+int64_t open(const std::string& tableName, const std::string& rowKey, const std::string& family,
+             const std::string& qualifier, int64_t& length, std::string& error);
+
+// 从offset开始复制最多size字节到buffer，返回复制的字节数（到达末尾为0），出错返回-1
+int64_t read(int64_t cellId, int64_t offset, uint8_t* buffer, int64_t size, std::string& error);
+
+void close(int64_t cellId);
+
+// 把单元格分块写入path（先写path.part，完成后重命名），返回写入的字节数；单元格不存在或出错返回-1
+int64_t save(const std::string& tableName, const std::string& rowKey, const std::string& family,
+             const std::string& qualifier, const std::string& path, std::string& error);
+
+} // namespace cells
+} // namespace bridge
+
+#endif // LARGE_CELL_H
@@ -0,0 +1,251 @@
+#include "memory_budget.h"
+#include "bridge_log.h"
+#include "cancel_token.h"
+#include "jni_support.h"
+#include "json_util.h"
+#include "spec_util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace bridge {
+namespace mem {
+
+namespace {
+
+// 阻塞等待时检查取消令牌的间隔
+const int WAIT_SLICE_MS = 100;
+
+std::mutex mutex;
+std::condition_variable changed;
+uint64_t globalLimit = 1ULL << 30;
+uint64_t operationLimit = 256ULL << 20;
+uint64_t queryBytes = 64ULL << 20;
+bool spill = true;
+std::string spillDir;
+uint64_t globalUsed = 0;
+uint64_t globalPeak = 0;
+std::set<Reservation*> live;
+// 已结束操作的累计量
+uint64_t finishedBlockedMicros = 0;
+uint64_t finishedSpilled = 0;
+
+// 调用方持有mutex
+bool fits(uint64_t used, uint64_t bytes) {
+    if (used == 0) {
+        return true; // 保证每个操作至少能持有一个批次
+    }
+    return (operationLimit == 0 || used + bytes <= operationLimit)
+        && (globalLimit == 0 || globalUsed + bytes <= globalLimit);
+}
+
+bool pushQueryBytes(uint64_t bytes, std::string& error) {
+    JNIEnv* env = currentEnv();
+    if (env == nullptr) {
+        error = "JVM未初始化";
+        return false;
+    }
+    jclass hbaseBridge = bridgeClass(env, "HBaseBridge");
+    if (hbaseBridge == nullptr) {
+        error = "无法找到HBaseBridge类";
+        return false;
+    }
+    jmethodID method = env->GetStaticMethodID(hbaseBridge, "configureMemory", "(J)V");
+    if (method == nullptr) {
+        clearPendingException(env, "HBaseBridge.configureMemory");
+        error = "无法找到configureMemory方法";
+        return false;
+    }
+    env->CallStaticVoidMethod(hbaseBridge, method, (jlong)bytes);
+    if (clearPendingException(env, "HBaseBridge.configureMemory")) {
+        error = "设置查询数据上限失败";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool setBudget(const std::string& spec, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(spec, entries, error)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t newGlobal = globalLimit;
+    uint64_t newOperation = operationLimit;
+    uint64_t newQuery = queryBytes;
+    bool newSpill = spill;
+    std::string newDir = spillDir;
+    bool queryGiven = false;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        bool ok = true;
+        if (key == "global") {
+            ok = spec::parseUint(value, newGlobal);
+        } else if (key == "operation") {
+            ok = spec::parseUint(value, newOperation);
+        } else if (key == "queryBytes") {
+            ok = spec::parseUint(value, newQuery);
+            queryGiven = true;
+        } else if (key == "spill") {
+            ok = spec::parseBool(value, newSpill);
+        } else if (key == "spillDir") {
+            newDir = value;
+        } else {
+            error = "未知的内存预算选项: " + key;
+            return false;
+        }
+        if (!ok) {
+            error = "内存预算选项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+    if (queryGiven && !pushQueryBytes(newQuery, error)) {
+        return false;
+    }
+    globalLimit = newGlobal;
+    operationLimit = newOperation;
+    queryBytes = newQuery;
+    spill = newSpill;
+    spillDir = newDir;
+    // 预算放宽时唤醒等待的生产者
+    changed.notify_all();
+    BRIDGE_LOG_INFO("【内存】全局预算 " << globalLimit << " 字节，单个操作 " << operationLimit
+                    << " 字节，溢出" << (spill ? "开启" : "关闭"));
+    return true;
+}
+
+bool spillEnabled() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return spill;
+}
+
+std::string spillDirectory() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!spillDir.empty()) {
+        return spillDir;
+    }
+    const char* tmp = getenv("TMPDIR");
+    return tmp != nullptr && *tmp != '\0' ? tmp : "/tmp";
+}
+
+Reservation::Reservation(const std::string& name)
+    : name_(name), used_(0), peak_(0), spilled_(0), blockedMicros_(0), aborted_(false) {
+    std::lock_guard<std::mutex> lock(mutex);
+    live.insert(this);
+}
+
+Reservation::~Reservation() {
+    std::lock_guard<std::mutex> lock(mutex);
+    globalUsed -= used_.load();
+    finishedBlockedMicros += blockedMicros_.load();
+    finishedSpilled += spilled_.load();
+    live.erase(this);
+    changed.notify_all();
+}
+
+bool Reservation::acquire(uint64_t bytes) {
+    const cancel::Token* token = cancel::current();
+    std::unique_lock<std::mutex> lock(mutex);
+    if (aborted_) {
+        return false;
+    }
+    if (!fits(used_.load(), bytes)) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while (!fits(used_.load(), bytes)) {
+            if (aborted_ || (token != nullptr && token->isAborted())) {
+                break;
+            }
+            changed.wait_for(lock, std::chrono::milliseconds(WAIT_SLICE_MS));
+        }
+        blockedMicros_ += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        if (aborted_ || !fits(used_.load(), bytes)) {
+            return false;
+        }
+    }
+    addLocked(bytes);
+    return true;
+}
+
+void Reservation::abort() {
+    std::lock_guard<std::mutex> lock(mutex);
+    aborted_ = true;
+    changed.notify_all();
+}
+
+bool Reservation::tryAcquire(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!fits(used_.load(), bytes)) {
+        return false;
+    }
+    addLocked(bytes);
+    return true;
+}
+
+void Reservation::force(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    addLocked(bytes);
+}
+
+void Reservation::addLocked(uint64_t bytes) {
+    used_ += bytes;
+    globalUsed += bytes;
+    if (used_.load() > peak_.load()) {
+        peak_ = used_.load();
+    }
+    if (globalUsed > globalPeak) {
+        globalPeak = globalUsed;
+    }
+}
+
+void Reservation::release(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    bytes = std::min(bytes, used_.load());
+    used_ -= bytes;
+    globalUsed -= bytes;
+    changed.notify_all();
+}
+
+void Reservation::addSpilled(uint64_t bytes) {
+    spilled_ += bytes;
+}
+
+std::string statsJson() {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t blocked = finishedBlockedMicros;
+    uint64_t spilled = finishedSpilled;
+    std::string operations;
+    for (std::set<Reservation*>::const_iterator it = live.begin(); it != live.end(); ++it) {
+        const Reservation& reservation = **it;
+        blocked += reservation.blockedMicros_.load();
+        spilled += reservation.spilled_.load();
+        char numbers[160];
+        snprintf(numbers, sizeof(numbers), ",\"used\":%llu,\"peak\":%llu,\"spilled\":%llu,\"blockedMs\":%llu}",
+                 (unsigned long long)reservation.used_.load(), (unsigned long long)reservation.peak_.load(),
+                 (unsigned long long)reservation.spilled_.load(),
+                 (unsigned long long)(reservation.blockedMicros_.load() / 1000));
+        operations += operations.empty() ? "[" : ",";
+        operations += "{\"name\":" + json::quote(reservation.name_) + numbers;
+    }
+    operations += operations.empty() ? "[]" : "]";
+    char numbers[320];
+    snprintf(numbers, sizeof(numbers),
+             "{\"global\":{\"limit\":%llu,\"used\":%llu,\"peak\":%llu},\"operationLimit\":%llu,\"queryBytes\":%llu,"
+             "\"spill\":%s,\"blockedMs\":%llu,\"spilledBytes\":%llu,\"operations\":",
+             (unsigned long long)globalLimit, (unsigned long long)globalUsed, (unsigned long long)globalPeak,
+             (unsigned long long)operationLimit, (unsigned long long)queryBytes, spill ? "true" : "false",
+             (unsigned long long)(blocked / 1000), (unsigned long long)spilled);
+    return numbers + operations + "}";
+}
+
+} // namespace mem
+} // namespace bridge
@@ -0,0 +1,82 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+// 桥接层扫描数据的内存预算。流水线中排队的批次（导出、复制）与结果集的arena都按字节记账：
+//   全局预算  所有操作合计的上限
+//   操作预算  单个操作（一个导出、一个复制或一个结果集）的上限
+// 流水线的生产者（扫描）在超出预算时阻塞，直到下游写出批次后释放，从而让扫描速度跟随消费速度；
+// 结果集不会被消费，超出预算后新分配的块改为映射到临时文件（见spill），由操作系统按需换出，
+// 关闭溢出时结果集在批次边界停止填充并标记truncated。
+// 一个操作至少可以持有一个批次，单个批次超过预算也不会永远阻塞。
+//
+// 预算规格（key=value，以 ; 或 & 分隔）：
+//   global=字节        全局预算，默认1GB，0表示不限
+//   operation=字节     单个操作的预算，默认256MB，0表示不限
+//   spill=true|false   结果集超出预算时是否溢出到临时文件，默认true
+//   spillDir=目录      临时文件目录，默认TMPDIR或/tmp
+//   queryBytes=字节    Java层getTableData/queryTableData单次返回的JSON数据上限，默认64MB，0表示不限
+
+namespace bridge {
+namespace mem {
+
+bool setBudget(const std::string& spec, std::string& error);
+
+bool spillEnabled();
+std::string spillDirectory();
+
+// 一个操作的内存记账，析构时归还尚未释放的字节
+class Reservation {
+public:
+    // name为统计中显示的操作类别（如export、results）
+    explicit Reservation(const std::string& name);
+    ~Reservation();
+
+    // 等待预算允许后记入bytes；当前线程的操作被取消或超时、或已调用abort时返回false（不记账）
+    bool acquire(uint64_t bytes);
+
+    // 中止：唤醒阻塞在acquire中的线程，之后的acquire都返回false。
+    // 流水线某个环节失败时调用，否则等待下游释放的生产者会一直阻塞
+    void abort();
+
+    // 不等待，超出预算时返回false（不记账）
+    bool tryAcquire(uint64_t bytes);
+
+    // 不检查预算直接记入（超出预算后仍必须分配时使用）
+    void force(uint64_t bytes);
+
+    void release(uint64_t bytes);
+
+    // 记录溢出到临时文件的字节数
+    void addSpilled(uint64_t bytes);
+
+    uint64_t used() const { return used_.load(); }
+
+private:
+    Reservation(const Reservation&);
+    Reservation& operator=(const Reservation&);
+
+    friend std::string statsJson();
+
+    // 调用方持有预算的锁
+    void addLocked(uint64_t bytes);
+
+    const std::string name_;
+    std::atomic<uint64_t> used_;
+    std::atomic<uint64_t> peak_;
+    std::atomic<uint64_t> spilled_;
+    std::atomic<uint64_t> blockedMicros_;
+    std::atomic<bool> aborted_;
+};
+
+// {"global":{"limit":..,"used":..,"peak":..},"operationLimit":..,"spill":..,"blockedMs":..,"spilledBytes":..,
+//  "operations":[{"name":..,"used":..,"peak":..,"spilled":..,"blockedMs":..},..]}
+std::string statsJson();
+
+} // namespace mem
+} // namespace bridge
+
+#endif // MEMORY_BUDGET_H
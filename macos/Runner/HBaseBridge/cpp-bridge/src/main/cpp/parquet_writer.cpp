@@ -0,0 +1,311 @@
+#include "parquet_writer.h"
+
+namespace bridge {
+namespace parquet {
+
+namespace {
+
+const char MAGIC[] = "PAR1";
+
+// Thrift Compact Protocol类型编码
+const uint8_t CT_I32 = 5;
+const uint8_t CT_I64 = 6;
+const uint8_t CT_BINARY = 8;
+const uint8_t CT_LIST = 9;
+const uint8_t CT_STRUCT = 12;
+
+// parquet.thrift 中用到的枚举值
+const int PAGE_DATA = 0;
+const int ENCODING_PLAIN = 0;
+const int ENCODING_RLE = 3;
+const int CODEC_UNCOMPRESSED = 0;
+const int REPETITION_REQUIRED = 0;
+
+// 只实现写入Parquet元数据所需的那部分Compact Protocol
+class CompactWriter {
+public:
+    explicit CompactWriter(std::string& out) : out_(out), lastField_(0) {}
+
+    void i32(int16_t field, int32_t value) {
+        header(field, CT_I32);
+        varint(zigzag(value));
+    }
+
+    void i64(int16_t field, int64_t value) {
+        header(field, CT_I64);
+        varint(zigzag(value));
+    }
+
+    void binary(int16_t field, const std::string& value) {
+        header(field, CT_BINARY);
+        rawBinary(value);
+    }
+
+    void structBegin(int16_t field) {
+        header(field, CT_STRUCT);
+        listStructBegin();
+    }
+
+    // 列表中的结构体元素没有字段头
+    void listStructBegin() {
+        stack_.push_back(lastField_);
+        lastField_ = 0;
+    }
+
+    void structEnd() {
+        out_ += (char)0; // STOP
+        lastField_ = stack_.back();
+        stack_.pop_back();
+    }
+
+    void listBegin(int16_t field, uint8_t elementType, size_t size) {
+        header(field, CT_LIST);
+        if (size < 15) {
+            out_ += (char)((size << 4) | elementType);
+        } else {
+            out_ += (char)(0xf0 | elementType);
+            varint(size);
+        }
+    }
+
+    void rawI32(int32_t value) { varint(zigzag(value)); }
+
+    void rawBinary(const std::string& value) {
+        varint(value.size());
+        out_ += value;
+    }
+
+    // 顶层结构体结束
+    void stop() { out_ += (char)0; }
+
+private:
+    static uint64_t zigzag(int64_t value) {
+        return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            out_ += (char)((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        out_ += (char)value;
+    }
+
+    void header(int16_t field, uint8_t type) {
+        int delta = field - lastField_;
+        if (delta > 0 && delta <= 15) {
+            out_ += (char)((delta << 4) | type);
+        } else {
+            out_ += (char)type;
+            varint(zigzag(field));
+        }
+        lastField_ = field;
+    }
+
+    std::string& out_;
+    int16_t lastField_;
+    std::vector<int16_t> stack_;
+};
+
+} // namespace
+
+void appendByteArray(std::string& out, const char* data, uint32_t length) {
+    char prefix[4] = {(char)length, (char)(length >> 8), (char)(length >> 16), (char)(length >> 24)};
+    out.append(prefix, 4);
+    out.append(data, length);
+}
+
+void appendInt64(std::string& out, int64_t value) {
+    uint64_t v = (uint64_t)value;
+    char bytes[8];
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = (char)(v >> (8 * i));
+    }
+    out.append(bytes, 8);
+}
+
+FileWriter::FileWriter(const std::vector<Column>& schema, size_t pageBytes, size_t rowGroupBytes)
+    : schema_(schema), pageBytes_(pageBytes), rowGroupBytes_(rowGroupBytes), file_(nullptr), offset_(0),
+      chunks_(schema.size()), rowGroupRows_(0), totalRows_(0) {
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+        chunks_[i].pageValues = 0;
+        chunks_[i].chunkValues = 0;
+    }
+}
+
+FileWriter::~FileWriter() {
+    if (file_ != nullptr) {
+        fclose(file_);
+    }
+}
+
+bool FileWriter::open(const std::string& path, std::string& error) {
+    file_ = fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        error = "无法创建文件: " + path;
+        return false;
+    }
+    return writeRaw(std::string(MAGIC, 4), error);
+}
+
+bool FileWriter::writeRaw(const std::string& data, std::string& error) {
+    if (fwrite(data.data(), 1, data.size(), file_) != data.size()) {
+        error = "写入Parquet文件失败";
+        return false;
+    }
+    offset_ += data.size();
+    return true;
+}
+
+void FileWriter::finishPage(ColumnChunk& chunk) {
+    if (chunk.pageValues == 0) {
+        return;
+    }
+    std::string header;
+    CompactWriter writer(header);
+    writer.i32(1, PAGE_DATA);
+    writer.i32(2, (int32_t)chunk.page.size());
+    writer.i32(3, (int32_t)chunk.page.size());
+    writer.structBegin(5); // DataPageHeader
+    writer.i32(1, (int32_t)chunk.pageValues);
+    writer.i32(2, ENCODING_PLAIN);
+    writer.i32(3, ENCODING_RLE);
+    writer.i32(4, ENCODING_RLE);
+    writer.structEnd();
+    writer.stop();
+
+    chunk.pages += header;
+    chunk.pages += chunk.page;
+    chunk.page.clear();
+    chunk.pageValues = 0;
+}
+
+bool FileWriter::append(const std::vector<std::string>& columns, uint64_t rows, std::string& error) {
+    if (columns.size() != chunks_.size()) {
+        error = "Parquet列数与schema不一致";
+        return false;
+    }
+    size_t buffered = 0;
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+        ColumnChunk& chunk = chunks_[i];
+        chunk.page += columns[i];
+        chunk.pageValues += rows;
+        chunk.chunkValues += rows;
+        if (chunk.page.size() >= pageBytes_) {
+            finishPage(chunk);
+        }
+        buffered += chunk.pages.size() + chunk.page.size();
+    }
+    rowGroupRows_ += rows;
+    totalRows_ += rows;
+    return buffered >= rowGroupBytes_ ? flushRowGroup(error) : true;
+}
+
+bool FileWriter::flushRowGroup(std::string& error) {
+    if (rowGroupRows_ == 0) {
+        return true;
+    }
+    RowGroupMeta group;
+    group.totalBytes = 0;
+    group.rows = (int64_t)rowGroupRows_;
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+        ColumnChunk& chunk = chunks_[i];
+        finishPage(chunk);
+        ChunkMeta meta;
+        meta.dataPageOffset = (int64_t)offset_;
+        meta.size = (int64_t)chunk.pages.size();
+        meta.values = (int64_t)chunk.chunkValues;
+        if (!writeRaw(chunk.pages, error)) {
+            return false;
+        }
+        group.columns.push_back(meta);
+        group.totalBytes += meta.size;
+        // 释放内存，下一个行组重新分配
+        std::string().swap(chunk.pages);
+        chunk.chunkValues = 0;
+    }
+    rowGroups_.push_back(group);
+    rowGroupRows_ = 0;
+    return true;
+}
+
+std::string FileWriter::encodeFooter() const {
+    std::string footer;
+    CompactWriter writer(footer);
+    writer.i32(1, 1); // version
+
+    writer.listBegin(2, CT_STRUCT, schema_.size() + 1);
+    writer.listStructBegin(); // 根节点
+    writer.binary(4, "schema");
+    writer.i32(5, (int32_t)schema_.size());
+    writer.structEnd();
+    for (size_t i = 0; i < schema_.size(); ++i) {
+        writer.listStructBegin();
+        writer.i32(1, schema_[i].type);
+        writer.i32(3, REPETITION_REQUIRED);
+        writer.binary(4, schema_[i].name);
+        if (schema_[i].convertedType != CONVERTED_NONE) {
+            writer.i32(6, schema_[i].convertedType);
+        }
+        writer.structEnd();
+    }
+
+    writer.i64(3, (int64_t)totalRows_);
+
+    writer.listBegin(4, CT_STRUCT, rowGroups_.size());
+    for (size_t g = 0; g < rowGroups_.size(); ++g) {
+        const RowGroupMeta& group = rowGroups_[g];
+        writer.listStructBegin();
+        writer.listBegin(1, CT_STRUCT, group.columns.size());
+        for (size_t i = 0; i < group.columns.size(); ++i) {
+            const ChunkMeta& chunk = group.columns[i];
+            writer.listStructBegin(); // ColumnChunk
+            writer.i64(2, chunk.dataPageOffset);
+            writer.structBegin(3); // ColumnMetaData
+            writer.i32(1, schema_[i].type);
+            writer.listBegin(2, CT_I32, 2);
+            writer.rawI32(ENCODING_PLAIN);
+            writer.rawI32(ENCODING_RLE);
+            writer.listBegin(3, CT_BINARY, 1);
+            writer.rawBinary(schema_[i].name);
+            writer.i32(4, CODEC_UNCOMPRESSED);
+            writer.i64(5, chunk.values);
+            writer.i64(6, chunk.size);
+            writer.i64(7, chunk.size);
+            writer.i64(9, chunk.dataPageOffset);
+            writer.structEnd();
+            writer.structEnd();
+        }
+        writer.i64(2, group.totalBytes);
+        writer.i64(3, group.rows);
+        writer.structEnd();
+    }
+
+    writer.binary(6, "hbase-gui bridge");
+    writer.stop();
+    return footer;
+}
+
+bool FileWriter::close(std::string& error) {
+    if (file_ == nullptr) {
+        return true;
+    }
+    bool ok = flushRowGroup(error);
+    if (ok) {
+        std::string footer = encodeFooter();
+        uint32_t length = (uint32_t)footer.size();
+        char lengthBytes[4] = {(char)length, (char)(length >> 8), (char)(length >> 16), (char)(length >> 24)};
+        footer.append(lengthBytes, 4);
+        footer.append(MAGIC, 4);
+        ok = writeRaw(footer, error);
+    }
+    if (fclose(file_) != 0 && ok) {
+        error = "关闭Parquet文件失败";
+        ok = false;
+    }
+    file_ = nullptr;
+    return ok;
+}
+
+} // namespace parquet
+} // namespace bridge
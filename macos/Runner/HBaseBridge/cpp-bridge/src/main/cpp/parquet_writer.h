@@ -0,0 +1,92 @@
+#ifndef PARQUET_WRITER_H
+#define PARQUET_WRITER_H
+
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// 最小化的Parquet文件写入器：扁平schema、全部REQUIRED列、PLAIN编码、不压缩。
+// 元数据使用Thrift Compact Protocol编码，符合Parquet格式规范，
+// 可被pyarrow、Spark、DuckDB等直接读取。
+
+namespace bridge {
+namespace parquet {
+
+// 物理类型（parquet.thrift Type）
+const int TYPE_INT64 = 2;
+const int TYPE_BYTE_ARRAY = 6;
+
+// 逻辑类型标注（parquet.thrift ConvertedType），-1表示无
+const int CONVERTED_NONE = -1;
+const int CONVERTED_UTF8 = 0;
+const int CONVERTED_TIMESTAMP_MILLIS = 9;
+
+struct Column {
+    std::string name;
+    int type;
+    int convertedType;
+};
+
+// PLAIN编码的辅助函数，编码线程可用它们直接生成列数据
+void appendByteArray(std::string& out, const char* data, uint32_t length);
+void appendInt64(std::string& out, int64_t value);
+
+class FileWriter {
+public:
+    FileWriter(const std::vector<Column>& schema, size_t pageBytes, size_t rowGroupBytes);
+    ~FileWriter();
+
+    bool open(const std::string& path, std::string& error);
+
+    // 追加rows行，columns[i]为第i列这些行的PLAIN编码值
+    bool append(const std::vector<std::string>& columns, uint64_t rows, std::string& error);
+
+    // 写出剩余数据与文件尾，关闭文件
+    bool close(std::string& error);
+
+    uint64_t bytesWritten() const { return offset_; }
+
+private:
+    FileWriter(const FileWriter&);
+    FileWriter& operator=(const FileWriter&);
+
+    struct ColumnChunk {
+        std::string pages;     // 已完成页（页头+数据）
+        std::string page;      // 正在填充的页数据
+        uint64_t pageValues;
+        uint64_t chunkValues;
+    };
+
+    struct ChunkMeta {
+        int64_t dataPageOffset;
+        int64_t size;
+        int64_t values;
+    };
+
+    struct RowGroupMeta {
+        std::vector<ChunkMeta> columns;
+        int64_t totalBytes;
+        int64_t rows;
+    };
+
+    void finishPage(ColumnChunk& chunk);
+    bool flushRowGroup(std::string& error);
+    bool writeRaw(const std::string& data, std::string& error);
+    std::string encodeFooter() const;
+
+    std::vector<Column> schema_;
+    size_t pageBytes_;
+    size_t rowGroupBytes_;
+    FILE* file_;
+    uint64_t offset_;
+    std::vector<ColumnChunk> chunks_;
+    uint64_t rowGroupRows_;
+    uint64_t totalRows_;
+    std::vector<RowGroupMeta> rowGroups_;
+};
+
+} // namespace parquet
+} // namespace bridge
+
+#endif // PARQUET_WRITER_H
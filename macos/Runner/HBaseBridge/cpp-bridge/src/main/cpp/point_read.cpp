@@ -0,0 +1,96 @@
+#include "point_read.h"
+#include "jni_support.h"
+#include "spec_util.h"
+
+#include <mutex>
+
+namespace bridge {
+
+namespace {
+
+std::mutex optionsMutex;
+PointReadOptions currentOptions;
+
+} // namespace
+
+PointReadOptions::PointReadOptions()
+    : hedge(false), percentile(95), minHedgeMs(5), maxRetries(0), backoffMs(50), maxBackoffMs(1000) {
+}
+
+bool parsePointReadOptions(const std::string& text, PointReadOptions& options, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(text, entries, error)) {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        uint64_t number = 0;
+        bool ok = true;
+        if (key == "hedge") {
+            ok = spec::parseBool(value, options.hedge);
+        } else if (key == "percentile") {
+            ok = spec::parseUint(value, number) && number >= 50 && number <= 99;
+            options.percentile = (int)number;
+        } else if (key == "minHedgeMs") {
+            ok = spec::parseUint(value, number) && number <= 60000;
+            options.minHedgeMs = (int64_t)number;
+        } else if (key == "maxRetries") {
+            ok = spec::parseUint(value, number) && number <= 10;
+            options.maxRetries = (int)number;
+        } else if (key == "backoffMs") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 60000;
+            options.backoffMs = (int64_t)number;
+        } else if (key == "maxBackoffMs") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 600000;
+            options.maxBackoffMs = (int64_t)number;
+        } else {
+            error = "未知的单行读取选项: " + key;
+            return false;
+        }
+        if (!ok) {
+            error = "单行读取选项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+    if (options.maxBackoffMs < options.backoffMs) {
+        error = "maxBackoffMs不能小于backoffMs";
+        return false;
+    }
+    return true;
+}
+
+bool setPointReadOptions(const std::string& text, std::string& error) {
+    std::lock_guard<std::mutex> lock(optionsMutex);
+    PointReadOptions options = currentOptions;
+    if (!parsePointReadOptions(text, options, error)) {
+        return false;
+    }
+    JNIEnv* env = currentEnv();
+    if (env == nullptr) {
+        error = "JVM未初始化";
+        return false;
+    }
+    jclass hbaseBridge = bridgeClass(env, "HBaseBridge");
+    if (hbaseBridge == nullptr) {
+        error = "无法找到HBaseBridge类";
+        return false;
+    }
+    jmethodID method = env->GetStaticMethodID(hbaseBridge, "configurePointReads", "(ZIJIJJ)V");
+    if (method == nullptr) {
+        clearPendingException(env, "HBaseBridge.configurePointReads");
+        error = "无法找到configurePointReads方法";
+        return false;
+    }
+    env->CallStaticVoidMethod(hbaseBridge, method, (jboolean)(options.hedge ? JNI_TRUE : JNI_FALSE),
+        (jint)options.percentile, (jlong)options.minHedgeMs, (jint)options.maxRetries,
+        (jlong)options.backoffMs, (jlong)options.maxBackoffMs);
+    if (clearPendingException(env, "HBaseBridge.configurePointReads")) {
+        error = "设置单行读取选项失败";
+        return false;
+    }
+    currentOptions = options;
+    return true;
+}
+
+} // namespace bridge
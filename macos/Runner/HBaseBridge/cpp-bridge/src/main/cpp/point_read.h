@@ -0,0 +1,37 @@
+#ifndef POINT_READ_H
+#define POINT_READ_H
+
+#include <stdint.h>
+#include <string>
+
+// 单行读取（getRow以及Java层executeCommand的get）的对冲与重试设置，实现在Java层的PointReads。
+// 默认关闭对冲与重试，只读主副本一次；读取失败直接返回错误。
+//
+// 选项字符串（key=value，以 ; 或 & 分隔），每次只修改给出的项：
+//   hedge         true时主副本超过阈值仍未返回，向只读副本（timeline一致性）发对冲请求
+//   percentile    对冲阈值取近期主副本延迟的百分位（默认95），被取消的主副本请求按已等待时间计入
+//   minHedgeMs    对冲阈值的下限（默认5）
+//   maxRetries    两条路径都失败后的重试次数（默认0，即不重试）
+//   backoffMs / maxBackoffMs  重试的指数退避基数与上限（默认50/1000），实际等待随机取其50%~100%
+
+namespace bridge {
+
+struct PointReadOptions {
+    bool hedge;
+    int percentile;
+    int64_t minHedgeMs;
+    int maxRetries;
+    int64_t backoffMs;
+    int64_t maxBackoffMs;
+
+    PointReadOptions();
+};
+
+bool parsePointReadOptions(const std::string& text, PointReadOptions& options, std::string& error);
+
+// 在当前设置上应用选项字符串并下发到Java层
+bool setPointReadOptions(const std::string& text, std::string& error);
+
+} // namespace bridge
+
+#endif // POINT_READ_H
@@ -0,0 +1,300 @@
+#include "qos.h"
+#include "bridge_log.h"
+#include "cell_codec.h"
+#include "json_util.h"
+#include "rate_limiter.h"
+#include "spec_util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace bridge {
+namespace qos {
+
+namespace {
+
+const char* const METRIC_NAMES[METRIC_COUNT] = {"rows", "bytes", "rpcs"};
+const std::string INTERACTIVE = "interactive";
+
+// 速率统计的窗口：按秒分桶的环，报告最近RATE_SECONDS个完整的秒
+const int WINDOW_SLOTS = 8;
+const int RATE_SECONDS = 5;
+
+// 一个操作类别或一个连接的计数与限速
+struct Entry {
+    std::atomic<uint64_t> totals[METRIC_COUNT];
+    std::atomic<uint64_t> throttledMicros;
+    TokenBucket buckets[METRIC_COUNT];
+
+    std::mutex windowMutex;
+    int64_t windowSecond[WINDOW_SLOTS];
+    uint64_t windowAmount[WINDOW_SLOTS][METRIC_COUNT];
+
+    Entry() : throttledMicros(0) {
+        for (int m = 0; m < METRIC_COUNT; ++m) {
+            totals[m] = 0;
+        }
+        for (int s = 0; s < WINDOW_SLOTS; ++s) {
+            windowSecond[s] = -1;
+            for (int m = 0; m < METRIC_COUNT; ++m) {
+                windowAmount[s][m] = 0;
+            }
+        }
+    }
+};
+
+typedef std::map<std::string, std::shared_ptr<Entry> > EntryMap;
+
+std::mutex registryMutex;
+EntryMap classes;
+EntryMap connections; // 键为集群名，主连接为空串
+
+// 客户端默认的单次扫描RPC结果上限（hbase.client.scanner.max.result.size），
+// Java层同步扫描未设置caching，按返回的字节数估算请求数
+const uint64_t SCAN_RESULT_BYTES = 2 * 1024 * 1024;
+
+thread_local const std::string* currentName = nullptr;
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+int64_t currentSecond() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+std::shared_ptr<Entry> lookup(EntryMap& map, const std::string& name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::shared_ptr<Entry>& entry = map[name];
+    if (!entry) {
+        entry = std::make_shared<Entry>();
+    }
+    return entry;
+}
+
+// 记入计数并取令牌，返回需要等待的秒数
+double account(Entry& entry, const uint64_t amounts[METRIC_COUNT]) {
+    int64_t second = currentSecond();
+    {
+        std::lock_guard<std::mutex> lock(entry.windowMutex);
+        int slot = (int)(second % WINDOW_SLOTS);
+        if (entry.windowSecond[slot] != second) {
+            entry.windowSecond[slot] = second;
+            for (int m = 0; m < METRIC_COUNT; ++m) {
+                entry.windowAmount[slot][m] = 0;
+            }
+        }
+        for (int m = 0; m < METRIC_COUNT; ++m) {
+            entry.windowAmount[slot][m] += amounts[m];
+        }
+    }
+    double wait = 0;
+    for (int m = 0; m < METRIC_COUNT; ++m) {
+        entry.totals[m].fetch_add(amounts[m], std::memory_order_relaxed);
+        if (amounts[m] != 0) {
+            wait = std::max(wait, entry.buckets[m].reserve((double)amounts[m]));
+        }
+    }
+    return wait;
+}
+
+void appendEntry(std::string& out, const std::string& name, Entry& entry) {
+    double rates[METRIC_COUNT] = {0, 0, 0};
+    int64_t second = currentSecond();
+    {
+        std::lock_guard<std::mutex> lock(entry.windowMutex);
+        for (int s = 0; s < WINDOW_SLOTS; ++s) {
+            int64_t age = second - entry.windowSecond[s];
+            if (entry.windowSecond[s] >= 0 && age >= 1 && age <= RATE_SECONDS) {
+                for (int m = 0; m < METRIC_COUNT; ++m) {
+                    rates[m] += (double)entry.windowAmount[s][m];
+                }
+            }
+        }
+    }
+    // 刚开始统计时不足RATE_SECONDS秒，按实际经过的完整秒数平均
+    int64_t span = std::max<int64_t>(1, std::min<int64_t>(second, RATE_SECONDS));
+    char numbers[384];
+    snprintf(numbers, sizeof(numbers),
+             "{\"rows\":%llu,\"bytes\":%llu,\"rpcs\":%llu,\"rowsPerSecond\":%.1f,\"bytesPerSecond\":%.1f,"
+             "\"rpcsPerSecond\":%.1f,\"throttledMs\":%llu,\"limits\":{\"rows\":%.17g,\"bytes\":%.17g,\"rpcs\":%.17g}}",
+             (unsigned long long)entry.totals[METRIC_ROWS].load(),
+             (unsigned long long)entry.totals[METRIC_BYTES].load(),
+             (unsigned long long)entry.totals[METRIC_RPCS].load(),
+             rates[METRIC_ROWS] / span, rates[METRIC_BYTES] / span, rates[METRIC_RPCS] / span,
+             (unsigned long long)(entry.throttledMicros.load() / 1000),
+             entry.buckets[METRIC_ROWS].rate(), entry.buckets[METRIC_BYTES].rate(),
+             entry.buckets[METRIC_RPCS].rate());
+    out += json::quote(name);
+    out += ':';
+    out += numbers;
+}
+
+void appendMap(std::string& out, const EntryMap& map, bool connectionNames) {
+    out += '{';
+    bool first = true;
+    for (EntryMap::const_iterator it = map.begin(); it != map.end(); ++it) {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+        appendEntry(out, connectionNames ? "@" + it->first : it->first, *it->second);
+    }
+    out += '}';
+}
+
+} // namespace
+
+ClassScope::ClassScope(const jobs::Job& job)
+    : previousName_(currentName), name_(job.kind()), tokenScope_(&job.token()) {
+    currentName = &name_;
+}
+
+ClassScope::ClassScope(const std::string& name)
+    : previousName_(currentName), name_(name), tokenScope_(nullptr) {
+    currentName = &name_;
+}
+
+ClassScope::~ClassScope() {
+    currentName = previousName_;
+}
+
+const std::string& currentClass() {
+    return currentName ? *currentName : INTERACTIVE;
+}
+
+bool setLimits(const std::string& spec, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(spec, entries, error)) {
+        return false;
+    }
+    struct Limit {
+        bool connection;
+        std::string name;
+        int metric;
+        double rate;
+    };
+    std::vector<Limit> limits;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        size_t dot = key.rfind('.');
+        Limit limit;
+        limit.metric = -1;
+        if (dot != std::string::npos) {
+            for (int m = 0; m < METRIC_COUNT; ++m) {
+                if (key.compare(dot + 1, std::string::npos, METRIC_NAMES[m]) == 0) {
+                    limit.metric = m;
+                }
+            }
+        }
+        if (limit.metric < 0 || dot == 0) {
+            error = "未知的限速选项: " + key;
+            return false;
+        }
+        limit.connection = key[0] == '@';
+        limit.name = key.substr(limit.connection ? 1 : 0, dot - (limit.connection ? 1 : 0));
+        if (!spec::parseDouble(entries[i].second, limit.rate) || limit.rate < 0) {
+            error = "限速选项取值无效: " + key + "=" + entries[i].second;
+            return false;
+        }
+        limits.push_back(limit);
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    EntryMap* maps[2] = {&classes, &connections};
+    for (int k = 0; k < 2; ++k) {
+        for (EntryMap::iterator it = maps[k]->begin(); it != maps[k]->end(); ++it) {
+            for (int m = 0; m < METRIC_COUNT; ++m) {
+                it->second->buckets[m].setRate(0);
+            }
+        }
+    }
+    for (size_t i = 0; i < limits.size(); ++i) {
+        std::shared_ptr<Entry>& entry = (limits[i].connection ? connections : classes)[limits[i].name];
+        if (!entry) {
+            entry = std::make_shared<Entry>();
+        }
+        entry->buckets[limits[i].metric].setRate(limits[i].rate);
+    }
+    log::write(log::LEVEL_INFO, "限速已更新: " + (spec.empty() ? std::string("不限") : spec));
+    return true;
+}
+
+void charge(const std::string& cluster, uint64_t rows, uint64_t bytes, uint64_t rpcs) {
+    uint64_t amounts[METRIC_COUNT] = {rows, bytes, rpcs};
+    std::shared_ptr<Entry> byClass = lookup(classes, currentClass());
+    std::shared_ptr<Entry> byConnection = lookup(connections, cluster);
+    double seconds = std::max(account(*byClass, amounts), account(*byConnection, amounts));
+    if (seconds <= 0) {
+        return;
+    }
+    // 分段睡眠以便及时响应取消与截止时间
+    const cancel::Token* token = cancel::current();
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point until = begin + std::chrono::microseconds((int64_t)(seconds * 1e6));
+    std::chrono::steady_clock::time_point now = begin;
+    while (now < until && !(token != nullptr && token->isAborted())) {
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(until - now,
+            std::chrono::milliseconds(100)));
+        now = std::chrono::steady_clock::now();
+    }
+    uint64_t micros = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(now - begin).count();
+    byClass->throttledMicros.fetch_add(micros, std::memory_order_relaxed);
+    byConnection->throttledMicros.fetch_add(micros, std::memory_order_relaxed);
+}
+
+uint64_t countRows(const std::vector<uint8_t>& batch) {
+    codec::BatchReader reader(batch.data(), batch.size());
+    codec::CellView cell;
+    uint64_t rows = 0;
+    const char* lastRow = nullptr;
+    uint32_t lastLength = 0;
+    while (reader.next(cell)) {
+        // 同一行的cell连续出现
+        if (lastRow == nullptr || cell.rowLength != lastLength
+            || (cell.row != lastRow && memcmp(cell.row, lastRow, lastLength) != 0)) {
+            ++rows;
+            lastRow = cell.row;
+            lastLength = cell.rowLength;
+        }
+    }
+    return rows;
+}
+
+void chargeJson(const std::string& cluster, const char* json, bool scan) {
+    if (json == nullptr) {
+        return;
+    }
+    uint64_t bytes = strlen(json);
+    uint64_t rows = 0;
+    static const char ROW_KEY[] = "\"row\":";
+    for (const char* p = strstr(json, ROW_KEY); p != nullptr; p = strstr(p + sizeof(ROW_KEY) - 1, ROW_KEY)) {
+        ++rows;
+    }
+    uint64_t rpcs = scan ? 1 + bytes / SCAN_RESULT_BYTES : 1;
+    charge(cluster, std::max<uint64_t>(rows, 1), bytes, rpcs);
+}
+
+std::string statsJson() {
+    EntryMap classCopy;
+    EntryMap connectionCopy;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        classCopy = classes;
+        connectionCopy = connections;
+    }
+    std::string out = "{\"classes\":";
+    appendMap(out, classCopy, false);
+    out += ",\"connections\":";
+    appendMap(out, connectionCopy, true);
+    out += '}';
+    return out;
+}
+
+} // namespace qos
+} // namespace bridge
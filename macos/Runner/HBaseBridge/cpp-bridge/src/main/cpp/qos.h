@@ -0,0 +1,77 @@
+#ifndef QOS_H
+#define QOS_H
+
+#include "job_registry.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// 桥接层访问集群的限速与流量统计。所有批量扫描（ScannerReader）与批量写入（TableWriter）
+// 都经过这里：按操作类别与连接分别累计行数、字节数与请求数，并按令牌桶限速。
+// 在Java层一次完成、直接返回JSON的同步调用（getTableData、queryTableData、getTableVersions、
+// getRow、getRowColumns、getRowVersions、executeCommand）由C++包装在返回后按结果估算记入（见chargeJson）。
+//
+// 操作类别是当前线程所属任务的kind（export、import、copy、aggregate等），由任务线程与
+// 各模块的工作线程通过ClassScope设置；不属于任何任务的访问归入interactive。
+// 连接为主连接或connectPeer的集群名。
+//
+// 限速规格（key=value，以 ; 或 & 分隔），key为 目标.指标：
+//   目标  操作类别名，或 @集群名（单独的 @ 表示主连接）
+//   指标  rows | bytes | rpcs（每秒）
+// 例如 export.bytes=20000000;copy.rows=50000;@.rpcs=200。值为0表示不限。
+// 每次设置替换全部限速。一次访问同时受所属类别与所属连接的限制。
+// 请求数按桥接层发起的调用估算：扫描一批为 行数/caching（至少1），写入一批为1。
+// 同步调用的限速只能在结果返回之后等待，超出限速时推迟的是本次返回与之后的调用，不会打断已完成的读取。
+
+namespace bridge {
+namespace qos {
+
+enum Metric {
+    METRIC_ROWS,
+    METRIC_BYTES,
+    METRIC_RPCS,
+    METRIC_COUNT
+};
+
+// 设置当前线程的操作类别，析构时恢复；按任务设置时同时绑定任务的取消令牌，
+// 限速等待、扫描与写入都可以被取消或截止时间打断
+class ClassScope {
+public:
+    explicit ClassScope(const jobs::Job& job);
+    explicit ClassScope(const std::string& name);
+    ~ClassScope();
+
+private:
+    ClassScope(const ClassScope&);
+    ClassScope& operator=(const ClassScope&);
+
+    const std::string* previousName_;
+    std::string name_;
+    cancel::TokenScope tokenScope_;
+};
+
+// 当前线程的操作类别（未设置时为interactive）
+const std::string& currentClass();
+
+bool setLimits(const std::string& spec, std::string& error);
+
+// 记录一次访问并按限速等待
+void charge(const std::string& cluster, uint64_t rows, uint64_t bytes, uint64_t rpcs);
+
+// 记录一次Java层同步调用的结果并按限速等待：行数按JSON中"row"键的个数估算（至少1），
+// 字节数为JSON长度；请求数扫描按每2MB结果一次（至少1），单行读写为1
+void chargeJson(const std::string& cluster, const char* json, bool scan);
+
+// cell_codec批次中的行数
+uint64_t countRows(const std::vector<uint8_t>& batch);
+
+// 各类别与连接的累计量、最近5秒的速率、被限速等待的时间与当前限速：
+// {"classes":{"export":{"rows":..,"bytes":..,"rpcs":..,"rowsPerSecond":..,"bytesPerSecond":..,
+//   "rpcsPerSecond":..,"throttledMs":..,"limits":{"rows":..,"bytes":..,"rpcs":..}},..},"connections":{"@":{..},..}}
+std::string statsJson();
+
+} // namespace qos
+} // namespace bridge
+
+#endif // QOS_H
@@ -0,0 +1,61 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <chrono>
+#include <mutex>
+
+namespace bridge {
+
+// 令牌桶：每秒补充rate个令牌，最多积累burst个。
+// 取令牌时先扣除（允许欠账），欠账部分按速率折算为需要等待的时间，
+// 因此一次取很多（例如一个大批次的字节数）也能得到正确的平均速率。
+// rate<=0表示不限速。可以被多个线程共享。
+class TokenBucket {
+public:
+    explicit TokenBucket(double rate = 0, double burst = 0) { setRate(rate, burst); }
+
+    // burst<=0时为一秒的量
+    void setRate(double rate, double burst = 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rate_ = rate;
+        burst_ = burst > 0 ? burst : rate;
+        tokens_ = burst_;
+        last_ = std::chrono::steady_clock::now();
+    }
+
+    double rate() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rate_;
+    }
+
+    // 取count个令牌，返回调用方需要等待的秒数（0表示不用等）
+    double reserve(double count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (rate_ <= 0) {
+            return 0;
+        }
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - last_).count();
+        last_ = now;
+        tokens_ += elapsed * rate_;
+        if (tokens_ > burst_) {
+            tokens_ = burst_;
+        }
+        tokens_ -= count;
+        return tokens_ >= 0 ? 0 : -tokens_ / rate_;
+    }
+
+private:
+    TokenBucket(const TokenBucket&);
+    TokenBucket& operator=(const TokenBucket&);
+
+    mutable std::mutex mutex_;
+    double rate_;
+    double burst_;
+    double tokens_;
+    std::chrono::steady_clock::time_point last_;
+};
+
+} // namespace bridge
+
+#endif // RATE_LIMITER_H
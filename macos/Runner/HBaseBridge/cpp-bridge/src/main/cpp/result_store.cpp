@@ -0,0 +1,518 @@
+#include "result_store.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cell_codec.h"
+#include "json_util.h"
+#include "large_cell.h"
+#include "spec_util.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace bridge {
+namespace results {
+
+namespace {
+
+std::mutex registryMutex;
+std::map<int64_t, std::shared_ptr<ResultStore> > registry;
+
+} // namespace
+
+Arena::~Arena() {
+    for (size_t i = 0; i < mappings_.size(); ++i) {
+        munmap(mappings_[i].first, mappings_[i].second);
+    }
+    if (spillFd_ >= 0) {
+        close(spillFd_);
+    }
+}
+
+char* Arena::allocate(size_t size) {
+    bytes_ += size;
+    if (!reservation_.tryAcquire(size)) {
+        if (mem::spillEnabled()) {
+            char* block = allocateSpill(size);
+            if (block != nullptr) {
+                return block;
+            }
+        }
+        reservation_.force(size);
+        overBudget_ = true;
+    }
+    heap_.push_back(std::unique_ptr<char[]>(new char[size]));
+    return heap_.back().get();
+}
+
+char* Arena::allocateSpill(size_t size) {
+    if (spillFd_ < 0) {
+        std::string path = mem::spillDirectory() + "/hbase-bridge-results-XXXXXX";
+        std::vector<char> name(path.begin(), path.end());
+        name.push_back('\0');
+        spillFd_ = mkstemp(name.data());
+        if (spillFd_ < 0) {
+            BRIDGE_LOG_WARN("【结果集】无法创建溢出文件: " << path);
+            return nullptr;
+        }
+        unlink(name.data());
+        BRIDGE_LOG_INFO("【结果集】超出内存预算，后续数据溢出到临时文件");
+    }
+    // 映射的偏移必须按页对齐
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t length = (size + page - 1) / page * page;
+    off_t offset = (off_t)spilled_;
+    if (ftruncate(spillFd_, offset + (off_t)length) != 0) {
+        return nullptr;
+    }
+    void* block = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, spillFd_, offset);
+    if (block == MAP_FAILED) {
+        return nullptr;
+    }
+    mappings_.push_back(std::make_pair(block, length));
+    spilled_ += length;
+    reservation_.addSpilled(length);
+    return static_cast<char*>(block);
+}
+
+const char* Arena::copy(const char* data, size_t length) {
+    if (length == 0) {
+        return "";
+    }
+    if (length > BLOCK_SIZE / 4) {
+        // 大值单独分配，不浪费当前块的剩余空间
+        char* target = allocate(length);
+        memcpy(target, data, length);
+        return target;
+    }
+    if (current_ == nullptr || used_ + length > BLOCK_SIZE) {
+        current_ = allocate(BLOCK_SIZE);
+        used_ = 0;
+    }
+    char* target = current_ + used_;
+    memcpy(target, data, length);
+    used_ += length;
+    return target;
+}
+
+uint32_t ResultStore::columnId(const char* family, uint32_t familyLength, const char* qualifier,
+                               uint32_t qualifierLength) {
+    columnKey_.assign(family, familyLength);
+    columnKey_ += ':';
+    columnKey_.append(qualifier, qualifierLength);
+    std::unordered_map<std::string, uint32_t>::iterator it = columnIds_.find(columnKey_);
+    if (it != columnIds_.end()) {
+        return it->second;
+    }
+    uint32_t id = (uint32_t)columns_.size();
+    columns_.push_back(Column());
+    columns_.back().name = columnKey_;
+    columnIds_[columnKey_] = id;
+    return id;
+}
+
+uint64_t ResultStore::append(const std::vector<uint8_t>& batch, uint64_t maxRows, std::string& error) {
+    trace::Span span("results.append");
+    std::lock_guard<std::mutex> lock(mutex_);
+    codec::BatchReader reader(batch.data(), batch.size());
+    codec::CellView cell;
+    uint64_t added = 0;
+    while (reader.next(cell)) {
+        if (rowKeys_.empty() || rowKeyLengths_.back() != cell.rowLength
+            || memcmp(rowKeys_.back(), cell.row, cell.rowLength) != 0) {
+            if (maxRows > 0 && rowKeys_.size() >= maxRows) {
+                break;
+            }
+            rowKeys_.push_back(arena_.copy(cell.row, cell.rowLength));
+            rowKeyLengths_.push_back(cell.rowLength);
+            ++added;
+        }
+        uint32_t row = (uint32_t)rowKeys_.size() - 1;
+        Column& column = columns_[columnId(cell.family, cell.familyLength, cell.qualifier, cell.qualifierLength)];
+        if (!column.rows.empty() && column.rows.back() == row) {
+            continue; // 多版本时只保留最新版本（扫描结果中排在前面）
+        }
+        column.rows.push_back(row);
+        column.values.push_back(arena_.copy(cell.value, cell.valueLength));
+        column.lengths.push_back(cell.valueLength);
+        column.timestamps.push_back(cell.timestamp);
+        maxTimestamp_ = std::max(maxTimestamp_, cell.timestamp);
+    }
+    if (reader.hasError()) {
+        error = reader.error();
+    }
+    return added;
+}
+
+void ResultStore::setSource(const ScanRange& range, uint64_t maxRows) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    range_ = range;
+    maxRows_ = maxRows;
+}
+
+int64_t ResultStore::findRow(const char* key, uint32_t length) {
+    // 填充得到的行按行键（无符号字节序）递增
+    uint64_t low = 0;
+    uint64_t high = scannedRows_;
+    while (low < high) {
+        uint64_t middle = low + (high - low) / 2;
+        uint32_t middleLength = rowKeyLengths_[middle];
+        int order = memcmp(rowKeys_[middle], key, std::min(middleLength, length));
+        if (order == 0) {
+            order = middleLength < length ? -1 : (middleLength > length ? 1 : 0);
+        }
+        if (order == 0) {
+            return (int64_t)middle;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    std::unordered_map<std::string, uint32_t>::const_iterator it = refreshedRows_.find(std::string(key, length));
+    return it != refreshedRows_.end() ? (int64_t)it->second : -1;
+}
+
+bool ResultStore::beginRefresh(ScanRange& range, std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!complete_) {
+        error = "结果集仍在填充，不能刷新";
+        return false;
+    }
+    if (refreshing_) {
+        error = "结果集正在刷新";
+        return false;
+    }
+    refreshing_ = true;
+    range = range_;
+    range.minTime = std::max(range.minTime, maxTimestamp_);
+    return true;
+}
+
+void ResultStore::endRefresh() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refreshing_ = false;
+}
+
+void ResultStore::merge(const std::vector<uint8_t>& batch, MergeStats& stats, std::string& error) {
+    trace::Span span("results.merge");
+    std::lock_guard<std::mutex> lock(mutex_);
+    codec::BatchReader reader(batch.data(), batch.size());
+    codec::CellView cell;
+    const char* currentKey = nullptr; // 当前行在批次中的行键
+    uint32_t currentLength = 0;
+    int64_t row = -1;
+    while (reader.next(cell)) {
+        if (currentKey == nullptr || currentLength != cell.rowLength
+            || memcmp(currentKey, cell.row, cell.rowLength) != 0) {
+            currentKey = cell.row;
+            currentLength = cell.rowLength;
+            row = findRow(cell.row, cell.rowLength);
+            if (row < 0) {
+                if (maxRows_ > 0 && rowKeys_.size() >= maxRows_) {
+                    ++stats.skippedRows;
+                } else {
+                    row = (int64_t)rowKeys_.size();
+                    rowKeys_.push_back(arena_.copy(cell.row, cell.rowLength));
+                    rowKeyLengths_.push_back(cell.rowLength);
+                    refreshedRows_[std::string(cell.row, cell.rowLength)] = (uint32_t)row;
+                    ++stats.newRows;
+                }
+            }
+        }
+        if (row < 0) {
+            continue;
+        }
+        maxTimestamp_ = std::max(maxTimestamp_, cell.timestamp);
+        Column& column = columns_[columnId(cell.family, cell.familyLength, cell.qualifier, cell.qualifierLength)];
+        std::vector<uint32_t>::iterator it = std::lower_bound(column.rows.begin(), column.rows.end(),
+            (uint32_t)row);
+        size_t index = it - column.rows.begin();
+        if (it != column.rows.end() && *it == (uint32_t)row) {
+            // 已有的cell只被更新的版本替换；同一时间戳只在值不同时替换（覆盖写入）
+            int64_t timestamp = column.timestamps[index];
+            if (cell.timestamp < timestamp || (cell.timestamp == timestamp
+                && column.lengths[index] == cell.valueLength
+                && memcmp(column.values[index], cell.value, cell.valueLength) == 0)) {
+                continue;
+            }
+            column.values[index] = arena_.copy(cell.value, cell.valueLength);
+            column.lengths[index] = cell.valueLength;
+            column.timestamps[index] = cell.timestamp;
+            ++stats.updatedCells;
+            continue;
+        }
+        // 新行的行号最大，追加在列末尾；已有行中的新列需要插入到行号对应的位置
+        column.rows.insert(it, (uint32_t)row);
+        column.values.insert(column.values.begin() + index, arena_.copy(cell.value, cell.valueLength));
+        column.lengths.insert(column.lengths.begin() + index, cell.valueLength);
+        column.timestamps.insert(column.timestamps.begin() + index, cell.timestamp);
+        ++stats.newCells;
+    }
+    if (reader.hasError()) {
+        error = reader.error();
+    }
+}
+
+decode::Format ResultStore::formatOf(const std::string& name) const {
+    std::map<std::string, decode::Format>::const_iterator it = formats_.find(name);
+    return it != formats_.end() ? it->second : defaultFormat_;
+}
+
+bool ResultStore::setFormats(const std::string& spec, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(spec, entries, error)) {
+        return false;
+    }
+    std::vector<std::pair<std::string, decode::Format> > parsed;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        decode::Format format;
+        if (entries[i].first.empty() || !decode::parseFormat(entries[i].second, format)) {
+            error = "列格式无效: " + entries[i].first + "=" + entries[i].second;
+            return false;
+        }
+        parsed.push_back(std::make_pair(entries[i].first, format));
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < parsed.size(); ++i) {
+        if (parsed[i].first == "*") {
+            defaultFormat_ = parsed[i].second;
+        } else {
+            formats_[parsed[i].first] = parsed[i].second;
+        }
+    }
+    return true;
+}
+
+void ResultStore::markComplete() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    complete_ = true;
+    scannedRows_ = rowKeys_.size();
+}
+
+bool ResultStore::overBudget() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return arena_.overBudget();
+}
+
+std::string ResultStore::infoJson() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    char number[160];
+    snprintf(number, sizeof(number), "{\"rows\":%llu,\"columns\":[", (unsigned long long)rowKeys_.size());
+    std::string json = number;
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (i > 0) {
+            json += ',';
+        }
+        json += '"';
+        json::appendText(json, columns_[i].name.data(), columns_[i].name.size());
+        json += '"';
+    }
+    snprintf(number, sizeof(number),
+        "],\"complete\":%s,\"bytes\":%llu,\"spilledBytes\":%llu,\"truncated\":%s,\"maxTimestamp\":%lld",
+        complete_ ? "true" : "false", (unsigned long long)arena_.bytes(),
+        (unsigned long long)arena_.spilledBytes(), arena_.overBudget() ? "true" : "false",
+        (long long)maxTimestamp_);
+    json += number;
+    if (hasView_) {
+        snprintf(number, sizeof(number), ",\"viewRows\":%llu", (unsigned long long)view_.size());
+        json += number;
+    }
+    json += '}';
+    return json;
+}
+
+std::string ResultStore::rowsJson(uint64_t firstRow, uint32_t rowCount, uint32_t firstColumn, uint32_t columnCount) {
+    trace::Span span("results.rows");
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t endRow = std::min<uint64_t>(firstRow + rowCount, hasView_ ? view_.size() : rowKeys_.size());
+    uint32_t endColumn = (uint32_t)std::min<uint64_t>((uint64_t)firstColumn + columnCount, columns_.size());
+    if (firstRow >= endRow) {
+        char number[64];
+        snprintf(number, sizeof(number), "{\"firstRow\":%llu,\"rows\":[]}", (unsigned long long)firstRow);
+        return number;
+    }
+    size_t height = (size_t)(endRow - firstRow);
+    size_t width = firstColumn < endColumn ? endColumn - firstColumn : 0;
+
+    // 逐列定位到视口内的行，填入行优先的网格
+    std::vector<int64_t> grid(height * width, -1);
+    for (uint32_t c = firstColumn; c < endColumn; ++c) {
+        const Column& column = columns_[c];
+        if (hasView_) {
+            // 视图中的行号不连续，逐行二分查找
+            for (size_t r = 0; r < height; ++r) {
+                uint32_t row = view_[firstRow + r];
+                std::vector<uint32_t>::const_iterator it = std::lower_bound(column.rows.begin(),
+                    column.rows.end(), row);
+                if (it != column.rows.end() && *it == row) {
+                    grid[r * width + (c - firstColumn)] = it - column.rows.begin();
+                }
+            }
+            continue;
+        }
+        std::vector<uint32_t>::const_iterator it = std::lower_bound(column.rows.begin(), column.rows.end(),
+            (uint32_t)firstRow);
+        for (; it != column.rows.end() && *it < endRow; ++it) {
+            grid[(*it - firstRow) * width + (c - firstColumn)] = it - column.rows.begin();
+        }
+    }
+
+    // 逐列解码渲染（行键作为第0列），再按行拼接
+    std::vector<std::string> rendered(width + 1);
+    std::vector<std::vector<size_t> > ends(width + 1);
+    std::vector<const char*> cellValues(height);
+    std::vector<uint32_t> cellLengths(height);
+    for (size_t r = 0; r < height; ++r) {
+        size_t row = hasView_ ? view_[firstRow + r] : firstRow + r;
+        cellValues[r] = rowKeys_[row];
+        cellLengths[r] = rowKeyLengths_[row];
+    }
+    decode::renderColumn(formatOf("rowkey"), cellValues.data(), cellLengths.data(), height, rendered[0], ends[0]);
+    // 超过预览阈值的值只渲染前面部分，完整长度另外列出
+    uint32_t preview = cells::previewBytes();
+    std::string truncated;
+    for (size_t c = 0; c < width; ++c) {
+        const Column& column = columns_[firstColumn + c];
+        for (size_t r = 0; r < height; ++r) {
+            int64_t index = grid[r * width + c];
+            cellValues[r] = index < 0 ? nullptr : column.values[index];
+            cellLengths[r] = index < 0 ? 0 : column.lengths[index];
+            if (preview > 0 && cellLengths[r] > preview) {
+                char entry[80];
+                snprintf(entry, sizeof(entry), "%s[%llu,%llu,%llu]", truncated.empty() ? "" : ",",
+                         (unsigned long long)(firstRow + r), (unsigned long long)(firstColumn + c),
+                         (unsigned long long)cellLengths[r]);
+                truncated += entry;
+                cellLengths[r] = cells::previewLength(cellValues[r], cellLengths[r]);
+            }
+        }
+        decode::renderColumn(formatOf(column.name), cellValues.data(), cellLengths.data(), height,
+            rendered[c + 1], ends[c + 1]);
+    }
+
+    char number[64];
+    snprintf(number, sizeof(number), "{\"firstRow\":%llu,\"rows\":[", (unsigned long long)firstRow);
+    std::string json = number;
+    for (size_t r = 0; r < height; ++r) {
+        json += r == 0 ? "[" : ",[";
+        for (size_t c = 0; c <= width; ++c) {
+            if (c > 0) {
+                json += ',';
+            }
+            size_t begin = r == 0 ? 0 : ends[c][r - 1];
+            json.append(rendered[c], begin, ends[c][r] - begin);
+        }
+        json += ']';
+    }
+    json += ']';
+    if (!truncated.empty()) {
+        json += ",\"truncated\":[" + truncated + "]";
+    }
+    json += '}';
+    return json;
+}
+
+bool fill(ResultStore& store, const ScanRange& range, uint64_t maxRows, jobs::Job& job, std::string& error) {
+    store.setSource(range, maxRows);
+    ScannerReader reader;
+    if (!reader.open(range, error)) {
+        return false;
+    }
+    std::vector<uint8_t> batch;
+    uint64_t rows = 0;
+    bool ok = true;
+    while (maxRows == 0 || rows < maxRows) {
+        if (job.isCancelRequested()) {
+            ok = false;
+            break;
+        }
+        if (!reader.next(batch, error)) {
+            ok = error.empty();
+            break;
+        }
+        uint64_t added = store.append(batch, maxRows, error);
+        if (!error.empty()) {
+            ok = false;
+            break;
+        }
+        rows += added;
+        job.rows.fetch_add(added);
+        job.bytesRead.fetch_add(batch.size());
+        if (store.overBudget()) {
+            BRIDGE_LOG_WARN("【结果集】超出内存预算，停止填充，已缓存 " << rows << " 行");
+            break;
+        }
+    }
+    reader.close();
+    store.markComplete();
+    return ok;
+}
+
+bool refresh(ResultStore& store, jobs::Job& job, std::string& error) {
+    ScanRange range;
+    if (!store.beginRefresh(range, error)) {
+        return false;
+    }
+    ScannerReader reader;
+    if (!reader.open(range, error)) {
+        store.endRefresh();
+        return false;
+    }
+    MergeStats stats;
+    bool ok = true;
+    std::vector<uint8_t> batch;
+    while (true) {
+        if (job.isCancelRequested()) {
+            ok = false;
+            break;
+        }
+        if (!reader.next(batch, error)) {
+            ok = error.empty();
+            break;
+        }
+        store.merge(batch, stats, error);
+        if (!error.empty()) {
+            ok = false;
+            break;
+        }
+        job.rows.store(stats.newRows);
+        job.cells.store(stats.newCells + stats.updatedCells);
+        job.bytesRead.fetch_add(batch.size());
+    }
+    reader.close();
+    store.endRefresh();
+    char result[200];
+    snprintf(result, sizeof(result),
+        "{\"newRows\":%llu,\"newCells\":%llu,\"updatedCells\":%llu,\"skippedRows\":%llu,\"minTime\":%lld}",
+        (unsigned long long)stats.newRows, (unsigned long long)stats.newCells,
+        (unsigned long long)stats.updatedCells, (unsigned long long)stats.skippedRows, (long long)range.minTime);
+    job.setResult(result);
+    BRIDGE_LOG_INFO("【结果集】增量刷新 " << range.tableName << "：新增 " << stats.newRows << " 行，新列 "
+        << stats.newCells << "，更新 " << stats.updatedCells);
+    return ok;
+}
+
+void put(int64_t id, const std::shared_ptr<ResultStore>& store) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry[id] = store;
+}
+
+std::shared_ptr<ResultStore> find(int64_t id) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::map<int64_t, std::shared_ptr<ResultStore> >::iterator it = registry.find(id);
+    return it != registry.end() ? it->second : std::shared_ptr<ResultStore>();
+}
+
+void release(int64_t id) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.erase(id);
+}
+
+} // namespace results
+} // namespace bridge
@@ -0,0 +1,171 @@
+#ifndef RESULT_STORE_H
+#define RESULT_STORE_H
+
+#include "job_registry.h"
+#include "memory_budget.h"
+#include "result_view.h"
+#include "scanner_reader.h"
+#include "value_decoder.h"
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 浏览用的列式结果集：扫描结果保存在桥接层，界面只按视口取需要显示的行列，
+// 避免把整个结果解码成Dart对象。
+//   行键与值复制到按块分配的arena中，插入后地址不变；
+//   列按 family:qualifier 字典编码为列号（按首次出现的顺序）；
+//   每列只保存有值的行：行号数组（递增）+ 值指针/长度，按行区间访问时二分定位。
+// 后台任务边扫描边追加，填充期间也可以读取已到达的部分。
+// 每列可以指定显示格式（见value_decoder.h），读取视口时按列解码。
+// 增量刷新：记录已见到的最大时间戳，只扫描不早于它的cell（时间范围扫描），合并到已有的行列中：
+//   已有的cell按时间戳替换值（旧值留在arena中，随结果集释放），新列插入对应行，新行追加在末尾；
+//   删除与写入时显式指定了较早时间戳的cell不会被增量扫描看到，需要重新打开结果集。
+
+namespace bridge {
+namespace results {
+
+// 按块分配、整体释放的内存池。分配的块记入内存预算（见memory_budget.h），
+// 超出预算后新块映射到临时文件（文件在创建后即删除，随进程或结果集释放而回收）；
+// 关闭溢出时仍在堆上分配并标记overBudget，由填充方停止追加
+class Arena {
+public:
+    Arena() : reservation_("results"), current_(nullptr), used_(0), bytes_(0), spilled_(0),
+              spillFd_(-1), overBudget_(false) {}
+    ~Arena();
+
+    const char* copy(const char* data, size_t length);
+    size_t bytes() const { return bytes_; }
+    size_t spilledBytes() const { return spilled_; }
+    bool overBudget() const { return overBudget_; }
+
+private:
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    static const size_t BLOCK_SIZE = 1 << 20;
+
+    char* allocate(size_t size);
+    char* allocateSpill(size_t size);
+
+    mem::Reservation reservation_;
+    std::vector<std::unique_ptr<char[]> > heap_;
+    std::vector<std::pair<void*, size_t> > mappings_; // 溢出到临时文件的块
+    char* current_; // 当前块
+    size_t used_;   // 当前块已用字节
+    size_t bytes_;  // 已分配的总字节
+    size_t spilled_;
+    int spillFd_;
+    bool overBudget_;
+};
+
+// 一次增量刷新合并的结果
+struct MergeStats {
+    uint64_t newRows;
+    uint64_t newCells;     // 已有行中新出现的列
+    uint64_t updatedCells; // 值或时间戳有变化的cell
+    uint64_t skippedRows;  // 超出maxRows未加入的新行
+
+    MergeStats() : newRows(0), newCells(0), updatedCells(0), skippedRows(0) {}
+};
+
+class ResultStore {
+public:
+    ResultStore() : maxRows_(0), maxTimestamp_(0), scannedRows_(0), defaultFormat_(decode::FORMAT_AUTO),
+                    viewGeneration_(0), hasView_(false), complete_(false), refreshing_(false) {}
+
+    // 记录填充所用的扫描范围与行数上限，增量刷新沿用
+    void setSource(const ScanRange& range, uint64_t maxRows);
+
+    // 追加一个cell_codec批次，行数达到maxRows后不再追加，返回新增的行数
+    uint64_t append(const std::vector<uint8_t>& batch, uint64_t maxRows, std::string& error);
+
+    void markComplete();
+
+    // 开始增量刷新：填充未完成或已有刷新在进行时返回false；
+    // range为填充的扫描范围，下界收紧到已见到的最大时间戳（含，同一毫秒内的后续写入不会遗漏）
+    bool beginRefresh(ScanRange& range, std::string& error);
+    void endRefresh();
+
+    // 把增量扫描的批次合并到已有数据中
+    void merge(const std::vector<uint8_t>& batch, MergeStats& stats, std::string& error);
+
+    // 超出内存预算且未能溢出到临时文件，填充应停止
+    bool overBudget();
+
+    // {"rows":..,"columns":["cf:q",..],"complete":..,"bytes":..,"spilledBytes":..,"truncated":..,
+    //  "maxTimestamp":..}，设置了视图时另有"viewRows"
+    std::string infoJson();
+
+    // 视口内的数据：{"firstRow":..,"rows":[["行键","值"或null,..],..]}，列按列号区间。
+    // 设置了视图时行号是视图中的位置。超过预览阈值（见large_cell.h）的值被截断，
+    // 另有"truncated":[[行号,列号,完整长度],..]
+    std::string rowsJson(uint64_t firstRow, uint32_t rowCount, uint32_t firstColumn, uint32_t columnCount);
+
+    // 设置列格式：spec为 列=格式 列表，列名为 family:qualifier、rowkey，或 * 表示其余所有列；
+    // 只修改spec中出现的列。还未出现的列也可以预先指定
+    bool setFormats(const std::string& spec, std::string& error);
+
+    // 按规格过滤、排序，生成行号排列作为视图（见result_view.h）；规格为空时恢复扫描顺序。
+    // 视图只包含生成时已到达的行（刷新新增的行需要重新生成视图），rows返回视图行数。
+    // 过滤与排序不持有结果集的锁，完成后替换旧视图；期间再次调用时以最后一次为准
+    bool applyView(const ViewSpec& spec, uint64_t& rows, std::string& error);
+
+private:
+    ResultStore(const ResultStore&);
+    ResultStore& operator=(const ResultStore&);
+
+    struct Column {
+        std::string name;
+        std::vector<uint32_t> rows;
+        std::vector<const char*> values;
+        std::vector<uint32_t> lengths;
+        std::vector<int64_t> timestamps;
+    };
+
+    uint32_t columnId(const char* family, uint32_t familyLength, const char* qualifier, uint32_t qualifierLength);
+    // 行键对应的行号，不存在时返回-1
+    int64_t findRow(const char* key, uint32_t length);
+    decode::Format formatOf(const std::string& name) const;
+
+    std::mutex mutex_;
+    Arena arena_;
+    std::vector<const char*> rowKeys_;
+    std::vector<uint32_t> rowKeyLengths_;
+    ScanRange range_;
+    uint64_t maxRows_;
+    int64_t maxTimestamp_;
+    uint64_t scannedRows_; // 填充得到的行数，这些行按行键有序，可二分查找
+    std::unordered_map<std::string, uint32_t> refreshedRows_; // 刷新追加的行键 -> 行号
+    std::vector<Column> columns_;
+    std::unordered_map<std::string, uint32_t> columnIds_;
+    std::string columnKey_; // columnId查找时复用的缓冲
+    std::map<std::string, decode::Format> formats_; // 列名（或rowkey）-> 显示格式
+    decode::Format defaultFormat_;
+    std::vector<uint32_t> view_; // 视图位置 -> 行号
+    uint64_t viewGeneration_;    // 每次applyView递增，只有最新的一次替换视图
+    bool hasView_;
+    bool complete_;
+    bool refreshing_;
+};
+
+// 在任务线程中扫描range填充结果集，最多maxRows行（0表示不限）
+bool fill(ResultStore& store, const ScanRange& range, uint64_t maxRows, jobs::Job& job, std::string& error);
+
+// 在任务线程中增量刷新结果集，合并计数写入任务结果：
+// {"newRows":..,"newCells":..,"updatedCells":..,"skippedRows":..,"minTime":..}
+bool refresh(ResultStore& store, jobs::Job& job, std::string& error);
+
+// 结果集注册表，ID与填充它的任务ID相同
+void put(int64_t id, const std::shared_ptr<ResultStore>& store);
+std::shared_ptr<ResultStore> find(int64_t id);
+void release(int64_t id);
+
+} // namespace results
+} // namespace bridge
+
+#endif // RESULT_STORE_H
@@ -0,0 +1,539 @@
+#include "result_store.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "scheduler.h"
+#include "spec_util.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace bridge {
+namespace results {
+
+namespace {
+
+const uint32_t NO_VALUE = UINT32_MAX;
+
+// 行数少于此值时单线程处理，线程开销不划算
+const size_t PARALLEL_MIN_ROWS = 65536;
+
+// threads选项的上限
+const int MAX_VIEW_THREADS = 8;
+
+// 某列在每一行的取值，行键列直接按行号取。值指针与长度是在锁内复制的快照（值本身在arena中，地址不变），
+// 过滤与排序在锁外进行时不受填充追加与刷新合并的影响
+struct ColumnValues {
+    std::vector<const char*> values;
+    std::vector<uint32_t> lengths;
+    std::vector<uint32_t> slots; // 行号 -> 值下标，NO_VALUE表示该行没有值
+    bool rowKey;
+    decode::Format format; // 列格式为long/int/double时数值按定长二进制解码
+
+    bool get(uint32_t row, const char*& data, uint32_t& length) const {
+        uint32_t index = rowKey ? row : slots[row];
+        if (index == NO_VALUE) {
+            return false;
+        }
+        data = values[index];
+        length = lengths[index];
+        return true;
+    }
+};
+
+int compareBytes(const char* a, uint32_t aLength, const char* b, uint32_t bLength) {
+    int c = memcmp(a, b, std::min(aLength, bLength));
+    if (c != 0) {
+        return c;
+    }
+    return aLength < bLength ? -1 : aLength > bLength ? 1 : 0;
+}
+
+int compareText(const char* a, uint32_t aLength, const char* b, uint32_t bLength) {
+    uint32_t length = std::min(aLength, bLength);
+    for (uint32_t i = 0; i < length; ++i) {
+        unsigned char x = (unsigned char)a[i];
+        unsigned char y = (unsigned char)b[i];
+        if (x >= 'A' && x <= 'Z') x += 'a' - 'A';
+        if (y >= 'A' && y <= 'Z') y += 'a' - 'A';
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+    return aLength < bLength ? -1 : aLength > bLength ? 1 : 0;
+}
+
+// 一组并行段。调度器中的工作与调用线程都从这里认领段执行，调用线程认领完剩余的段后
+// 只等待已被认领、正在执行的段，因此normal队列排满时也不会互相等待
+struct SegmentBatch {
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<bool> claimed;
+    int running;
+    const std::function<void(int)>* segment; // 只在认领到段后使用，此时调用方一定还在等待
+};
+
+void drainSegments(const std::shared_ptr<SegmentBatch>& batch) {
+    while (true) {
+        int index = -1;
+        {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            for (size_t i = 0; i < batch->claimed.size(); ++i) {
+                if (!batch->claimed[i]) {
+                    batch->claimed[i] = true;
+                    index = (int)i;
+                    ++batch->running;
+                    break;
+                }
+            }
+        }
+        if (index < 0) {
+            return;
+        }
+        (*batch->segment)(index);
+        std::lock_guard<std::mutex> lock(batch->mutex);
+        if (--batch->running == 0) {
+            batch->finished.notify_all();
+        }
+    }
+}
+
+// 并行执行segment(0..count-1)：count-1段提交到结果集所属的调度队列，调用线程也参与，全部完成后返回
+void runSegments(int count, const std::function<void(int)>& segment) {
+    if (count <= 1) {
+        for (int i = 0; i < count; ++i) {
+            segment(i);
+        }
+        return;
+    }
+    std::shared_ptr<SegmentBatch> batch = std::make_shared<SegmentBatch>();
+    batch->claimed.assign(count, false);
+    batch->running = 0;
+    batch->segment = &segment;
+    sched::Priority priority = sched::priorityOf("results");
+    for (int i = 1; i < count; ++i) {
+        sched::submit(priority, [batch]() { drainSegments(batch); });
+    }
+    drainSegments(batch);
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&batch] { return batch->running == 0; });
+}
+
+// 把[0, count)分成threads段并行执行body(begin, end, 段号)
+void parallelRanges(size_t count, int threads, const std::function<void(size_t, size_t, int)>& body) {
+    if (threads <= 1 || count < PARALLEL_MIN_ROWS) {
+        body(0, count, 0);
+        return;
+    }
+    runSegments(threads, [count, threads, &body](int t) {
+        body(count * t / threads, count * (t + 1) / threads, t);
+    });
+}
+
+// 分段并行排序后两两并行归并。比较器以行号兜底，结果与线程数无关
+template <class Less>
+void parallelSort(std::vector<uint32_t>& order, const Less& less, int threads) {
+    size_t n = order.size();
+    if (threads <= 1 || n < PARALLEL_MIN_ROWS) {
+        std::sort(order.begin(), order.end(), less);
+        return;
+    }
+    std::vector<size_t> bounds;
+    for (int t = 0; t <= threads; ++t) {
+        bounds.push_back(n * t / threads);
+    }
+    runSegments(threads, [&order, &bounds, &less](int t) {
+        std::sort(order.begin() + bounds[t], order.begin() + bounds[t + 1], less);
+    });
+
+    std::vector<uint32_t> buffer(n);
+    while (bounds.size() > 2) {
+        std::vector<size_t> next;
+        size_t pairs = 0;
+        size_t i = 0;
+        for (; i + 2 < bounds.size(); i += 2) {
+            next.push_back(bounds[i]);
+            ++pairs;
+        }
+        if (i + 1 < bounds.size()) {
+            // 段数为奇数，最后一段原样保留
+            std::copy(order.begin() + bounds[i], order.begin() + bounds[i + 1], buffer.begin() + bounds[i]);
+            next.push_back(bounds[i]);
+        }
+        next.push_back(n);
+        runSegments((int)pairs, [&order, &buffer, &bounds, &less](int p) {
+            size_t begin = bounds[2 * p];
+            size_t middle = bounds[2 * p + 1];
+            size_t end = bounds[2 * p + 2];
+            std::merge(order.begin() + begin, order.begin() + middle, order.begin() + middle,
+                order.begin() + end, buffer.begin() + begin, less);
+        });
+        order.swap(buffer);
+        bounds.swap(next);
+    }
+}
+
+// 数值键：有值的排在前面，相等时按行号
+template <class T>
+struct NumericLess {
+    const T* keys;
+    const uint8_t* present;
+    bool descending;
+
+    bool operator()(uint32_t a, uint32_t b) const {
+        if (present[a] != present[b]) {
+            return present[a] > present[b];
+        }
+        if (present[a] && keys[a] != keys[b]) {
+            return descending ? keys[a] > keys[b] : keys[a] < keys[b];
+        }
+        return a < b;
+    }
+};
+
+struct TextLess {
+    const ColumnValues* values;
+    bool ignoreCase;
+    bool descending;
+
+    bool operator()(uint32_t a, uint32_t b) const {
+        const char* aData = nullptr;
+        const char* bData = nullptr;
+        uint32_t aLength = 0;
+        uint32_t bLength = 0;
+        bool aPresent = values->get(a, aData, aLength);
+        bool bPresent = values->get(b, bData, bLength);
+        if (aPresent != bPresent) {
+            return aPresent;
+        }
+        if (aPresent) {
+            int c = ignoreCase ? compareText(aData, aLength, bData, bLength)
+                               : compareBytes(aData, aLength, bData, bLength);
+            if (c != 0) {
+                return descending ? c > 0 : c < 0;
+            }
+        }
+        return a < b;
+    }
+};
+
+struct CompiledFilter {
+    const FilterSpec* spec;
+    const ColumnValues* values;
+    ValueType type;
+    int64_t longValue;
+    double doubleValue;
+};
+
+bool matches(const CompiledFilter& filter, uint32_t row) {
+    const char* data = nullptr;
+    uint32_t length = 0;
+    bool present = filter.values->get(row, data, length);
+    const std::string& expected = filter.spec->value;
+    switch (filter.spec->op) {
+    case FILTER_EXISTS:
+        return present;
+    case FILTER_MISSING:
+        return !present;
+    case FILTER_PREFIX:
+        return present && length >= expected.size() && memcmp(data, expected.data(), expected.size()) == 0;
+    case FILTER_CONTAINS:
+        return present && std::search(data, data + length, expected.begin(), expected.end()) != data + length;
+    default:
+        break;
+    }
+    if (!present) {
+        return false;
+    }
+
+    int c = 0;
+    switch (filter.type) {
+    case VALUE_LONG: {
+        int64_t value;
+        if (!decode::asLong(filter.values->format, data, length, value)) {
+            return false;
+        }
+        c = value < filter.longValue ? -1 : value > filter.longValue ? 1 : 0;
+        break;
+    }
+    case VALUE_DOUBLE: {
+        double value;
+        if (!decode::asDouble(filter.values->format, data, length, value)) {
+            return false;
+        }
+        c = value < filter.doubleValue ? -1 : value > filter.doubleValue ? 1 : 0;
+        break;
+    }
+    case VALUE_BYTES:
+        c = compareBytes(data, length, expected.data(), (uint32_t)expected.size());
+        break;
+    default:
+        c = compareText(data, length, expected.data(), (uint32_t)expected.size());
+        break;
+    }
+    switch (filter.spec->op) {
+    case FILTER_EQ: return c == 0;
+    case FILTER_NE: return c != 0;
+    case FILTER_LT: return c < 0;
+    case FILTER_LE: return c <= 0;
+    case FILTER_GT: return c > 0;
+    case FILTER_GE: return c >= 0;
+    default: return false;
+    }
+}
+
+bool parseFilterOp(const std::string& name, FilterOp& op) {
+    static const struct {
+        const char* name;
+        FilterOp op;
+    } ops[] = {
+        {"eq", FILTER_EQ}, {"ne", FILTER_NE}, {"lt", FILTER_LT}, {"le", FILTER_LE}, {"gt", FILTER_GT},
+        {"ge", FILTER_GE}, {"prefix", FILTER_PREFIX}, {"contains", FILTER_CONTAINS}, {"exists", FILTER_EXISTS},
+        {"missing", FILTER_MISSING},
+    };
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); ++i) {
+        if (name == ops[i].name) {
+            op = ops[i].op;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+ViewSpec::ViewSpec() : sortType(VALUE_AUTO), descending(false), threads(4) {
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores > 0) {
+        threads = (int)std::min((unsigned)MAX_VIEW_THREADS, cores);
+    }
+}
+
+bool parseValueType(const std::string& name, ValueType& type) {
+    if (name == "auto") type = VALUE_AUTO;
+    else if (name == "string") type = VALUE_STRING;
+    else if (name == "bytes") type = VALUE_BYTES;
+    else if (name == "long") type = VALUE_LONG;
+    else if (name == "double") type = VALUE_DOUBLE;
+    else return false;
+    return true;
+}
+
+bool parseViewSpec(const std::string& text, ViewSpec& spec, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(text, entries, error)) {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        bool ok = true;
+        if (key == "sort") {
+            spec.sortColumn = value;
+            ok = !value.empty();
+        } else if (key == "type") {
+            ok = parseValueType(value, spec.sortType);
+        } else if (key == "order") {
+            ok = value == "asc" || value == "desc";
+            spec.descending = value == "desc";
+        } else if (key == "filter") {
+            std::vector<std::string> parts = spec::split(value, '|');
+            FilterSpec filter;
+            filter.op = FILTER_EQ;
+            filter.type = VALUE_AUTO;
+            ok = parts.size() >= 2 && parts.size() <= 4 && !parts[0].empty() && parseFilterOp(parts[1], filter.op);
+            if (ok) {
+                filter.column = parts[0];
+                filter.value = parts.size() > 2 ? parts[2] : std::string();
+                ok = (parts.size() > 2) == (filter.op != FILTER_EXISTS && filter.op != FILTER_MISSING)
+                    && (parts.size() < 4 || parseValueType(parts[3], filter.type));
+            }
+            spec.filters.push_back(filter);
+        } else if (key == "threads") {
+            uint64_t threads = 0;
+            ok = spec::parseUint(value, threads) && threads > 0 && threads <= (uint64_t)MAX_VIEW_THREADS;
+            spec.threads = (int)threads;
+        } else {
+            error = "未知的视图选项: " + key;
+            return false;
+        }
+        if (!ok) {
+            error = "视图选项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ResultStore::applyView(const ViewSpec& spec, uint64_t& rows, std::string& error) {
+    trace::Span span("results.view");
+    std::vector<std::string> names;
+    for (size_t i = 0; i < spec.filters.size(); ++i) {
+        names.push_back(spec.filters[i].column);
+    }
+    if (!spec.sortColumn.empty()) {
+        names.push_back(spec.sortColumn);
+    }
+
+    // 锁内只取当前行数与用到的列的快照，过滤与排序在锁外进行，
+    // 期间填充线程可以继续追加，界面也可以继续读取旧视图
+    uint32_t rowCount = 0;
+    uint64_t generation = 0;
+    std::map<std::string, ColumnValues> lookup;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rowCount = (uint32_t)rowKeys_.size();
+        generation = ++viewGeneration_;
+        if (spec.empty()) {
+            view_.clear();
+            hasView_ = false;
+            rows = rowCount;
+            return true;
+        }
+        // 每列只建一次行号到值的映射
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (lookup.count(names[i]) != 0) {
+                continue;
+            }
+            ColumnValues& values = lookup[names[i]];
+            values.format = formatOf(names[i]);
+            if (names[i] == "rowkey") {
+                values.values.assign(rowKeys_.begin(), rowKeys_.begin() + rowCount);
+                values.lengths.assign(rowKeyLengths_.begin(), rowKeyLengths_.begin() + rowCount);
+                values.rowKey = true;
+                continue;
+            }
+            std::unordered_map<std::string, uint32_t>::const_iterator id = columnIds_.find(names[i]);
+            if (id == columnIds_.end()) {
+                error = "结果集中没有列: " + names[i];
+                return false;
+            }
+            const Column& column = columns_[id->second];
+            values.rowKey = false;
+            values.slots.assign(rowCount, NO_VALUE);
+            for (size_t k = 0; k < column.rows.size() && column.rows[k] < rowCount; ++k) {
+                values.slots[column.rows[k]] = (uint32_t)values.values.size();
+                values.values.push_back(column.values[k]);
+                values.lengths.push_back(column.lengths[k]);
+            }
+        }
+    }
+
+    // 过滤：各线程处理一段行号，按段顺序拼接
+    std::vector<uint32_t> order;
+    if (spec.filters.empty()) {
+        order.resize(rowCount);
+        for (uint32_t r = 0; r < rowCount; ++r) {
+            order[r] = r;
+        }
+    } else {
+        std::vector<CompiledFilter> filters;
+        for (size_t i = 0; i < spec.filters.size(); ++i) {
+            CompiledFilter filter;
+            filter.spec = &spec.filters[i];
+            filter.values = &lookup[spec.filters[i].column];
+            filter.type = spec.filters[i].type;
+            filter.longValue = 0;
+            filter.doubleValue = 0;
+            const std::string& value = spec.filters[i].value;
+            bool isLong = decode::parseLongText(value.data(), value.size(), filter.longValue);
+            bool isDouble = decode::parseDoubleText(value.data(), value.size(), filter.doubleValue);
+            if (filter.type == VALUE_AUTO) {
+                bool doubleColumn = filter.values->format == decode::FORMAT_DOUBLE;
+                filter.type = isLong && !doubleColumn ? VALUE_LONG : isDouble ? VALUE_DOUBLE : VALUE_STRING;
+            }
+            if ((filter.type == VALUE_LONG && !isLong) || (filter.type == VALUE_DOUBLE && !isDouble)) {
+                FilterOp op = spec.filters[i].op;
+                if (op != FILTER_PREFIX && op != FILTER_CONTAINS && op != FILTER_EXISTS && op != FILTER_MISSING) {
+                    error = "过滤值不是有效的数字: " + value;
+                    return false;
+                }
+            }
+            filters.push_back(filter);
+        }
+        std::vector<std::vector<uint32_t> > parts(spec.threads);
+        parallelRanges(rowCount, spec.threads, [&filters, &parts](size_t begin, size_t end, int part) {
+            std::vector<uint32_t>& kept = parts[part];
+            for (size_t r = begin; r < end; ++r) {
+                bool keep = true;
+                for (size_t f = 0; f < filters.size() && keep; ++f) {
+                    keep = matches(filters[f], (uint32_t)r);
+                }
+                if (keep) {
+                    kept.push_back((uint32_t)r);
+                }
+            }
+        });
+        for (size_t i = 0; i < parts.size(); ++i) {
+            order.insert(order.end(), parts[i].begin(), parts[i].end());
+        }
+    }
+
+    // 排序
+    if (!spec.sortColumn.empty()) {
+        const ColumnValues& values = lookup[spec.sortColumn];
+        ValueType type = spec.sortType;
+        if (type == VALUE_AUTO || type == VALUE_LONG || type == VALUE_DOUBLE) {
+            // 数值键先并行解析到按行号索引的数组，比较时不再解析文本
+            std::vector<int64_t> longKeys(type == VALUE_DOUBLE ? 0 : rowCount);
+            std::vector<double> doubleKeys(type == VALUE_LONG ? 0 : rowCount);
+            std::vector<uint8_t> longPresent(longKeys.size());
+            std::vector<uint8_t> doublePresent(doubleKeys.size());
+            std::vector<uint8_t> notLong(spec.threads);
+            std::vector<uint8_t> notDouble(spec.threads);
+            parallelRanges(order.size(), spec.threads, [&](size_t begin, size_t end, int part) {
+                for (size_t i = begin; i < end; ++i) {
+                    uint32_t row = order[i];
+                    const char* data = nullptr;
+                    uint32_t length = 0;
+                    if (!values.get(row, data, length)) {
+                        continue;
+                    }
+                    if (!longKeys.empty()) {
+                        longPresent[row] = decode::asLong(values.format, data, length, longKeys[row]);
+                        notLong[part] |= !longPresent[row];
+                    }
+                    if (!doubleKeys.empty()) {
+                        doublePresent[row] = decode::asDouble(values.format, data, length, doubleKeys[row]);
+                        notDouble[part] |= !doublePresent[row];
+                    }
+                }
+            });
+            if (type == VALUE_AUTO) {
+                bool allLong = std::find(notLong.begin(), notLong.end(), 1) == notLong.end();
+                bool allDouble = std::find(notDouble.begin(), notDouble.end(), 1) == notDouble.end();
+                type = allLong ? VALUE_LONG : allDouble ? VALUE_DOUBLE : VALUE_STRING;
+            }
+            if (type == VALUE_LONG) {
+                NumericLess<int64_t> less = {longKeys.data(), longPresent.data(), spec.descending};
+                parallelSort(order, less, spec.threads);
+            } else if (type == VALUE_DOUBLE) {
+                NumericLess<double> less = {doubleKeys.data(), doublePresent.data(), spec.descending};
+                parallelSort(order, less, spec.threads);
+            }
+        }
+        if (type == VALUE_STRING || type == VALUE_BYTES) {
+            TextLess less = {&values, type == VALUE_STRING, spec.descending};
+            parallelSort(order, less, spec.threads);
+        }
+    }
+
+    rows = order.size();
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 生成期间又有新的视图请求时由后者生效
+    if (generation == viewGeneration_) {
+        view_.swap(order);
+        hasView_ = true;
+    }
+    BRIDGE_LOG_DEBUG("结果集视图：" << rowCount << " 行 -> " << rows << " 行");
+    return true;
+}
+
+} // namespace results
+} // namespace bridge
@@ -0,0 +1,77 @@
+#ifndef RESULT_VIEW_H
+#define RESULT_VIEW_H
+
+#include <string>
+#include <vector>
+
+// 结果集视图：对已缓存的结果集做过滤与排序，只生成行号排列，不复制行数据。
+//
+// 视图规格为 key=value 列表（以 ; 或 & 分隔）：
+//   sort     排序列（family:qualifier，或 rowkey 表示行键），不指定时保持扫描顺序
+//   type     排序时的取值类型（默认auto）
+//   order    asc | desc（默认asc）
+//   filter   过滤条件 列|运算|值[|类型]，可重复，多个条件同时满足
+//            运算：eq ne lt le gt ge（按类型比较）、prefix contains（按字节）、exists missing（不需要值）
+//   threads  过滤与排序的并行段数（默认CPU核数，最多8），各段在调度器的normal队列中执行
+//
+// 类型：
+//   string   文本，忽略ASCII大小写
+//   bytes    按无符号字节比较
+//   long     十进制整数文本
+//   double   浮点数文本
+//   auto     排序列全部可按long解析时用long，其次double，否则string
+// 列格式（ResultStore::setFormats）为long/int/double时，long与double类型按解码后的数值比较。
+// 缺少该列或无法按类型解析的值排在最后（升序、降序都是），且不满足任何比较条件
+
+namespace bridge {
+namespace results {
+
+enum ValueType {
+    VALUE_AUTO,
+    VALUE_STRING,
+    VALUE_BYTES,
+    VALUE_LONG,
+    VALUE_DOUBLE
+};
+
+enum FilterOp {
+    FILTER_EQ,
+    FILTER_NE,
+    FILTER_LT,
+    FILTER_LE,
+    FILTER_GT,
+    FILTER_GE,
+    FILTER_PREFIX,
+    FILTER_CONTAINS,
+    FILTER_EXISTS,
+    FILTER_MISSING
+};
+
+struct FilterSpec {
+    std::string column;
+    FilterOp op;
+    std::string value;
+    ValueType type;
+};
+
+struct ViewSpec {
+    std::string sortColumn; // 为空表示不排序
+    ValueType sortType;
+    bool descending;
+    std::vector<FilterSpec> filters;
+    int threads;
+
+    ViewSpec();
+
+    bool empty() const { return sortColumn.empty() && filters.empty(); }
+};
+
+bool parseValueType(const std::string& name, ValueType& type);
+
+// 解析视图规格，失败返回false并写入error
+bool parseViewSpec(const std::string& text, ViewSpec& spec, std::string& error);
+
+} // namespace results
+} // namespace bridge
+
+#endif // RESULT_VIEW_H
@@ -0,0 +1,51 @@
+#include "scanner_reader.h"
+#include "spec_util.h"
+
+// 扫描选项的解析不涉及JNI，单独成文件，单元测试可以与替身ScannerReader一起链接
+
+namespace bridge {
+
+bool parseVersionOption(const std::string& key, const std::string& value, ScanRange& range, bool& ok) {
+    uint64_t number = 0;
+    if (key == "versions") {
+        ok = spec::parseUint(value, number) && number > 0 && number <= 100000;
+        range.maxVersions = (int)number;
+    } else if (key == "minTime") {
+        ok = spec::parseUint(value, number) && number < (uint64_t)INT64_MAX;
+        range.minTime = (int64_t)number;
+    } else if (key == "maxTime") {
+        ok = spec::parseUint(value, number) && number < (uint64_t)INT64_MAX;
+        range.maxTime = (int64_t)number;
+    } else if (key == "timestamp") {
+        ok = spec::parseUint(value, number) && number < (uint64_t)INT64_MAX;
+        range.minTime = (int64_t)number;
+        range.maxTime = (int64_t)number + 1;
+    } else {
+        return false;
+    }
+    if (ok && range.maxTime != 0 && range.maxTime <= range.minTime) {
+        ok = false;
+    }
+    return true;
+}
+
+bool parseVersionOptions(const std::string& text, ScanRange& range, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(text, entries, error)) {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        bool ok = true;
+        if (!parseVersionOption(entries[i].first, entries[i].second, range, ok)) {
+            error = "未知的版本选项: " + entries[i].first;
+            return false;
+        }
+        if (!ok) {
+            error = "版本选项取值无效: " + entries[i].first + "=" + entries[i].second;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace bridge
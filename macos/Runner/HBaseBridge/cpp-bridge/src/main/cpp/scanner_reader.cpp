@@ -0,0 +1,219 @@
+#include "scanner_reader.h"
+#include "bridge_trace.h"
+#include "jni_support.h"
+#include "qos.h"
+#include "scheduler.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace bridge {
+
+namespace {
+
+bool setString(JNIEnv* env, jclass cls, jobject options, const char* name, const std::string& value) {
+    jfieldID field = env->GetFieldID(cls, name, "Ljava/lang/String;");
+    if (field == nullptr) {
+        return false;
+    }
+    JavaString str(env, value.c_str());
+    env->SetObjectField(options, field, str.get());
+    return true;
+}
+
+bool setInt(JNIEnv* env, jclass cls, jobject options, const char* name, jint value) {
+    jfieldID field = env->GetFieldID(cls, name, "I");
+    if (field == nullptr) {
+        return false;
+    }
+    env->SetIntField(options, field, value);
+    return true;
+}
+
+bool setLong(JNIEnv* env, jclass cls, jobject options, const char* name, jlong value) {
+    jfieldID field = env->GetFieldID(cls, name, "J");
+    if (field == nullptr) {
+        return false;
+    }
+    env->SetLongField(options, field, value);
+    return true;
+}
+
+// 按ScanRange创建Java端的ScanOptions，失败返回nullptr（调用方负责删除局部引用）
+jobject newScanOptions(JNIEnv* env, const ScanRange& range, jlong token) {
+    jclass cls = bridgeClass(env, "ScanOptions");
+    if (cls == nullptr) {
+        return nullptr;
+    }
+    jmethodID ctor = env->GetMethodID(cls, "<init>", "()V");
+    jobject options = ctor != nullptr ? env->NewObject(cls, ctor) : nullptr;
+    if (options == nullptr) {
+        clearPendingException(env, "ScanOptions.<init>");
+        return nullptr;
+    }
+    jfieldID reversed = env->GetFieldID(cls, "reversed", "Z");
+    bool ok = setString(env, cls, options, "tableName", range.tableName)
+        && setString(env, cls, options, "startRow", range.startRow)
+        && setString(env, cls, options, "stopRow", range.stopRow)
+        && setString(env, cls, options, "prefix", range.prefix)
+        && setInt(env, cls, options, "caching", (jint)range.caching)
+        && setString(env, cls, options, "columns", range.columns)
+        && setString(env, cls, options, "splitStart", range.splitStart)
+        && setString(env, cls, options, "splitStop", range.splitStop)
+        && setString(env, cls, options, "cluster", range.cluster)
+        && setLong(env, cls, options, "token", token)
+        && setInt(env, cls, options, "versions", (jint)range.maxVersions)
+        && setLong(env, cls, options, "minTime", (jlong)range.minTime)
+        && setLong(env, cls, options, "maxTime", (jlong)range.maxTime)
+        && reversed != nullptr;
+    if (!ok) {
+        clearPendingException(env, "ScanOptions fields");
+        env->DeleteLocalRef(options);
+        return nullptr;
+    }
+    env->SetBooleanField(options, reversed, (jboolean)range.reversed);
+    return options;
+}
+
+}  // namespace
+
+ScannerReader::ScannerReader()
+    : env_(nullptr), bridgeClass_(nullptr), nextBatch_(nullptr), closeScanner_(nullptr), scannerId_(-1),
+      token_(nullptr) {
+}
+
+ScannerReader::~ScannerReader() {
+    close();
+}
+
+bool ScannerReader::open(const ScanRange& range, std::string& error) {
+    range_ = range;
+    token_ = cancel::current();
+    if (token_ != nullptr && token_->isAborted()) {
+        error = cancel::statusMessage(token_->status());
+        return false;
+    }
+    env_ = currentEnv();
+    if (env_ == nullptr) {
+        error = "JVM未初始化";
+        return false;
+    }
+    bridgeClass_ = bridgeClass(env_, "HBaseBridge");
+    if (bridgeClass_ == nullptr) {
+        error = "无法找到HBaseBridge类";
+        return false;
+    }
+    jmethodID openScanner = env_->GetStaticMethodID(bridgeClass_, "openScanner",
+        "(Lcom/hbasegui/bridge/ScanOptions;)J");
+    nextBatch_ = env_->GetStaticMethodID(bridgeClass_, "nextBatch", "(JII)[B");
+    closeScanner_ = env_->GetStaticMethodID(bridgeClass_, "closeScanner", "(J)V");
+    if (openScanner == nullptr || nextBatch_ == nullptr || closeScanner_ == nullptr) {
+        clearPendingException(env_, "HBaseBridge scanner methods");
+        error = "无法找到扫描会话方法";
+        return false;
+    }
+
+    jobject options = newScanOptions(env_, range, (jlong)(token_ != nullptr ? token_->id() : 0));
+    if (options == nullptr) {
+        error = "无法创建扫描参数";
+        return false;
+    }
+    scannerId_ = env_->CallStaticLongMethod(bridgeClass_, openScanner, options);
+    env_->DeleteLocalRef(options);
+    if (clearPendingException(env_, "HBaseBridge.openScanner") || scannerId_ < 0) {
+        scannerId_ = -1;
+        error = token_ != nullptr && token_->isAborted() ? cancel::statusMessage(token_->status())
+            : "打开扫描失败，表名: " + range.tableName;
+        return false;
+    }
+    return true;
+}
+
+bool ScannerReader::next(std::vector<uint8_t>& batch, std::string& error) {
+    batch.clear();
+    if (scannerId_ < 0) {
+        return false;
+    }
+    if (token_ != nullptr && token_->isAborted()) {
+        error = cancel::statusMessage(token_->status());
+        return false;
+    }
+    sched::yieldToInteractive();
+    jbyteArray array;
+    {
+        trace::Span span("scanner.nextBatch");
+        array = (jbyteArray)env_->CallStaticObjectMethod(bridgeClass_, nextBatch_, scannerId_,
+            (jint)range_.batchRows, (jint)range_.batchBytes);
+    }
+    if (clearPendingException(env_, "HBaseBridge.nextBatch")) {
+        // 取消时Java层关闭扫描器，阻塞中的nextBatch以异常返回
+        error = token_ != nullptr && token_->isAborted() ? cancel::statusMessage(token_->status())
+            : "扫描过程中发生异常，表名: " + range_.tableName;
+        return false;
+    }
+    if (array == nullptr) {
+        return false;
+    }
+    jsize length = env_->GetArrayLength(array);
+    batch.resize((size_t)length);
+    env_->GetByteArrayRegion(array, 0, length, (jbyte*)batch.data());
+    env_->DeleteLocalRef(array);
+    // 一批可能跨多次RPC，按caching估算请求数
+    uint64_t rows = qos::countRows(batch);
+    uint64_t caching = range_.caching > 0 ? (uint64_t)range_.caching : 1;
+    qos::charge(range_.cluster, rows, batch.size(), std::max<uint64_t>(1, (rows + caching - 1) / caching));
+    return true;
+}
+
+void ScannerReader::close() {
+    if (scannerId_ >= 0 && env_ != nullptr) {
+        env_->CallStaticVoidMethod(bridgeClass_, closeScanner_, scannerId_);
+        clearPendingException(env_, "HBaseBridge.closeScanner");
+    }
+    scannerId_ = -1;
+}
+
+bool splitByRegion(const ScanRange& range, std::vector<ScanRange>& splits, std::string& error) {
+    JNIEnv* env = currentEnv();
+    if (env == nullptr) {
+        error = "JVM未初始化";
+        return false;
+    }
+    char* text;
+    {
+        JavaString tableName(env, range.tableName.c_str());
+        JavaString startRow(env, range.startRow.c_str());
+        JavaString stopRow(env, range.stopRow.c_str());
+        JavaString prefix(env, range.prefix.c_str());
+        JavaString cluster(env, range.cluster.c_str());
+        text = callStaticString("HBaseBridge", "getScanSplits",
+            "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;",
+            tableName.get(), startRow.get(), stopRow.get(), prefix.get(), cluster.get());
+    }
+    if (text == nullptr) {
+        error = "获取Region切分失败，表名: " + range.tableName;
+        return false;
+    }
+    // 每行 "起始键,结束键"
+    std::string lines(text);
+    free(text);
+    splits.clear();
+    size_t begin = 0;
+    while (begin < lines.size()) {
+        size_t end = lines.find('\n', begin);
+        if (end == std::string::npos) {
+            end = lines.size();
+        }
+        size_t comma = lines.find(',', begin);
+        if (comma != std::string::npos && comma < end) {
+            ScanRange split = range;
+            split.splitStart = lines.substr(begin, comma - begin);
+            split.splitStop = lines.substr(comma + 1, end - comma - 1);
+            splits.push_back(split);
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+} // namespace bridge
@@ -0,0 +1,79 @@
+#ifndef SCANNER_READER_H
+#define SCANNER_READER_H
+
+#include "cancel_token.h"
+
+#include <jni.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace bridge {
+
+struct ScanRange {
+    std::string tableName;
+    std::string startRow;
+    std::string stopRow;
+    std::string prefix;
+    int caching;     // 每次RPC返回的行数
+    int batchRows;   // 每个批次最多行数
+    int batchBytes;  // 每个批次大约字节数
+    std::string columns;    // 投影列 "cf:q,cf"，空为全部列
+    std::string splitStart; // 限定在一个Region切分内（十六进制原始字节，空为不限），见splitByRegion
+    std::string splitStop;
+    std::string cluster;    // connectPeer的集群名，空为主连接
+    int maxVersions;        // 每列最多返回的版本数（从新到旧），1为只取最新版本
+    int64_t minTime;        // 时间范围 [minTime, maxTime)（毫秒时间戳），两者都为0时不限
+    int64_t maxTime;        // 0为不限上界
+    bool reversed;          // 从范围末端向前扫描（行键递减），范围仍为 [startRow, stopRow) 与prefix
+
+    ScanRange() : caching(1000), batchRows(2000), batchBytes(4 << 20), maxVersions(1), minTime(0), maxTime(0),
+                  reversed(false) {}
+};
+
+// 解析版本与时间范围选项中的一项，key不是以下几项时返回false：
+//   versions=N      每列最多N个版本
+//   minTime=毫秒    时间范围下界（含）
+//   maxTime=毫秒    时间范围上界（不含）
+//   timestamp=毫秒  只取该时间戳的版本，等同于 minTime=ts;maxTime=ts+1
+// 取值无效时ok为false
+bool parseVersionOption(const std::string& key, const std::string& value, ScanRange& range, bool& ok);
+
+// 整个选项串都是版本与时间范围选项（见parseVersionOption），用于没有其他选项的接口
+bool parseVersionOptions(const std::string& text, ScanRange& range, std::string& error);
+
+// 按批拉取扫描结果（cell_codec格式），对应Java层的扫描会话。
+// 只能在创建它的线程中使用。打开时登记在当前线程的取消令牌下（见cancel_token.h），
+// 取消或超时后next返回false，error为对应的说明。
+class ScannerReader {
+public:
+    ScannerReader();
+    ~ScannerReader();
+
+    bool open(const ScanRange& range, std::string& error);
+
+    // 取下一批，扫描结束返回false且error为空；出错返回false并写入error
+    bool next(std::vector<uint8_t>& batch, std::string& error);
+
+    void close();
+
+private:
+    ScannerReader(const ScannerReader&);
+    ScannerReader& operator=(const ScannerReader&);
+
+    JNIEnv* env_;
+    jclass bridgeClass_;
+    jmethodID nextBatch_;
+    jmethodID closeScanner_;
+    jlong scannerId_;
+    ScanRange range_;
+    const cancel::Token* token_;
+};
+
+// 按Region把range切分为多个子范围（各自带splitStart/splitStop），用于并行扫描。
+// 范围与任何Region都不相交时splits为空
+bool splitByRegion(const ScanRange& range, std::vector<ScanRange>& splits, std::string& error);
+
+} // namespace bridge
+
+#endif // SCANNER_READER_H
@@ -0,0 +1,254 @@
+#include "scheduler.h"
+#include "bridge_log.h"
+#include "json_util.h"
+#include "qos.h"
+#include "spec_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace bridge {
+namespace sched {
+
+namespace {
+
+const char* const PRIORITY_NAMES[PRIORITY_COUNT] = {"interactive", "normal", "background"};
+
+struct Pending {
+    std::function<void()> task;
+    std::chrono::steady_clock::time_point enqueued;
+};
+
+struct Lane {
+    uint64_t slots; // 0为不限
+    uint64_t running;
+    uint64_t completed;
+    uint64_t queuedMicros;
+    uint64_t waiting; // interactive在调用线程中等待的数量
+    std::deque<Pending> queue;
+};
+
+std::mutex mutex;
+std::condition_variable changed;
+Lane lanes[PRIORITY_COUNT] = {
+    {8, 0, 0, 0, 0, std::deque<Pending>()},
+    {4, 0, 0, 0, 0, std::deque<Pending>()},
+    {2, 0, 0, 0, 0, std::deque<Pending>()},
+};
+std::map<std::string, Priority> kinds = {
+    {"interactive", PRIORITY_INTERACTIVE},
+    {"results", PRIORITY_NORMAL},
+};
+uint64_t yieldMillis = 200;
+uint64_t yields = 0;
+uint64_t yieldedMicros = 0;
+
+std::atomic<int> activeInteractive(0);
+
+bool hasRoom(const Lane& lane) {
+    return lane.slots == 0 || lane.running < lane.slots;
+}
+
+uint64_t microsSince(std::chrono::steady_clock::time_point start) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// 执行一项工作后继续取同一队列的下一项，队列空或超出（调小后的）上限时退出
+void runLane(Priority priority, Pending current) {
+    Lane& lane = lanes[priority];
+    while (true) {
+        try {
+            current.task();
+        } catch (...) {
+            BRIDGE_LOG_ERROR("调度的工作抛出未捕获的异常（" << PRIORITY_NAMES[priority] << "）");
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        ++lane.completed;
+        if (lane.queue.empty() || (lane.slots != 0 && lane.running > lane.slots)) {
+            --lane.running;
+            changed.notify_all();
+            return;
+        }
+        current = lane.queue.front();
+        lane.queue.pop_front();
+        lane.queuedMicros += microsSince(current.enqueued);
+    }
+}
+
+// 在额度内启动排队的工作，调用方持有mutex
+void dispatchLocked(Priority priority) {
+    Lane& lane = lanes[priority];
+    while (!lane.queue.empty() && hasRoom(lane)) {
+        Pending next = lane.queue.front();
+        lane.queue.pop_front();
+        lane.queuedMicros += microsSince(next.enqueued);
+        ++lane.running;
+        std::thread(runLane, priority, next).detach();
+    }
+}
+
+bool parsePriority(const std::string& text, Priority& priority) {
+    for (int p = 0; p < PRIORITY_COUNT; ++p) {
+        if (text == PRIORITY_NAMES[p]) {
+            priority = (Priority)p;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+const char* priorityName(Priority priority) {
+    return priority >= 0 && priority < PRIORITY_COUNT ? PRIORITY_NAMES[priority] : "unknown";
+}
+
+Priority priorityOf(const std::string& kind) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, Priority>::const_iterator it = kinds.find(kind);
+    return it != kinds.end() ? it->second : PRIORITY_BACKGROUND;
+}
+
+bool configure(const std::string& spec, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(spec, entries, error)) {
+        return false;
+    }
+    // 先全部校验再生效，避免只应用一部分
+    uint64_t slots[PRIORITY_COUNT] = {0, 0, 0};
+    bool slotsSet[PRIORITY_COUNT] = {false, false, false};
+    uint64_t newYield = 0;
+    bool yieldSet = false;
+    std::map<std::string, Priority> newKinds;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        bool valid = true;
+        if (key == "yieldMs") {
+            valid = spec::parseUint(value, newYield);
+            yieldSet = true;
+        } else if (key.compare(0, 5, "kind.") == 0 && key.size() > 5) {
+            Priority priority;
+            valid = parsePriority(value, priority);
+            newKinds[key.substr(5)] = priority;
+        } else {
+            Priority priority;
+            size_t dot = key.find('.');
+            if (dot == std::string::npos || key.compare(dot, std::string::npos, ".slots") != 0
+                || !parsePriority(key.substr(0, dot), priority)) {
+                error = "未知的调度选项: " + key;
+                return false;
+            }
+            valid = spec::parseUint(value, slots[priority]);
+            slotsSet[priority] = true;
+        }
+        if (!valid) {
+            error = "调度选项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int p = 0; p < PRIORITY_COUNT; ++p) {
+        if (slotsSet[p]) {
+            lanes[p].slots = slots[p];
+            dispatchLocked((Priority)p);
+        }
+    }
+    if (yieldSet) {
+        yieldMillis = newYield;
+    }
+    for (std::map<std::string, Priority>::const_iterator it = newKinds.begin(); it != newKinds.end(); ++it) {
+        kinds[it->first] = it->second;
+    }
+    changed.notify_all();
+    return true;
+}
+
+void submit(Priority priority, const std::function<void()>& task) {
+    Pending pending;
+    pending.task = task;
+    pending.enqueued = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    lanes[priority].queue.push_back(pending);
+    dispatchLocked(priority);
+}
+
+InteractiveScope::InteractiveScope() {
+    std::unique_lock<std::mutex> lock(mutex);
+    Lane& lane = lanes[PRIORITY_INTERACTIVE];
+    // 先登记，等待额度期间background就开始让出
+    ++activeInteractive;
+    if (!hasRoom(lane)) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ++lane.waiting;
+        changed.wait(lock, [&lane] { return hasRoom(lane); });
+        --lane.waiting;
+        lane.queuedMicros += microsSince(start);
+    }
+    ++lane.running;
+}
+
+InteractiveScope::~InteractiveScope() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Lane& lane = lanes[PRIORITY_INTERACTIVE];
+    --lane.running;
+    ++lane.completed;
+    --activeInteractive;
+    changed.notify_all();
+}
+
+void yieldToInteractive() {
+    if (activeInteractive.load(std::memory_order_relaxed) == 0
+        || priorityOf(qos::currentClass()) != PRIORITY_BACKGROUND) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    if (yieldMillis == 0 || activeInteractive.load() == 0) {
+        return;
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    changed.wait_for(lock, std::chrono::milliseconds(yieldMillis), [] { return activeInteractive.load() == 0; });
+    ++yields;
+    yieldedMicros += microsSince(start);
+}
+
+std::string statsJson() {
+    std::lock_guard<std::mutex> lock(mutex);
+    char numbers[256];
+    snprintf(numbers, sizeof(numbers), "{\"yieldMs\":%llu,\"yields\":%llu,\"yieldedMs\":%llu,\"classes\":{",
+             (unsigned long long)yieldMillis, (unsigned long long)yields,
+             (unsigned long long)(yieldedMicros / 1000));
+    std::string out = numbers;
+    for (int p = 0; p < PRIORITY_COUNT; ++p) {
+        const Lane& lane = lanes[p];
+        snprintf(numbers, sizeof(numbers),
+                 "\"%s\":{\"slots\":%llu,\"running\":%llu,\"queued\":%llu,\"completed\":%llu,\"queuedMs\":%llu}",
+                 PRIORITY_NAMES[p], (unsigned long long)lane.slots, (unsigned long long)lane.running,
+                 (unsigned long long)(lane.queue.size() + lane.waiting), (unsigned long long)lane.completed,
+                 (unsigned long long)(lane.queuedMicros / 1000));
+        if (p > 0) {
+            out += ',';
+        }
+        out += numbers;
+    }
+    out += "},\"kinds\":{";
+    for (std::map<std::string, Priority>::const_iterator it = kinds.begin(); it != kinds.end(); ++it) {
+        if (it != kinds.begin()) {
+            out += ',';
+        }
+        out += json::quote(it->first) + ":\"" + PRIORITY_NAMES[it->second] + "\"";
+    }
+    out += "}}";
+    return out;
+}
+
+} // namespace sched
+} // namespace bridge
@@ -0,0 +1,64 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <functional>
+#include <string>
+
+// 桥接层的优先级调度。工作分为三个优先级，各有独立的队列与并发上限：
+//   interactive  界面上的即时请求（表列表、浏览数据等），在调用线程中执行，超出上限时等待
+//   normal       界面正在等待结果的后台任务（结果集填充等）
+//   background   导出、导入、复制、对比等长时间任务
+// 任务按kind归入优先级，超出并发上限时排队（任务状态为queued），有任务结束时按提交顺序启动。
+//
+// 抢占：有交互请求在执行时，background的扫描与写入在每个批次之前让出，
+// 等交互请求结束（最多yieldMs）再继续，从而不和交互请求争用连接与RegionServer。
+// 批次边界之外无法中断正在进行的RPC，因此让出的粒度是一个批次。
+//
+// 配置规格（key=value，以 ; 或 & 分隔）：
+//   interactive.slots / normal.slots / background.slots  并发上限（0为不限，默认8/4/2）
+//   yieldMs          background每次让出的最长时间（默认200，0为不让出）
+//   kind.<任务kind>  该类任务的优先级，例如 kind.aggregate=normal
+// 每次配置只修改给出的项。
+
+namespace bridge {
+namespace sched {
+
+enum Priority {
+    PRIORITY_INTERACTIVE,
+    PRIORITY_NORMAL,
+    PRIORITY_BACKGROUND,
+    PRIORITY_COUNT
+};
+
+const char* priorityName(Priority priority);
+
+// 任务kind（或qos的操作类别）对应的优先级
+Priority priorityOf(const std::string& kind);
+
+bool configure(const std::string& spec, std::string& error);
+
+// 提交在后台线程中执行的工作，并发额度不足时排队
+void submit(Priority priority, const std::function<void()>& task);
+
+// 一次交互请求：占用一个interactive额度（不足时等待），期间background让出
+class InteractiveScope {
+public:
+    InteractiveScope();
+    ~InteractiveScope();
+
+private:
+    InteractiveScope(const InteractiveScope&);
+    InteractiveScope& operator=(const InteractiveScope&);
+};
+
+// 扫描与写入在每个批次之前调用：当前线程属于background且有交互请求在执行时等待
+void yieldToInteractive();
+
+// {"yieldMs":..,"yields":..,"yieldedMs":..,"classes":{"interactive":{"slots":..,"running":..,"queued":..,
+//   "completed":..,"queuedMs":..},..},"kinds":{"export":"background",..}}
+std::string statsJson();
+
+} // namespace sched
+} // namespace bridge
+
+#endif // SCHEDULER_H
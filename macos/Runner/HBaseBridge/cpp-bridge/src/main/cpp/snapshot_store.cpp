@@ -0,0 +1,777 @@
+#include "snapshot_store.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cell_codec.h"
+#include "jni_support.h"
+#include "json_util.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef BRIDGE_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+namespace bridge {
+namespace snapshot {
+
+namespace {
+
+const char FILE_MAGIC[] = "HBS1";
+const char BLOCK_MAGIC[] = "BLK1";
+const char INDEX_MAGIC[] = "IDX1";
+const char TRAILER_MAGIC[] = "HBSE";
+const uint32_t FORMAT_VERSION = 1;
+const size_t BLOCK_HEADER_SIZE = 4 + 1 + 4 + 4 + 4;
+const size_t TRAILER_SIZE = 8 + 4 + 4;
+const int BLOCK_BYTES = 256 << 10;
+
+enum BlockCodec {
+    CODEC_NONE = 0,
+    CODEC_LZ4 = 1
+};
+
+// FNV-1a，只用于发现损坏或写了一半的块
+uint32_t checksum(const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+int64_t nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+class Encoder {
+public:
+    explicit Encoder(std::vector<uint8_t>& out) : out_(out) {}
+
+    void magic(const char* text) { out_.insert(out_.end(), text, text + 4); }
+    void u8(uint8_t v) { out_.push_back(v); }
+    void u32(uint32_t v) {
+        for (int i = 0; i < 4; ++i) out_.push_back((uint8_t)(v >> (8 * i)));
+    }
+    void u64(uint64_t v) {
+        for (int i = 0; i < 8; ++i) out_.push_back((uint8_t)(v >> (8 * i)));
+    }
+    void str(const std::string& s) {
+        u32((uint32_t)s.size());
+        out_.insert(out_.end(), s.begin(), s.end());
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+// 越界时置ok为false并返回0/空串，由调用方最后统一检查
+class Decoder {
+public:
+    Decoder(const uint8_t* data, size_t length) : p_(data), end_(data + length), ok_(true) {}
+
+    bool ok() const { return ok_; }
+    size_t remaining() const { return end_ - p_; }
+
+    bool magic(const char* text) {
+        if (!need(4)) return false;
+        bool same = memcmp(p_, text, 4) == 0;
+        p_ += 4;
+        return same;
+    }
+    uint8_t u8() { return need(1) ? *p_++ : 0; }
+    uint32_t u32() {
+        if (!need(4)) return 0;
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= (uint32_t)p_[i] << (8 * i);
+        p_ += 4;
+        return v;
+    }
+    uint64_t u64() {
+        if (!need(8)) return 0;
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= (uint64_t)p_[i] << (8 * i);
+        p_ += 8;
+        return v;
+    }
+    std::string str() {
+        uint32_t length = u32();
+        if (!need(length)) return std::string();
+        std::string s((const char*)p_, length);
+        p_ += length;
+        return s;
+    }
+
+private:
+    bool need(size_t n) {
+        if (!ok_ || (size_t)(end_ - p_) < n) {
+            ok_ = false;
+            return false;
+        }
+        return true;
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+    bool ok_;
+};
+
+// 已打开的快照文件（只读映射，打开后不再变化，可被多个线程同时读取）
+struct Snapshot {
+    const uint8_t* data;
+    size_t size;
+    std::string tableName;
+    std::vector<RangeInfo> ranges;
+
+    Snapshot() : data(nullptr), size(0) {}
+    ~Snapshot() {
+        if (data != nullptr) {
+            munmap((void*)data, size);
+        }
+    }
+
+private:
+    Snapshot(const Snapshot&);
+    Snapshot& operator=(const Snapshot&);
+};
+
+void encodeIndex(const std::vector<RangeInfo>& ranges, std::vector<uint8_t>& out) {
+    Encoder encoder(out);
+    encoder.u32((uint32_t)ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        const RangeInfo& range = ranges[i];
+        encoder.str(range.startRow);
+        encoder.str(range.stopRow);
+        encoder.str(range.prefix);
+        encoder.u64((uint64_t)range.scannedAtMs);
+        encoder.u64(range.rows);
+        encoder.u64(range.cells);
+        encoder.u64(range.rawBytes);
+        encoder.u64(range.storedBytes);
+        encoder.u32((uint32_t)range.blocks.size());
+        for (size_t b = 0; b < range.blocks.size(); ++b) {
+            encoder.u64(range.blocks[b].offset);
+            encoder.str(range.blocks[b].firstRow);
+            encoder.str(range.blocks[b].lastRow);
+            encoder.u32(range.blocks[b].cellCount);
+        }
+    }
+}
+
+bool decodeIndex(const uint8_t* data, size_t length, std::vector<RangeInfo>& ranges) {
+    Decoder decoder(data, length);
+    uint32_t rangeCount = decoder.u32();
+    for (uint32_t i = 0; i < rangeCount && decoder.ok(); ++i) {
+        RangeInfo range;
+        range.startRow = decoder.str();
+        range.stopRow = decoder.str();
+        range.prefix = decoder.str();
+        range.scannedAtMs = (int64_t)decoder.u64();
+        range.rows = decoder.u64();
+        range.cells = decoder.u64();
+        range.rawBytes = decoder.u64();
+        range.storedBytes = decoder.u64();
+        uint32_t blockCount = decoder.u32();
+        for (uint32_t b = 0; b < blockCount && decoder.ok(); ++b) {
+            BlockInfo block;
+            block.offset = decoder.u64();
+            block.firstRow = decoder.str();
+            block.lastRow = decoder.str();
+            block.cellCount = decoder.u32();
+            range.blocks.push_back(block);
+        }
+        ranges.push_back(range);
+    }
+    return decoder.ok() && decoder.remaining() == 0;
+}
+
+std::shared_ptr<Snapshot> openSnapshot(const std::string& path, std::string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "快照文件不存在: " + path;
+        return std::shared_ptr<Snapshot>();
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < 12 + TRAILER_SIZE) {
+        ::close(fd);
+        error = "不是有效的快照文件: " + path;
+        return std::shared_ptr<Snapshot>();
+    }
+    std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+    void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        error = "无法映射快照文件: " + path;
+        return std::shared_ptr<Snapshot>();
+    }
+    snapshot->data = (const uint8_t*)mapped;
+    snapshot->size = (size_t)info.st_size;
+
+    Decoder header(snapshot->data, snapshot->size);
+    bool valid = header.magic(FILE_MAGIC) && header.u32() == FORMAT_VERSION;
+    snapshot->tableName = header.str();
+
+    Decoder trailer(snapshot->data + snapshot->size - TRAILER_SIZE, TRAILER_SIZE);
+    uint64_t indexOffset = trailer.u64();
+    uint32_t indexLength = trailer.u32();
+    valid = valid && header.ok() && trailer.magic(TRAILER_MAGIC)
+        && indexOffset + 8 + indexLength + TRAILER_SIZE == snapshot->size;
+    if (valid) {
+        Decoder index(snapshot->data + indexOffset, 8);
+        valid = index.magic(INDEX_MAGIC)
+            && index.u32() == checksum(snapshot->data + indexOffset + 8, indexLength)
+            && decodeIndex(snapshot->data + indexOffset + 8, indexLength, snapshot->ranges);
+    }
+    if (!valid) {
+        error = "快照文件损坏或未写完: " + path;
+        return std::shared_ptr<Snapshot>();
+    }
+    return snapshot;
+}
+
+// 已打开快照的缓存，文件大小或修改时间变化时重新打开
+struct CacheEntry {
+    std::shared_ptr<Snapshot> snapshot;
+    off_t size;
+    time_t mtime;
+};
+
+std::mutex cacheMutex;
+std::map<std::string, CacheEntry> cache;
+const size_t CACHE_CAPACITY = 8;
+
+std::shared_ptr<Snapshot> cachedSnapshot(const std::string& path, std::string& error) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        error = "快照文件不存在: " + path;
+        return std::shared_ptr<Snapshot>();
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::map<std::string, CacheEntry>::iterator it = cache.find(path);
+    if (it != cache.end() && it->second.size == info.st_size && it->second.mtime == info.st_mtime) {
+        return it->second.snapshot;
+    }
+    std::shared_ptr<Snapshot> snapshot = openSnapshot(path, error);
+    if (!snapshot) {
+        return snapshot;
+    }
+    if (cache.size() >= CACHE_CAPACITY && it == cache.end()) {
+        cache.clear();
+    }
+    CacheEntry entry;
+    entry.snapshot = snapshot;
+    entry.size = info.st_size;
+    entry.mtime = info.st_mtime;
+    cache[path] = entry;
+    return snapshot;
+}
+
+void invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.erase(path);
+}
+
+// 读取并校验一个数据块，未压缩时直接指向映射内存，否则解压到buffer
+bool loadBlock(const Snapshot& snapshot, uint64_t offset, std::vector<uint8_t>& buffer,
+               const uint8_t*& data, size_t& length, std::string& error) {
+    if (offset + BLOCK_HEADER_SIZE > snapshot.size) {
+        error = "快照数据块越界";
+        return false;
+    }
+    Decoder header(snapshot.data + offset, BLOCK_HEADER_SIZE);
+    bool valid = header.magic(BLOCK_MAGIC);
+    uint8_t codec = header.u8();
+    uint32_t rawLength = header.u32();
+    uint32_t storedLength = header.u32();
+    uint32_t expected = header.u32();
+    const uint8_t* stored = snapshot.data + offset + BLOCK_HEADER_SIZE;
+    if (!valid || offset + BLOCK_HEADER_SIZE + storedLength > snapshot.size
+        || checksum(stored, storedLength) != expected) {
+        error = "快照数据块损坏";
+        return false;
+    }
+    if (codec == CODEC_NONE) {
+        data = stored;
+        length = storedLength;
+        return true;
+    }
+#ifdef BRIDGE_HAVE_LZ4
+    if (codec == CODEC_LZ4) {
+        buffer.resize(rawLength);
+        int decoded = LZ4_decompress_safe((const char*)stored, (char*)buffer.data(), (int)storedLength, (int)rawLength);
+        if (decoded != (int)rawLength) {
+            error = "快照数据块解压失败";
+            return false;
+        }
+        data = buffer.data();
+        length = rawLength;
+        return true;
+    }
+#else
+    (void)buffer;
+    (void)rawLength;
+#endif
+    error = "不支持的快照块编码（编译时未启用LZ4）: " + std::to_string((int)codec);
+    return false;
+}
+
+// 压缩后更小时才使用LZ4，返回块编码
+uint8_t compressBlock(const std::vector<uint8_t>& raw, std::vector<uint8_t>& stored) {
+#ifdef BRIDGE_HAVE_LZ4
+    stored.resize(LZ4_compressBound((int)raw.size()));
+    int compressed = LZ4_compress_default((const char*)raw.data(), (char*)stored.data(), (int)raw.size(),
+        (int)stored.size());
+    if (compressed > 0 && (size_t)compressed < raw.size()) {
+        stored.resize(compressed);
+        return CODEC_LZ4;
+    }
+#endif
+    stored = raw;
+    return CODEC_NONE;
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t length, uint64_t offset) {
+    while (length > 0) {
+        ssize_t written = pwrite(fd, data, length, (off_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= written;
+        offset += written;
+    }
+    return true;
+}
+
+// 与Java层buildScan一致：有前缀时扫描区间为[前缀, 前缀的后继)，忽略起止行。hi为空表示没有上界
+struct Interval {
+    std::string lo;
+    std::string hi;
+};
+
+Interval toInterval(const std::string& startRow, const std::string& stopRow, const std::string& prefix) {
+    Interval interval;
+    if (prefix.empty()) {
+        interval.lo = startRow;
+        interval.hi = stopRow;
+        return interval;
+    }
+    interval.lo = prefix;
+    interval.hi = prefix;
+    while (!interval.hi.empty() && (uint8_t)interval.hi[interval.hi.size() - 1] == 0xff) {
+        interval.hi.erase(interval.hi.size() - 1);
+    }
+    if (!interval.hi.empty()) {
+        interval.hi[interval.hi.size() - 1] = (char)((uint8_t)interval.hi[interval.hi.size() - 1] + 1);
+    }
+    return interval;
+}
+
+bool covers(const Interval& outer, const Interval& inner) {
+    if (inner.lo < outer.lo) {
+        return false;
+    }
+    return outer.hi.empty() || (!inner.hi.empty() && inner.hi <= outer.hi);
+}
+
+void appendQuoted(std::string& out, const std::string& text) {
+    out += '"';
+    json::appendText(out, text.data(), text.size());
+    out += '"';
+}
+
+// 统计批次的行数与首末行键
+void summarize(const std::vector<uint8_t>& batch, BlockInfo& block, uint64_t& rows) {
+    codec::BatchReader reader(batch.data(), batch.size());
+    codec::CellView cell;
+    const char* lastRow = nullptr;
+    uint32_t lastLength = 0;
+    rows = 0;
+    block.cellCount = 0;
+    while (reader.next(cell)) {
+        if (lastRow == nullptr || lastLength != cell.rowLength || memcmp(lastRow, cell.row, lastLength) != 0) {
+            if (lastRow == nullptr) {
+                block.firstRow.assign(cell.row, cell.rowLength);
+            }
+            ++rows;
+        }
+        lastRow = cell.row;
+        lastLength = cell.rowLength;
+        ++block.cellCount;
+    }
+    if (lastRow != nullptr) {
+        block.lastRow.assign(lastRow, lastLength);
+    }
+}
+
+int hasChangesSince(JNIEnv* env, jclass bridge, jmethodID method, const std::string& tableName,
+                    const RangeInfo& range) {
+    JavaString table(env, tableName.c_str());
+    JavaString startRow(env, range.startRow.c_str());
+    JavaString stopRow(env, range.stopRow.c_str());
+    JavaString prefix(env, range.prefix.c_str());
+    jint changed = env->CallStaticIntMethod(bridge, method, table.get(), startRow.get(), stopRow.get(),
+        prefix.get(), (jlong)range.scannedAtMs);
+    if (clearPendingException(env, "HBaseBridge.hasChangesSince")) {
+        return -1;
+    }
+    return changed;
+}
+
+} // namespace
+
+bool appendRange(const std::string& path, const ScanRange& range, jobs::Job& job, std::string& error) {
+    trace::Span span("snapshot.append");
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        error = "无法打开快照文件: " + path;
+        return false;
+    }
+    struct Closer {
+        int fd;
+        ~Closer() { ::close(fd); }
+    } closer = {fd};
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        error = "快照文件正在被其他任务写入: " + path;
+        return false;
+    }
+
+    std::vector<RangeInfo> ranges;
+    struct stat info;
+    uint64_t originalSize = fstat(fd, &info) == 0 ? (uint64_t)info.st_size : 0;
+    if (originalSize > 0) {
+        std::string openError;
+        std::shared_ptr<Snapshot> existing = openSnapshot(path, openError);
+        if (!existing) {
+            BRIDGE_LOG_WARN(openError << "，重新创建");
+            originalSize = 0;
+        } else if (existing->tableName != range.tableName) {
+            error = "快照文件属于表 " + existing->tableName + "，不能写入表 " + range.tableName;
+            return false;
+        } else {
+            ranges = existing->ranges;
+        }
+    }
+
+    uint64_t offset = originalSize;
+    bool ok = true;
+    // 失败或取消时截断回写入前的状态
+    struct Rollback {
+        int fd;
+        uint64_t size;
+        const std::string& path;
+        bool& ok;
+        ~Rollback() {
+            if (!ok) {
+                if (size == 0) {
+                    unlink(path.c_str());
+                } else if (ftruncate(fd, (off_t)size) != 0) {
+                    BRIDGE_LOG_ERROR("无法回滚快照文件: " << path);
+                }
+            }
+        }
+    } rollback = {fd, originalSize, path, ok};
+
+    ok = false;
+    std::vector<uint8_t> header;
+    if (originalSize == 0) {
+        if (ftruncate(fd, 0) != 0) {
+            error = "无法重建快照文件: " + path;
+            return false;
+        }
+        Encoder encoder(header);
+        encoder.magic(FILE_MAGIC);
+        encoder.u32(FORMAT_VERSION);
+        encoder.str(range.tableName);
+        if (!writeAll(fd, header.data(), header.size(), 0)) {
+            error = "写入快照文件失败: " + path;
+            return false;
+        }
+        offset = header.size();
+    }
+
+    RangeInfo added;
+    added.startRow = range.startRow;
+    added.stopRow = range.stopRow;
+    added.prefix = range.prefix;
+    added.scannedAtMs = nowMillis();
+
+    ScanRange blockRange = range;
+    blockRange.batchBytes = BLOCK_BYTES;
+    ScannerReader reader;
+    if (!reader.open(blockRange, error)) {
+        return false;
+    }
+    job.setDetail(path);
+
+    std::vector<uint8_t> batch;
+    std::vector<uint8_t> stored;
+    std::vector<uint8_t> blockHeader;
+    while (true) {
+        if (job.isCancelRequested()) {
+            reader.close();
+            return false;
+        }
+        if (!reader.next(batch, error)) {
+            if (!error.empty()) {
+                reader.close();
+                return false;
+            }
+            break;
+        }
+        BlockInfo block;
+        uint64_t rows = 0;
+        summarize(batch, block, rows);
+        if (block.cellCount == 0) {
+            continue;
+        }
+        uint8_t blockCodec;
+        {
+            trace::Span compressSpan("snapshot.compress");
+            blockCodec = compressBlock(batch, stored);
+        }
+        blockHeader.clear();
+        Encoder encoder(blockHeader);
+        encoder.magic(BLOCK_MAGIC);
+        encoder.u8(blockCodec);
+        encoder.u32((uint32_t)batch.size());
+        encoder.u32((uint32_t)stored.size());
+        encoder.u32(checksum(stored.data(), stored.size()));
+        if (!writeAll(fd, blockHeader.data(), blockHeader.size(), offset)
+            || !writeAll(fd, stored.data(), stored.size(), offset + blockHeader.size())) {
+            reader.close();
+            error = "写入快照文件失败: " + path;
+            return false;
+        }
+        block.offset = offset;
+        offset += blockHeader.size() + stored.size();
+        added.blocks.push_back(block);
+        added.rows += rows;
+        added.cells += block.cellCount;
+        added.rawBytes += batch.size();
+        added.storedBytes += blockHeader.size() + stored.size();
+
+        job.rows.fetch_add(rows);
+        job.cells.fetch_add(block.cellCount);
+        job.bytesRead.fetch_add(batch.size());
+        job.bytesWritten.fetch_add(blockHeader.size() + stored.size());
+    }
+    reader.close();
+
+    // 新范围完全覆盖的旧范围不再需要
+    Interval addedInterval = toInterval(added.startRow, added.stopRow, added.prefix);
+    std::vector<RangeInfo> kept;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (!covers(addedInterval, toInterval(ranges[i].startRow, ranges[i].stopRow, ranges[i].prefix))) {
+            kept.push_back(ranges[i]);
+        }
+    }
+    kept.push_back(added);
+
+    std::vector<uint8_t> index;
+    encodeIndex(kept, index);
+    std::vector<uint8_t> tail;
+    Encoder encoder(tail);
+    encoder.magic(INDEX_MAGIC);
+    encoder.u32(checksum(index.data(), index.size()));
+    tail.insert(tail.end(), index.begin(), index.end());
+    encoder.u64(offset);
+    encoder.u32((uint32_t)index.size());
+    encoder.magic(TRAILER_MAGIC);
+    if (!writeAll(fd, tail.data(), tail.size(), offset) || fsync(fd) != 0) {
+        error = "写入快照索引失败: " + path;
+        return false;
+    }
+    ok = true;
+    invalidate(path);
+    BRIDGE_LOG_INFO("快照已写入 " << path << "：" << added.rows << " 行，" << added.blocks.size() << " 个数据块，"
+        << added.rawBytes << " -> " << added.storedBytes << " 字节");
+    return true;
+}
+
+bool readRows(const std::string& path, const std::string& startRow, const std::string& stopRow,
+              const std::string& prefix, int limit, std::string& json, std::string& error) {
+    trace::Span span("snapshot.read");
+    std::shared_ptr<Snapshot> snapshot = cachedSnapshot(path, error);
+    if (!snapshot) {
+        return false;
+    }
+
+    Interval query = toInterval(startRow, stopRow, prefix);
+    const RangeInfo* best = nullptr;
+    for (size_t i = 0; i < snapshot->ranges.size(); ++i) {
+        const RangeInfo& range = snapshot->ranges[i];
+        if (covers(toInterval(range.startRow, range.stopRow, range.prefix), query)
+            && (best == nullptr || range.scannedAtMs > best->scannedAtMs)) {
+            best = &range;
+        }
+    }
+    if (best == nullptr) {
+        error = "快照中没有覆盖该查询的范围";
+        return false;
+    }
+
+    // 稀疏索引：从第一个末行不小于下界的数据块开始
+    struct LastRowBefore {
+        bool operator()(const BlockInfo& block, const std::string& row) const { return block.lastRow < row; }
+    };
+    std::vector<BlockInfo>::const_iterator block = std::lower_bound(best->blocks.begin(), best->blocks.end(),
+        query.lo, LastRowBefore());
+
+    json = "[";
+    uint64_t rows = 0;
+    uint64_t maxRows = limit > 0 ? (uint64_t)limit : UINT64_MAX;
+    std::vector<uint8_t> buffer;
+    std::string row;
+    std::string family;
+    bool done = false;
+    for (; block != best->blocks.end() && !done; ++block) {
+        if (!query.hi.empty() && block->firstRow >= query.hi) {
+            break;
+        }
+        const uint8_t* data = nullptr;
+        size_t length = 0;
+        if (!loadBlock(*snapshot, block->offset, buffer, data, length, error)) {
+            return false;
+        }
+        codec::BatchReader reader(data, length);
+        codec::CellView cell;
+        while (reader.next(cell)) {
+            bool newRow = rows == 0 || row.size() != cell.rowLength || memcmp(row.data(), cell.row, cell.rowLength) != 0;
+            if (newRow) {
+                std::string key(cell.row, cell.rowLength);
+                if (key < query.lo) {
+                    continue;
+                }
+                if ((!query.hi.empty() && key >= query.hi) || rows >= maxRows) {
+                    done = true;
+                    break;
+                }
+                json += rows == 0 ? "{\"row\":" : "}}},{\"row\":";
+                appendQuoted(json, key);
+                json += ",\"families\":{";
+                row.swap(key);
+                ++rows;
+            }
+            bool newFamily = newRow || family.size() != cell.familyLength
+                || memcmp(family.data(), cell.family, cell.familyLength) != 0;
+            if (newFamily) {
+                if (!newRow) {
+                    json += "},";
+                }
+                family.assign(cell.family, cell.familyLength);
+                appendQuoted(json, family);
+                json += ":{";
+            } else {
+                json += ',';
+            }
+            json += '"';
+            json::appendText(json, cell.qualifier, cell.qualifierLength);
+            json += "\":\"";
+            json::appendText(json, cell.value, cell.valueLength);
+            json += '"';
+        }
+        if (reader.hasError()) {
+            error = reader.error();
+            return false;
+        }
+    }
+    json += rows > 0 ? "}}}]" : "]";
+    return true;
+}
+
+bool describe(const std::string& path, std::string& tableName, std::vector<RangeInfo>& ranges,
+              uint64_t& fileBytes, uint64_t& liveBytes, std::string& error) {
+    std::shared_ptr<Snapshot> snapshot = cachedSnapshot(path, error);
+    if (!snapshot) {
+        return false;
+    }
+    tableName = snapshot->tableName;
+    ranges = snapshot->ranges;
+    fileBytes = snapshot->size;
+    liveBytes = 0;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        liveBytes += ranges[i].storedBytes;
+    }
+    return true;
+}
+
+std::string checkFreshness(const std::string& path, int maxAgeSeconds, bool checkCluster) {
+    std::string tableName;
+    std::vector<RangeInfo> ranges;
+    uint64_t fileBytes = 0;
+    uint64_t liveBytes = 0;
+    std::string error;
+    if (!describe(path, tableName, ranges, fileBytes, liveBytes, error)) {
+        return json::error(error);
+    }
+
+    JNIEnv* env = checkCluster ? currentEnv() : nullptr;
+    jclass bridge = env != nullptr ? bridgeClass(env, "HBaseBridge") : nullptr;
+    jmethodID method = nullptr;
+    if (bridge != nullptr) {
+        method = env->GetStaticMethodID(bridge, "hasChangesSince",
+            "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;J)I");
+        if (method == nullptr) {
+            clearPendingException(env, "HBaseBridge.hasChangesSince");
+        }
+    }
+
+    int64_t now = nowMillis();
+    char number[160];
+    std::string out = "{\"table\":";
+    appendQuoted(out, tableName);
+    snprintf(number, sizeof(number), ",\"fileBytes\":%llu,\"liveBytes\":%llu,\"ranges\":[",
+        (unsigned long long)fileBytes, (unsigned long long)liveBytes);
+    out += number;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        const RangeInfo& range = ranges[i];
+        int64_t ageSeconds = (now - range.scannedAtMs) / 1000;
+        const char* fresh = "null";
+        if (maxAgeSeconds > 0 && ageSeconds > maxAgeSeconds) {
+            fresh = "false";
+        } else if (method != nullptr) {
+            int changed = hasChangesSince(env, bridge, method, tableName, range);
+            fresh = changed == 0 ? "true" : changed > 0 ? "false" : "null";
+        } else if (!checkCluster && maxAgeSeconds > 0) {
+            fresh = "true";
+        }
+
+        out += i == 0 ? "{\"startRow\":" : ",{\"startRow\":";
+        appendQuoted(out, range.startRow);
+        out += ",\"stopRow\":";
+        appendQuoted(out, range.stopRow);
+        out += ",\"prefix\":";
+        appendQuoted(out, range.prefix);
+        snprintf(number, sizeof(number),
+            ",\"scannedAt\":%lld,\"ageSeconds\":%lld,\"rows\":%llu,\"cells\":%llu,\"rawBytes\":%llu,\"storedBytes\":%llu,",
+            (long long)range.scannedAtMs, (long long)ageSeconds, (unsigned long long)range.rows,
+            (unsigned long long)range.cells, (unsigned long long)range.rawBytes,
+            (unsigned long long)range.storedBytes);
+        out += number;
+        out += "\"fresh\":";
+        out += fresh;
+        out += '}';
+    }
+    out += "]}";
+    return out;
+}
+
+} // namespace snapshot
+} // namespace bridge
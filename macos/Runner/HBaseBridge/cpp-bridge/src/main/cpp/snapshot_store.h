@@ -0,0 +1,68 @@
+#ifndef SNAPSHOT_STORE_H
+#define SNAPSHOT_STORE_H
+
+#include "job_registry.h"
+#include "scanner_reader.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// 本地快照：把扫描过的范围持久化到本地文件，之后的会话直接从磁盘浏览，减少对集群的重复扫描。
+//
+// 文件只追加写入，读取时整体mmap映射（小端序）：
+//   文件头   "HBS1" u32版本 | u32表名长度 表名
+//   数据块   "BLK1" u8编码(0=不压缩 1=LZ4) u32原始长度 u32存储长度 u32校验和 | 存储的字节
+//            解压后是一个cell_codec批次（约256KiB，按行对齐）
+//   索引     "IDX1" u32校验和 | 索引内容（各范围及其数据块的稀疏键索引：偏移、首行、末行）
+//   文件尾   u64索引偏移 u32索引长度 "HBSE"
+// 每写完一个范围追加一份完整索引，打开时只读文件尾指向的最新索引；
+// 被新范围完全覆盖的旧范围从索引中移除，其数据块成为垃圾（见describe的liveBytes），
+// 写入失败或取消时截断回写入前的长度。
+
+namespace bridge {
+namespace snapshot {
+
+struct BlockInfo {
+    uint64_t offset;
+    std::string firstRow;
+    std::string lastRow;
+    uint32_t cellCount;
+};
+
+struct RangeInfo {
+    std::string startRow;
+    std::string stopRow;
+    std::string prefix;
+    int64_t scannedAtMs; // 开始扫描的时间，新鲜度检查从这一时刻起查找变化
+    uint64_t rows;
+    uint64_t cells;
+    uint64_t rawBytes;
+    uint64_t storedBytes;
+    std::vector<BlockInfo> blocks;
+
+    RangeInfo() : scannedAtMs(0), rows(0), cells(0), rawBytes(0), storedBytes(0) {}
+};
+
+// 扫描range并追加到快照文件（在任务线程中执行），文件不存在时创建。
+// 同一文件同时只允许一个写入者
+bool appendRange(const std::string& path, const ScanRange& range, jobs::Job& job, std::string& error);
+
+// 从快照读取行，输出与getTableData相同的JSON数组（查询参数含义也相同）。
+// 没有快照范围覆盖该查询时返回false并写入原因，调用方应回退到集群查询
+bool readRows(const std::string& path, const std::string& startRow, const std::string& stopRow,
+              const std::string& prefix, int limit, std::string& json, std::string& error);
+
+// 快照中的表名与各范围信息，fileBytes为文件大小，liveBytes为仍被索引引用的部分
+bool describe(const std::string& path, std::string& tableName, std::vector<RangeInfo>& ranges,
+              uint64_t& fileBytes, uint64_t& liveBytes, std::string& error);
+
+// 新鲜度检查，返回JSON：{"table":..,"fileBytes":..,"liveBytes":..,"ranges":[{..,"ageSeconds":..,"fresh":..}]}
+// maxAgeSeconds>0时超过该时长的范围视为过期；checkCluster为true时向集群查询扫描之后是否有写入
+// （按单元格时间戳判断，带显式旧时间戳的写入无法发现）。无法检查时fresh为null
+std::string checkFreshness(const std::string& path, int maxAgeSeconds, bool checkCluster);
+
+} // namespace snapshot
+} // namespace bridge
+
+#endif // SNAPSHOT_STORE_H
@@ -0,0 +1,90 @@
+#ifndef SPEC_UTIL_H
+#define SPEC_UTIL_H
+
+#include <stdint.h>
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 解析 "key=value;key=value" 形式的选项字符串（生成器规格、导入选项等共用），
+// 分隔符可以是 ; 或 &
+
+namespace bridge {
+namespace spec {
+
+inline std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::string current;
+    std::istringstream in(text);
+    while (std::getline(in, current, separator)) {
+        parts.push_back(current);
+    }
+    return parts;
+}
+
+// 只接受十进制数字：strtoull本身会跳过前导空白并接受符号（"-1"变成最大值），溢出时也不报错
+inline bool parseUint(const std::string& text, uint64_t& value) {
+    if (text.empty() || text[0] < '0' || text[0] > '9') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = strtoull(text.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+inline bool parseDouble(const std::string& text, double& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return *end == '\0';
+}
+
+inline bool parseBool(const std::string& text, bool& value) {
+    if (text == "true" || text == "1" || text == "yes") {
+        value = true;
+    } else if (text == "false" || text == "0" || text == "no") {
+        value = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 拆分为有序的(key, value)列表，空项忽略；缺少'='时返回false
+inline bool parseEntries(const std::string& text, std::vector<std::pair<std::string, std::string> >& entries,
+                         std::string& error) {
+    std::string normalized = text;
+    for (size_t i = 0; i < normalized.size(); ++i) {
+        if (normalized[i] == '&') {
+            normalized[i] = ';';
+        }
+    }
+    std::vector<std::string> parts = split(normalized, ';');
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (parts[i].empty()) {
+            continue;
+        }
+        size_t eq = parts[i].find('=');
+        if (eq == std::string::npos) {
+            error = "选项缺少'=': " + parts[i];
+            return false;
+        }
+        entries.push_back(std::make_pair(parts[i].substr(0, eq), parts[i].substr(eq + 1)));
+    }
+    return true;
+}
+
+} // namespace spec
+} // namespace bridge
+
+#endif // SPEC_UTIL_H
@@ -0,0 +1,405 @@
+#include "table_aggregate.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cell_codec.h"
+#include "jni_support.h"
+#include "json_util.h"
+#include "qos.h"
+#include "spec_util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace bridge {
+
+namespace {
+
+// 一个或多个Region的部分结果
+struct Partial {
+    uint64_t rows;
+    uint64_t longCount;   // 整数值个数
+    uint64_t doubleCount; // 非整数值个数
+    uint64_t invalid;
+    int64_t longSum;      // 整数和，溢出前的部分
+    bool overflowed;      // 整数和曾溢出，溢出部分已转入doubleSum
+    int64_t longMin;
+    int64_t longMax;
+    double doubleSum;     // Neumaier补偿求和
+    double compensation;
+    double doubleMin;
+    double doubleMax;
+
+    Partial()
+        : rows(0), longCount(0), doubleCount(0), invalid(0), longSum(0), overflowed(false),
+          longMin(std::numeric_limits<int64_t>::max()), longMax(std::numeric_limits<int64_t>::min()),
+          doubleSum(0), compensation(0), doubleMin(HUGE_VAL), doubleMax(-HUGE_VAL) {}
+
+    void addDouble(double value) {
+        double total = doubleSum + value;
+        if (std::fabs(doubleSum) >= std::fabs(value)) {
+            compensation += (doubleSum - total) + value;
+        } else {
+            compensation += (value - total) + doubleSum;
+        }
+        doubleSum = total;
+    }
+
+    void addLong(int64_t value) {
+        int64_t total;
+        if (__builtin_add_overflow(longSum, value, &total)) {
+            addDouble((double)longSum);
+            longSum = value;
+            overflowed = true;
+        } else {
+            longSum = total;
+        }
+    }
+
+    void merge(const Partial& other) {
+        rows += other.rows;
+        longCount += other.longCount;
+        doubleCount += other.doubleCount;
+        invalid += other.invalid;
+        addLong(other.longSum);
+        overflowed = overflowed || other.overflowed;
+        addDouble(other.doubleSum);
+        compensation += other.compensation;
+        longMin = std::min(longMin, other.longMin);
+        longMax = std::max(longMax, other.longMax);
+        doubleMin = std::min(doubleMin, other.doubleMin);
+        doubleMax = std::max(doubleMax, other.doubleMax);
+    }
+};
+
+// 整段归约：min/max是无分支的独立循环，编译器可以向量化；求和需要检查溢出，单独一遍
+void reduceLongs(const std::vector<int64_t>& values, Partial& partial) {
+    if (values.empty()) {
+        return;
+    }
+    const int64_t* data = values.data();
+    size_t count = values.size();
+    int64_t low = partial.longMin;
+    int64_t high = partial.longMax;
+    for (size_t i = 0; i < count; ++i) {
+        low = data[i] < low ? data[i] : low;
+        high = data[i] > high ? data[i] : high;
+    }
+    partial.longMin = low;
+    partial.longMax = high;
+    for (size_t i = 0; i < count; ++i) {
+        partial.addLong(data[i]);
+    }
+    partial.longCount += count;
+}
+
+void reduceDoubles(const std::vector<double>& values, Partial& partial) {
+    if (values.empty()) {
+        return;
+    }
+    const double* data = values.data();
+    size_t count = values.size();
+    double low = partial.doubleMin;
+    double high = partial.doubleMax;
+    for (size_t i = 0; i < count; ++i) {
+        low = data[i] < low ? data[i] : low;
+        high = data[i] > high ? data[i] : high;
+    }
+    partial.doubleMin = low;
+    partial.doubleMax = high;
+    for (size_t i = 0; i < count; ++i) {
+        partial.addDouble(data[i]);
+    }
+    partial.doubleCount += count;
+}
+
+struct Context {
+    const AggregateOptions* options;
+    const std::vector<ScanRange>* splits;
+    jobs::Job* job;
+    std::string family;
+    std::string qualifier;
+    std::atomic<size_t> nextSplit;
+    std::atomic<size_t> doneSplits;
+    std::atomic<bool> failed;
+    std::mutex mutex; // 保护result与error
+    Partial result;
+    std::string error;
+
+    void fail(const std::string& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!failed.exchange(true)) {
+            error = message;
+        }
+    }
+};
+
+bool sameBytes(const char* data, uint32_t length, const std::string& expected) {
+    return length == expected.size() && memcmp(data, expected.data(), length) == 0;
+}
+
+// 扫描一个切分，返回false表示出错或取消（已记录到context）
+bool aggregateSplit(Context& context, const ScanRange& split, Partial& partial) {
+    trace::Span span("aggregate.region");
+    ScannerReader reader;
+    std::string error;
+    if (!reader.open(split, error)) {
+        context.fail(error);
+        return false;
+    }
+    std::vector<uint8_t> batch;
+    std::vector<int64_t> longs;
+    std::vector<double> doubles;
+    decode::Format format = context.options->format;
+    bool ok = true;
+    while (true) {
+        if (context.failed.load() || context.job->isCancelRequested()) {
+            ok = false;
+            break;
+        }
+        if (!reader.next(batch, error)) {
+            if (!error.empty()) {
+                context.fail(error);
+                ok = false;
+            }
+            break;
+        }
+
+        // 先把本批次的值解码到连续数组
+        longs.clear();
+        doubles.clear();
+        codec::BatchReader cells(batch.data(), batch.size());
+        codec::CellView cell;
+        const char* lastRow = nullptr;
+        uint32_t lastRowLength = 0;
+        uint64_t rows = 0;
+        uint64_t invalid = 0;
+        while (cells.next(cell)) {
+            if (!sameBytes(cell.family, cell.familyLength, context.family)
+                || !sameBytes(cell.qualifier, cell.qualifierLength, context.qualifier)) {
+                continue;
+            }
+            if (lastRow == nullptr || lastRowLength != cell.rowLength || memcmp(lastRow, cell.row, cell.rowLength) != 0) {
+                lastRow = cell.row;
+                lastRowLength = cell.rowLength;
+                ++rows;
+            } else {
+                continue; // 多版本时只取最新版本
+            }
+            int64_t number;
+            double real;
+            if (decode::asLong(format, cell.value, cell.valueLength, number)) {
+                longs.push_back(number);
+            } else if (decode::asDouble(format, cell.value, cell.valueLength, real) && std::isfinite(real)) {
+                doubles.push_back(real);
+            } else {
+                ++invalid;
+            }
+        }
+        if (cells.hasError()) {
+            context.fail(cells.error());
+            ok = false;
+            break;
+        }
+
+        reduceLongs(longs, partial);
+        reduceDoubles(doubles, partial);
+        partial.rows += rows;
+        partial.invalid += invalid;
+        context.job->rows.fetch_add(rows);
+        context.job->cells.fetch_add(longs.size() + doubles.size());
+        context.job->errors.fetch_add(invalid);
+        context.job->bytesRead.fetch_add(batch.size());
+    }
+    reader.close();
+    return ok;
+}
+
+void runWorker(Context* context) {
+    qos::ClassScope qosScope(*context->job);
+    Partial partial;
+    while (!context->failed.load() && !context->job->isCancelRequested()) {
+        size_t index = context->nextSplit.fetch_add(1);
+        if (index >= context->splits->size()) {
+            break;
+        }
+        if (!aggregateSplit(*context, (*context->splits)[index], partial)) {
+            break;
+        }
+        size_t done = context->doneSplits.fetch_add(1) + 1;
+        context->job->setDetail("已完成 " + std::to_string((unsigned long long)done) + "/"
+            + std::to_string((unsigned long long)context->splits->size()) + " 个Region");
+    }
+    {
+        std::lock_guard<std::mutex> lock(context->mutex);
+        context->result.merge(partial);
+    }
+    detachCurrentThread();
+}
+
+void appendNumber(std::string& json, double value) {
+    if (!std::isfinite(value)) {
+        json += "null";
+        return;
+    }
+    char text[32];
+    snprintf(text, sizeof(text), "%.17g", value);
+    json += text;
+}
+
+std::string resultJson(const AggregateOptions& options, const Partial& result, size_t regions) {
+    uint64_t count = result.longCount + result.doubleCount;
+    bool integral = result.doubleCount == 0 && !result.overflowed;
+    double sum = (double)result.longSum + result.doubleSum + result.compensation;
+
+    std::string json = "{\"column\":" + json::quote(options.column)
+        + ",\"regions\":" + std::to_string((unsigned long long)regions)
+        + ",\"rows\":" + std::to_string((unsigned long long)result.rows)
+        + ",\"values\":" + std::to_string((unsigned long long)count)
+        + ",\"invalid\":" + std::to_string((unsigned long long)result.invalid);
+    if (options.ops & AGGREGATE_COUNT) {
+        json += ",\"count\":" + std::to_string((unsigned long long)count);
+    }
+    if (options.ops & AGGREGATE_SUM) {
+        json += ",\"sum\":";
+        if (integral) {
+            json += std::to_string((long long)result.longSum);
+        } else {
+            appendNumber(json, sum);
+        }
+    }
+    for (int op = AGGREGATE_MIN; op <= AGGREGATE_MAX; op <<= 1) {
+        if (!(options.ops & op)) {
+            continue;
+        }
+        bool isMin = op == AGGREGATE_MIN;
+        json += isMin ? ",\"min\":" : ",\"max\":";
+        if (count == 0) {
+            json += "null";
+        } else if (result.doubleCount == 0) {
+            json += std::to_string((long long)(isMin ? result.longMin : result.longMax));
+        } else if (result.longCount == 0) {
+            appendNumber(json, isMin ? result.doubleMin : result.doubleMax);
+        } else {
+            double longValue = (double)(isMin ? result.longMin : result.longMax);
+            double doubleValue = isMin ? result.doubleMin : result.doubleMax;
+            appendNumber(json, isMin ? std::min(longValue, doubleValue) : std::max(longValue, doubleValue));
+        }
+    }
+    if (options.ops & AGGREGATE_AVG) {
+        json += ",\"avg\":";
+        if (count == 0) {
+            json += "null";
+        } else {
+            appendNumber(json, sum / (double)count);
+        }
+    }
+    json += "}";
+    return json;
+}
+
+} // namespace
+
+AggregateOptions::AggregateOptions()
+    : ops(AGGREGATE_COUNT | AGGREGATE_SUM | AGGREGATE_MIN | AGGREGATE_MAX | AGGREGATE_AVG),
+      format(decode::FORMAT_AUTO), threads(4) {
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores > 0) {
+        threads = (int)std::min(8u, cores);
+    }
+}
+
+bool parseAggregateOptions(const std::string& text, AggregateOptions& options, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(text, entries, error)) {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        uint64_t number = 0;
+        bool ok = true;
+        if (key == "ops") {
+            std::vector<std::string> names = spec::split(value, ',');
+            options.ops = 0;
+            for (size_t k = 0; k < names.size() && ok; ++k) {
+                if (names[k] == "count") options.ops |= AGGREGATE_COUNT;
+                else if (names[k] == "sum") options.ops |= AGGREGATE_SUM;
+                else if (names[k] == "min") options.ops |= AGGREGATE_MIN;
+                else if (names[k] == "max") options.ops |= AGGREGATE_MAX;
+                else if (names[k] == "avg") options.ops |= AGGREGATE_AVG;
+                else ok = false;
+            }
+            ok = ok && options.ops != 0;
+        } else if (key == "type") {
+            ok = decode::parseFormat(value, options.format)
+                && (options.format == decode::FORMAT_AUTO || options.format == decode::FORMAT_LONG
+                    || options.format == decode::FORMAT_INT || options.format == decode::FORMAT_DOUBLE);
+        } else if (key == "threads") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 64;
+            options.threads = (int)number;
+        } else {
+            error = "未知的聚合选项: " + key;
+            return false;
+        }
+        if (!ok) {
+            error = "聚合选项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool runAggregate(const AggregateOptions& options, jobs::Job& job, std::string& error) {
+    trace::Span span("aggregate.run");
+    size_t colon = options.column.find(':');
+    if (colon == std::string::npos || colon == 0) {
+        error = "聚合列应为 family:qualifier: " + options.column;
+        return false;
+    }
+
+    ScanRange range = options.range;
+    range.columns = options.column;
+    std::vector<ScanRange> splits;
+    if (!splitByRegion(range, splits, error)) {
+        return false;
+    }
+
+    Context context;
+    context.options = &options;
+    context.splits = &splits;
+    context.job = &job;
+    context.family = options.column.substr(0, colon);
+    context.qualifier = options.column.substr(colon + 1);
+    context.nextSplit = 0;
+    context.doneSplits = 0;
+    context.failed = false;
+
+    int threads = (int)std::min<size_t>((size_t)options.threads, splits.size());
+    BRIDGE_LOG_INFO("聚合 " << options.range.tableName << " 的 " << options.column << "：" << splits.size()
+        << " 个Region，" << threads << " 个线程");
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.push_back(std::thread(runWorker, &context));
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    if (context.failed.load()) {
+        error = context.error;
+        return false;
+    }
+    if (job.isCancelRequested()) {
+        return false;
+    }
+    job.setResult(resultJson(options, context.result, splits.size()));
+    return true;
+}
+
+} // namespace bridge
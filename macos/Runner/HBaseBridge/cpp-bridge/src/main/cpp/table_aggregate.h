@@ -0,0 +1,51 @@
+#ifndef TABLE_AGGREGATE_H
+#define TABLE_AGGREGATE_H
+
+#include "job_registry.h"
+#include "scanner_reader.h"
+#include "value_decoder.h"
+
+#include <string>
+
+// 扫描范围内某一列的聚合（count/sum/min/max/avg），只把聚合结果交给调用方：
+// 范围按Region切分，多个线程各扫描一个Region，扫描只投影这一列；
+// 每个批次的值先解码到连续数组，再整段归约，最后合并各Region的部分结果。
+//
+// 选项字符串（key=value，以 ; 或 & 分隔）：
+//   ops      逗号分隔的 count,sum,min,max,avg（默认全部）
+//   type     值的格式：auto（默认，按数字文本解析）| long | int | double（Bytes.toBytes写入的定长二进制）
+//   threads  并行扫描的Region数（默认CPU核数，最多8）
+//
+// 结果（任务进度JSON中的"result"）：
+//   {"column":..,"regions":..,"rows":..,"values":..,"invalid":..,"count":..,"sum":..,"min":..,"max":..,"avg":..}
+// rows为含该列的行数，invalid为无法按格式解析的值的个数（不参与聚合）。
+// 全部是整数且没有溢出时sum/min/max为整数，否则为浮点数；没有值时min/max/avg为null。
+
+namespace bridge {
+
+enum AggregateOp {
+    AGGREGATE_COUNT = 1,
+    AGGREGATE_SUM = 2,
+    AGGREGATE_MIN = 4,
+    AGGREGATE_MAX = 8,
+    AGGREGATE_AVG = 16
+};
+
+struct AggregateOptions {
+    ScanRange range;
+    std::string column; // family:qualifier
+    unsigned ops;       // AggregateOp的组合
+    decode::Format format;
+    int threads;
+
+    AggregateOptions();
+};
+
+bool parseAggregateOptions(const std::string& text, AggregateOptions& options, std::string& error);
+
+// 在当前线程（任务线程）中执行聚合，结果通过job.setResult返回
+bool runAggregate(const AggregateOptions& options, jobs::Job& job, std::string& error);
+
+} // namespace bridge
+
+#endif // TABLE_AGGREGATE_H
@@ -0,0 +1,652 @@
+#include "table_checksum.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cell_codec.h"
+#include "hash_util.h"
+#include "jni_support.h"
+#include "json_util.h"
+#include "qos.h"
+#include "spec_util.h"
+#include "value_decoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace bridge {
+
+namespace {
+
+// 范围起点的节点是所有层的边界
+const int HEAD_LEVEL = 64;
+// 最多的层数（含叶子层）
+const size_t MAX_LEVELS = 12;
+
+// 一段连续的行：从start行开始，到下一个边界行之前
+struct Node {
+    std::string start; // 行键原始字节，空表示范围起点（或切分开头的续接部分）
+    int level;         // 该边界所属的最高层，-1表示不是边界
+    uint64_t rows;
+    uint64_t hash;
+
+    Node() : level(-1), rows(0), hash(0) {}
+    Node(const std::string& start, int level) : start(start), level(level), rows(0), hash(0) {}
+
+    void add(uint64_t rowCount, uint64_t rowHash) {
+        rows += rowCount;
+        hash += rowHash;
+    }
+};
+
+struct SplitResult {
+    std::vector<Node> nodes; // nodes[0]是切分开头到第一个边界之前的行，接在上一个切分最后一个叶子后面
+    uint64_t rows;
+    uint64_t hash;
+
+    SplitResult() : rows(0), hash(0) {}
+};
+
+int log2Exact(uint32_t value) {
+    int bits = 0;
+    while ((1u << bits) < value) {
+        ++bits;
+    }
+    return (1u << bits) == value ? bits : -1;
+}
+
+// 行键哈希对应的边界层：低leafBits位全为0是叶子边界，每再多fanoutBits个0位高一层
+int boundaryLevel(uint64_t keyHash, int leafBits, int fanoutBits) {
+    if (leafBits > 0 && (keyHash & ((1ULL << leafBits) - 1)) != 0) {
+        return -1;
+    }
+    int level = 0;
+    int bits = leafBits + fanoutBits;
+    while (bits < 64 && level + 1 < (int)MAX_LEVELS && (keyHash & ((1ULL << bits) - 1)) == 0) {
+        ++level;
+        bits += fanoutBits;
+    }
+    return level;
+}
+
+struct Context {
+    const ChecksumOptions* options;
+    const std::vector<ScanRange>* splits;
+    jobs::Job* job;
+    int leafBits;
+    int fanoutBits;
+    std::vector<SplitResult> results; // 与splits一一对应，各线程只写自己领取的切分
+    std::atomic<size_t> nextSplit;
+    std::atomic<size_t> doneSplits;
+    std::atomic<bool> failed;
+    std::mutex mutex; // 保护error
+    std::string error;
+
+    void fail(const std::string& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!failed.exchange(true)) {
+            error = message;
+        }
+    }
+};
+
+bool checksumSplit(Context& context, const ScanRange& split, SplitResult& result) {
+    trace::Span span("checksum.region");
+    ScannerReader reader;
+    std::string error;
+    if (!reader.open(split, error)) {
+        context.fail(error);
+        return false;
+    }
+    bool timestamps = context.options->timestamps;
+    result.nodes.assign(1, Node());
+    std::vector<uint8_t> batch;
+    std::vector<codec::CellView> cells;
+    bool ok = true;
+    while (true) {
+        if (context.failed.load() || context.job->isCancelRequested()) {
+            ok = false;
+            break;
+        }
+        if (!reader.next(batch, error)) {
+            if (!error.empty()) {
+                context.fail(error);
+                ok = false;
+            }
+            break;
+        }
+        cells.clear();
+        codec::BatchReader batchReader(batch.data(), batch.size());
+        codec::CellView cell;
+        while (batchReader.next(cell)) {
+            cells.push_back(cell);
+        }
+        if (batchReader.hasError()) {
+            context.fail(batchReader.error());
+            ok = false;
+            break;
+        }
+
+        // Java层按完整的Result组批，一行不会跨批次
+        uint64_t rows = 0;
+        size_t begin = 0;
+        while (begin < cells.size()) {
+            const codec::CellView& first = cells[begin];
+            size_t end = begin + 1;
+            while (end < cells.size() && (cells[end].row == first.row
+                    || (cells[end].rowLength == first.rowLength
+                        && memcmp(cells[end].row, first.row, first.rowLength) == 0))) {
+                ++end;
+            }
+            uint64_t keyHash = hash::xxh64(first.row, first.rowLength);
+            uint64_t rowHash = hash::row(&cells[begin], end - begin, timestamps, keyHash);
+            int level = boundaryLevel(keyHash, context.leafBits, context.fanoutBits);
+            if (level >= 0) {
+                result.nodes.push_back(Node(std::string(first.row, first.rowLength), level));
+            }
+            result.nodes.back().add(1, rowHash);
+            result.rows += 1;
+            result.hash += rowHash;
+            ++rows;
+            begin = end;
+        }
+        context.job->rows.fetch_add(rows);
+        context.job->cells.fetch_add(cells.size());
+        context.job->bytesRead.fetch_add(batch.size());
+    }
+    reader.close();
+    return ok;
+}
+
+void runWorker(Context* context) {
+    qos::ClassScope qosScope(*context->job);
+    while (!context->failed.load() && !context->job->isCancelRequested()) {
+        size_t index = context->nextSplit.fetch_add(1);
+        if (index >= context->splits->size()) {
+            break;
+        }
+        if (!checksumSplit(*context, (*context->splits)[index], context->results[index])) {
+            break;
+        }
+        size_t done = context->doneSplits.fetch_add(1) + 1;
+        context->job->setDetail("已完成 " + std::to_string((unsigned long long)done) + "/"
+            + std::to_string((unsigned long long)context->splits->size()) + " 个Region");
+    }
+    detachCurrentThread();
+}
+
+// 由下一层构造上一层：level不低于该层的节点开始一个新节点
+void buildLevel(const std::vector<Node>& lower, int level, std::vector<Node>& upper) {
+    upper.clear();
+    for (size_t i = 0; i < lower.size(); ++i) {
+        if (upper.empty() || lower[i].level >= level) {
+            upper.push_back(Node(lower[i].start, lower[i].level));
+        }
+        upper.back().add(lower[i].rows, lower[i].hash);
+    }
+}
+
+std::string hashHex(uint64_t hash) {
+    char text[17];
+    snprintf(text, sizeof(text), "%016llx", (unsigned long long)hash);
+    return text;
+}
+
+bool fromHex(const std::string& text, std::string& bytes) {
+    if (text.size() % 2 != 0) {
+        return false;
+    }
+    bytes.clear();
+    for (size_t i = 0; i < text.size(); i += 2) {
+        int value = 0;
+        for (size_t k = i; k < i + 2; ++k) {
+            char c = text[k];
+            int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            if (digit < 0) {
+                return false;
+            }
+            value = value * 16 + digit;
+        }
+        bytes += (char)value;
+    }
+    return true;
+}
+
+// 行键按auto格式显示，空串（范围起点/终点）为null
+void appendKey(std::string& out, const std::string& key) {
+    if (key.empty()) {
+        out += "null";
+        return;
+    }
+    out += '"';
+    decode::appendAuto(out, key.data(), key.size());
+    out += '"';
+}
+
+bool writeTree(const std::string& path, const ChecksumOptions& options, const std::vector<std::vector<Node> >& levels,
+               uint64_t rows, uint64_t hash, jobs::Job& job, std::string& error) {
+    std::string partPath = path + ".part";
+    FILE* file = fopen(partPath.c_str(), "wb");
+    if (file == nullptr) {
+        error = "无法创建校验树文件: " + partPath;
+        return false;
+    }
+    std::string out = "{\"table\":" + json::quote(options.range.tableName)
+        + ",\"leafRows\":" + std::to_string((unsigned long long)options.leafRows)
+        + ",\"fanout\":" + std::to_string((unsigned long long)options.fanout)
+        + ",\"levels\":" + std::to_string((unsigned long long)levels.size())
+        + ",\"rows\":" + std::to_string((unsigned long long)rows)
+        + ",\"hash\":\"" + hashHex(hash) + "\"}\n";
+    bool ok = true;
+    for (size_t level = levels.size(); level-- > 0 && ok;) {
+        const std::vector<Node>& nodes = levels[level];
+        for (size_t i = 0; i < nodes.size() && ok; ++i) {
+            out += "{\"level\":" + std::to_string((unsigned long long)level) + ",\"start\":\"";
+            decode::appendHex(out, nodes[i].start.data(), nodes[i].start.size());
+            out += "\",\"rows\":" + std::to_string((unsigned long long)nodes[i].rows)
+                + ",\"hash\":\"" + hashHex(nodes[i].hash) + "\"}\n";
+            if (out.size() >= (1 << 20)) {
+                ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+                job.bytesWritten.fetch_add(out.size());
+                out.clear();
+            }
+        }
+    }
+    ok = ok && fwrite(out.data(), 1, out.size(), file) == out.size();
+    job.bytesWritten.fetch_add(out.size());
+    if (fclose(file) != 0 || !ok) {
+        remove(partPath.c_str());
+        error = "写入校验树文件失败: " + path;
+        return false;
+    }
+    if (rename(partPath.c_str(), path.c_str()) != 0) {
+        error = "无法重命名校验树文件: " + partPath;
+        return false;
+    }
+    return true;
+}
+
+std::string resultJson(const ChecksumOptions& options, const std::vector<ScanRange>& splits,
+                       const std::vector<SplitResult>& results, const std::vector<std::vector<Node> >& levels,
+                       uint64_t rows, uint64_t hash) {
+    std::string json = "{\"table\":" + json::quote(options.range.tableName)
+        + ",\"rows\":" + std::to_string((unsigned long long)rows)
+        + ",\"hash\":\"" + hashHex(hash) + "\""
+        + ",\"leaves\":" + std::to_string((unsigned long long)levels[0].size())
+        + ",\"levels\":" + std::to_string((unsigned long long)levels.size())
+        + ",\"regions\":[";
+    std::string key;
+    for (size_t i = 0; i < splits.size(); ++i) {
+        json += i > 0 ? ",{\"start\":" : "{\"start\":";
+        appendKey(json, fromHex(splits[i].splitStart, key) ? key : std::string());
+        json += ",\"end\":";
+        appendKey(json, fromHex(splits[i].splitStop, key) ? key : std::string());
+        json += ",\"rows\":" + std::to_string((unsigned long long)results[i].rows)
+            + ",\"hash\":\"" + hashHex(results[i].hash) + "\"}";
+    }
+    json += "],\"top\":[";
+    const std::vector<Node>& top = levels.back();
+    for (size_t i = 0; i < top.size(); ++i) {
+        json += i > 0 ? ",{\"start\":" : "{\"start\":";
+        appendKey(json, top[i].start);
+        json += ",\"rows\":" + std::to_string((unsigned long long)top[i].rows)
+            + ",\"hash\":\"" + hashHex(top[i].hash) + "\"}";
+    }
+    json += "]}";
+    return json;
+}
+
+// 校验树文件
+
+struct Tree {
+    uint32_t leafRows;
+    uint32_t fanout;
+    uint64_t rows;
+    uint64_t hash;
+    std::vector<std::vector<Node> > levels;
+
+    Tree() : leafRows(0), fanout(0), rows(0), hash(0) {}
+};
+
+// 取本模块写出的JSON行中的字段（数字或字符串），不是通用的JSON解析
+bool fieldText(const std::string& line, const char* name, std::string& value) {
+    std::string key = std::string("\"") + name + "\":";
+    size_t pos = line.find(key);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    pos += key.size();
+    if (pos < line.size() && line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        if (end == std::string::npos) {
+            return false;
+        }
+        value = line.substr(pos + 1, end - pos - 1);
+        return true;
+    }
+    size_t end = line.find_first_of(",}", pos);
+    if (end == std::string::npos) {
+        return false;
+    }
+    value = line.substr(pos, end - pos);
+    return true;
+}
+
+bool fieldUint(const std::string& line, const char* name, uint64_t& value) {
+    std::string text;
+    return fieldText(line, name, text) && spec::parseUint(text, value);
+}
+
+bool fieldHash(const std::string& line, const char* name, uint64_t& value) {
+    std::string text;
+    if (!fieldText(line, name, text) || text.size() != 16) {
+        return false;
+    }
+    char* end = nullptr;
+    value = strtoull(text.c_str(), &end, 16);
+    return end == text.c_str() + text.size();
+}
+
+bool loadTree(const std::string& path, Tree& tree, std::string& error) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        error = "无法打开校验树文件: " + path;
+        return false;
+    }
+    std::string line;
+    char buffer[1 << 16];
+    bool header = true;
+    bool ok = true;
+    uint64_t number = 0;
+    size_t lineNumber = 0;
+    while (ok) {
+        line.clear();
+        bool more = false;
+        while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+            more = true;
+            line += buffer;
+            if (!line.empty() && line[line.size() - 1] == '\n') {
+                break;
+            }
+        }
+        if (!more) {
+            break;
+        }
+        ++lineNumber;
+        if (header) {
+            uint64_t leafRows = 0;
+            uint64_t fanout = 0;
+            ok = fieldUint(line, "leafRows", leafRows) && fieldUint(line, "fanout", fanout)
+                && fieldUint(line, "levels", number) && number > 0 && number <= MAX_LEVELS
+                && fieldUint(line, "rows", tree.rows) && fieldHash(line, "hash", tree.hash);
+            tree.leafRows = (uint32_t)leafRows;
+            tree.fanout = (uint32_t)fanout;
+            tree.levels.resize((size_t)number);
+            header = false;
+            continue;
+        }
+        Node node;
+        std::string start;
+        ok = fieldUint(line, "level", number) && number < tree.levels.size()
+            && fieldText(line, "start", start) && fromHex(start, node.start)
+            && fieldUint(line, "rows", node.rows) && fieldHash(line, "hash", node.hash);
+        if (ok) {
+            std::vector<Node>& nodes = tree.levels[(size_t)number];
+            ok = nodes.empty() ? node.start.empty() : nodes.back().start < node.start;
+            nodes.push_back(node);
+        }
+    }
+    fclose(file);
+    if (!ok || header) {
+        error = "校验树文件格式错误: " + path + "，第 " + std::to_string((unsigned long long)lineNumber) + " 行";
+        return false;
+    }
+    for (size_t i = 0; i < tree.levels.size(); ++i) {
+        if (tree.levels[i].empty()) {
+            error = "校验树文件不完整: " + path;
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Comparison {
+    const Tree* a;
+    const Tree* b;
+    uint32_t maxRanges;
+    std::string ranges;
+    uint32_t rangeCount;
+    bool truncated;
+};
+
+size_t lowerBound(const std::vector<Node>& nodes, const std::string& key) {
+    size_t low = 0;
+    size_t high = nodes.size();
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (nodes[mid].start < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void compareRange(Comparison& comparison, size_t level, const std::string& low, const std::string& high, bool open);
+
+// 两侧在[start, end)内的行数与哈希之和不同时，在下一层展开或记录为差异范围
+void closeRange(Comparison& comparison, size_t level, const std::string& start, const std::string& end, bool open,
+                const Node& a, const Node& b) {
+    if (a.rows == b.rows && a.hash == b.hash) {
+        return;
+    }
+    if (level > 0) {
+        compareRange(comparison, level - 1, start, end, open);
+        return;
+    }
+    if (comparison.rangeCount >= comparison.maxRanges) {
+        comparison.truncated = true;
+        return;
+    }
+    comparison.ranges += comparison.rangeCount > 0 ? ",{\"start\":" : "{\"start\":";
+    appendKey(comparison.ranges, start);
+    comparison.ranges += ",\"end\":";
+    appendKey(comparison.ranges, open ? std::string() : end);
+    comparison.ranges += ",\"rows\":[" + std::to_string((unsigned long long)a.rows) + ","
+        + std::to_string((unsigned long long)b.rows) + "]}";
+    ++comparison.rangeCount;
+}
+
+// [low, high)的两端在该层两侧都是边界。两侧都有的边界把范围分成若干段，
+// 每段的哈希是其中节点哈希之和，只有不相等的段需要展开
+void compareRange(Comparison& comparison, size_t level, const std::string& low, const std::string& high, bool open) {
+    if (comparison.truncated) {
+        return;
+    }
+    const std::vector<Node>& a = comparison.a->levels[level];
+    const std::vector<Node>& b = comparison.b->levels[level];
+    size_t i = lowerBound(a, low);
+    size_t k = lowerBound(b, low);
+    size_t iEnd = open ? a.size() : lowerBound(a, high);
+    size_t kEnd = open ? b.size() : lowerBound(b, high);
+    std::string start = low;
+    Node sumA;
+    Node sumB;
+    bool first = true;
+    while (i < iEnd || k < kEnd) {
+        bool takeA = i < iEnd && (k >= kEnd || a[i].start <= b[k].start);
+        bool takeB = k < kEnd && (i >= iEnd || b[k].start <= a[i].start);
+        if (takeA && takeB) {
+            if (!first) {
+                closeRange(comparison, level, start, a[i].start, false, sumA, sumB);
+                if (comparison.truncated) {
+                    return;
+                }
+            }
+            start = a[i].start;
+            sumA = Node();
+            sumB = Node();
+        }
+        first = false;
+        if (takeA) {
+            sumA.add(a[i].rows, a[i].hash);
+            ++i;
+        }
+        if (takeB) {
+            sumB.add(b[k].rows, b[k].hash);
+            ++k;
+        }
+    }
+    closeRange(comparison, level, start, high, open, sumA, sumB);
+}
+
+} // namespace
+
+ChecksumOptions::ChecksumOptions() : timestamps(false), leafRows(1024), fanout(16), threads(4) {
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores > 0) {
+        threads = (int)std::min(8u, cores);
+    }
+}
+
+bool parseChecksumOptions(const std::string& text, ChecksumOptions& options, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(text, entries, error)) {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        uint64_t number = 0;
+        bool ok = true;
+        if (key == "cluster") {
+            options.range.cluster = value;
+        } else if (key == "columns") {
+            options.range.columns = value;
+        } else if (key == "timestamps") {
+            ok = spec::parseBool(value, options.timestamps);
+        } else if (key == "leafRows") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= (1 << 20)
+                && log2Exact((uint32_t)number) >= 0;
+            options.leafRows = (uint32_t)number;
+        } else if (key == "fanout") {
+            ok = spec::parseUint(value, number) && number >= 2 && number <= 256 && log2Exact((uint32_t)number) >= 0;
+            options.fanout = (uint32_t)number;
+        } else if (key == "path") {
+            options.path = value;
+        } else if (key == "threads") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 64;
+            options.threads = (int)number;
+        } else {
+            error = "未知的校验选项: " + key;
+            return false;
+        }
+        if (!ok) {
+            error = "校验选项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool runChecksum(const ChecksumOptions& options, jobs::Job& job, std::string& error) {
+    trace::Span span("checksum.run");
+    std::vector<ScanRange> splits;
+    if (!splitByRegion(options.range, splits, error)) {
+        return false;
+    }
+
+    Context context;
+    context.options = &options;
+    context.splits = &splits;
+    context.job = &job;
+    context.leafBits = log2Exact(options.leafRows);
+    context.fanoutBits = log2Exact(options.fanout);
+    context.results.resize(splits.size());
+    context.nextSplit = 0;
+    context.doneSplits = 0;
+    context.failed = false;
+
+    int threads = (int)std::min<size_t>((size_t)options.threads, splits.size());
+    BRIDGE_LOG_INFO("校验 " << options.range.tableName << "：" << splits.size() << " 个Region，"
+        << threads << " 个线程");
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.push_back(std::thread(runWorker, &context));
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+    if (context.failed.load()) {
+        error = context.error;
+        return false;
+    }
+    if (job.isCancelRequested()) {
+        return false;
+    }
+
+    // 按切分顺序拼接叶子，切分开头的续接部分并入上一个叶子
+    std::vector<std::vector<Node> > levels(1);
+    std::vector<Node>& leaves = levels[0];
+    leaves.push_back(Node(std::string(), HEAD_LEVEL));
+    uint64_t rows = 0;
+    uint64_t hash = 0;
+    for (size_t i = 0; i < context.results.size(); ++i) {
+        std::vector<Node>& nodes = context.results[i].nodes;
+        leaves.back().add(nodes[0].rows, nodes[0].hash);
+        leaves.insert(leaves.end(), nodes.begin() + 1, nodes.end());
+        nodes.clear();
+        rows += context.results[i].rows;
+        hash += context.results[i].hash;
+    }
+    while (levels.back().size() > options.fanout && levels.size() < MAX_LEVELS) {
+        std::vector<Node> upper;
+        buildLevel(levels.back(), (int)levels.size(), upper);
+        levels.push_back(std::vector<Node>());
+        levels.back().swap(upper);
+    }
+
+    if (!options.path.empty() && !writeTree(options.path, options, levels, rows, hash, job, error)) {
+        return false;
+    }
+    job.setResult(resultJson(options, splits, context.results, levels, rows, hash));
+    return true;
+}
+
+bool compareChecksumFiles(const std::string& pathA, const std::string& pathB, uint32_t maxRanges,
+                          std::string& json, std::string& error) {
+    trace::Span span("checksum.compare");
+    Tree a;
+    Tree b;
+    if (!loadTree(pathA, a, error) || !loadTree(pathB, b, error)) {
+        return false;
+    }
+    if (a.leafRows != b.leafRows || a.fanout != b.fanout) {
+        error = "两个校验树的leafRows或fanout不同，无法对比";
+        return false;
+    }
+
+    Comparison comparison;
+    comparison.a = &a;
+    comparison.b = &b;
+    comparison.maxRanges = maxRanges;
+    comparison.rangeCount = 0;
+    comparison.truncated = false;
+    bool equal = a.rows == b.rows && a.hash == b.hash;
+    if (!equal) {
+        size_t top = std::min(a.levels.size(), b.levels.size()) - 1;
+        compareRange(comparison, top, std::string(), std::string(), true);
+    }
+    json = "{\"status\":\"success\",\"equal\":" + std::string(equal ? "true" : "false")
+        + ",\"rows\":[" + std::to_string((unsigned long long)a.rows) + ","
+        + std::to_string((unsigned long long)b.rows) + "],\"ranges\":[" + comparison.ranges
+        + "],\"truncated\":" + (comparison.truncated ? "true" : "false") + "}";
+    return true;
+}
+
+} // namespace bridge
@@ -0,0 +1,66 @@
+#ifndef TABLE_CHECKSUM_H
+#define TABLE_CHECKSUM_H
+
+#include "job_registry.h"
+#include "scanner_reader.h"
+
+#include <stdint.h>
+#include <string>
+
+// 表内容的校验树：不传输数据，只比较哈希就能定位两个集群间不一致的键范围。
+//
+// 每行的哈希为XXH64(行键 + 各单元格)，一个范围的哈希是其中各行哈希之和（模2^64），
+// 因此相邻范围的哈希可以直接相加合并。
+// 哈希用XXH64而不是XXH3：XXH64已在hash_util.h中实现并用于表对比（table_diff），校验树与对比共用同一个
+// 哈希，不引入xxHash库；XXH3在短输入上更快，但校验的开销主要在扫描，行哈希不是瓶颈。
+// 树的节点边界只由行键决定，与Region划分无关：行键哈希的低位全为0的行开始一个新节点，
+// 叶子平均约leafRows行，每上一层平均约fanout个子节点，上层边界一定也是下层边界。
+// 两个集群的Region不同也能得到可对比的树，多出或缺少的行只影响所在的节点。
+//
+// 范围按Region切分后并行扫描，每个切分产生一段叶子，按切分顺序拼接（跨切分的叶子哈希相加）。
+//
+// 选项字符串（key=value，以 ; 或 & 分隔）：
+//   cluster     扫描的集群（connectPeer的名称，默认主连接）
+//   columns     只校验这些列 "cf:q,cf"（默认全部列）
+//   timestamps  时间戳参与哈希（默认false）
+//   leafRows    叶子平均行数，2的幂（默认1024）
+//   fanout      每层平均分支数，2的幂（默认16）
+//   path        校验树输出文件（NDJSON，供compareChecksumFiles对比），为空时只返回概要
+//   threads     并行扫描的Region数（默认CPU核数，最多8）
+//
+// 输出文件第一行为概要 {"table":..,"leafRows":..,"fanout":..,"levels":..,"rows":..,"hash":..}，
+// 之后从顶层到叶子，每行一个节点 {"level":..,"start":"十六进制行键","rows":..,"hash":..}，
+// 同层按行键有序，节点覆盖到同层下一节点的start为止；第一个节点start为空，表示范围起点。
+//
+// 结果（任务进度JSON中的"result"）：
+//   {"table":..,"rows":..,"hash":..,"leaves":..,"levels":..,
+//    "regions":[{"start":..,"end":..,"rows":..,"hash":..},..],"top":[{"start":..,"rows":..,"hash":..},..]}
+// regions为各Region切分的哈希（只有两侧Region划分相同时可以直接对比），top为顶层节点。
+
+namespace bridge {
+
+struct ChecksumOptions {
+    ScanRange range;
+    std::string path;
+    bool timestamps;
+    uint32_t leafRows;
+    uint32_t fanout;
+    int threads;
+
+    ChecksumOptions();
+};
+
+bool parseChecksumOptions(const std::string& text, ChecksumOptions& options, std::string& error);
+
+// 在当前线程（任务线程）中计算校验树，概要通过job.setResult返回
+bool runChecksum(const ChecksumOptions& options, jobs::Job& job, std::string& error);
+
+// 对比两个校验树文件，从顶层向下只展开哈希不同的范围，结果写入json：
+//   {"status":"success","equal":..,"rows":[a,b],"ranges":[{"start":..,"end":..,"rows":[a,b]},..],"truncated":..}
+// start为null表示范围起点，end为null表示范围终点；最多列出maxRanges个叶子范围
+bool compareChecksumFiles(const std::string& pathA, const std::string& pathB, uint32_t maxRanges,
+                          std::string& json, std::string& error);
+
+} // namespace bridge
+
+#endif // TABLE_CHECKSUM_H
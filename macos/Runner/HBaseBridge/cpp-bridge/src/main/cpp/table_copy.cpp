@@ -0,0 +1,491 @@
+#include "table_copy.h"
+#include "bounded_queue.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cell_codec.h"
+#include "jni_support.h"
+#include "json_util.h"
+#include "memory_budget.h"
+#include "qos.h"
+#include "rate_limiter.h"
+#include "spec_util.h"
+#include "table_writer.h"
+#include "value_decoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace bridge {
+
+namespace {
+
+const char* const CHECKPOINT_MAGIC = "HBCOPY1";
+// 检查点的最短保存间隔
+const int CHECKPOINT_INTERVAL_MS = 2000;
+
+struct CopyBatch {
+    size_t split;
+    uint64_t sequence; // 切分内的批次序号
+    std::vector<uint8_t> data;
+    uint64_t rows;
+    uint64_t cells;
+    std::string lastRow; // 批次最后一行的行键（十六进制）
+};
+
+// 一个切分的进度。批次由多个写入线程乱序完成，只有连续写完的前缀才能作为续传位置
+struct SplitState {
+    std::string start; // 切分边界（十六进制，空为不限）
+    std::string stop;
+    std::string resume; // 已连续写入的最后一行（十六进制），空为还没有
+    bool done;
+    bool scanFinished;
+    uint64_t scanned; // 已入队的批次数
+    uint64_t written; // 已连续写完的批次数
+    std::map<uint64_t, std::string> finished; // 已写完但前面还有未完成批次的：序号 -> 最后一行
+
+    SplitState() : done(false), scanFinished(false), scanned(0), written(0) {}
+};
+
+std::string toHex(const std::string& bytes) {
+    std::string hex;
+    decode::appendHex(hex, bytes.data(), bytes.size());
+    return hex;
+}
+
+struct Context {
+    const CopyOptions* options;
+    jobs::Job* job;
+    std::vector<SplitState> splits;
+    BoundedQueue<CopyBatch> queue;
+    mem::Reservation memory; // 已扫描、尚未写入的批次
+    TokenBucket rowsBucket;
+    TokenBucket bytesBucket;
+    std::atomic<size_t> nextSplit;
+    std::atomic<size_t> doneSplits;
+    std::atomic<bool> failed;
+    std::mutex mutex; // 保护splits的进度、error与检查点文件
+    std::chrono::steady_clock::time_point lastSave;
+    std::string error;
+
+    explicit Context(size_t queueDepth) : queue(queueDepth), memory("copy") {}
+
+    void fail(const std::string& message) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failed.exchange(true)) {
+                error = message;
+            }
+        }
+        // 唤醒等待预算的扫描线程，并归还队列中丢弃的批次
+        memory.abort();
+        queue.abort([this](CopyBatch& batch) { memory.release(batch.data.size()); });
+    }
+
+    bool stopped() const { return failed.load() || job->isCancelRequested(); }
+};
+
+// 复制多个版本或时间范围时写入检查点头，默认设置时为空（与旧检查点兼容）
+std::string versionSuffix(const ScanRange& source) {
+    if (source.maxVersions == 1 && source.minTime == 0 && source.maxTime == 0) {
+        return std::string();
+    }
+    char text[96];
+    snprintf(text, sizeof(text), "\tv%d:%lld:%lld", source.maxVersions, (long long)source.minTime,
+             (long long)source.maxTime);
+    return text;
+}
+
+std::string checkpointHeader(const CopyOptions& options) {
+    const ScanRange& source = options.source;
+    return std::string(CHECKPOINT_MAGIC) + "\t" + toHex(source.tableName) + "\t" + toHex(source.startRow)
+        + "\t" + toHex(source.stopRow) + "\t" + toHex(source.prefix) + "\t" + toHex(source.columns)
+        + "\t" + toHex(options.targetTable) + versionSuffix(source);
+}
+
+// 调用方持有context.mutex
+bool saveCheckpoint(Context& context, std::string& error) {
+    const std::string& path = context.options->checkpoint;
+    std::string text = checkpointHeader(*context.options) + "\n";
+    for (size_t i = 0; i < context.splits.size(); ++i) {
+        const SplitState& split = context.splits[i];
+        text += split.start + "\t" + split.stop + "\t";
+        text += split.done ? "done" : split.resume.empty() ? "-" : "@" + split.resume;
+        text += "\n";
+    }
+    std::string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    bool ok = file != nullptr && fwrite(text.data(), 1, text.size(), file) == text.size();
+    if (file != nullptr && fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(tempPath.c_str(), path.c_str()) != 0) {
+        remove(tempPath.c_str());
+        error = "无法保存复制检查点: " + path;
+        return false;
+    }
+    context.lastSave = std::chrono::steady_clock::now();
+    return true;
+}
+
+// 检查点不存在时返回true且splits为空
+bool loadCheckpoint(const CopyOptions& options, std::vector<SplitState>& splits, std::string& error) {
+    std::ifstream in(options.checkpoint.c_str());
+    if (!in) {
+        return true;
+    }
+    std::string line;
+    if (!std::getline(in, line) || line != checkpointHeader(options)) {
+        error = "检查点与本次复制的表或范围不同: " + options.checkpoint;
+        return false;
+    }
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields = spec::split(line, '\t');
+        if (fields.size() != 3) {
+            error = "检查点文件格式错误: " + options.checkpoint;
+            return false;
+        }
+        SplitState split;
+        split.start = fields[0];
+        split.stop = fields[1];
+        if (fields[2] == "done") {
+            split.done = true;
+        } else if (fields[2].size() > 1 && fields[2][0] == '@') {
+            split.resume = fields[2].substr(1);
+        } else if (fields[2] != "-") {
+            error = "检查点文件格式错误: " + options.checkpoint;
+            return false;
+        }
+        splits.push_back(split);
+    }
+    if (splits.empty()) {
+        error = "检查点文件格式错误: " + options.checkpoint;
+        return false;
+    }
+    return true;
+}
+
+void markSplitDone(Context& context, SplitState& split) {
+    split.done = true;
+    size_t done = context.doneSplits.fetch_add(1) + 1;
+    context.job->setDetail("已完成 " + std::to_string((unsigned long long)done) + "/"
+        + std::to_string((unsigned long long)context.splits.size()) + " 个Region");
+}
+
+// 按令牌桶等待，分段睡眠以便及时响应取消
+void throttle(Context& context, TokenBucket& bucket, double amount) {
+    double seconds = bucket.reserve(amount);
+    std::chrono::steady_clock::time_point until = std::chrono::steady_clock::now()
+        + std::chrono::microseconds((int64_t)(seconds * 1e6));
+    while (seconds > 0 && !context.stopped()) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now >= until) {
+            break;
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(until - now,
+            std::chrono::milliseconds(100)));
+    }
+}
+
+bool scanSplit(Context& context, size_t index) {
+    trace::Span span("copy.region");
+    ScanRange range = context.options->source;
+    {
+        std::lock_guard<std::mutex> lock(context.mutex);
+        const SplitState& split = context.splits[index];
+        // 从已写入的最后一行之后继续：行键后追加一个0字节是紧随其后的最小行键
+        range.splitStart = split.resume.empty() ? split.start : split.resume + "00";
+        range.splitStop = split.stop;
+    }
+    ScannerReader reader;
+    std::string error;
+    if (!reader.open(range, error)) {
+        context.fail(error);
+        return false;
+    }
+    uint64_t sequence = 0;
+    while (!context.stopped()) {
+        CopyBatch batch;
+        if (!reader.next(batch.data, error)) {
+            if (!error.empty()) {
+                context.fail(error);
+                return false;
+            }
+            break;
+        }
+        batch.split = index;
+        batch.sequence = sequence;
+        batch.rows = 0;
+        batch.cells = 0;
+        codec::BatchReader cells(batch.data.data(), batch.data.size());
+        codec::CellView cell;
+        const char* lastRow = nullptr;
+        uint32_t lastRowLength = 0;
+        while (cells.next(cell)) {
+            if (cell.row != lastRow) {
+                lastRow = cell.row;
+                lastRowLength = cell.rowLength;
+                ++batch.rows;
+            }
+            ++batch.cells;
+        }
+        if (cells.hasError()) {
+            context.fail(cells.error());
+            return false;
+        }
+        if (batch.cells == 0) {
+            continue;
+        }
+        batch.lastRow = toHex(std::string(lastRow, lastRowLength));
+        context.job->bytesRead.fetch_add(batch.data.size());
+        // 超出内存预算时等待写线程追上
+        size_t bytes = batch.data.size();
+        if (!context.memory.acquire(bytes)) {
+            return false;
+        }
+        if (!context.queue.push(std::move(batch))) {
+            context.memory.release(bytes);
+            return false;
+        }
+        ++sequence;
+    }
+    if (context.stopped()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(context.mutex);
+    SplitState& split = context.splits[index];
+    split.scanFinished = true;
+    split.scanned = sequence;
+    if (split.written == split.scanned) {
+        markSplitDone(context, split);
+    }
+    return true;
+}
+
+void runScanner(Context* context) {
+    qos::ClassScope qosScope(*context->job);
+    while (!context->stopped()) {
+        size_t index = context->nextSplit.fetch_add(1);
+        if (index >= context->splits.size()) {
+            break;
+        }
+        if (context->splits[index].done) {
+            continue;
+        }
+        if (!scanSplit(*context, index)) {
+            break;
+        }
+    }
+    detachCurrentThread();
+}
+
+void runWriter(Context* context) {
+    qos::ClassScope qosScope(*context->job);
+    {
+        const CopyOptions& options = *context->options;
+        TableWriter writer(options.targetTable, options.targetCluster);
+        if (!writer.isValid()) {
+            context->fail("无法写入目标表: " + options.targetTable);
+        }
+        CopyBatch batch;
+        while (!context->stopped() && context->queue.pop(batch)) {
+            throttle(*context, context->rowsBucket, (double)batch.rows);
+            throttle(*context, context->bytesBucket, (double)batch.data.size());
+            if (context->stopped()) {
+                context->memory.release(batch.data.size());
+                break;
+            }
+            int status = writer.write(batch.data);
+            context->memory.release(batch.data.size());
+            if (status < 0) {
+                context->fail("写入目标表失败: " + options.targetTable);
+                break;
+            }
+            context->job->rows.fetch_add(batch.rows);
+            context->job->cells.fetch_add(batch.cells);
+            context->job->bytesWritten.fetch_add(batch.data.size());
+
+            std::lock_guard<std::mutex> lock(context->mutex);
+            SplitState& split = context->splits[batch.split];
+            split.finished[batch.sequence] = batch.lastRow;
+            std::map<uint64_t, std::string>::iterator next = split.finished.begin();
+            while (next != split.finished.end() && next->first == split.written) {
+                split.resume.swap(next->second);
+                split.finished.erase(next++);
+                ++split.written;
+            }
+            if (split.scanFinished && split.written == split.scanned && !split.done) {
+                markSplitDone(*context, split);
+            }
+            std::string error;
+            if (!options.checkpoint.empty() && std::chrono::steady_clock::now() - context->lastSave
+                    >= std::chrono::milliseconds(CHECKPOINT_INTERVAL_MS) && !saveCheckpoint(*context, error)) {
+                // 检查点只影响续传，保存失败时记录日志并继续复制
+                BRIDGE_LOG_WARN(error);
+            }
+        }
+    } // TableWriter的局部引用需要在解除附加前释放
+    detachCurrentThread();
+}
+
+} // namespace
+
+CopyOptions::CopyOptions()
+    : threads(4), writers(2), queueDepth(0), rowsPerSecond(0), bytesPerSecond(0) {
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores > 0) {
+        threads = (int)std::min(8u, cores);
+    }
+    source.batchRows = 1000;
+}
+
+bool parseCopyOptions(const std::string& text, CopyOptions& options, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(text, entries, error)) {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        uint64_t number = 0;
+        bool ok = true;
+        if (key == "sourceCluster") {
+            options.source.cluster = value;
+        } else if (key == "targetCluster") {
+            options.targetCluster = value;
+        } else if (key == "columns") {
+            options.source.columns = value;
+        } else if (key == "threads") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 64;
+            options.threads = (int)number;
+        } else if (key == "writers") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 64;
+            options.writers = (int)number;
+        } else if (key == "queueDepth") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 1024;
+            options.queueDepth = (int)number;
+        } else if (key == "batchRows") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 1000000;
+            options.source.batchRows = (int)number;
+        } else if (key == "batchBytes") {
+            ok = spec::parseUint(value, number) && number >= 1024 && number <= (256u << 20);
+            options.source.batchBytes = (int)number;
+        } else if (key == "rowsPerSecond") {
+            ok = spec::parseDouble(value, options.rowsPerSecond) && options.rowsPerSecond >= 0;
+        } else if (key == "bytesPerSecond") {
+            ok = spec::parseDouble(value, options.bytesPerSecond) && options.bytesPerSecond >= 0;
+        } else if (key == "checkpoint") {
+            options.checkpoint = value;
+        } else if (parseVersionOption(key, value, options.source, ok)) {
+            // versions / minTime / maxTime / timestamp：复制多个版本或只复制一段时间内的写入
+        } else {
+            error = "未知的复制选项: " + key;
+            return false;
+        }
+        if (!ok) {
+            error = "复制选项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+    if (options.queueDepth == 0) {
+        options.queueDepth = options.threads * 2;
+    }
+    if (options.source.tableName == options.targetTable && options.source.cluster == options.targetCluster) {
+        error = "复制的源表与目标表相同: " + options.targetTable;
+        return false;
+    }
+    return true;
+}
+
+bool runCopy(const CopyOptions& options, jobs::Job& job, std::string& error) {
+    trace::Span span("copy.run");
+    Context context((size_t)options.queueDepth);
+    context.options = &options;
+    context.job = &job;
+    context.nextSplit = 0;
+    context.doneSplits = 0;
+    context.failed = false;
+    context.rowsBucket.setRate(options.rowsPerSecond);
+    context.bytesBucket.setRate(options.bytesPerSecond);
+
+    size_t skipped = 0;
+    if (!options.checkpoint.empty()) {
+        if (!loadCheckpoint(options, context.splits, error)) {
+            return false;
+        }
+        for (size_t i = 0; i < context.splits.size(); ++i) {
+            skipped += context.splits[i].done ? 1 : 0;
+        }
+    }
+    if (context.splits.empty()) {
+        std::vector<ScanRange> ranges;
+        if (!splitByRegion(options.source, ranges, error)) {
+            return false;
+        }
+        context.splits.resize(ranges.size());
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            context.splits[i].start = ranges[i].splitStart;
+            context.splits[i].stop = ranges[i].splitStop;
+        }
+    } else {
+        BRIDGE_LOG_INFO("按检查点继续复制，跳过 " << skipped << "/" << context.splits.size() << " 个已完成的Region");
+    }
+    context.doneSplits = skipped;
+    if (!options.checkpoint.empty()) {
+        std::lock_guard<std::mutex> lock(context.mutex);
+        if (!saveCheckpoint(context, error)) {
+            return false;
+        }
+    }
+
+    int scanners = (int)std::min<size_t>((size_t)options.threads, context.splits.size());
+    BRIDGE_LOG_INFO("复制 " << options.source.tableName << " 到 " << options.targetTable << "："
+        << context.splits.size() << " 个Region，" << scanners << " 个扫描线程，" << options.writers << " 个写入线程");
+    std::vector<std::thread> writers;
+    for (int i = 0; i < options.writers; ++i) {
+        writers.push_back(std::thread(runWriter, &context));
+    }
+    std::vector<std::thread> readers;
+    for (int i = 0; i < scanners; ++i) {
+        readers.push_back(std::thread(runScanner, &context));
+    }
+    for (size_t i = 0; i < readers.size(); ++i) {
+        readers[i].join();
+    }
+    context.queue.close();
+    for (size_t i = 0; i < writers.size(); ++i) {
+        writers[i].join();
+    }
+
+    bool complete = context.doneSplits.load() == context.splits.size();
+    if (!options.checkpoint.empty()) {
+        std::lock_guard<std::mutex> lock(context.mutex);
+        std::string saveError;
+        if (complete) {
+            remove(options.checkpoint.c_str());
+        } else if (!saveCheckpoint(context, saveError)) {
+            BRIDGE_LOG_WARN(saveError);
+        }
+    }
+    if (context.failed.load()) {
+        error = context.error;
+        return false;
+    }
+    if (job.isCancelRequested()) {
+        return false;
+    }
+    job.setResult("{\"regions\":" + std::to_string((unsigned long long)context.splits.size())
+        + ",\"skipped\":" + std::to_string((unsigned long long)skipped)
+        + ",\"rows\":" + std::to_string((unsigned long long)job.rows.load())
+        + ",\"cells\":" + std::to_string((unsigned long long)job.cells.load())
+        + ",\"bytes\":" + std::to_string((unsigned long long)job.bytesWritten.load()) + "}");
+    return true;
+}
+
+} // namespace bridge
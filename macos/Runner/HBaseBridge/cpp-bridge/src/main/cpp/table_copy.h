@@ -0,0 +1,55 @@
+#ifndef TABLE_COPY_H
+#define TABLE_COPY_H
+
+#include "job_registry.h"
+#include "scanner_reader.h"
+
+#include <stdint.h>
+#include <string>
+
+// 表复制（可以跨集群，见connectPeer）：范围按源表的Region切分，多个扫描线程并行扫描各切分，
+// 扫描到的cell_codec批次经有界队列交给写入线程，原样作为批量Put写入目标表（保留时间戳）。
+// 写入按行数、字节数限速，队列满时扫描线程阻塞，源集群的读取速率随之受限。
+//
+// 检查点：指定checkpoint文件后，每个切分记录已经连续写入的最后一个行键（或已完成），
+// 定期及结束时保存。任务失败或取消后用同一个检查点重新启动，跳过已完成的切分，
+// 未完成的切分从记录的行键之后继续；全部完成后删除检查点文件。
+//
+// 选项字符串（key=value，以 ; 或 & 分隔）：
+//   sourceCluster / targetCluster  两侧所在集群（默认主连接）
+//   columns         只复制这些列 "cf:q,cf"（默认全部列）
+//   threads         并行扫描的切分数（默认CPU核数，最多8）
+//   writers         写入线程数（默认2）
+//   queueDepth      队列最多缓存的批次数（默认threads*2）
+//   batchRows / batchBytes  每个批次的上限（默认1000行/4MiB）
+//   rowsPerSecond / bytesPerSecond  写入限速（默认不限）
+//   checkpoint      检查点文件路径（默认不记录）
+//   versions / minTime / maxTime / timestamp  复制的版本数与时间范围（见scanner_reader.h，默认只复制最新版本）
+//
+// 结果（任务进度JSON中的"result"）：{"regions":..,"skipped":..,"rows":..,"cells":..,"bytes":..}
+// skipped为按检查点跳过的已完成切分数。
+
+namespace bridge {
+
+struct CopyOptions {
+    ScanRange source; // 源表、集群、范围与投影列
+    std::string targetTable;
+    std::string targetCluster;
+    int threads;
+    int writers;
+    int queueDepth;
+    double rowsPerSecond;
+    double bytesPerSecond;
+    std::string checkpoint;
+
+    CopyOptions();
+};
+
+bool parseCopyOptions(const std::string& text, CopyOptions& options, std::string& error);
+
+// 在当前线程（任务线程）中执行复制，进度写入job
+bool runCopy(const CopyOptions& options, jobs::Job& job, std::string& error);
+
+} // namespace bridge
+
+#endif // TABLE_COPY_H
@@ -0,0 +1,535 @@
+#include "table_diff.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cell_codec.h"
+#include "hash_util.h"
+#include "jni_support.h"
+#include "json_util.h"
+#include "qos.h"
+#include "spec_util.h"
+#include "value_decoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace bridge {
+
+namespace {
+
+// 差异行缓冲超过该大小时写入文件
+const size_t FLUSH_BYTES = 1 << 20;
+
+int compareBytes(const char* a, uint32_t aLength, const char* b, uint32_t bLength) {
+    int order = memcmp(a, b, std::min(aLength, bLength));
+    if (order != 0) {
+        return order;
+    }
+    return aLength < bLength ? -1 : aLength > bLength ? 1 : 0;
+}
+
+// 按行遍历一个扫描：Java层按完整的Result组批，一行不会跨批次
+class RowCursor {
+public:
+    RowCursor() : row_(0), end_(false), bytesRead_(0) {}
+
+    bool open(const ScanRange& range, std::string& error) {
+        if (!reader_.open(range, error)) {
+            return false;
+        }
+        rowStarts_.assign(1, 0);
+        row_ = 0;
+        return advance(error);
+    }
+
+    bool atEnd() const { return end_; }
+
+    const char* key() const { return cells_[rowStarts_[row_]].row; }
+    uint32_t keyLength() const { return cells_[rowStarts_[row_]].rowLength; }
+    const codec::CellView* cells() const { return &cells_[rowStarts_[row_]]; }
+    size_t cellCount() const { return rowStarts_[row_ + 1] - rowStarts_[row_]; }
+
+    // 前进到下一行（open后位于第一行），扫描结束时atEnd()为true；出错返回false
+    bool advance(std::string& error) {
+        if (!cells_.empty()) {
+            ++row_;
+        }
+        while (row_ + 1 >= rowStarts_.size()) {
+            if (!reader_.next(batch_, error)) {
+                if (!error.empty()) {
+                    return false;
+                }
+                end_ = true;
+                reader_.close();
+                return true;
+            }
+            bytesRead_ += batch_.size();
+            if (!load(error)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 自上次调用以来读取的字节数
+    uint64_t takeBytesRead() {
+        uint64_t bytes = bytesRead_;
+        bytesRead_ = 0;
+        return bytes;
+    }
+
+private:
+    bool load(std::string& error) {
+        cells_.clear();
+        rowStarts_.clear();
+        row_ = 0;
+        codec::BatchReader reader(batch_.data(), batch_.size());
+        codec::CellView cell;
+        while (reader.next(cell)) {
+            if (cells_.empty() || (cell.row != cells_.back().row
+                    && compareBytes(cell.row, cell.rowLength, cells_.back().row, cells_.back().rowLength) != 0)) {
+                rowStarts_.push_back(cells_.size());
+            }
+            cells_.push_back(cell);
+        }
+        if (reader.hasError()) {
+            error = reader.error();
+            return false;
+        }
+        rowStarts_.push_back(cells_.size());
+        return true;
+    }
+
+    ScannerReader reader_;
+    std::vector<uint8_t> batch_;
+    std::vector<codec::CellView> cells_;
+    std::vector<size_t> rowStarts_; // 每行第一个单元格的下标，末尾为cells_.size()
+    size_t row_;
+    bool end_;
+    uint64_t bytesRead_;
+};
+
+int compareColumns(const codec::CellView& a, const codec::CellView& b) {
+    int order = compareBytes(a.family, a.familyLength, b.family, b.familyLength);
+    if (order != 0) {
+        return order;
+    }
+    return compareBytes(a.qualifier, a.qualifierLength, b.qualifier, b.qualifierLength);
+}
+
+bool sameCell(const codec::CellView& a, const codec::CellView& b, bool timestamps) {
+    return a.fullValueLength == b.fullValueLength && a.valueLength == b.valueLength
+        && memcmp(a.value, b.value, a.valueLength) == 0 && (!timestamps || a.timestamp == b.timestamp);
+}
+
+struct Counts {
+    uint64_t rows;
+    uint64_t same;
+    uint64_t changed;
+    uint64_t onlySource;
+    uint64_t onlyTarget;
+    uint64_t cells;
+
+    Counts() : rows(0), same(0), changed(0), onlySource(0), onlyTarget(0), cells(0) {}
+
+    void merge(const Counts& other) {
+        rows += other.rows;
+        same += other.same;
+        changed += other.changed;
+        onlySource += other.onlySource;
+        onlyTarget += other.onlyTarget;
+        cells += other.cells;
+    }
+};
+
+struct Context {
+    const DiffOptions* options;
+    const std::vector<ScanRange>* splits;
+    jobs::Job* job;
+    FILE* output;
+    std::atomic<size_t> nextSplit;
+    std::atomic<size_t> doneSplits;
+    std::atomic<uint64_t> differences;
+    std::atomic<bool> failed;
+    std::mutex mutex; // 保护counts、keys、error与输出文件
+    Counts counts;
+    std::vector<std::string> keys; // 各切分中最小的maxKeys个差异行键
+    std::string error;
+
+    void fail(const std::string& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!failed.exchange(true)) {
+            error = message;
+        }
+    }
+};
+
+// 一个工作线程的状态，切分之间复用
+struct Worker {
+    Context* context;
+    Counts counts;
+    std::vector<std::string> keys;
+    size_t splitKeys; // 当前切分已记录的差异行键数
+    std::string lines; // 待写入的差异行
+
+    bool flush() {
+        if (lines.empty() || context->output == nullptr) {
+            lines.clear();
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(context->mutex);
+        bool ok = fwrite(lines.data(), 1, lines.size(), context->output) == lines.size();
+        if (ok) {
+            context->job->bytesWritten.fetch_add(lines.size());
+        }
+        lines.clear();
+        return ok;
+    }
+};
+
+void appendColumn(std::string& out, const codec::CellView& cell) {
+    out += '"';
+    decode::appendAuto(out, cell.family, cell.familyLength);
+    out += ':';
+    decode::appendAuto(out, cell.qualifier, cell.qualifierLength);
+    out += '"';
+}
+
+void appendValue(std::string& out, const codec::CellView* cell) {
+    if (cell == nullptr) {
+        out += "null";
+        return;
+    }
+    out += '"';
+    decode::appendAuto(out, cell->value, cell->valueLength);
+    out += '"';
+}
+
+void appendCell(std::string& out, const codec::CellView* source, const codec::CellView* target, bool timestamps) {
+    out += "{\"column\":";
+    appendColumn(out, source != nullptr ? *source : *target);
+    out += ",\"source\":";
+    appendValue(out, source);
+    out += ",\"target\":";
+    appendValue(out, target);
+    if (timestamps) {
+        if (source != nullptr) {
+            out += ",\"sourceTimestamp\":" + std::to_string((long long)source->timestamp);
+        }
+        if (target != nullptr) {
+            out += ",\"targetTimestamp\":" + std::to_string((long long)target->timestamp);
+        }
+    }
+    out += '}';
+}
+
+// 按字节序排序，只保留最小的limit个行键
+void trimKeys(std::vector<std::string>& keys, size_t limit) {
+    std::sort(keys.begin(), keys.end(), [](const std::string& a, const std::string& b) {
+        return compareBytes(a.data(), (uint32_t)a.size(), b.data(), (uint32_t)b.size()) < 0;
+    });
+    if (keys.size() > limit) {
+        keys.resize(limit);
+    }
+}
+
+// 记录一个差异行，返回有差异的单元格数。source/target为nullptr表示该侧没有这一行
+uint64_t recordRow(Worker& worker, const RowCursor* source, const RowCursor* target, const char* status) {
+    const RowCursor& present = source != nullptr ? *source : *target;
+    if (worker.splitKeys < worker.context->options->maxKeys) {
+        worker.keys.push_back(std::string(present.key(), present.keyLength()));
+        ++worker.splitKeys;
+    }
+    bool timestamps = worker.context->options->timestamps;
+    bool writing = worker.context->output != nullptr;
+    std::string& out = worker.lines;
+    if (writing) {
+        out += "{\"row\":\"";
+        decode::appendAuto(out, present.key(), present.keyLength());
+        out += "\",\"status\":\"";
+        out += status;
+        out += "\",\"cells\":[";
+    }
+
+    // 两侧的单元格都按列有序，归并出只在一侧存在或内容不同的列
+    const codec::CellView* a = source != nullptr ? source->cells() : nullptr;
+    size_t aCount = source != nullptr ? source->cellCount() : 0;
+    const codec::CellView* b = target != nullptr ? target->cells() : nullptr;
+    size_t bCount = target != nullptr ? target->cellCount() : 0;
+    size_t i = 0;
+    size_t k = 0;
+    uint64_t differing = 0;
+    while (i < aCount || k < bCount) {
+        const codec::CellView* left = nullptr;
+        const codec::CellView* right = nullptr;
+        int order = i >= aCount ? 1 : k >= bCount ? -1 : compareColumns(a[i], b[k]);
+        if (order <= 0) {
+            left = &a[i++];
+        }
+        if (order >= 0) {
+            right = &b[k++];
+        }
+        if (left != nullptr && right != nullptr && sameCell(*left, *right, timestamps)) {
+            continue;
+        }
+        if (writing) {
+            if (differing > 0) {
+                out += ',';
+            }
+            appendCell(out, left, right, timestamps);
+        }
+        ++differing;
+    }
+    if (writing) {
+        out += "]}\n";
+    }
+    return differing;
+}
+
+// 对比一个切分，返回false表示出错或取消（错误已记录到context）
+bool diffSplit(Worker& worker, const ScanRange& sourceSplit) {
+    trace::Span span("diff.region");
+    Context& context = *worker.context;
+    const DiffOptions& options = *context.options;
+    ScanRange targetSplit = options.target;
+    targetSplit.splitStart = sourceSplit.splitStart;
+    targetSplit.splitStop = sourceSplit.splitStop;
+
+    RowCursor source;
+    RowCursor target;
+    std::string error;
+    if (!source.open(sourceSplit, error) || !target.open(targetSplit, error)) {
+        context.fail(error);
+        return false;
+    }
+
+    Counts& counts = worker.counts;
+    worker.splitKeys = 0;
+    uint64_t pendingRows = 0;
+    while (!source.atEnd() || !target.atEnd()) {
+        int order = source.atEnd() ? 1 : target.atEnd() ? -1
+            : compareBytes(source.key(), source.keyLength(), target.key(), target.keyLength());
+        uint64_t differing = 0;
+        if (order < 0) {
+            differing = recordRow(worker, &source, nullptr, "onlySource");
+            ++counts.onlySource;
+        } else if (order > 0) {
+            differing = recordRow(worker, nullptr, &target, "onlyTarget");
+            ++counts.onlyTarget;
+        } else if (hash::row(source.cells(), source.cellCount(), options.timestamps)
+                   == hash::row(target.cells(), target.cellCount(), options.timestamps)) {
+            ++counts.same;
+        } else {
+            differing = recordRow(worker, &source, &target, "changed");
+            ++counts.changed;
+        }
+        counts.cells += differing;
+        ++counts.rows;
+        if (differing > 0) {
+            context.differences.fetch_add(1);
+        }
+
+        if (order <= 0 && !source.advance(error)) {
+            break;
+        }
+        if (order >= 0 && !target.advance(error)) {
+            break;
+        }
+        if (++pendingRows == 1024) {
+            context.job->rows.fetch_add(pendingRows);
+            context.job->bytesRead.fetch_add(source.takeBytesRead() + target.takeBytesRead());
+            pendingRows = 0;
+            if (context.failed.load() || context.job->isCancelRequested()) {
+                return false;
+            }
+        }
+        if (worker.lines.size() >= FLUSH_BYTES && !worker.flush()) {
+            error = "写入差异文件失败: " + options.path;
+            break;
+        }
+    }
+    context.job->rows.fetch_add(pendingRows);
+    context.job->bytesRead.fetch_add(source.takeBytesRead() + target.takeBytesRead());
+    if (error.empty() && !worker.flush()) {
+        error = "写入差异文件失败: " + options.path;
+    }
+    if (!error.empty()) {
+        context.fail(error);
+        return false;
+    }
+    return true;
+}
+
+void runWorker(Context* context) {
+    qos::ClassScope qosScope(*context->job);
+    Worker worker;
+    worker.context = context;
+    worker.splitKeys = 0;
+    while (!context->failed.load() && !context->job->isCancelRequested()) {
+        size_t index = context->nextSplit.fetch_add(1);
+        if (index >= context->splits->size()) {
+            break;
+        }
+        if (!diffSplit(worker, (*context->splits)[index])) {
+            break;
+        }
+        // 每个切分保留了各自最小的maxKeys个行键，合并后只需保留全局最小的
+        trimKeys(worker.keys, context->options->maxKeys);
+        size_t done = context->doneSplits.fetch_add(1) + 1;
+        context->job->setDetail("已完成 " + std::to_string((unsigned long long)done) + "/"
+            + std::to_string((unsigned long long)context->splits->size()) + " 个Region，差异 "
+            + std::to_string((unsigned long long)context->differences.load()) + " 行");
+    }
+    {
+        std::lock_guard<std::mutex> lock(context->mutex);
+        context->counts.merge(worker.counts);
+        context->keys.insert(context->keys.end(), worker.keys.begin(), worker.keys.end());
+    }
+    detachCurrentThread();
+}
+
+std::string resultJson(const DiffOptions& options, const Counts& counts, std::vector<std::string>& keys,
+                       size_t regions) {
+    trimKeys(keys, options.maxKeys);
+    std::string json = "{\"source\":" + json::quote(options.source.tableName)
+        + ",\"target\":" + json::quote(options.target.tableName)
+        + ",\"regions\":" + std::to_string((unsigned long long)regions)
+        + ",\"rows\":" + std::to_string((unsigned long long)counts.rows)
+        + ",\"same\":" + std::to_string((unsigned long long)counts.same)
+        + ",\"changed\":" + std::to_string((unsigned long long)counts.changed)
+        + ",\"onlySource\":" + std::to_string((unsigned long long)counts.onlySource)
+        + ",\"onlyTarget\":" + std::to_string((unsigned long long)counts.onlyTarget)
+        + ",\"cells\":" + std::to_string((unsigned long long)counts.cells)
+        + ",\"keys\":[";
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (i > 0) {
+            json += ',';
+        }
+        json += '"';
+        decode::appendAuto(json, keys[i].data(), keys[i].size());
+        json += '"';
+    }
+    json += "]}";
+    return json;
+}
+
+} // namespace
+
+DiffOptions::DiffOptions() : timestamps(false), maxKeys(100), threads(4) {
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores > 0) {
+        threads = (int)std::min(8u, cores);
+    }
+}
+
+bool parseDiffOptions(const std::string& text, DiffOptions& options, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(text, entries, error)) {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        uint64_t number = 0;
+        bool ok = true;
+        if (key == "sourceCluster") {
+            options.source.cluster = value;
+        } else if (key == "targetCluster") {
+            options.target.cluster = value;
+        } else if (key == "columns") {
+            options.source.columns = value;
+            options.target.columns = value;
+        } else if (key == "timestamps") {
+            ok = spec::parseBool(value, options.timestamps);
+        } else if (key == "path") {
+            options.path = value;
+        } else if (key == "maxKeys") {
+            ok = spec::parseUint(value, number) && number <= 100000;
+            options.maxKeys = (uint32_t)number;
+        } else if (key == "threads") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 64;
+            options.threads = (int)number;
+        } else {
+            error = "未知的对比选项: " + key;
+            return false;
+        }
+        if (!ok) {
+            error = "对比选项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+    if (options.source.tableName == options.target.tableName && options.source.cluster == options.target.cluster) {
+        error = "对比的两侧是同一张表: " + options.source.tableName;
+        return false;
+    }
+    return true;
+}
+
+bool runDiff(const DiffOptions& options, jobs::Job& job, std::string& error) {
+    trace::Span span("diff.run");
+    // 两侧范围相同，按源表的Region切分；目标表的Region边界不同时扫描会跨Region，结果不受影响
+    std::vector<ScanRange> splits;
+    if (!splitByRegion(options.source, splits, error)) {
+        return false;
+    }
+
+    std::string partPath = options.path + ".part";
+    FILE* output = nullptr;
+    if (!options.path.empty()) {
+        output = fopen(partPath.c_str(), "wb");
+        if (output == nullptr) {
+            error = "无法创建差异文件: " + partPath;
+            return false;
+        }
+    }
+
+    Context context;
+    context.options = &options;
+    context.splits = &splits;
+    context.job = &job;
+    context.output = output;
+    context.nextSplit = 0;
+    context.doneSplits = 0;
+    context.differences = 0;
+    context.failed = false;
+
+    int threads = (int)std::min<size_t>((size_t)options.threads, splits.size());
+    BRIDGE_LOG_INFO("对比 " << options.source.tableName << " 与 " << options.target.tableName << "："
+        << splits.size() << " 个Region，" << threads << " 个线程");
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.push_back(std::thread(runWorker, &context));
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    bool ok = !context.failed.load() && !job.isCancelRequested();
+    if (output != nullptr) {
+        if (fclose(output) != 0 && ok) {
+            context.error = "写入差异文件失败: " + options.path;
+            ok = false;
+            context.failed = true;
+        }
+        if (!ok) {
+            remove(partPath.c_str());
+        } else if (rename(partPath.c_str(), options.path.c_str()) != 0) {
+            error = "无法重命名差异文件: " + partPath;
+            return false;
+        }
+    }
+    if (context.failed.load()) {
+        error = context.error;
+        return false;
+    }
+    if (!ok) {
+        return false;
+    }
+    job.setResult(resultJson(options, context.counts, context.keys, splits.size()));
+    return true;
+}
+
+} // namespace bridge
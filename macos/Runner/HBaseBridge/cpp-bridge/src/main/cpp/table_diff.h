@@ -0,0 +1,54 @@
+#ifndef TABLE_DIFF_H
+#define TABLE_DIFF_H
+
+#include "job_registry.h"
+#include "scanner_reader.h"
+
+#include <stdint.h>
+#include <string>
+
+// 两张表（可以在不同集群，见connectPeer）在同一行键范围内的对比，用于迁移、容灾校验：
+// 范围按源表的Region切分，多个线程各负责一个切分，在切分内同时扫描两侧，按行键归并；
+// 行键相同的行先比较单元格内容的XXH64，不同时才逐列比较，只输出有差异的行与单元格。
+//
+// 选项字符串（key=value，以 ; 或 & 分隔）：
+//   sourceCluster  源表所在集群（connectPeer的名称，默认主连接）
+//   targetCluster  目标表所在集群（默认主连接）
+//   columns        只对比这些列 "cf:q,cf"（默认全部列）
+//   timestamps     时间戳不同也算差异（默认false，只比较值）
+//   path           差异输出文件（NDJSON，每行一个差异行），为空时只统计
+//   maxKeys        结果中列出的差异行键个数（默认100，按行键排序取最小的）
+//   threads        并行对比的切分数（默认CPU核数，最多8）
+//
+// 输出文件每行：
+//   {"row":..,"status":"changed"|"onlySource"|"onlyTarget","cells":[{"column":"cf:q","source":..,"target":..},..]}
+// 只在一侧存在的单元格另一侧为null；timestamps=true时另有"sourceTimestamp"/"targetTimestamp"。
+// 各切分的差异按完成顺序写入，切分内按行键有序。
+//
+// 结果（任务进度JSON中的"result"）：
+//   {"source":..,"target":..,"regions":..,"rows":..,"same":..,"changed":..,"onlySource":..,"onlyTarget":..,
+//    "cells":..,"keys":[..]}
+// rows为两侧行键的并集行数，cells为有差异的单元格数。
+
+namespace bridge {
+
+struct DiffOptions {
+    ScanRange source; // 表名、集群与范围
+    ScanRange target; // 范围与source相同
+    std::string path;
+    bool timestamps;
+    uint32_t maxKeys;
+    int threads;
+
+    DiffOptions();
+};
+
+// 解析选项并写入source/target的集群与投影列
+bool parseDiffOptions(const std::string& text, DiffOptions& options, std::string& error);
+
+// 在当前线程（任务线程）中执行对比，结果通过job.setResult返回
+bool runDiff(const DiffOptions& options, jobs::Job& job, std::string& error);
+
+} // namespace bridge
+
+#endif // TABLE_DIFF_H
@@ -0,0 +1,461 @@
+#include "table_export.h"
+#include "bounded_queue.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cell_codec.h"
+#include "jni_support.h"
+#include "json_util.h"
+#include "memory_budget.h"
+#include "parquet_writer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace bridge {
+
+namespace {
+
+struct RawBatch {
+    uint64_t sequence;
+    std::vector<uint8_t> data;
+};
+
+struct EncodedBatch {
+    uint64_t sequence;
+    uint64_t rows;
+    uint64_t cells;
+    uint64_t reserved;                // 记入内存预算的字节数（原始批次大小）
+    std::string text;                 // ndjson / csv
+    std::vector<std::string> columns; // parquet，每列PLAIN编码
+};
+
+// 编码线程乱序完成，写线程按sequence顺序取出；缓存的批次数有上限
+class ReorderBuffer {
+public:
+    ReorderBuffer(size_t capacity, int producers)
+        : capacity_(capacity), producers_(producers), next_(0), aborted_(false) {}
+
+    bool put(EncodedBatch& batch) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // 下一个要写出的批次总能放入，避免所有编码线程都在等待而写线程在等它
+        changed_.wait(lock, [&] {
+            return aborted_ || batch.sequence == next_ || pending_.size() < capacity_;
+        });
+        if (aborted_) {
+            return false;
+        }
+        uint64_t sequence = batch.sequence;
+        std::swap(pending_[sequence], batch);
+        changed_.notify_all();
+        return true;
+    }
+
+    bool take(EncodedBatch& batch) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [&] {
+            return aborted_ || pending_.count(next_) != 0 || (producers_ == 0 && pending_.empty());
+        });
+        std::map<uint64_t, EncodedBatch>::iterator it = pending_.find(next_);
+        if (aborted_ || it == pending_.end()) {
+            return false;
+        }
+        std::swap(batch, it->second);
+        pending_.erase(it);
+        ++next_;
+        changed_.notify_all();
+        return true;
+    }
+
+    void producerDone() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --producers_;
+        changed_.notify_all();
+    }
+
+    // 中止并丢弃缓存的批次，归还它们记入memory的字节
+    void abort(mem::Reservation& memory) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborted_ = true;
+        for (std::map<uint64_t, EncodedBatch>::iterator it = pending_.begin(); it != pending_.end(); ++it) {
+            memory.release(it->second.reserved);
+        }
+        pending_.clear();
+        changed_.notify_all();
+    }
+
+private:
+    const size_t capacity_;
+    int producers_;
+    uint64_t next_;
+    bool aborted_;
+    std::map<uint64_t, EncodedBatch> pending_;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+};
+
+void appendCsvField(std::string& out, const char* data, size_t length) {
+    bool quote = false;
+    for (size_t i = 0; i < length && !quote; ++i) {
+        char c = data[i];
+        quote = c == ',' || c == '"' || c == '\n' || c == '\r';
+    }
+    if (!quote) {
+        out.append(data, length);
+        return;
+    }
+    out += '"';
+    for (size_t i = 0; i < length; ++i) {
+        if (data[i] == '"') {
+            out += '"';
+        }
+        out += data[i];
+    }
+    out += '"';
+}
+
+bool sameBytes(const char* a, uint32_t aLength, const char* b, uint32_t bLength) {
+    return aLength == bLength && (a == b || memcmp(a, b, aLength) == 0);
+}
+
+bool encodeBatch(ExportFormat format, const RawBatch& raw, EncodedBatch& encoded, std::string& error) {
+    trace::Span span("export.encode");
+    encoded.sequence = raw.sequence;
+    encoded.rows = 0;
+    encoded.cells = 0;
+    encoded.text.clear();
+    encoded.columns.clear();
+    if (format == EXPORT_PARQUET) {
+        encoded.columns.resize(5);
+    } else {
+        encoded.text.reserve(raw.data.size() + raw.data.size() / 4);
+    }
+
+    codec::BatchReader reader(raw.data.data(), raw.data.size());
+    codec::CellView cell;
+    const char* row = nullptr;
+    uint32_t rowLength = 0;
+    const char* family = nullptr;
+    uint32_t familyLength = 0;
+    char number[32];
+
+    while (reader.next(cell)) {
+        bool newRow = row == nullptr || !sameBytes(row, rowLength, cell.row, cell.rowLength);
+        if (newRow) {
+            ++encoded.rows;
+        }
+        ++encoded.cells;
+
+        switch (format) {
+        case EXPORT_NDJSON: {
+            bool newFamily = newRow || !sameBytes(family, familyLength, cell.family, cell.familyLength);
+            if (newRow) {
+                if (row != nullptr) {
+                    encoded.text += "}}}\n";
+                }
+                encoded.text += "{\"row\":\"";
+                json::appendText(encoded.text, cell.row, cell.rowLength);
+                encoded.text += "\",\"families\":{\"";
+            } else if (newFamily) {
+                encoded.text += "},\"";
+            } else {
+                encoded.text += ',';
+            }
+            if (newFamily) {
+                json::appendText(encoded.text, cell.family, cell.familyLength);
+                encoded.text += "\":{";
+            }
+            encoded.text += '"';
+            json::appendText(encoded.text, cell.qualifier, cell.qualifierLength);
+            encoded.text += "\":\"";
+            json::appendText(encoded.text, cell.value, cell.valueLength);
+            encoded.text += '"';
+            break;
+        }
+        case EXPORT_CSV:
+            appendCsvField(encoded.text, cell.row, cell.rowLength);
+            encoded.text += ',';
+            appendCsvField(encoded.text, cell.family, cell.familyLength);
+            encoded.text += ',';
+            appendCsvField(encoded.text, cell.qualifier, cell.qualifierLength);
+            snprintf(number, sizeof(number), ",%lld,", (long long)cell.timestamp);
+            encoded.text += number;
+            appendCsvField(encoded.text, cell.value, cell.valueLength);
+            encoded.text += '\n';
+            break;
+        case EXPORT_PARQUET:
+            parquet::appendByteArray(encoded.columns[0], cell.row, cell.rowLength);
+            parquet::appendByteArray(encoded.columns[1], cell.family, cell.familyLength);
+            parquet::appendByteArray(encoded.columns[2], cell.qualifier, cell.qualifierLength);
+            parquet::appendInt64(encoded.columns[3], cell.timestamp);
+            parquet::appendByteArray(encoded.columns[4], cell.value, cell.valueLength);
+            break;
+        }
+        row = cell.row;
+        rowLength = cell.rowLength;
+        family = cell.family;
+        familyLength = cell.familyLength;
+    }
+    if (format == EXPORT_NDJSON && row != nullptr) {
+        encoded.text += "}}}\n";
+    }
+    if (reader.hasError()) {
+        error = reader.error();
+        return false;
+    }
+    return true;
+}
+
+// 输出文件：文本格式直接追加，Parquet交给FileWriter组织行组
+class OutputSink {
+public:
+    OutputSink(const ExportOptions& options)
+        : options_(options), file_(nullptr), written_(0) {
+        if (options.format == EXPORT_PARQUET) {
+            std::vector<parquet::Column> schema;
+            parquet::Column columns[] = {
+                {"row", parquet::TYPE_BYTE_ARRAY, parquet::CONVERTED_UTF8},
+                {"family", parquet::TYPE_BYTE_ARRAY, parquet::CONVERTED_UTF8},
+                {"qualifier", parquet::TYPE_BYTE_ARRAY, parquet::CONVERTED_UTF8},
+                {"timestamp", parquet::TYPE_INT64, parquet::CONVERTED_TIMESTAMP_MILLIS},
+                {"value", parquet::TYPE_BYTE_ARRAY, parquet::CONVERTED_NONE},
+            };
+            schema.assign(columns, columns + 5);
+            parquet_.reset(new parquet::FileWriter(schema, 1 << 20, options.rowGroupBytes));
+        }
+    }
+
+    ~OutputSink() {
+        if (file_ != nullptr) {
+            fclose(file_);
+        }
+    }
+
+    bool open(const std::string& path, std::string& error) {
+        if (parquet_) {
+            return parquet_->open(path, error);
+        }
+        file_ = fopen(path.c_str(), "wb");
+        if (file_ == nullptr) {
+            error = "无法创建文件: " + path;
+            return false;
+        }
+        setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+        if (options_.format == EXPORT_CSV) {
+            std::string header("row,family,qualifier,timestamp,value\n");
+            return writeText(header, error);
+        }
+        return true;
+    }
+
+    bool write(const EncodedBatch& batch, std::string& error) {
+        trace::Span span("export.write");
+        if (parquet_) {
+            return parquet_->append(batch.columns, batch.cells, error);
+        }
+        return writeText(batch.text, error);
+    }
+
+    bool close(std::string& error) {
+        if (parquet_) {
+            return parquet_->close(error);
+        }
+        int result = fclose(file_);
+        file_ = nullptr;
+        if (result != 0) {
+            error = "关闭导出文件失败";
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t bytesWritten() const {
+        return parquet_ ? parquet_->bytesWritten() : written_;
+    }
+
+private:
+    bool writeText(const std::string& text, std::string& error) {
+        if (fwrite(text.data(), 1, text.size(), file_) != text.size()) {
+            error = "写入导出文件失败";
+            return false;
+        }
+        written_ += text.size();
+        return true;
+    }
+
+    const ExportOptions& options_;
+    FILE* file_;
+    uint64_t written_;
+    std::unique_ptr<parquet::FileWriter> parquet_;
+};
+
+// 流水线的共享状态：任一环节失败时中止所有队列
+struct Pipeline {
+    Pipeline(const ExportOptions& options)
+        : raw(options.queueDepth), encoded(options.queueDepth, options.encoderThreads), memory("export"),
+          failed(false) {}
+
+    BoundedQueue<RawBatch> raw;
+    ReorderBuffer encoded;
+    mem::Reservation memory; // 已扫描、尚未写出的批次
+    std::atomic<bool> failed;
+    std::mutex errorMutex;
+    std::string error;
+
+    void fail(const std::string& message) {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (failed.exchange(true)) {
+                return;
+            }
+            error = message;
+        }
+        // 唤醒等待预算的扫描线程，并归还队列中丢弃的批次
+        memory.abort();
+        raw.abort([this](RawBatch& batch) { memory.release(batch.data.size()); });
+        encoded.abort(memory);
+    }
+};
+
+void runEncoder(Pipeline* pipeline, ExportFormat format) {
+    RawBatch raw;
+    EncodedBatch encoded;
+    std::string error;
+    while (pipeline->raw.pop(raw)) {
+        if (!encodeBatch(format, raw, encoded, error)) {
+            pipeline->memory.release(raw.data.size());
+            pipeline->fail(error);
+            break;
+        }
+        encoded.reserved = raw.data.size();
+        if (!pipeline->encoded.put(encoded)) {
+            pipeline->memory.release(encoded.reserved);
+            break;
+        }
+    }
+    pipeline->encoded.producerDone();
+}
+
+void runWriter(Pipeline* pipeline, OutputSink* sink, jobs::Job* job) {
+    EncodedBatch batch;
+    std::string error;
+    while (pipeline->encoded.take(batch)) {
+        bool written = sink->write(batch, error);
+        pipeline->memory.release(batch.reserved);
+        if (!written) {
+            pipeline->fail(error);
+            return;
+        }
+        job->rows.fetch_add(batch.rows);
+        job->cells.fetch_add(batch.cells);
+        job->bytesWritten = sink->bytesWritten();
+    }
+}
+
+} // namespace
+
+bool parseExportFormat(const std::string& name, ExportFormat& format) {
+    if (name == "ndjson" || name == "json") {
+        format = EXPORT_NDJSON;
+    } else if (name == "csv") {
+        format = EXPORT_CSV;
+    } else if (name == "parquet") {
+        format = EXPORT_PARQUET;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+ExportOptions::ExportOptions()
+    : format(EXPORT_NDJSON), encoderThreads(2), queueDepth(8), rowGroupBytes(64 << 20) {
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores > 2) {
+        encoderThreads = (int)std::min(4u, cores - 1);
+    }
+    queueDepth = encoderThreads * 2 + 2;
+}
+
+bool runExport(const ExportOptions& options, jobs::Job& job, std::string& error) {
+    trace::Span span("export.run");
+    std::string partPath = options.path + ".part";
+    job.setDetail(options.path);
+
+    ScannerReader scanner;
+    if (!scanner.open(options.range, error)) {
+        return false;
+    }
+    OutputSink sink(options);
+    if (!sink.open(partPath, error)) {
+        return false;
+    }
+
+    Pipeline pipeline(options);
+    std::vector<std::thread> encoders;
+    for (int i = 0; i < options.encoderThreads; ++i) {
+        encoders.push_back(std::thread(runEncoder, &pipeline, options.format));
+    }
+    std::thread writer(runWriter, &pipeline, &sink, &job);
+
+    // 扫描在任务线程中进行（该线程已附加到JVM）
+    uint64_t sequence = 0;
+    std::string scanError;
+    while (!pipeline.failed.load()) {
+        if (job.isCancelRequested()) {
+            pipeline.fail("导出已取消");
+            break;
+        }
+        RawBatch raw;
+        raw.sequence = sequence;
+        if (!scanner.next(raw.data, scanError)) {
+            if (!scanError.empty()) {
+                pipeline.fail(scanError);
+            }
+            break;
+        }
+        job.bytesRead.fetch_add(raw.data.size());
+        // 超出内存预算时等待编码与写出追上
+        size_t bytes = raw.data.size();
+        if (!pipeline.memory.acquire(bytes)) {
+            pipeline.fail(cancel::statusMessage(job.token().status()));
+            break;
+        }
+        if (!pipeline.raw.push(std::move(raw))) {
+            pipeline.memory.release(bytes);
+            break;
+        }
+        ++sequence;
+    }
+    scanner.close();
+    pipeline.raw.close();
+    for (size_t i = 0; i < encoders.size(); ++i) {
+        encoders[i].join();
+    }
+    writer.join();
+
+    std::string closeError;
+    bool closed = sink.close(closeError);
+    if (pipeline.failed.load()) {
+        remove(partPath.c_str());
+        error = pipeline.error;
+        return false;
+    }
+    if (!closed) {
+        remove(partPath.c_str());
+        error = closeError;
+        return false;
+    }
+    job.bytesWritten = sink.bytesWritten();
+    if (rename(partPath.c_str(), options.path.c_str()) != 0) {
+        error = "无法重命名导出文件: " + partPath;
+        return false;
+    }
+    return true;
+}
+
+} // namespace bridge
@@ -0,0 +1,44 @@
+#ifndef TABLE_EXPORT_H
+#define TABLE_EXPORT_H
+
+#include "job_registry.h"
+#include "scanner_reader.h"
+
+#include <string>
+
+// 流式导出：扫描线程按批拉取（cell_codec格式）-> 多个编码线程并行编码 ->
+// 写文件线程按原顺序写出。各级之间是有界队列，内存占用与表大小无关。
+//
+// 输出格式：
+//   ndjson   每行一个JSON对象，结构与getTableData相同：{"row":..,"families":{"cf":{"q":"v"}}}
+//   csv      每个单元格一行：row,family,qualifier,timestamp,value（RFC 4180转义，带表头）
+//   parquet  每个单元格一行，列为 row/family/qualifier(UTF8) timestamp(TIMESTAMP_MILLIS) value(BYTE_ARRAY)
+// 写入过程中输出到 <path>.part，成功后重命名，失败或取消时删除。
+
+namespace bridge {
+
+enum ExportFormat {
+    EXPORT_NDJSON,
+    EXPORT_CSV,
+    EXPORT_PARQUET
+};
+
+bool parseExportFormat(const std::string& name, ExportFormat& format);
+
+struct ExportOptions {
+    ScanRange range;
+    std::string path;
+    ExportFormat format;
+    int encoderThreads;
+    int queueDepth;        // 每级队列最多缓存的批次数
+    size_t rowGroupBytes;  // Parquet行组大小
+
+    ExportOptions();
+};
+
+// 在当前线程（任务线程）中执行导出，进度写入job
+bool runExport(const ExportOptions& options, jobs::Job& job, std::string& error);
+
+} // namespace bridge
+
+#endif // TABLE_EXPORT_H
@@ -0,0 +1,436 @@
+#include "table_generator.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cell_codec.h"
+#include "jni_support.h"
+#include "qos.h"
+#include "spec_util.h"
+#include "table_writer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+namespace bridge {
+namespace gen {
+
+namespace {
+
+// SplitMix64的终结函数，是64位整数上的双射，可用来打散行号而不产生重复
+uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+        state_ += 0x9e3779b97f4a7c15ULL;
+        return mix64(state_);
+    }
+
+    // [0, 1)
+    double nextDouble() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // [low, high]
+    uint64_t between(uint64_t low, uint64_t high) {
+        return high <= low ? low : low + next() % (high - low + 1);
+    }
+
+    double nextGaussian() {
+        double u1 = nextDouble();
+        double u2 = nextDouble();
+        if (u1 < 1e-300) {
+            u1 = 1e-300;
+        }
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    }
+
+private:
+    uint64_t state_;
+};
+
+// 按累积分布表抽样的Zipf分布，桶0最热
+class ZipfSampler {
+public:
+    ZipfSampler(uint32_t buckets, double exponent) : cdf_(buckets) {
+        double sum = 0;
+        for (uint32_t k = 0; k < buckets; ++k) {
+            sum += 1.0 / std::pow((double)(k + 1), exponent);
+            cdf_[k] = sum;
+        }
+        for (uint32_t k = 0; k < buckets; ++k) {
+            cdf_[k] /= sum;
+        }
+    }
+
+    uint32_t sample(Random& random) const {
+        double u = random.nextDouble();
+        std::vector<double>::const_iterator it = std::upper_bound(cdf_.begin(), cdf_.end(), u);
+        return it == cdf_.end() ? (uint32_t)cdf_.size() - 1 : (uint32_t)(it - cdf_.begin());
+    }
+
+private:
+    std::vector<double> cdf_;
+};
+
+// 每个worker共享的只读数据
+struct Context {
+    const Spec* spec;
+    std::string tableName;
+    jobs::Job* job; // 同步生成时为空
+    ZipfSampler* zipf;
+    std::string valuePool; // 值内容从该池中按随机偏移循环截取，避免逐字节生成
+
+    std::atomic<uint64_t> nextRow;
+    std::atomic<uint64_t> rows;
+    std::atomic<uint64_t> cells;
+    std::atomic<uint64_t> bytes;
+    std::atomic<uint64_t> batches;
+    std::atomic<bool> failed;
+    std::mutex errorMutex;
+    std::string error;
+
+    void fail(const std::string& message) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!failed.exchange(true)) {
+            error = message;
+        }
+    }
+
+    bool stopped() const {
+        return failed.load(std::memory_order_relaxed) || (job != nullptr && job->isCancelRequested());
+    }
+};
+
+void makeRowKey(const Spec& spec, const Context& context, uint64_t row, Random& random, std::string& key) {
+    char buffer[64];
+    switch (spec.keyPattern) {
+    case KEYS_HASHED:
+        snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)mix64(row ^ spec.seed));
+        break;
+    case KEYS_ZIPF:
+        snprintf(buffer, sizeof(buffer), "%06u-%012llu", context.zipf->sample(random), (unsigned long long)row);
+        break;
+    case KEYS_SALTED:
+        snprintf(buffer, sizeof(buffer), "%03u-%012llu",
+            (unsigned)(mix64(row) % spec.keyBuckets), (unsigned long long)row);
+        break;
+    case KEYS_SEQUENTIAL:
+    default:
+        snprintf(buffer, sizeof(buffer), "%012llu", (unsigned long long)row);
+        break;
+    }
+    key = spec.keyPrefix;
+    key += buffer;
+}
+
+uint32_t valueSize(const Spec& spec, Random& random) {
+    double size;
+    switch (spec.valueDistribution) {
+    case VALUES_UNIFORM:
+        size = (double)random.between((uint64_t)spec.valueA, (uint64_t)spec.valueB);
+        break;
+    case VALUES_LOGNORMAL:
+        size = spec.valueA * std::exp(spec.valueB * random.nextGaussian());
+        break;
+    case VALUES_FIXED:
+    default:
+        size = spec.valueA;
+        break;
+    }
+    if (size < 0) {
+        size = 0;
+    }
+    return size > spec.valueMax ? spec.valueMax : (uint32_t)size;
+}
+
+void makeValue(const Context& context, uint32_t size, Random& random, std::string& value) {
+    const std::string& pool = context.valuePool;
+    value.resize(size);
+    size_t offset = random.next() % pool.size();
+    size_t written = 0;
+    while (written < size) {
+        size_t chunk = std::min((size_t)(size - written), pool.size() - offset);
+        value.replace(written, chunk, pool, offset, chunk);
+        written += chunk;
+        offset = 0;
+    }
+}
+
+void writeRows(Context* context) {
+    const Spec& spec = *context->spec;
+    {
+        TableWriter writer(context->tableName);
+        if (!writer.isValid()) {
+            context->fail("无法初始化批量写入（JVM未初始化或缺少HBaseBridge.putCells）");
+        }
+
+        codec::BatchWriter batch;
+        std::string rowKey;
+        std::string value;
+        char qualifier[16];
+        uint64_t batchRows = 0;
+        uint64_t batchBytes = 0;
+
+        while (!context->stopped()) {
+            uint64_t first = context->nextRow.fetch_add(spec.batchRows);
+            if (first >= spec.rows) {
+                break;
+            }
+            uint64_t last = std::min(first + spec.batchRows, spec.rows);
+            for (uint64_t row = first; row < last; ++row) {
+                // 每行的随机数只由种子和行号决定，因此结果与线程划分无关
+                Random random(spec.seed * 0x9e3779b97f4a7c15ULL ^ mix64(row));
+                makeRowKey(spec, *context, row, random, rowKey);
+                for (size_t f = 0; f < spec.families.size(); ++f) {
+                    const std::string& family = spec.families[f];
+                    uint32_t qualifiers = (uint32_t)random.between(spec.minQualifiers, spec.maxQualifiers);
+                    for (uint32_t q = 0; q < qualifiers; ++q) {
+                        int qualifierLength = snprintf(qualifier, sizeof(qualifier), "q%06u", q);
+                        makeValue(*context, valueSize(spec, random), random, value);
+                        batch.add(rowKey.data(), rowKey.size(), family.data(), family.size(),
+                            qualifier, (size_t)qualifierLength, codec::LATEST_TIMESTAMP, codec::TYPE_PUT,
+                            value.data(), value.size());
+                        batchBytes += rowKey.size() + family.size() + qualifierLength + value.size();
+                    }
+                }
+                ++batchRows;
+
+                bool lastRow = row + 1 == last;
+                if ((batch.size() >= spec.batchBytes || lastRow) && !batch.empty()) {
+                    if (writer.write(batch.finish()) < 0) {
+                        context->fail("写入表 " + context->tableName + " 失败");
+                        break;
+                    }
+                    context->rows.fetch_add(batchRows);
+                    context->cells.fetch_add(batch.cellCount());
+                    context->bytes.fetch_add(batchBytes);
+                    context->batches.fetch_add(1);
+                    if (context->job != nullptr) {
+                        context->job->rows.fetch_add(batchRows);
+                        context->job->cells.fetch_add(batch.cellCount());
+                        context->job->bytesWritten.fetch_add(batchBytes);
+                    }
+                    batch.clear();
+                    batchRows = 0;
+                    batchBytes = 0;
+                }
+            }
+        }
+    }
+    detachCurrentThread();
+}
+
+void runWorker(Context* context) {
+    // 作为任务运行时绑定任务的取消令牌，限速等待与写入可以被打断
+    if (context->job != nullptr) {
+        qos::ClassScope qosScope(*context->job);
+        writeRows(context);
+    } else {
+        qos::ClassScope qosScope("generate");
+        writeRows(context);
+    }
+}
+
+bool run(const std::string& tableName, const Spec& spec, jobs::Job* job, Stats& stats, std::string& error) {
+    trace::Span span("generator.run");
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    ZipfSampler zipf(spec.keyPattern == KEYS_ZIPF ? spec.keyBuckets : 1, spec.zipfExponent);
+    Context context;
+    context.spec = &spec;
+    context.tableName = tableName;
+    context.job = job;
+    context.zipf = &zipf;
+    context.nextRow = 0;
+    context.rows = 0;
+    context.cells = 0;
+    context.bytes = 0;
+    context.batches = 0;
+    context.failed = false;
+
+    // 可打印字符组成的值池，由种子决定
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    Random poolRandom(spec.seed);
+    context.valuePool.resize(1 << 20);
+    for (size_t i = 0; i < context.valuePool.size(); ++i) {
+        context.valuePool[i] = alphabet[poolRandom.next() & 63];
+    }
+
+    BRIDGE_LOG_INFO("开始生成表 " << tableName << "：" << spec.rows << " 行，" << spec.threads << " 个写入线程");
+    std::vector<std::thread> workers;
+    for (int i = 0; i < spec.threads; ++i) {
+        workers.push_back(std::thread(runWorker, &context));
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    stats.rows = context.rows.load();
+    stats.cells = context.cells.load();
+    stats.bytes = context.bytes.load();
+    stats.batches = context.batches.load();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (context.failed.load()) {
+        error = context.error;
+        BRIDGE_LOG_ERROR("生成表 " << tableName << " 失败: " << error);
+        return false;
+    }
+    if (stats.rows < spec.rows) {
+        // 任务被取消或超过截止时间，状态由任务记录
+        BRIDGE_LOG_INFO("生成表 " << tableName << " 已停止：" << stats.rows << " 行");
+        return false;
+    }
+    BRIDGE_LOG_INFO("生成表 " << tableName << " 完成：" << stats.rows << " 行，" << stats.cells << " 个单元格，耗时 "
+        << stats.seconds << " 秒");
+    return true;
+}
+
+} // namespace
+
+Spec::Spec()
+    : rows(10000), families(1, "cf"), minQualifiers(4), maxQualifiers(4),
+      valueDistribution(VALUES_FIXED), valueA(64), valueB(0), valueMax(16u << 20),
+      keyPattern(KEYS_SEQUENTIAL), zipfExponent(1.1), keyBuckets(1000), keyPrefix("row"),
+      seed(1), threads(4), batchRows(1000), batchBytes(4u << 20) {
+}
+
+bool parseSpec(const std::string& text, Spec& spec, std::string& error) {
+    using spec::parseDouble;
+    using spec::parseUint;
+    using spec::split;
+
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(text, entries, error)) {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        uint64_t number = 0;
+        bool ok = true;
+
+        if (key == "rows") {
+            ok = parseUint(value, spec.rows);
+        } else if (key == "families") {
+            spec.families.clear();
+            std::vector<std::string> families = split(value, ',');
+            for (size_t f = 0; f < families.size(); ++f) {
+                if (!families[f].empty()) {
+                    spec.families.push_back(families[f]);
+                }
+            }
+            ok = !spec.families.empty();
+        } else if (key == "qualifiers") {
+            size_t dash = value.find('-');
+            uint64_t low = 0;
+            uint64_t high = 0;
+            if (dash == std::string::npos) {
+                ok = parseUint(value, low);
+                high = low;
+            } else {
+                ok = parseUint(value.substr(0, dash), low) && parseUint(value.substr(dash + 1), high) && low <= high;
+            }
+            spec.minQualifiers = (uint32_t)low;
+            spec.maxQualifiers = (uint32_t)high;
+        } else if (key == "values") {
+            std::vector<std::string> parts = split(value, ':');
+            if (parts.size() == 2 && parts[0] == "fixed") {
+                spec.valueDistribution = VALUES_FIXED;
+                ok = parseDouble(parts[1], spec.valueA);
+            } else if (parts.size() == 3 && parts[0] == "uniform") {
+                spec.valueDistribution = VALUES_UNIFORM;
+                ok = parseDouble(parts[1], spec.valueA) && parseDouble(parts[2], spec.valueB)
+                    && spec.valueA <= spec.valueB;
+            } else if (parts.size() == 3 && parts[0] == "lognormal") {
+                spec.valueDistribution = VALUES_LOGNORMAL;
+                ok = parseDouble(parts[1], spec.valueA) && parseDouble(parts[2], spec.valueB);
+            } else {
+                ok = false;
+            }
+        } else if (key == "valueMax") {
+            ok = parseUint(value, number) && number > 0 && number <= 0x7fffffffULL;
+            spec.valueMax = (uint32_t)number;
+        } else if (key == "keys") {
+            std::vector<std::string> parts = split(value, ':');
+            if (parts.size() == 1 && parts[0] == "sequential") {
+                spec.keyPattern = KEYS_SEQUENTIAL;
+            } else if (parts.size() == 1 && parts[0] == "hashed") {
+                spec.keyPattern = KEYS_HASHED;
+            } else if ((parts.size() == 2 || parts.size() == 3) && parts[0] == "zipf") {
+                spec.keyPattern = KEYS_ZIPF;
+                ok = parseDouble(parts[1], spec.zipfExponent) && spec.zipfExponent > 0;
+                if (ok && parts.size() == 3) {
+                    ok = parseUint(parts[2], number) && number > 0 && number <= 1000000;
+                    spec.keyBuckets = (uint32_t)number;
+                }
+            } else if (parts.size() == 2 && parts[0] == "salted") {
+                spec.keyPattern = KEYS_SALTED;
+                ok = parseUint(parts[1], number) && number > 0 && number <= 1000;
+                spec.keyBuckets = (uint32_t)number;
+            } else {
+                ok = false;
+            }
+        } else if (key == "keyPrefix") {
+            spec.keyPrefix = value;
+        } else if (key == "seed") {
+            ok = parseUint(value, spec.seed);
+        } else if (key == "threads") {
+            ok = parseUint(value, number) && number > 0 && number <= 64;
+            spec.threads = (int)number;
+        } else if (key == "batchRows") {
+            ok = parseUint(value, number) && number > 0;
+            spec.batchRows = (uint32_t)number;
+        } else if (key == "batchBytes") {
+            ok = parseUint(value, number) && number > 0;
+            spec.batchBytes = (uint32_t)number;
+        } else {
+            error = "未知的规格项: " + key;
+            return false;
+        }
+
+        if (!ok) {
+            error = "规格项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool generate(const std::string& tableName, const Spec& spec, Stats& stats, std::string& error) {
+    return run(tableName, spec, nullptr, stats, error);
+}
+
+std::string statsJson(const Stats& stats) {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer),
+        "{\"rows\":%llu,\"cells\":%llu,\"bytes\":%llu,\"batches\":%llu,\"elapsedMs\":%.0f,\"rowsPerSecond\":%.0f}",
+        (unsigned long long)stats.rows, (unsigned long long)stats.cells, (unsigned long long)stats.bytes,
+        (unsigned long long)stats.batches, stats.seconds * 1000,
+        stats.seconds > 0 ? stats.rows / stats.seconds : 0.0);
+    return buffer;
+}
+
+bool runGenerate(const std::string& tableName, const Spec& spec, jobs::Job& job, std::string& error) {
+    job.totalRows = (int64_t)spec.rows;
+    job.setDetail(tableName);
+    Stats stats;
+    bool ok = run(tableName, spec, &job, stats, error);
+    job.setResult(statsJson(stats));
+    return ok;
+}
+
+} // namespace gen
+} // namespace bridge
@@ -0,0 +1,93 @@
+#ifndef TABLE_GENERATOR_H
+#define TABLE_GENERATOR_H
+
+#include "job_registry.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// 可复现的大表生成器，用于浏览/导出等场景的压测。
+// 通过桥接层的批量写入路径（TableWriter）写入真实集群或 memory:// 内存后端。
+//
+// 规格字符串为 key=value 列表，以 ; 或 & 分隔，例如：
+//   rows=1000000;families=cf,meta;qualifiers=1-200;values=lognormal:512:1.5;keys=zipf:1.2;seed=7
+//
+//   rows        行数（默认10000）
+//   families    列族，逗号分隔（默认cf）
+//   qualifiers  每个列族的列数：固定值N或区间min-max（每行均匀取值，用于宽行）（默认4）
+//   values      值大小分布：fixed:N | uniform:min:max | lognormal:中位数:sigma（默认fixed:64）
+//   valueMax    值大小上限，截断分布长尾（默认16MiB）
+//   keys        行键模式：
+//                 sequential   顺序递增（默认）
+//                 hashed       均匀打散（与行号一一对应，不重复）
+//                 zipf:s[:n]   前缀按Zipf(s)分布集中在少数热点桶（n个桶，默认1000）
+//                 salted:n     n个盐值前缀轮转
+//   keyPrefix   行键前缀（默认row）
+//   seed        随机种子（默认1），相同规格与种子生成完全相同的数据，与线程数无关
+//   threads     写入线程数（默认4）
+//   batchRows / batchBytes  每个写入批次的行数/字节上限（默认1000行/4MiB）
+
+namespace bridge {
+namespace gen {
+
+enum KeyPattern {
+    KEYS_SEQUENTIAL,
+    KEYS_HASHED,
+    KEYS_ZIPF,
+    KEYS_SALTED
+};
+
+enum ValueDistribution {
+    VALUES_FIXED,
+    VALUES_UNIFORM,
+    VALUES_LOGNORMAL
+};
+
+struct Spec {
+    uint64_t rows;
+    std::vector<std::string> families;
+    uint32_t minQualifiers;
+    uint32_t maxQualifiers;
+    ValueDistribution valueDistribution;
+    double valueA; // fixed:大小  uniform:最小值  lognormal:中位数
+    double valueB; // uniform:最大值  lognormal:sigma
+    uint32_t valueMax;
+    KeyPattern keyPattern;
+    double zipfExponent;
+    uint32_t keyBuckets; // zipf的桶数或salted的盐值数
+    std::string keyPrefix;
+    uint64_t seed;
+    int threads;
+    uint32_t batchRows;
+    uint32_t batchBytes;
+
+    Spec();
+};
+
+// 解析规格字符串，失败返回false并写入error
+bool parseSpec(const std::string& text, Spec& spec, std::string& error);
+
+struct Stats {
+    uint64_t rows;
+    uint64_t cells;
+    uint64_t bytes; // 行键+列+值的原始字节数
+    uint64_t batches;
+    double seconds;
+};
+
+// 按规格生成数据写入表（表不存在时内存后端自动创建，真实集群需预先建表）。
+// 失败返回false并写入error，stats为已完成部分的统计
+bool generate(const std::string& tableName, const Spec& spec, Stats& stats, std::string& error);
+
+// {"rows":..,"cells":..,"bytes":..,"batches":..,"elapsedMs":..,"rowsPerSecond":..}
+std::string statsJson(const Stats& stats);
+
+// 作为后台任务生成：进度计入job的rows/cells/bytesWritten（totalRows为规格行数），
+// 取消或超过截止时间后在当前批次写完时停止。结束时statsJson作为任务结果
+bool runGenerate(const std::string& tableName, const Spec& spec, jobs::Job& job, std::string& error);
+
+} // namespace gen
+} // namespace bridge
+
+#endif // TABLE_GENERATOR_H
@@ -0,0 +1,926 @@
+#include "table_import.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cell_codec.h"
+#include "jni_support.h"
+#include "qos.h"
+#include "spec_util.h"
+#include "table_writer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace bridge {
+
+size_t parseRecord(const char* data, size_t pos, size_t end, char delimiter, bool quoting,
+                   std::vector<std::string>& fields, bool& malformed) {
+    fields.clear();
+    malformed = false;
+    std::string field;
+    while (true) {
+        field.clear();
+        if (quoting && pos < end && data[pos] == '"') {
+            ++pos;
+            bool closed = false;
+            while (pos < end) {
+                const char* quote = (const char*)memchr(data + pos, '"', end - pos);
+                if (quote == nullptr) {
+                    field.append(data + pos, end - pos);
+                    pos = end;
+                    break;
+                }
+                field.append(data + pos, quote - (data + pos));
+                pos = quote - data + 1;
+                if (pos < end && data[pos] == '"') {
+                    field += '"';
+                    ++pos;
+                } else {
+                    closed = true;
+                    break;
+                }
+            }
+            if (!closed) {
+                malformed = true;
+            }
+            // 引号后只能是分隔符或行尾
+            if (pos < end && data[pos] != delimiter && data[pos] != '\n' && data[pos] != '\r') {
+                malformed = true;
+                while (pos < end && data[pos] != delimiter && data[pos] != '\n') {
+                    ++pos;
+                }
+            }
+        } else {
+            size_t start = pos;
+            while (pos < end && data[pos] != delimiter && data[pos] != '\n') {
+                ++pos;
+            }
+            size_t fieldEnd = pos;
+            if (fieldEnd > start && data[fieldEnd - 1] == '\r' && (pos == end || data[pos] == '\n')) {
+                --fieldEnd;
+            }
+            field.assign(data + start, fieldEnd - start);
+        }
+        if (pos < end && data[pos] == '\r') {
+            ++pos;
+        }
+        fields.push_back(field);
+        if (pos >= end) {
+            return end;
+        }
+        if (data[pos] == '\n') {
+            return pos + 1;
+        }
+        ++pos; // 分隔符
+    }
+}
+
+std::vector<size_t> splitChunks(const char* data, size_t begin, size_t end, size_t chunkBytes, bool quoted) {
+    std::vector<size_t> starts;
+    starts.push_back(begin);
+    if (!quoted) {
+        size_t target = begin + chunkBytes;
+        while (target < end) {
+            const char* newline = (const char*)memchr(data + target, '\n', end - target);
+            if (newline == nullptr) {
+                break;
+            }
+            size_t next = newline - data + 1;
+            if (next >= end) {
+                break;
+            }
+            starts.push_back(next);
+            target = next + chunkBytes;
+        }
+        return starts;
+    }
+
+    bool inQuotes = false;
+    size_t target = begin + chunkBytes;
+    for (size_t pos = begin; pos < end; ++pos) {
+        char c = data[pos];
+        if (c == '"') {
+            inQuotes = !inQuotes;
+        } else if (c == '\n' && !inQuotes && pos + 1 >= target && pos + 1 < end) {
+            starts.push_back(pos + 1);
+            target = pos + 1 + chunkBytes;
+        }
+    }
+    return starts;
+}
+
+namespace {
+
+// 只读映射整个输入文件，由操作系统按需换入换出，不占用进程堆内存
+class MappedFile {
+public:
+    MappedFile() : data_(nullptr), size_(0) {}
+
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            munmap((void*)data_, size_);
+        }
+    }
+
+    bool open(const std::string& path, std::string& error) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "无法打开文件: " + path;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            error = "无法读取文件信息: " + path;
+            return false;
+        }
+        size_ = (size_t)info.st_size;
+        if (size_ > 0) {
+            void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                error = "无法映射文件: " + path;
+                return false;
+            }
+            data_ = (const char*)mapped;
+            madvise(mapped, size_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+        return true;
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const char* data_;
+    size_t size_;
+};
+
+enum TargetKind {
+    TARGET_SKIP,
+    TARGET_ROWKEY,
+    TARGET_CELL
+};
+
+struct Target {
+    TargetKind kind;
+    std::string family;
+    std::string qualifier;
+};
+
+// 输入列到单元格的映射
+struct Layout {
+    bool longFormat; // row,family,qualifier,timestamp,value
+    std::vector<Target> targets;
+};
+
+Target parseTarget(const std::string& name, const std::string& defaultFamily) {
+    Target target;
+    target.kind = TARGET_CELL;
+    if (name == "-" || name.empty()) {
+        target.kind = TARGET_SKIP;
+        return target;
+    }
+    if (name == "rowkey") {
+        target.kind = TARGET_ROWKEY;
+        return target;
+    }
+    size_t colon = name.find(':');
+    if (colon == std::string::npos) {
+        target.family = defaultFamily;
+        target.qualifier = name;
+    } else {
+        target.family = name.substr(0, colon);
+        target.qualifier = name.substr(colon + 1);
+    }
+    return target;
+}
+
+// 只支持导入所需的JSON子集：对象、字符串、数字/布尔（保留原文）、null；数组保留原文
+struct JsonValue {
+    enum Type { JSON_NULL, JSON_STRING, JSON_RAW, JSON_OBJECT } type;
+    std::string text; // 字符串内容或原文
+    std::vector<std::pair<std::string, JsonValue> > members;
+};
+
+class JsonParser {
+public:
+    JsonParser(const char* data, size_t length) : p_(data), end_(data + length) {}
+
+    bool parseDocument(JsonValue& value, std::string& error) {
+        skipSpace();
+        if (!parseValue(value, 0)) {
+            error = error_.empty() ? "JSON格式错误" : error_;
+            return false;
+        }
+        skipSpace();
+        if (p_ != end_) {
+            error = "JSON对象之后存在多余内容";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void skipSpace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\r' || *p_ == '\n')) {
+            ++p_;
+        }
+    }
+
+    bool fail(const char* message) {
+        if (error_.empty()) {
+            error_ = message;
+        }
+        return false;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += (char)code;
+        } else if (code < 0x800) {
+            out += (char)(0xc0 | (code >> 6));
+            out += (char)(0x80 | (code & 0x3f));
+        } else if (code < 0x10000) {
+            out += (char)(0xe0 | (code >> 12));
+            out += (char)(0x80 | ((code >> 6) & 0x3f));
+            out += (char)(0x80 | (code & 0x3f));
+        } else {
+            out += (char)(0xf0 | (code >> 18));
+            out += (char)(0x80 | ((code >> 12) & 0x3f));
+            out += (char)(0x80 | ((code >> 6) & 0x3f));
+            out += (char)(0x80 | (code & 0x3f));
+        }
+    }
+
+    bool parseHex4(uint32_t& code) {
+        if (end_ - p_ < 4) {
+            return fail("\\u转义不完整");
+        }
+        code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *p_++;
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= c - '0';
+            else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+            else return fail("\\u转义包含非法字符");
+        }
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        ++p_; // 开头的引号
+        out.clear();
+        while (p_ < end_) {
+            const char* start = p_;
+            while (p_ < end_ && *p_ != '"' && *p_ != '\\') {
+                ++p_;
+            }
+            out.append(start, p_ - start);
+            if (p_ >= end_) {
+                break;
+            }
+            if (*p_ == '"') {
+                ++p_;
+                return true;
+            }
+            ++p_; // 反斜杠
+            if (p_ >= end_) {
+                break;
+            }
+            char c = *p_++;
+            switch (c) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (!parseHex4(code)) {
+                    return false;
+                }
+                if (code >= 0xdc00 && code < 0xe000) {
+                    return fail("\\u转义中的低位代理项前缺少高位代理项");
+                }
+                if (code >= 0xd800 && code < 0xdc00) {
+                    // 高位代理项必须紧跟低位代理项，单独的代理项无法编码为UTF-8
+                    if (end_ - p_ < 6 || p_[0] != '\\' || p_[1] != 'u') {
+                        return fail("\\u转义中的高位代理项后缺少低位代理项");
+                    }
+                    p_ += 2;
+                    uint32_t low;
+                    if (!parseHex4(low)) {
+                        return false;
+                    }
+                    if (low < 0xdc00 || low >= 0xe000) {
+                        return fail("\\u转义中的高位代理项后缺少低位代理项");
+                    }
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return fail("非法的转义字符");
+            }
+        }
+        return fail("字符串缺少结束引号");
+    }
+
+    // 跳过数组或数字等，保留原文
+    bool parseRaw(std::string& out) {
+        const char* start = p_;
+        int depth = 0;
+        while (p_ < end_) {
+            char c = *p_;
+            if (c == '"') {
+                std::string ignored;
+                if (!parseString(ignored)) {
+                    return false;
+                }
+                continue;
+            }
+            if (c == '[' || c == '{') {
+                ++depth;
+            } else if (c == ']' || c == '}') {
+                if (depth == 0) {
+                    break;
+                }
+                --depth;
+            } else if (depth == 0 && (c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\n')) {
+                break;
+            }
+            ++p_;
+        }
+        if (depth != 0) {
+            return fail("数组缺少结束括号");
+        }
+        out.assign(start, p_ - start);
+        return !out.empty() || fail("缺少取值");
+    }
+
+    bool parseValue(JsonValue& value, int depth) {
+        value.members.clear();
+        if (p_ >= end_) {
+            return fail("缺少取值");
+        }
+        if (*p_ == '"') {
+            value.type = JsonValue::JSON_STRING;
+            return parseString(value.text);
+        }
+        if (*p_ == '{') {
+            if (depth > 16) {
+                return fail("JSON嵌套层数过深");
+            }
+            value.type = JsonValue::JSON_OBJECT;
+            const char* start = p_;
+            ++p_;
+            skipSpace();
+            if (p_ < end_ && *p_ == '}') {
+                ++p_;
+                value.text.assign(start, p_ - start);
+                return true;
+            }
+            while (p_ < end_) {
+                skipSpace();
+                if (p_ >= end_ || *p_ != '"') {
+                    return fail("对象的键必须是字符串");
+                }
+                value.members.push_back(std::make_pair(std::string(), JsonValue()));
+                if (!parseString(value.members.back().first)) {
+                    return false;
+                }
+                skipSpace();
+                if (p_ >= end_ || *p_ != ':') {
+                    return fail("对象的键后缺少冒号");
+                }
+                ++p_;
+                skipSpace();
+                if (!parseValue(value.members.back().second, depth + 1)) {
+                    return false;
+                }
+                skipSpace();
+                if (p_ < end_ && *p_ == ',') {
+                    ++p_;
+                    continue;
+                }
+                if (p_ < end_ && *p_ == '}') {
+                    ++p_;
+                    value.text.assign(start, p_ - start);
+                    return true;
+                }
+                return fail("对象缺少逗号或结束括号");
+            }
+            return fail("对象缺少结束括号");
+        }
+        if (end_ - p_ >= 4 && memcmp(p_, "null", 4) == 0) {
+            p_ += 4;
+            value.type = JsonValue::JSON_NULL;
+            return true;
+        }
+        value.type = JsonValue::JSON_RAW;
+        return parseRaw(value.text);
+    }
+
+    const char* p_;
+    const char* end_;
+    std::string error_;
+};
+
+struct Context {
+    const ImportOptions* options;
+    const MappedFile* file;
+    Layout layout;
+    std::vector<size_t> chunks; // 各分块起点，最后一块到文件末尾
+    size_t dataEnd;
+    jobs::Job* job;
+
+    std::atomic<size_t> nextChunk;
+    std::atomic<bool> failed;
+    std::mutex errorMutex;
+    std::string error;
+
+    void fail(const std::string& message) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!failed.exchange(true)) {
+            error = message;
+        }
+    }
+
+    // 记录一条被跳过的错误记录，超过上限时整个任务失败
+    void recordError(size_t offset, const std::string& message) {
+        uint64_t count = job->errors.fetch_add(1) + 1;
+        if (count == 1) {
+            job->setDetail(options->path + "：偏移 " + std::to_string((unsigned long long)offset) + "：" + message);
+        }
+        if (count > options->maxErrors) {
+            fail("错误记录超过上限（" + std::to_string((unsigned long long)options->maxErrors) + "），最后一个错误位于偏移 "
+                + std::to_string((unsigned long long)offset) + "：" + message);
+        }
+    }
+};
+
+// 每个解析线程自己的写入状态
+class ChunkSink {
+public:
+    ChunkSink(Context& context) : context_(context), writer_(context.options->tableName), rows_(0) {}
+
+    bool isValid() const { return writer_.isValid(); }
+
+    void add(const std::string& row, const std::string& family, const std::string& qualifier,
+             const std::string& value, int64_t timestamp) {
+        batch_.add(row, family, qualifier, value, timestamp);
+    }
+
+    // 一条记录结束，必要时写出批次
+    bool endRecord() {
+        ++rows_;
+        if (rows_ >= context_.options->batchRows || batch_.size() >= context_.options->batchBytes) {
+            return flush();
+        }
+        return true;
+    }
+
+    bool flush() {
+        if (batch_.empty()) {
+            rows_ = 0;
+            return true;
+        }
+        if (writer_.write(batch_.finish()) < 0) {
+            context_.fail("写入表 " + context_.options->tableName + " 失败");
+            return false;
+        }
+        context_.job->rows.fetch_add(rows_);
+        context_.job->cells.fetch_add(batch_.cellCount());
+        context_.job->bytesWritten.fetch_add(batch_.size());
+        batch_.clear();
+        rows_ = 0;
+        return true;
+    }
+
+private:
+    Context& context_;
+    TableWriter writer_;
+    codec::BatchWriter batch_;
+    uint64_t rows_;
+};
+
+bool parseTimestamp(const std::string& text, int64_t& timestamp) {
+    if (text.empty()) {
+        timestamp = codec::LATEST_TIMESTAMP;
+        return true;
+    }
+    char* end = nullptr;
+    long long parsed = strtoll(text.c_str(), &end, 10);
+    if (*end != '\0') {
+        return false;
+    }
+    timestamp = parsed;
+    return true;
+}
+
+// 处理一个分块中的分隔符记录
+void importDelimitedChunk(Context& context, ChunkSink& sink, size_t begin, size_t end) {
+    const ImportOptions& options = *context.options;
+    const char* data = context.file->data();
+    char delimiter = options.format == IMPORT_TSV ? '\t' : ',';
+    bool quoting = options.format == IMPORT_CSV;
+    std::vector<std::string> fields;
+    std::string rowKey;
+    bool malformed = false;
+
+    size_t pos = begin;
+    while (pos < end && !context.failed.load(std::memory_order_relaxed)) {
+        size_t recordStart = pos;
+        if (data[pos] == '\n' || (data[pos] == '\r' && pos + 1 < end && data[pos + 1] == '\n')) {
+            pos += data[pos] == '\r' ? 2 : 1; // 空行
+            continue;
+        }
+        pos = parseRecord(data, pos, end, delimiter, quoting, fields, malformed);
+        if (malformed) {
+            context.recordError(recordStart, "引号不匹配");
+            continue;
+        }
+        if (context.layout.longFormat) {
+            int64_t timestamp = 0;
+            if (fields.size() != 5 || fields[0].empty() || fields[1].empty()) {
+                context.recordError(recordStart, "长表格式的记录应为 row,family,qualifier,timestamp,value");
+                continue;
+            }
+            if (!parseTimestamp(fields[3], timestamp)) {
+                context.recordError(recordStart, "时间戳不是整数: " + fields[3]);
+                continue;
+            }
+            sink.add(fields[0], fields[1], fields[2], fields[4], timestamp);
+        } else {
+            const std::vector<Target>& targets = context.layout.targets;
+            if (fields.size() != targets.size()) {
+                context.recordError(recordStart, "列数为 " + std::to_string((unsigned long long)fields.size())
+                    + "，应为 " + std::to_string((unsigned long long)targets.size()));
+                continue;
+            }
+            rowKey.clear();
+            for (size_t i = 0; i < targets.size(); ++i) {
+                if (targets[i].kind == TARGET_ROWKEY) {
+                    rowKey = fields[i];
+                }
+            }
+            if (rowKey.empty()) {
+                context.recordError(recordStart, "行键为空");
+                continue;
+            }
+            for (size_t i = 0; i < targets.size(); ++i) {
+                // csv中的空字段视为没有该列
+                if (targets[i].kind == TARGET_CELL && !fields[i].empty()) {
+                    sink.add(rowKey, targets[i].family, targets[i].qualifier, fields[i], codec::LATEST_TIMESTAMP);
+                }
+            }
+        }
+        if (!sink.endRecord()) {
+            return;
+        }
+    }
+}
+
+// 处理一个分块中的NDJSON记录
+void importJsonChunk(Context& context, ChunkSink& sink, size_t begin, size_t end) {
+    const ImportOptions& options = *context.options;
+    const char* data = context.file->data();
+    JsonValue document;
+    std::string error;
+    std::string rowKey;
+
+    size_t pos = begin;
+    while (pos < end && !context.failed.load(std::memory_order_relaxed)) {
+        size_t lineStart = pos;
+        const char* newline = (const char*)memchr(data + pos, '\n', end - pos);
+        size_t lineEnd = newline != nullptr ? (size_t)(newline - data) : end;
+        pos = lineEnd + 1;
+
+        size_t first = lineStart;
+        while (first < lineEnd && (data[first] == ' ' || data[first] == '\t' || data[first] == '\r')) {
+            ++first;
+        }
+        if (first == lineEnd) {
+            continue;
+        }
+        JsonParser parser(data + first, lineEnd - first);
+        if (!parser.parseDocument(document, error)) {
+            context.recordError(lineStart, error);
+            continue;
+        }
+        if (document.type != JsonValue::JSON_OBJECT) {
+            context.recordError(lineStart, "每行应为一个JSON对象");
+            continue;
+        }
+
+        // 导出格式：{"row":..,"families":{"cf":{"q":"v"}}}
+        const JsonValue* row = nullptr;
+        const JsonValue* families = nullptr;
+        for (size_t i = 0; i < document.members.size(); ++i) {
+            if (document.members[i].first == "row") {
+                row = &document.members[i].second;
+            } else if (document.members[i].first == "families") {
+                families = &document.members[i].second;
+            }
+        }
+        bool structured = options.rowKey.empty() && row != nullptr && row->type == JsonValue::JSON_STRING
+            && families != nullptr && families->type == JsonValue::JSON_OBJECT && document.members.size() == 2;
+
+        size_t cells = 0;
+        if (structured) {
+            rowKey = row->text;
+            for (size_t f = 0; f < families->members.size(); ++f) {
+                const JsonValue& qualifiers = families->members[f].second;
+                if (qualifiers.type != JsonValue::JSON_OBJECT) {
+                    continue;
+                }
+                for (size_t q = 0; q < qualifiers.members.size(); ++q) {
+                    const JsonValue& value = qualifiers.members[q].second;
+                    if (value.type != JsonValue::JSON_NULL) {
+                        sink.add(rowKey, families->members[f].first, qualifiers.members[q].first, value.text,
+                            codec::LATEST_TIMESTAMP);
+                        ++cells;
+                    }
+                }
+            }
+        } else {
+            const std::string& keyField = options.rowKey.empty() ? std::string("row") : options.rowKey;
+            rowKey.clear();
+            bool found = false;
+            for (size_t i = 0; i < document.members.size() && !found; ++i) {
+                if (document.members[i].first == keyField && document.members[i].second.type != JsonValue::JSON_NULL) {
+                    rowKey = document.members[i].second.text;
+                    found = true;
+                }
+            }
+            if (!found || rowKey.empty()) {
+                context.recordError(lineStart, "缺少行键字段: " + keyField);
+                continue;
+            }
+            for (size_t i = 0; i < document.members.size(); ++i) {
+                const std::string& name = document.members[i].first;
+                const JsonValue& value = document.members[i].second;
+                if (name == keyField || value.type == JsonValue::JSON_NULL) {
+                    continue;
+                }
+                Target target = parseTarget(name, options.family);
+                sink.add(rowKey, target.family, target.qualifier, value.text, codec::LATEST_TIMESTAMP);
+                ++cells;
+            }
+        }
+        if (cells == 0) {
+            continue;
+        }
+        if (!sink.endRecord()) {
+            return;
+        }
+    }
+}
+
+void runWorker(Context* context) {
+    qos::ClassScope qosScope(*context->job);
+    {
+        ChunkSink sink(*context);
+        if (!sink.isValid()) {
+            context->fail("无法初始化批量写入（JVM未初始化或缺少HBaseBridge.putCells）");
+        }
+        while (!context->failed.load(std::memory_order_relaxed)) {
+            if (context->job->isCancelRequested()) {
+                context->fail("导入已取消");
+                break;
+            }
+            size_t index = context->nextChunk.fetch_add(1);
+            if (index >= context->chunks.size()) {
+                break;
+            }
+            size_t begin = context->chunks[index];
+            size_t end = index + 1 < context->chunks.size() ? context->chunks[index + 1] : context->dataEnd;
+            {
+                trace::Span span("import.chunk");
+                if (context->options->format == IMPORT_NDJSON) {
+                    importJsonChunk(*context, sink, begin, end);
+                } else {
+                    importDelimitedChunk(*context, sink, begin, end);
+                }
+            }
+            context->job->bytesRead.fetch_add(end - begin);
+        }
+        if (!context->failed.load()) {
+            sink.flush();
+        }
+    }
+    detachCurrentThread();
+}
+
+// 根据表头或columns选项确定列映射，返回数据部分的起点
+bool resolveLayout(const ImportOptions& options, const MappedFile& file, Layout& layout, size_t& dataStart,
+                   std::string& error) {
+    layout.longFormat = false;
+    dataStart = 0;
+    if (options.format == IMPORT_NDJSON) {
+        return true;
+    }
+
+    std::vector<std::string> header;
+    if (options.header && file.size() > 0) {
+        bool malformed = false;
+        dataStart = parseRecord(file.data(), 0, file.size(), options.format == IMPORT_TSV ? '\t' : ',',
+            options.format == IMPORT_CSV, header, malformed);
+        if (malformed) {
+            error = "表头格式错误";
+            return false;
+        }
+        // 去掉UTF-8 BOM
+        if (!header.empty() && header[0].compare(0, 3, "\xef\xbb\xbf") == 0) {
+            header[0].erase(0, 3);
+        }
+    }
+
+    if (!options.columns.empty()) {
+        for (size_t i = 0; i < options.columns.size(); ++i) {
+            layout.targets.push_back(parseTarget(options.columns[i], options.family));
+        }
+    } else if (!header.empty()) {
+        static const char* longHeader[] = {"row", "family", "qualifier", "timestamp", "value"};
+        if (header.size() == 5 && options.rowKey.empty()) {
+            layout.longFormat = true;
+            for (size_t i = 0; i < 5 && layout.longFormat; ++i) {
+                layout.longFormat = header[i] == longHeader[i];
+            }
+            if (layout.longFormat) {
+                return true;
+            }
+        }
+        int rowKeyIndex = -1;
+        for (size_t i = 0; i < header.size(); ++i) {
+            bool isKey = options.rowKey.empty() ? (header[i] == "row" || header[i] == "rowkey")
+                                                : header[i] == options.rowKey;
+            if (isKey && rowKeyIndex < 0) {
+                rowKeyIndex = (int)i;
+            }
+        }
+        if (rowKeyIndex < 0) {
+            if (!options.rowKey.empty()) {
+                error = "表头中没有行键列: " + options.rowKey;
+                return false;
+            }
+            rowKeyIndex = 0;
+        }
+        for (size_t i = 0; i < header.size(); ++i) {
+            layout.targets.push_back((int)i == rowKeyIndex ? parseTarget("rowkey", options.family)
+                                                           : parseTarget(header[i], options.family));
+        }
+    } else {
+        error = "没有表头时必须通过columns指定列映射";
+        return false;
+    }
+
+    bool hasRowKey = false;
+    for (size_t i = 0; i < layout.targets.size(); ++i) {
+        hasRowKey = hasRowKey || layout.targets[i].kind == TARGET_ROWKEY;
+    }
+    if (!hasRowKey) {
+        error = "列映射中没有rowkey列";
+        return false;
+    }
+    return true;
+}
+
+bool endsWith(const std::string& text, const char* suffix) {
+    size_t length = strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+} // namespace
+
+ImportOptions::ImportOptions()
+    : format(IMPORT_CSV), header(true), family("cf"), threads(4), chunkBytes(16 << 20),
+      batchRows(1000), batchBytes(4u << 20), maxErrors(1000) {
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores > 0) {
+        threads = (int)std::min(8u, cores);
+    }
+}
+
+bool parseImportOptions(const std::string& text, ImportOptions& options, std::string& error) {
+    if (endsWith(options.path, ".tsv") || endsWith(options.path, ".tab")) {
+        options.format = IMPORT_TSV;
+    } else if (endsWith(options.path, ".ndjson") || endsWith(options.path, ".jsonl") || endsWith(options.path, ".json")) {
+        options.format = IMPORT_NDJSON;
+    }
+
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(text, entries, error)) {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        uint64_t number = 0;
+        bool ok = true;
+        if (key == "format") {
+            if (value == "csv") options.format = IMPORT_CSV;
+            else if (value == "tsv") options.format = IMPORT_TSV;
+            else if (value == "ndjson" || value == "json") options.format = IMPORT_NDJSON;
+            else ok = false;
+        } else if (key == "header") {
+            ok = spec::parseBool(value, options.header);
+        } else if (key == "columns") {
+            options.columns = spec::split(value, ',');
+            ok = !options.columns.empty();
+        } else if (key == "rowKey") {
+            options.rowKey = value;
+        } else if (key == "family") {
+            options.family = value;
+            ok = !value.empty();
+        } else if (key == "threads") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 64;
+            options.threads = (int)number;
+        } else if (key == "chunkMB") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 1024;
+            options.chunkBytes = (size_t)number << 20;
+        } else if (key == "batchRows") {
+            ok = spec::parseUint(value, number) && number > 0;
+            options.batchRows = (uint32_t)number;
+        } else if (key == "batchBytes") {
+            ok = spec::parseUint(value, number) && number > 0;
+            options.batchBytes = (uint32_t)number;
+        } else if (key == "maxErrors") {
+            ok = spec::parseUint(value, options.maxErrors);
+        } else {
+            error = "未知的导入选项: " + key;
+            return false;
+        }
+        if (!ok) {
+            error = "导入选项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool runImport(const ImportOptions& options, jobs::Job& job, std::string& error) {
+    trace::Span span("import.run");
+    MappedFile file;
+    if (!file.open(options.path, error)) {
+        return false;
+    }
+    job.totalBytes = (int64_t)file.size();
+
+    Context context;
+    context.options = &options;
+    context.file = &file;
+    context.job = &job;
+    context.nextChunk = 0;
+    context.failed = false;
+    context.dataEnd = file.size();
+
+    size_t dataStart = 0;
+    if (!resolveLayout(options, file, context.layout, dataStart, error)) {
+        return false;
+    }
+    job.bytesRead = dataStart;
+    if (dataStart >= file.size()) {
+        return true;
+    }
+    context.chunks = splitChunks(file.data(), dataStart, file.size(), options.chunkBytes,
+        options.format == IMPORT_CSV);
+    BRIDGE_LOG_INFO("开始导入 " << options.path << " 到表 " << options.tableName << "：" << file.size() << " 字节，"
+        << context.chunks.size() << " 个分块，" << options.threads << " 个解析线程");
+
+    std::vector<std::thread> workers;
+    int threads = (int)std::min((size_t)options.threads, context.chunks.size());
+    for (int i = 0; i < threads; ++i) {
+        workers.push_back(std::thread(runWorker, &context));
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    if (context.failed.load()) {
+        error = context.error;
+        return false;
+    }
+    return true;
+}
+
+} // namespace bridge
@@ -0,0 +1,74 @@
+#ifndef TABLE_IMPORT_H
+#define TABLE_IMPORT_H
+
+#include "job_registry.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// 从文件批量导入：输入文件以mmap映射，按记录边界切分为多个分块，
+// 多个线程并行解析，各自编码为cell_codec批次后经TableWriter批量写入。
+//
+// 支持的输入：
+//   csv / tsv   首行为表头（header=false时用columns指定列映射）。
+//               表头为 row,family,qualifier,timestamp,value 时按单元格长表导入（即导出的csv），
+//               否则每条记录是一行：行键列由rowKey指定（默认名为row/rowkey的列，否则第一列），
+//               其他列名为 family:qualifier，或不含冒号时写入默认列族family。
+//   ndjson      每行一个JSON对象。结构为 {"row":..,"families":{..}}（即导出的ndjson）时按原结构导入，
+//               否则为扁平对象：rowKey字段作为行键，其余字段写入 family:字段名。
+//
+// 选项字符串（key=value，以 ; 或 & 分隔）：
+//   format      csv | tsv | ndjson，默认按扩展名判断
+//   header      csv/tsv是否有表头（默认true）
+//   columns     显式列映射，逗号分隔，每项为 rowkey | family:qualifier | -（忽略该列）
+//   rowKey      行键所在的列名/字段名
+//   family      未指定列族的列写入的默认列族（默认cf）
+//   threads     解析线程数（默认CPU核数，最多8）
+//   chunkMB     每个分块的大小（默认16）
+//   batchRows / batchBytes  每个写入批次的上限（默认1000行/4MiB）
+//   maxErrors   允许跳过的错误记录数，超过后任务失败（默认1000）
+
+namespace bridge {
+
+enum ImportFormat {
+    IMPORT_CSV,
+    IMPORT_TSV,
+    IMPORT_NDJSON
+};
+
+struct ImportOptions {
+    std::string tableName;
+    std::string path;
+    ImportFormat format;
+    bool header;
+    std::vector<std::string> columns;
+    std::string rowKey;
+    std::string family;
+    int threads;
+    size_t chunkBytes;
+    uint32_t batchRows;
+    uint32_t batchBytes;
+    uint64_t maxErrors;
+
+    ImportOptions();
+};
+
+// 解析选项字符串，format未指定时按path的扩展名判断
+bool parseImportOptions(const std::string& text, ImportOptions& options, std::string& error);
+
+// 在当前线程（任务线程）中执行导入，进度与错误计数写入job
+bool runImport(const ImportOptions& options, jobs::Job& job, std::string& error);
+
+// 解析data[pos, end)中的一条分隔符记录，返回下一条记录的起点。quoting为false时（tsv）不处理引号；
+// 引号未闭合或闭合引号后还有其他字符时malformed为true
+size_t parseRecord(const char* data, size_t pos, size_t end, char delimiter, bool quoting,
+                   std::vector<std::string>& fields, bool& malformed);
+
+// 在[begin, end)内按约chunkBytes切分，返回各分块的起点，每个分块从记录开头开始。
+// csv的引号字段可能包含换行，只能顺序扫描引号状态来找边界；其他格式直接找换行
+std::vector<size_t> splitChunks(const char* data, size_t begin, size_t end, size_t chunkBytes, bool quoted);
+
+} // namespace bridge
+
+#endif // TABLE_IMPORT_H
@@ -0,0 +1,409 @@
+#include "table_watch.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cancel_token.h"
+#include "cell_codec.h"
+#include "jni_support.h"
+#include "json_util.h"
+#include "large_cell.h"
+#include "qos.h"
+#include "spec_util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bridge {
+namespace watch {
+
+namespace {
+
+struct Event {
+    uint64_t seq;
+    std::string row;
+    std::string column;
+    int64_t timestamp;
+    std::string value;  // 超过预览阈值时只保留前面部分
+    uint32_t length;    // 完整长度
+};
+
+class Watch {
+public:
+    Watch(int64_t id, const WatchOptions& options)
+        : id(id), options(options), nextSeq(1), stopped(false), polls(0), errors(0), lastPollMs(0), minTime(0) {}
+
+    const int64_t id;
+    const WatchOptions options;
+    cancel::Token token;
+
+    std::mutex mutex;
+    std::condition_variable changed; // 有新事件或已停止
+    std::deque<Event> events;
+    uint64_t nextSeq;
+    bool stopped;
+    uint64_t polls;
+    uint64_t errors;
+    int64_t lastPollMs;
+    int64_t minTime;
+    std::string lastError;
+};
+
+std::mutex registryMutex;
+std::map<int64_t, std::shared_ptr<Watch> > registry;
+std::atomic<int64_t> nextWatchId(1);
+
+const int64_t MIN_INTERVAL_MS = 50;
+const int64_t MAX_WAIT_MS = 60000;
+
+int64_t nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool parseMillis(const std::string& text, int64_t& value) {
+    uint64_t number = 0;
+    if (!spec::parseUint(text, number) || number > (uint64_t)INT32_MAX * 1000) {
+        return false;
+    }
+    value = (int64_t)number;
+    return true;
+}
+
+// 去重用的键：行键、列与时间戳
+std::string cellKey(const codec::CellView& cell) {
+    std::string key(cell.row, cell.rowLength);
+    key += '\0';
+    key.append(cell.family, cell.familyLength);
+    key += ':';
+    key.append(cell.qualifier, cell.qualifierLength);
+    key += '\0';
+    key.append(reinterpret_cast<const char*>(&cell.timestamp), sizeof(cell.timestamp));
+    return key;
+}
+
+// 轮询线程的状态，只在轮询线程中访问
+struct PollState {
+    int64_t lowWater; // 下一次扫描的时间范围下界
+    std::unordered_map<std::string, int64_t> seen; // 时间戳不早于lowWater的已发布cell
+    std::vector<Event> pending; // 合并窗口内等待发布的事件
+    std::unordered_map<std::string, size_t> pendingIndex; // 行键+列 -> pending中的位置
+    std::chrono::steady_clock::time_point windowStart;
+};
+
+void addPending(PollState& state, const codec::CellView& cell, uint32_t preview) {
+    Event event;
+    event.seq = 0;
+    event.row.assign(cell.row, cell.rowLength);
+    event.column.assign(cell.family, cell.familyLength);
+    event.column += ':';
+    event.column.append(cell.qualifier, cell.qualifierLength);
+    event.timestamp = cell.timestamp;
+    event.length = cell.fullValueLength;
+    event.value.assign(cell.value, preview > 0 ? std::min(cell.valueLength, preview) : cell.valueLength);
+
+    if (state.pending.empty()) {
+        state.windowStart = std::chrono::steady_clock::now();
+    }
+    std::string key = event.row + '\0' + event.column;
+    std::unordered_map<std::string, size_t>::iterator it = state.pendingIndex.find(key);
+    if (it == state.pendingIndex.end()) {
+        state.pendingIndex[key] = state.pending.size();
+        state.pending.push_back(std::move(event));
+    } else if (event.timestamp >= state.pending[it->second].timestamp) {
+        // 窗口内同一行同一列只保留最新的写入
+        state.pending[it->second] = std::move(event);
+    }
+}
+
+// 一次时间范围扫描，新cell加入pending
+bool pollOnce(Watch& watch, PollState& state, std::string& error) {
+    trace::Span span("watch.poll");
+    const WatchOptions& options = watch.options;
+    ScanRange range = options.range;
+    range.minTime = state.lowWater;
+    range.maxTime = 0;
+    range.maxVersions = 1;
+    if (options.rowLimit > 0) {
+        range.batchRows = (int)std::min<uint64_t>((uint64_t)range.batchRows, options.rowLimit);
+        range.caching = (int)std::min<uint64_t>((uint64_t)range.caching, options.rowLimit);
+    }
+    ScannerReader reader;
+    if (!reader.open(range, error)) {
+        return false;
+    }
+    uint32_t preview = cells::previewBytes();
+    int64_t maxSeen = state.lowWater;
+    uint64_t rows = 0;
+    std::string lastRow;
+    std::vector<uint8_t> batch;
+    bool full = false;
+    while (!full && reader.next(batch, error)) {
+        codec::BatchReader batchReader(batch.data(), batch.size());
+        codec::CellView cell;
+        while (batchReader.next(cell)) {
+            if (lastRow.size() != cell.rowLength || memcmp(lastRow.data(), cell.row, cell.rowLength) != 0) {
+                if (options.rowLimit > 0 && rows >= options.rowLimit) {
+                    full = true;
+                    break;
+                }
+                lastRow.assign(cell.row, cell.rowLength);
+                ++rows;
+            }
+            std::string key = cellKey(cell);
+            if (state.seen.find(key) != state.seen.end()) {
+                continue; // 上一次扫描的边界上已经发布过
+            }
+            state.seen[key] = cell.timestamp;
+            maxSeen = std::max(maxSeen, cell.timestamp);
+            addPending(state, cell, preview);
+        }
+        if (batchReader.hasError()) {
+            error = batchReader.error();
+            break;
+        }
+    }
+    reader.close();
+    if (!error.empty()) {
+        return false;
+    }
+
+    // 下界推进到见到的最大时间戳（含），同一毫秒内稍后的写入下次仍能扫到
+    state.lowWater = std::max(state.lowWater, maxSeen - options.lagMs);
+    for (std::unordered_map<std::string, int64_t>::iterator it = state.seen.begin(); it != state.seen.end(); ) {
+        if (it->second < state.lowWater) {
+            it = state.seen.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return true;
+}
+
+// 把pending中的事件编号后放入缓冲，调用方持有watch.mutex
+void publishLocked(Watch& watch, PollState& state) {
+    for (size_t i = 0; i < state.pending.size(); ++i) {
+        state.pending[i].seq = watch.nextSeq++;
+        watch.events.push_back(std::move(state.pending[i]));
+    }
+    while (watch.events.size() > watch.options.bufferEvents) {
+        watch.events.pop_front();
+    }
+    state.pending.clear();
+    state.pendingIndex.clear();
+}
+
+void runWatch(std::shared_ptr<Watch> watch) {
+    qos::ClassScope qosScope("watch");
+    cancel::TokenScope tokenScope(&watch->token);
+    const WatchOptions& options = watch->options;
+    PollState state;
+    state.lowWater = nowMillis() - options.lookbackMs;
+    BRIDGE_LOG_INFO("【监视】开始监视 " << options.range.tableName << "，间隔 " << options.intervalMs << "ms");
+
+    while (!watch->token.isAborted()) {
+        std::chrono::steady_clock::time_point pollStart = std::chrono::steady_clock::now();
+        std::string error;
+        bool ok = pollOnce(*watch, state, error);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (!ok && watch->token.isAborted()) {
+            break;
+        }
+        if (!ok) {
+            BRIDGE_LOG_WARN("【监视】轮询 " << options.range.tableName << " 失败: " << error);
+        }
+
+        std::unique_lock<std::mutex> lock(watch->mutex);
+        ++watch->polls;
+        watch->lastPollMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - pollStart).count();
+        watch->minTime = state.lowWater;
+        if (!ok) {
+            ++watch->errors;
+            watch->lastError = error;
+        } else {
+            watch->lastError.clear();
+        }
+        if (!state.pending.empty() && (options.coalesceMs <= 0
+            || now - state.windowStart >= std::chrono::milliseconds(options.coalesceMs))) {
+            publishLocked(*watch, state);
+            watch->changed.notify_all();
+        }
+        watch->changed.wait_until(lock, pollStart + std::chrono::milliseconds(options.intervalMs),
+            [&watch]() { return watch->stopped; });
+        if (watch->stopped) {
+            break;
+        }
+    }
+    BRIDGE_LOG_INFO("【监视】停止监视 " << options.range.tableName);
+    watch->token.release();
+    detachCurrentThread();
+}
+
+void appendEvent(std::string& json, const Event& event) {
+    char number[96];
+    snprintf(number, sizeof(number), "{\"seq\":%llu,\"row\":\"", (unsigned long long)event.seq);
+    json += number;
+    json::appendText(json, event.row.data(), event.row.size());
+    json += "\",\"column\":\"";
+    json::appendText(json, event.column.data(), event.column.size());
+    snprintf(number, sizeof(number), "\",\"timestamp\":%lld,\"value\":\"", (long long)event.timestamp);
+    json += number;
+    json::appendText(json, event.value.data(), event.value.size());
+    json += '"';
+    if (event.length > event.value.size()) {
+        snprintf(number, sizeof(number), ",\"length\":%u", event.length);
+        json += number;
+    }
+    json += '}';
+}
+
+} // namespace
+
+bool parseWatchOptions(const std::string& text, WatchOptions& options, std::string& error) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    if (!spec::parseEntries(text, entries, error)) {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string& key = entries[i].first;
+        const std::string& value = entries[i].second;
+        uint64_t number = 0;
+        bool ok = true;
+        if (key == "interval") {
+            ok = parseMillis(value, options.intervalMs) && options.intervalMs >= MIN_INTERVAL_MS;
+        } else if (key == "coalesce") {
+            ok = parseMillis(value, options.coalesceMs);
+        } else if (key == "lookback") {
+            ok = parseMillis(value, options.lookbackMs);
+        } else if (key == "lag") {
+            ok = parseMillis(value, options.lagMs);
+        } else if (key == "limit") {
+            ok = spec::parseUint(value, options.rowLimit);
+        } else if (key == "reverse") {
+            ok = spec::parseBool(value, options.range.reversed);
+        } else if (key == "buffer") {
+            ok = spec::parseUint(value, number) && number > 0 && number <= 10000000;
+            options.bufferEvents = (size_t)number;
+        } else if (key == "columns") {
+            options.range.columns = value;
+        } else if (key == "cluster") {
+            options.range.cluster = value;
+        } else {
+            error = "未知的监视选项: " + key;
+            return false;
+        }
+        if (!ok) {
+            error = "监视选项取值无效: " + key + "=" + value;
+            return false;
+        }
+    }
+    return true;
+}
+
+int64_t start(const WatchOptions& options) {
+    int64_t id = nextWatchId.fetch_add(1);
+    std::shared_ptr<Watch> watch = std::make_shared<Watch>(id, options);
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry[id] = watch;
+    }
+    std::thread(runWatch, watch).detach();
+    return id;
+}
+
+bool poll(int64_t watchId, uint64_t afterSeq, uint32_t maxEvents, int64_t waitMs, std::string& json,
+          std::string& error) {
+    std::shared_ptr<Watch> watch;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::map<int64_t, std::shared_ptr<Watch> >::iterator it = registry.find(watchId);
+        if (it != registry.end()) {
+            watch = it->second;
+        }
+    }
+    if (!watch) {
+        error = "监视不存在: " + std::to_string((long long)watchId);
+        return false;
+    }
+
+    std::vector<Event> events;
+    uint64_t dropped = 0;
+    uint64_t nextSeq = afterSeq;
+    std::string lastError;
+    char number[200];
+    {
+        std::unique_lock<std::mutex> lock(watch->mutex);
+        if (waitMs > 0) {
+            watch->changed.wait_for(lock, std::chrono::milliseconds(std::min(waitMs, MAX_WAIT_MS)),
+                [&watch, afterSeq]() { return watch->stopped || watch->nextSeq - 1 > afterSeq; });
+        }
+        uint64_t firstSeq = watch->events.empty() ? watch->nextSeq : watch->events.front().seq;
+        if (afterSeq + 1 < firstSeq) {
+            // 订阅方落后，中间的事件已从缓冲中丢弃
+            dropped = firstSeq - afterSeq - 1;
+            nextSeq = firstSeq - 1;
+        }
+        size_t begin = (size_t)(nextSeq + 1 - firstSeq);
+        for (size_t i = begin; i < watch->events.size() && events.size() < maxEvents; ++i) {
+            events.push_back(watch->events[i]);
+        }
+        if (!events.empty()) {
+            nextSeq = events.back().seq;
+        }
+        snprintf(number, sizeof(number),
+            "],\"nextSeq\":%llu,\"dropped\":%llu,\"state\":\"%s\",\"polls\":%llu,\"errors\":%llu,"
+            "\"lastPollMs\":%lld,\"minTime\":%lld",
+            (unsigned long long)nextSeq, (unsigned long long)dropped, watch->stopped ? "stopped" : "running",
+            (unsigned long long)watch->polls, (unsigned long long)watch->errors, (long long)watch->lastPollMs,
+            (long long)watch->minTime);
+        lastError = watch->lastError;
+    }
+
+    json = "{\"status\":\"success\",\"events\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (i > 0) {
+            json += ',';
+        }
+        appendEvent(json, events[i]);
+    }
+    json += number;
+    if (!lastError.empty()) {
+        // 最近一次失败的轮询，监视仍按间隔重试
+        json += ",\"error\":" + json::quote(lastError);
+    }
+    json += '}';
+    return true;
+}
+
+bool stop(int64_t watchId) {
+    std::shared_ptr<Watch> watch;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::map<int64_t, std::shared_ptr<Watch> >::iterator it = registry.find(watchId);
+        if (it == registry.end()) {
+            return false;
+        }
+        watch = it->second;
+        registry.erase(it);
+    }
+    {
+        std::lock_guard<std::mutex> lock(watch->mutex);
+        watch->stopped = true;
+    }
+    watch->changed.notify_all();
+    // 关闭正在进行的扫描
+    watch->token.cancel();
+    return true;
+}
+
+} // namespace watch
+} // namespace bridge
@@ -0,0 +1,68 @@
+#ifndef TABLE_WATCH_H
+#define TABLE_WATCH_H
+
+#include "scanner_reader.h"
+
+#include <stdint.h>
+#include <string>
+
+// 监视表的新写入（调试数据管道时实时查看正在写入的行）。每个监视在自己的后台线程中按间隔轮询，
+// 每次是一个时间范围扫描：只取时间戳不早于上次见到的最大时间戳（减去lag）的cell，
+// 范围、前缀与投影列沿用ScanRange，行键按时间递增时可以反向扫描并用limit只取最新的行。
+// 边界上重复扫到的cell按 行键+列+时间戳 去重，每个cell只发布一次。
+//
+// 新cell按发布顺序编号（seq从1开始）放入监视的环形缓冲，订阅方各自记住读到的seq，
+// 调用poll取之后的事件，可以等待到有新事件为止；多个订阅方互不影响。
+// 缓冲满时丢弃最旧的事件，落后的订阅方在结果中看到dropped。
+//
+// 合并（coalesce）：窗口内同一行同一列的多次写入只发布最后一次，窗口结束时一并发布。
+//
+// 时间范围按RegionServer写入时的时间戳判断：写入方显式指定较早的时间戳、或客户端与服务端时钟
+// 有偏差时，cell可能落在已经扫过的范围之前，可以用lag把下界向前放宽。删除不会被时间范围扫描看到。
+//
+// 选项字符串（key=value，以 ; 或 & 分隔）：
+//   interval   轮询间隔毫秒（默认1000，最小50）
+//   coalesce   合并窗口毫秒（默认0，每次轮询后立即发布）
+//   lookback   第一次轮询从多少毫秒之前开始（默认0，只看监视开始之后的写入）
+//   lag        每次轮询把下界向前放宽的毫秒数（默认0）
+//   limit      每次轮询最多读取的行数（默认0不限），超出的行本次跳过；配合reverse只看最新的行
+//   reverse    反向扫描（默认false）
+//   buffer     缓冲的事件数（默认10000）
+//   columns    只监视这些列 "cf:q,cf"（默认全部列）
+//   cluster    connectPeer的集群名（默认主连接）
+
+namespace bridge {
+namespace watch {
+
+struct WatchOptions {
+    ScanRange range;
+    int64_t intervalMs;
+    int64_t coalesceMs;
+    int64_t lookbackMs;
+    int64_t lagMs;
+    uint64_t rowLimit;
+    size_t bufferEvents;
+
+    WatchOptions() : intervalMs(1000), coalesceMs(0), lookbackMs(0), lagMs(0), rowLimit(0), bufferEvents(10000) {}
+};
+
+bool parseWatchOptions(const std::string& text, WatchOptions& options, std::string& error);
+
+// 启动监视线程，返回监视ID
+int64_t start(const WatchOptions& options);
+
+// 取afterSeq之后的最多maxEvents个事件，没有时最多等待waitMs毫秒。返回JSON：
+// {"status":"success","events":[{"seq":..,"row":..,"column":"cf:q","timestamp":..,"value":..[,"length":完整长度]},..],
+//  "nextSeq":..,"dropped":..,"state":"running|stopped","polls":..,"errors":..,"lastPollMs":..,"minTime":..[,"error":..]}
+// nextSeq作为下一次的afterSeq，dropped为缓冲满时该订阅方错过的事件数；值超过预览阈值（见large_cell.h）时
+// 截断并给出完整长度。最近一次轮询失败时带有error，监视仍按间隔重试
+bool poll(int64_t watchId, uint64_t afterSeq, uint32_t maxEvents, int64_t waitMs, std::string& json,
+          std::string& error);
+
+// 停止监视并释放缓冲，正在进行的扫描随即关闭；监视不存在时返回false
+bool stop(int64_t watchId);
+
+} // namespace watch
+} // namespace bridge
+
+#endif // TABLE_WATCH_H
@@ -0,0 +1,69 @@
+#include "table_writer.h"
+#include "bridge_log.h"
+#include "bridge_trace.h"
+#include "cancel_token.h"
+#include "jni_support.h"
+#include "qos.h"
+#include "scheduler.h"
+
+namespace bridge {
+
+TableWriter::TableWriter(const std::string& tableName, const std::string& cluster)
+    : env_(currentEnv()), bridgeClass_(nullptr), method_(nullptr), tableName_(nullptr), cluster_(nullptr),
+      clusterName_(cluster) {
+    if (env_ == nullptr) {
+        BRIDGE_LOG_ERROR("JVM未初始化，无法写入表 " << tableName);
+        return;
+    }
+    bridgeClass_ = bridgeClass(env_, "HBaseBridge");
+    if (bridgeClass_ == nullptr) {
+        return;
+    }
+    method_ = env_->GetStaticMethodID(bridgeClass_, "putCells", "(Ljava/lang/String;[BLjava/lang/String;)I");
+    if (method_ == nullptr) {
+        clearPendingException(env_, "HBaseBridge.putCells");
+        return;
+    }
+    tableName_ = env_->NewStringUTF(tableName.c_str());
+    cluster_ = env_->NewStringUTF(cluster.c_str());
+    if (tableName_ == nullptr || cluster_ == nullptr) {
+        clearPendingException(env_, "NewStringUTF");
+        method_ = nullptr;
+    }
+}
+
+TableWriter::~TableWriter() {
+    if (tableName_ != nullptr) {
+        env_->DeleteLocalRef(tableName_);
+    }
+    if (cluster_ != nullptr) {
+        env_->DeleteLocalRef(cluster_);
+    }
+}
+
+int TableWriter::write(const std::vector<uint8_t>& batch) {
+    if (!isValid()) {
+        return -1;
+    }
+    const cancel::Token* token = cancel::current();
+    if (token != nullptr && token->isAborted()) {
+        return -1;
+    }
+    sched::yieldToInteractive();
+    qos::charge(clusterName_, qos::countRows(batch), batch.size(), 1);
+    trace::Span span("writer.putCells");
+    jbyteArray array = env_->NewByteArray((jsize)batch.size());
+    if (array == nullptr) {
+        clearPendingException(env_, "NewByteArray");
+        return -1;
+    }
+    env_->SetByteArrayRegion(array, 0, (jsize)batch.size(), (const jbyte*)batch.data());
+    jint rows = env_->CallStaticIntMethod(bridgeClass_, method_, tableName_, array, cluster_);
+    env_->DeleteLocalRef(array);
+    if (clearPendingException(env_, "HBaseBridge.putCells")) {
+        return -1;
+    }
+    return rows;
+}
+
+} // namespace bridge
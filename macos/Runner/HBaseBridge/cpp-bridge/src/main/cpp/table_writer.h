@@ -0,0 +1,39 @@
+#ifndef TABLE_WRITER_H
+#define TABLE_WRITER_H
+
+#include <jni.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace bridge {
+
+// 桥接层的批量写入路径：把cell_codec编码的批次交给 HBaseBridge.putCells。
+// 每个线程使用自己的TableWriter（JNIEnv不能跨线程共享）。
+class TableWriter {
+public:
+    // cluster为connectPeer的集群名，空为主连接
+    explicit TableWriter(const std::string& tableName, const std::string& cluster = std::string());
+    ~TableWriter();
+
+    // JVM不可用或找不到Java方法时为false
+    bool isValid() const { return method_ != nullptr; }
+
+    // 写入一个批次，返回写入的行数，失败返回-1
+    int write(const std::vector<uint8_t>& batch);
+
+private:
+    TableWriter(const TableWriter&);
+    TableWriter& operator=(const TableWriter&);
+
+    JNIEnv* env_;
+    jclass bridgeClass_;
+    jmethodID method_;
+    jstring tableName_;
+    jstring cluster_;
+    std::string clusterName_; // 限速统计用
+};
+
+} // namespace bridge
+
+#endif // TABLE_WRITER_H
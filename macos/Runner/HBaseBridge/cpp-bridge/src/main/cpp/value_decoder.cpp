@@ -0,0 +1,442 @@
+#include "value_decoder.h"
+#include "json_util.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace bridge {
+namespace decode {
+
+namespace {
+
+const uint64_t ONES = 0x0101010101010101ULL;
+const uint64_t HIGHS = 0x8080808080808080ULL;
+
+const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline uint64_t load64(const char* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t load32(const char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t fromBigEndian64(uint64_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return value;
+#else
+    return __builtin_bswap64(value);
+#endif
+}
+
+inline uint32_t fromBigEndian32(uint32_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return value;
+#else
+    return __builtin_bswap32(value);
+#endif
+}
+
+// 8个字节中是否有0字节（SWAR，一次检查一个机器字）
+inline bool hasZeroByte(uint64_t x) {
+    return ((x - ONES) & ~x & HIGHS) != 0;
+}
+
+// 8个ASCII字节中是否有控制字符（< 0x20 或 0x7f）
+inline bool hasControlByte(uint64_t x) {
+    return ((x - 0x20 * ONES) & ~x & HIGHS) != 0 || hasZeroByte(x ^ (0x7f * ONES));
+}
+
+// 8个字节是否都可以原样写入toStringBinary的JSON输出：可打印ASCII，且不是 " 与 \ .
+inline bool allPlainBytes(uint64_t x) {
+    return (x & HIGHS) == 0 && !hasControlByte(x) && !hasZeroByte(x ^ (0x22 * ONES))
+        && !hasZeroByte(x ^ (0x5c * ONES));
+}
+
+struct HexTable {
+    char pairs[512];
+
+    HexTable() {
+        static const char digits[] = "0123456789abcdef";
+        for (int i = 0; i < 256; ++i) {
+            pairs[i * 2] = digits[i >> 4];
+            pairs[i * 2 + 1] = digits[i & 0xf];
+        }
+    }
+};
+
+const HexTable& hexTable() {
+    static const HexTable table;
+    return table;
+}
+
+void appendInt64(std::string& out, int64_t value) {
+    char text[24];
+    char* end = text + sizeof(text);
+    char* p = end;
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    while (magnitude >= 100) {
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + (magnitude % 100) * 2, 2);
+        magnitude /= 100;
+    }
+    if (magnitude >= 10) {
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + magnitude * 2, 2);
+    } else {
+        *--p = (char)('0' + magnitude);
+    }
+    if (value < 0) {
+        *--p = '-';
+    }
+    out.append(p, end - p);
+}
+
+// 可往返的最短表示（先试15位有效数字），整数值补 ".0"，与Java的Double.toString接近
+void appendDouble(std::string& out, double value) {
+    if (std::isnan(value)) {
+        out += "NaN";
+        return;
+    }
+    if (std::isinf(value)) {
+        out += value < 0 ? "-Infinity" : "Infinity";
+        return;
+    }
+    char text[32];
+    snprintf(text, sizeof(text), "%.15g", value);
+    if (strtod(text, nullptr) != value) {
+        snprintf(text, sizeof(text), "%.17g", value);
+    }
+    out += text;
+    if (strpbrk(text, ".e") == nullptr) {
+        out += ".0";
+    }
+}
+
+// 定长数值列：先批量读入并转换字节序，再逐个格式化
+void renderNumbers(Format format, const char* const* values, const uint32_t* lengths, size_t count,
+                   std::string& out, std::vector<size_t>& ends) {
+    uint32_t width = format == FORMAT_INT ? 4 : 8;
+    std::vector<uint64_t> raw(count, 0);
+    std::vector<uint8_t> fixed(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] != nullptr && lengths[i] == width) {
+            fixed[i] = 1;
+            raw[i] = width == 8 ? load64(values[i]) : load32(values[i]);
+        }
+    }
+    if (width == 8) {
+        for (size_t i = 0; i < count; ++i) {
+            raw[i] = fromBigEndian64(raw[i]);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            raw[i] = fromBigEndian32((uint32_t)raw[i]);
+        }
+    }
+
+    out.reserve(out.size() + count * 24);
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] == nullptr) {
+            out += "null";
+        } else {
+            out += '"';
+            if (!fixed[i]) {
+                appendBinary(out, values[i], lengths[i]);
+            } else if (format == FORMAT_LONG) {
+                appendInt64(out, (int64_t)raw[i]);
+            } else if (format == FORMAT_INT) {
+                appendInt64(out, (int32_t)(uint32_t)raw[i]);
+            } else {
+                double value;
+                memcpy(&value, &raw[i], sizeof(value));
+                appendDouble(out, value);
+            }
+            out += '"';
+        }
+        ends[i] = out.size();
+    }
+}
+
+} // namespace
+
+bool parseFormat(const std::string& name, Format& format) {
+    static const Format formats[] = {FORMAT_AUTO, FORMAT_TEXT, FORMAT_BINARY, FORMAT_HEX, FORMAT_LONG, FORMAT_INT,
+        FORMAT_DOUBLE};
+    for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i) {
+        if (name == formatName(formats[i])) {
+            format = formats[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* formatName(Format format) {
+    switch (format) {
+    case FORMAT_TEXT: return "text";
+    case FORMAT_BINARY: return "binary";
+    case FORMAT_HEX: return "hex";
+    case FORMAT_LONG: return "long";
+    case FORMAT_INT: return "int";
+    case FORMAT_DOUBLE: return "double";
+    default: return "auto";
+    }
+}
+
+bool readLong(const char* data, uint32_t length, int64_t& value) {
+    if (length != 8) {
+        return false;
+    }
+    value = (int64_t)fromBigEndian64(load64(data));
+    return true;
+}
+
+bool readInt(const char* data, uint32_t length, int32_t& value) {
+    if (length != 4) {
+        return false;
+    }
+    value = (int32_t)fromBigEndian32(load32(data));
+    return true;
+}
+
+bool readDouble(const char* data, uint32_t length, double& value) {
+    if (length != 8) {
+        return false;
+    }
+    uint64_t bits = fromBigEndian64(load64(data));
+    memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+bool parseLongText(const char* data, size_t length, int64_t& value) {
+    const char* p = data;
+    const char* end = data + length;
+    while (p < end && isSpace(*p)) ++p;
+    while (end > p && isSpace(end[-1])) --end;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    if (p == end) {
+        return false;
+    }
+    uint64_t magnitude = 0;
+    for (; p < end; ++p) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        uint64_t digit = (uint64_t)(*p - '0');
+        if (magnitude > (UINT64_MAX - digit) / 10) {
+            return false;
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+    if (negative ? magnitude > (uint64_t)INT64_MAX + 1 : magnitude > (uint64_t)INT64_MAX) {
+        return false;
+    }
+    value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    return true;
+}
+
+bool parseDoubleText(const char* data, size_t length, double& value) {
+    char text[64];
+    if (length == 0 || length >= sizeof(text)) {
+        return false;
+    }
+    memcpy(text, data, length);
+    text[length] = '\0';
+    char* end = nullptr;
+    value = strtod(text, &end);
+    while (*end != '\0' && isSpace(*end)) ++end;
+    return end != text && *end == '\0' && !std::isnan(value);
+}
+
+bool asLong(Format format, const char* data, uint32_t length, int64_t& value) {
+    switch (format) {
+    case FORMAT_LONG:
+        return readLong(data, length, value);
+    case FORMAT_INT: {
+        int32_t number;
+        if (!readInt(data, length, number)) {
+            return false;
+        }
+        value = number;
+        return true;
+    }
+    case FORMAT_DOUBLE:
+        return false;
+    default:
+        return parseLongText(data, length, value);
+    }
+}
+
+bool asDouble(Format format, const char* data, uint32_t length, double& value) {
+    switch (format) {
+    case FORMAT_LONG: {
+        int64_t number;
+        if (!readLong(data, length, number)) {
+            return false;
+        }
+        value = (double)number;
+        return true;
+    }
+    case FORMAT_INT: {
+        int32_t number;
+        if (!readInt(data, length, number)) {
+            return false;
+        }
+        value = number;
+        return true;
+    }
+    case FORMAT_DOUBLE:
+        return readDouble(data, length, value) && !std::isnan(value);
+    default:
+        return parseDoubleText(data, length, value);
+    }
+}
+
+bool isPrintableUtf8(const char* data, size_t length) {
+    const unsigned char* p = (const unsigned char*)data;
+    size_t i = 0;
+    while (i < length) {
+        // ASCII文本按机器字跳过
+        if (i + 8 <= length) {
+            uint64_t word = load64(data + i);
+            if ((word & HIGHS) == 0 && !hasControlByte(word)) {
+                i += 8;
+                continue;
+            }
+        }
+        unsigned char c = p[i];
+        if (c < 0x80) {
+            if ((c < 0x20 && c != '\t' && c != '\n' && c != '\r') || c == 0x7f) {
+                return false;
+            }
+            ++i;
+            continue;
+        }
+        size_t sequenceLength = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc2 ? 2 : 0;
+        if (sequenceLength == 0 || c > 0xf4 || i + sequenceLength > length) {
+            return false;
+        }
+        // 排除过长编码、代理区与超出U+10FFFF的码点
+        unsigned char second = p[i + 1];
+        unsigned char low = 0x80;
+        unsigned char high = 0xbf;
+        if (c == 0xe0) low = 0xa0;
+        else if (c == 0xed) high = 0x9f;
+        else if (c == 0xf0) low = 0x90;
+        else if (c == 0xf4) high = 0x8f;
+        if (second < low || second > high) {
+            return false;
+        }
+        for (size_t k = 2; k < sequenceLength; ++k) {
+            if ((p[i + k] & 0xc0) != 0x80) {
+                return false;
+            }
+        }
+        i += sequenceLength;
+    }
+    return true;
+}
+
+void appendHex(std::string& out, const char* data, size_t length) {
+    const char* pairs = hexTable().pairs;
+    size_t position = out.size();
+    out.resize(position + length * 2);
+    char* target = &out[position];
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < length; ++i) {
+        memcpy(target + i * 2, pairs + p[i] * 2, 2);
+    }
+}
+
+void appendBinary(std::string& out, const char* data, size_t length) {
+    static const char digits[] = "0123456789ABCDEF";
+    size_t i = 0;
+    while (i < length) {
+        // 连续的可打印字节整段复制
+        size_t run = i;
+        while (run + 8 <= length && allPlainBytes(load64(data + run))) {
+            run += 8;
+        }
+        if (run > i) {
+            out.append(data + i, run - i);
+            i = run;
+        }
+        if (i >= length) {
+            break;
+        }
+        unsigned char c = (unsigned char)data[i++];
+        if (c == '"') {
+            out += "\\\"";
+        } else if (c >= 0x20 && c < 0x7f && c != '\\') {
+            out += (char)c;
+        } else {
+            // Bytes.toStringBinary的 \xNN，反斜杠在JSON中需要再转义
+            out += "\\\\x";
+            out += digits[c >> 4];
+            out += digits[c & 0xf];
+        }
+    }
+}
+
+void appendAuto(std::string& out, const char* data, size_t length) {
+    if (isPrintableUtf8(data, length)) {
+        json::appendText(out, data, length);
+    } else {
+        appendBinary(out, data, length);
+    }
+}
+
+void renderColumn(Format format, const char* const* values, const uint32_t* lengths, size_t count,
+                  std::string& out, std::vector<size_t>& ends) {
+    ends.assign(count, 0);
+    if (format == FORMAT_LONG || format == FORMAT_INT || format == FORMAT_DOUBLE) {
+        renderNumbers(format, values, lengths, count, out, ends);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] == nullptr) {
+            out += "null";
+            ends[i] = out.size();
+            continue;
+        }
+        out += '"';
+        switch (format) {
+        case FORMAT_TEXT:
+            json::appendText(out, values[i], lengths[i]);
+            break;
+        case FORMAT_BINARY:
+            appendBinary(out, values[i], lengths[i]);
+            break;
+        case FORMAT_HEX:
+            appendHex(out, values[i], lengths[i]);
+            break;
+        default:
+            appendAuto(out, values[i], lengths[i]);
+            break;
+        }
+        out += '"';
+        ends[i] = out.size();
+    }
+}
+
+} // namespace decode
+} // namespace bridge
@@ -0,0 +1,72 @@
+#ifndef VALUE_DECODER_H
+#define VALUE_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// 单元格值的类型化解码。HBase中的值是任意字节，数值通常由Bytes.toBytes(long/int/double)
+// 写成定长大端字节，直接按文本显示会是乱码。按列指定格式后在桥接层解码：
+//   auto     可打印的UTF-8按文本显示，否则按binary转义（默认）
+//   text     按UTF-8文本，非法字节替换为U+FFFD（旧行为）
+//   binary   与Bytes.toStringBinary一致：可打印ASCII原样输出，其余字节为 \xNN
+//   hex      每字节两位小写十六进制
+//   long     8字节大端有符号整数
+//   int      4字节大端有符号整数
+//   double   8字节大端IEEE 754双精度
+// 长度与格式不符的值按binary输出。
+//
+// 渲染以整列为单位：先把定长值批量读入连续数组再统一转换，避免逐个单元格分派。
+
+namespace bridge {
+namespace decode {
+
+enum Format {
+    FORMAT_AUTO,
+    FORMAT_TEXT,
+    FORMAT_BINARY,
+    FORMAT_HEX,
+    FORMAT_LONG,
+    FORMAT_INT,
+    FORMAT_DOUBLE
+};
+
+bool parseFormat(const std::string& name, Format& format);
+const char* formatName(Format format);
+
+// 定长大端数值，长度不符返回false
+bool readLong(const char* data, uint32_t length, int64_t& value);
+bool readInt(const char* data, uint32_t length, int32_t& value);
+bool readDouble(const char* data, uint32_t length, double& value);
+
+// 数字文本：十进制整数（允许前后空白与正负号，溢出返回false）与浮点数（NaN视为无法解析）
+bool parseLongText(const char* data, size_t length, int64_t& value);
+bool parseDoubleText(const char* data, size_t length, double& value);
+
+// 按列格式取数值：long/int/double按定长二进制解码，其余格式按数字文本解析。
+// double格式的值不能按整数读取
+bool asLong(Format format, const char* data, uint32_t length, int64_t& value);
+bool asDouble(Format format, const char* data, uint32_t length, double& value);
+
+// 是否为可按文本显示的UTF-8（合法编码，且除\t\n\r外没有控制字符）
+bool isPrintableUtf8(const char* data, size_t length);
+
+// 追加Bytes.toStringBinary形式的JSON字符串内容（不含引号）
+void appendBinary(std::string& out, const char* data, size_t length);
+
+// 追加小写十六进制（每字节两位）
+void appendHex(std::string& out, const char* data, size_t length);
+
+// 追加auto格式的JSON字符串内容（不含引号）：可打印的UTF-8按文本，否则按binary
+void appendAuto(std::string& out, const char* data, size_t length);
+
+// 把一列值渲染为JSON字符串（含引号）追加到out，第i个值位于[ends[i-1], ends[i])；
+// values[i]为nullptr时输出null
+void renderColumn(Format format, const char* const* values, const uint32_t* lengths, size_t count,
+                  std::string& out, std::vector<size_t>& ends);
+
+} // namespace decode
+} // namespace bridge
+
+#endif // VALUE_DECODER_H
@@ -0,0 +1,58 @@
+#ifndef BRIDGE_TEST_H
+#define BRIDGE_TEST_H
+
+#include <sstream>
+#include <string>
+
+// 单元测试的最小框架（不依赖gtest）：TEST定义并注册用例，CHECK系列失败时记录位置后继续执行，
+// bridge_tests按注册顺序运行全部用例（参数为用例名的子串时只运行匹配的用例），有失败时退出码非0。
+
+namespace bridge {
+namespace test {
+
+typedef void (*TestFunction)();
+
+struct Registrar {
+    Registrar(const char* name, TestFunction function);
+};
+
+// 记录一次检查失败
+void fail(const char* file, int line, const std::string& message);
+
+template <typename A, typename B>
+void checkEqual(const A& actual, const B& expected, const char* actualText, const char* expectedText,
+                const char* file, int line) {
+    if (!(actual == expected)) {
+        std::ostringstream out;
+        out << actualText << " == " << expectedText << "\n      实际: " << actual << "\n      期望: " << expected;
+        fail(file, line, out.str());
+    }
+}
+
+void checkContains(const std::string& text, const std::string& part, const char* textExpression,
+                   const char* file, int line);
+
+// 每个用例一个临时目录下的文件路径，用例结束后目录被删除
+std::string tempPath(const std::string& name);
+
+} // namespace test
+} // namespace bridge
+
+#define TEST(name)                                                               \
+    static void name();                                                          \
+    static const bridge::test::Registrar name##Registrar(#name, name);           \
+    static void name()
+
+#define CHECK(condition)                                                         \
+    do {                                                                         \
+        if (!(condition)) {                                                      \
+            bridge::test::fail(__FILE__, __LINE__, #condition);                  \
+        }                                                                        \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    bridge::test::checkEqual((actual), (expected), #actual, #expected, __FILE__, __LINE__)
+
+#define CHECK_CONTAINS(text, part) bridge::test::checkContains((text), (part), #text, __FILE__, __LINE__)
+
+#endif // BRIDGE_TEST_H
@@ -0,0 +1,362 @@
+#include "fake_cluster.h"
+#include "cancel_token.h"
+#include "cell_codec.h"
+#include "scanner_reader.h"
+#include "spec_util.h"
+#include "table_writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace bridge {
+namespace test {
+
+namespace {
+
+struct Table {
+    std::vector<FakeCell> cells; // 按cellLess排序
+    std::vector<std::string> splits;
+};
+
+struct OpenScan {
+    std::vector<FakeCell> cells; // 已按扫描顺序排好，同一行连续
+    size_t position;
+};
+
+std::mutex clusterMutex;
+std::map<std::string, Table> tables; // 键为 集群名 + '\0' + 表名
+std::map<jlong, OpenScan> scans;
+jlong nextScanId = 1;
+uint64_t scannerCount = 0;
+std::map<const TableWriter*, std::string> writers; // TableWriter -> 表的键
+char writerMethodTag;
+
+std::string tableKey(const std::string& cluster, const std::string& table) {
+    return cluster + '\0' + table;
+}
+
+// 行键、列族、列名升序，同一列时间戳从新到旧
+bool cellLess(const FakeCell& a, const FakeCell& b) {
+    if (a.row != b.row) {
+        return a.row < b.row;
+    }
+    if (a.family != b.family) {
+        return a.family < b.family;
+    }
+    if (a.qualifier != b.qualifier) {
+        return a.qualifier < b.qualifier;
+    }
+    return a.timestamp > b.timestamp;
+}
+
+void insertCell(Table& table, const FakeCell& cell) {
+    std::vector<FakeCell>::iterator it = std::lower_bound(table.cells.begin(), table.cells.end(), cell, cellLess);
+    if (it != table.cells.end() && !cellLess(cell, *it)) {
+        it->value = cell.value;
+    } else {
+        table.cells.insert(it, cell);
+    }
+}
+
+std::string toHex(const std::string& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        unsigned char c = (unsigned char)bytes[i];
+        out += digits[c >> 4];
+        out += digits[c & 15];
+    }
+    return out;
+}
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 0;
+}
+
+std::string fromHex(const std::string& hex) {
+    std::string out;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out += (char)(hexDigit(hex[i]) * 16 + hexDigit(hex[i + 1]));
+    }
+    return out;
+}
+
+// 前缀之后的第一个行键（不以该前缀开头的最小行键），前缀全为0xFF时为空（无上界）
+std::string prefixEnd(const std::string& prefix) {
+    std::string end = prefix;
+    while (!end.empty() && (unsigned char)end[end.size() - 1] == 0xFF) {
+        end.erase(end.size() - 1);
+    }
+    if (!end.empty()) {
+        end[end.size() - 1] = (char)((unsigned char)end[end.size() - 1] + 1);
+    }
+    return end;
+}
+
+// 与HBaseBridge.buildScan相同：有前缀时起止行由前缀决定，否则为 [startRow, stopRow)，空为无界
+void rowBounds(const ScanRange& range, std::string& low, std::string& high) {
+    if (!range.prefix.empty()) {
+        low = range.prefix;
+        high = prefixEnd(range.prefix);
+    } else {
+        low = range.startRow;
+        high = range.stopRow;
+    }
+}
+
+bool inColumns(const std::vector<std::string>& columns, const FakeCell& cell) {
+    if (columns.empty()) {
+        return true;
+    }
+    for (size_t i = 0; i < columns.size(); ++i) {
+        size_t colon = columns[i].find(':');
+        if (colon == std::string::npos) {
+            if (columns[i] == cell.family) {
+                return true;
+            }
+        } else if (columns[i].compare(0, colon, cell.family) == 0
+                   && columns[i].compare(colon + 1, std::string::npos, cell.qualifier) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<FakeCell> selectCells(const Table& table, const ScanRange& range) {
+    std::string low;
+    std::string high;
+    rowBounds(range, low, high);
+    std::string splitLow = fromHex(range.splitStart);
+    std::string splitHigh = fromHex(range.splitStop);
+    std::vector<std::string> columns;
+    if (!range.columns.empty()) {
+        columns = spec::split(range.columns, ',');
+    }
+
+    std::vector<FakeCell> selected;
+    const FakeCell* previous = nullptr;
+    int versions = 0;
+    for (size_t i = 0; i < table.cells.size(); ++i) {
+        const FakeCell& cell = table.cells[i];
+        if (cell.row < low || (!high.empty() && cell.row >= high) || cell.row < splitLow
+            || (!splitHigh.empty() && cell.row >= splitHigh) || !inColumns(columns, cell)) {
+            continue;
+        }
+        if ((range.minTime != 0 || range.maxTime != 0)
+            && (cell.timestamp < range.minTime || (range.maxTime != 0 && cell.timestamp >= range.maxTime))) {
+            continue;
+        }
+        bool sameColumn = previous != nullptr && previous->row == cell.row && previous->family == cell.family
+            && previous->qualifier == cell.qualifier;
+        versions = sameColumn ? versions + 1 : 1;
+        previous = &cell;
+        if (versions <= range.maxVersions) {
+            selected.push_back(cell);
+        }
+    }
+    if (range.reversed) {
+        // 行的顺序反转，行内单元格仍为正常顺序
+        std::vector<FakeCell> reversed;
+        size_t end = selected.size();
+        while (end > 0) {
+            size_t begin = end - 1;
+            while (begin > 0 && selected[begin - 1].row == selected[end - 1].row) {
+                --begin;
+            }
+            reversed.insert(reversed.end(), selected.begin() + begin, selected.begin() + end);
+            end = begin;
+        }
+        selected.swap(reversed);
+    }
+    return selected;
+}
+
+int64_t nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+void resetCluster() {
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    tables.clear();
+    scans.clear();
+    scannerCount = 0;
+}
+
+void putCell(const std::string& cluster, const std::string& table, const std::string& row,
+             const std::string& family, const std::string& qualifier, int64_t timestamp, const std::string& value) {
+    FakeCell cell = {row, family, qualifier, timestamp == codec::LATEST_TIMESTAMP ? nowMillis() : timestamp, value};
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    insertCell(tables[tableKey(cluster, table)], cell);
+}
+
+void setSplits(const std::string& cluster, const std::string& table, const std::vector<std::string>& keys) {
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    std::vector<std::string>& splits = tables[tableKey(cluster, table)].splits;
+    splits = keys;
+    std::sort(splits.begin(), splits.end());
+}
+
+std::vector<FakeCell> tableCells(const std::string& cluster, const std::string& table) {
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    std::map<std::string, Table>::const_iterator it = tables.find(tableKey(cluster, table));
+    return it != tables.end() ? it->second.cells : std::vector<FakeCell>();
+}
+
+uint64_t openedScanners() {
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    return scannerCount;
+}
+
+} // namespace test
+
+ScannerReader::ScannerReader()
+    : env_(nullptr), bridgeClass_(nullptr), nextBatch_(nullptr), closeScanner_(nullptr), scannerId_(-1),
+      token_(nullptr) {
+}
+
+ScannerReader::~ScannerReader() {
+    close();
+}
+
+bool ScannerReader::open(const ScanRange& range, std::string& error) {
+    range_ = range;
+    token_ = cancel::current();
+    if (token_ != nullptr && token_->isAborted()) {
+        error = cancel::statusMessage(token_->status());
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(test::clusterMutex);
+    std::map<std::string, test::Table>::const_iterator table =
+        test::tables.find(test::tableKey(range.cluster, range.tableName));
+    if (table == test::tables.end()) {
+        error = "打开扫描失败，表名: " + range.tableName;
+        return false;
+    }
+    test::OpenScan scan;
+    scan.cells = test::selectCells(table->second, range);
+    scan.position = 0;
+    scannerId_ = test::nextScanId++;
+    test::scans[scannerId_] = scan;
+    ++test::scannerCount;
+    return true;
+}
+
+bool ScannerReader::next(std::vector<uint8_t>& batch, std::string& error) {
+    error.clear();
+    if (scannerId_ < 0) {
+        return false;
+    }
+    if (token_ != nullptr && token_->isAborted()) {
+        error = cancel::statusMessage(token_->status());
+        close();
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(test::clusterMutex);
+    test::OpenScan& scan = test::scans[scannerId_];
+    codec::BatchWriter writer;
+    int rows = 0;
+    while (scan.position < scan.cells.size()) {
+        const test::FakeCell& cell = scan.cells[scan.position];
+        bool newRow = scan.position == 0 || scan.cells[scan.position - 1].row != cell.row;
+        if (newRow && (rows >= range_.batchRows || writer.size() >= (size_t)range_.batchBytes)) {
+            break;
+        }
+        rows += newRow ? 1 : 0;
+        writer.add(cell.row, cell.family, cell.qualifier, cell.value, cell.timestamp);
+        ++scan.position;
+    }
+    if (writer.empty()) {
+        return false;
+    }
+    batch = writer.finish();
+    return true;
+}
+
+void ScannerReader::close() {
+    if (scannerId_ >= 0) {
+        std::lock_guard<std::mutex> lock(test::clusterMutex);
+        test::scans.erase(scannerId_);
+    }
+    scannerId_ = -1;
+}
+
+bool splitByRegion(const ScanRange& range, std::vector<ScanRange>& splits, std::string& error) {
+    std::vector<std::string> keys;
+    {
+        std::lock_guard<std::mutex> lock(test::clusterMutex);
+        std::map<std::string, test::Table>::const_iterator table =
+            test::tables.find(test::tableKey(range.cluster, range.tableName));
+        if (table == test::tables.end()) {
+            error = "获取Region切分失败，表名: " + range.tableName;
+            return false;
+        }
+        keys = table->second.splits;
+    }
+    std::string low;
+    std::string high;
+    test::rowBounds(range, low, high);
+    keys.insert(keys.begin(), std::string());
+    splits.clear();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        std::string start = keys[i];
+        std::string stop = i + 1 < keys.size() ? keys[i + 1] : std::string();
+        bool intersects = (stop.empty() || low < stop) && (high.empty() || start < high);
+        if (intersects) {
+            ScanRange split = range;
+            split.splitStart = test::toHex(start);
+            split.splitStop = test::toHex(stop);
+            splits.push_back(split);
+        }
+    }
+    return true;
+}
+
+TableWriter::TableWriter(const std::string& tableName, const std::string& cluster)
+    : env_(nullptr), bridgeClass_(nullptr), method_(reinterpret_cast<jmethodID>(&test::writerMethodTag)),
+      tableName_(nullptr), cluster_(nullptr), clusterName_(cluster) {
+    std::lock_guard<std::mutex> lock(test::clusterMutex);
+    test::writers[this] = test::tableKey(cluster, tableName);
+}
+
+TableWriter::~TableWriter() {
+    std::lock_guard<std::mutex> lock(test::clusterMutex);
+    test::writers.erase(this);
+}
+
+int TableWriter::write(const std::vector<uint8_t>& batch) {
+    codec::BatchReader reader(batch.data(), batch.size());
+    codec::CellView view;
+    std::vector<test::FakeCell> cells;
+    int rows = 0;
+    while (reader.next(view)) {
+        test::FakeCell cell;
+        cell.row.assign(view.row, view.rowLength);
+        cell.family.assign(view.family, view.familyLength);
+        cell.qualifier.assign(view.qualifier, view.qualifierLength);
+        cell.timestamp = view.timestamp == codec::LATEST_TIMESTAMP ? test::nowMillis() : view.timestamp;
+        cell.value.assign(view.value, view.valueLength);
+        if (cells.empty() || cells.back().row != cell.row) {
+            ++rows;
+        }
+        cells.push_back(cell);
+    }
+    if (reader.hasError()) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(test::clusterMutex);
+    test::Table& table = test::tables[test::writers[this]];
+    for (size_t i = 0; i < cells.size(); ++i) {
+        test::insertCell(table, cells[i]);
+    }
+    return rows;
+}
+
+} // namespace bridge
@@ -0,0 +1,43 @@
+#ifndef FAKE_CLUSTER_H
+#define FAKE_CLUSTER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// 单元测试用的进程内集群替身：替换ScannerReader、splitByRegion与TableWriter的JNI实现
+// （见fake_cluster.cpp），扫描与批量写入直接访问这里的内存表，不需要JVM。
+// 扫描语义与Java层MemoryTableBackend一致：起止行、前缀、Region切分、投影列、时间范围、
+// 多版本与反向扫描；写入时间戳为LATEST_TIMESTAMP时取当前毫秒时间。
+
+namespace bridge {
+namespace test {
+
+struct FakeCell {
+    std::string row;
+    std::string family;
+    std::string qualifier;
+    int64_t timestamp;
+    std::string value;
+};
+
+// 清空所有集群的表与切分
+void resetCluster();
+
+// 写入一个单元格（同一列同一时间戳覆盖旧值），cluster为空表示主连接
+void putCell(const std::string& cluster, const std::string& table, const std::string& row,
+             const std::string& family, const std::string& qualifier, int64_t timestamp, const std::string& value);
+
+// 设置表的Region切分键（按行键排序），未设置时整张表是一个Region
+void setSplits(const std::string& cluster, const std::string& table, const std::vector<std::string>& keys);
+
+// 表中的全部单元格：按行键、列族、列名升序，同一列从新到旧
+std::vector<FakeCell> tableCells(const std::string& cluster, const std::string& table);
+
+// 打开过的扫描器数，用于检查按Region并行扫描
+uint64_t openedScanners();
+
+} // namespace test
+} // namespace bridge
+
+#endif // FAKE_CLUSTER_H
@@ -0,0 +1,7 @@
+#include <jni.h>
+
+// 测试进程不创建JVM：jni_support按“JVM尚未创建”处理，依赖Java层的功能直接返回失败
+extern "C" JNIEXPORT jint JNICALL JNI_GetCreatedJavaVMs(JavaVM**, jsize, jsize* count) {
+    *count = 0;
+    return JNI_OK;
+}
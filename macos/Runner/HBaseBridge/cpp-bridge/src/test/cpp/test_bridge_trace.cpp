@@ -0,0 +1,69 @@
+#include "bridge_test.h"
+#include "bridge_trace.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+std::string flushText() {
+    std::string path = test::tempPath("trace.json");
+    CHECK(trace::flushToFile(path));
+    std::ifstream in(path.c_str());
+    std::ostringstream out;
+    out << in.rdbuf();
+    return out.str();
+}
+
+size_t countOf(const std::string& text, const std::string& part) {
+    size_t count = 0;
+    for (size_t pos = text.find(part); pos != std::string::npos; pos = text.find(part, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(traceReleasesRingsOfExitedThreads) {
+    trace::setEnabled(true);
+    flushText();
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < 4; ++i) {
+        workers.push_back(std::thread([]() {
+            trace::Span span("worker");
+        }));
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+    // 退出线程的事件在下一次导出时仍然可见
+    std::string first = flushText();
+    CHECK_EQ(countOf(first, "\"name\":\"worker\""), (size_t)4);
+
+    // 导出后缓冲区已释放，不再出现这些线程
+    std::string second = flushText();
+    CHECK_EQ(countOf(second, "\"name\":\"worker\""), (size_t)0);
+    CHECK(countOf(second, "thread_name") + 4 <= countOf(first, "thread_name"));
+
+    // 关闭追踪后的线程不创建缓冲区
+    std::thread last([]() {
+        trace::Span span("last");
+    });
+    last.join();
+    trace::setEnabled(false);
+    std::thread quiet([]() {
+        trace::Span span("quiet");
+    });
+    quiet.join();
+    std::string third = flushText();
+    CHECK_EQ(countOf(third, "\"name\":\"last\""), (size_t)1);
+    CHECK_EQ(countOf(third, "\"name\":\"quiet\""), (size_t)0);
+    CHECK_EQ(countOf(flushText(), "thread_name"), countOf(second, "thread_name"));
+}
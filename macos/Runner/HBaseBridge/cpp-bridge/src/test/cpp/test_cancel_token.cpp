@@ -0,0 +1,67 @@
+#include "bridge_test.h"
+#include "cancel_token.h"
+#include "fake_cluster.h"
+#include "scanner_reader.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bridge;
+
+TEST(tokenReportsCancelAndDeadline) {
+    cancel::Token token;
+    CHECK(!token.isAborted());
+    token.setDeadline(0);
+    CHECK(token.status() == cancel::STATUS_OK);
+    token.cancel();
+    CHECK(token.status() == cancel::STATUS_CANCELLED);
+    CHECK_EQ(std::string(cancel::statusName(token.status())), std::string("cancelled"));
+
+    cancel::Token timed;
+    timed.setDeadline(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    CHECK(timed.status() == cancel::STATUS_DEADLINE_EXCEEDED);
+    CHECK_EQ(cancel::statusMessage(timed.status()), std::string("操作超过截止时间"));
+}
+
+TEST(tokenScopeBindsCurrentThread) {
+    CHECK(cancel::current() == nullptr);
+    std::shared_ptr<cancel::Token> token = cancel::create(0);
+    {
+        cancel::TokenScope scope(token.get());
+        CHECK(cancel::current() == token.get());
+        cancel::TokenScope keep(nullptr);
+        CHECK(cancel::current() == token.get());
+    }
+    CHECK(cancel::current() == nullptr);
+    CHECK(cancel::find(token->id()) == token);
+    cancel::release(token->id());
+    CHECK(cancel::find(token->id()) == nullptr);
+}
+
+TEST(cancelledTokenStopsScan) {
+    test::resetCluster();
+    for (int i = 0; i < 10; ++i) {
+        test::putCell("", "t", "r" + std::to_string(i), "cf", "q", 1, "v");
+    }
+    ScanRange range;
+    range.tableName = "t";
+    range.batchRows = 2;
+
+    cancel::Token token;
+    cancel::TokenScope scope(&token);
+    ScannerReader reader;
+    std::string error;
+    CHECK(reader.open(range, error));
+    std::vector<uint8_t> batch;
+    CHECK(reader.next(batch, error));
+    token.cancel();
+    CHECK(!reader.next(batch, error));
+    CHECK_EQ(error, std::string("操作已取消"));
+
+    ScannerReader again;
+    CHECK(!again.open(range, error));
+    CHECK_EQ(error, std::string("操作已取消"));
+}
@@ -0,0 +1,88 @@
+#include "bridge_test.h"
+#include "cell_codec.h"
+
+#include <string>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+std::string text(const char* data, uint32_t length) {
+    return std::string(data, length);
+}
+
+} // namespace
+
+TEST(cellCodecRoundTripSharesRowKeys) {
+    codec::BatchWriter writer;
+    writer.add("row-1", "cf", "a", "1", 10);
+    writer.add("row-1", "cf", "b", "22", 11);
+    writer.add("row-2", "meta", "c", "", codec::LATEST_TIMESTAMP);
+    const std::vector<uint8_t>& batch = writer.finish();
+    CHECK_EQ(writer.cellCount(), (uint32_t)3);
+
+    codec::BatchReader reader(batch.data(), batch.size());
+    CHECK_EQ(reader.cellCount(), (uint32_t)3);
+    codec::CellView cell;
+    std::vector<std::string> cells;
+    while (reader.next(cell)) {
+        cells.push_back(text(cell.row, cell.rowLength) + "/" + text(cell.family, cell.familyLength) + ":"
+                        + text(cell.qualifier, cell.qualifierLength) + "=" + text(cell.value, cell.valueLength));
+        CHECK_EQ(cell.type, codec::TYPE_PUT);
+        CHECK_EQ(cell.fullValueLength, cell.valueLength);
+    }
+    CHECK(!reader.hasError());
+    CHECK_EQ(cells.size(), (size_t)3);
+    if (cells.size() == 3) {
+        CHECK_EQ(cells[0], std::string("row-1/cf:a=1"));
+        CHECK_EQ(cells[1], std::string("row-1/cf:b=22"));
+        CHECK_EQ(cells[2], std::string("row-2/meta:c="));
+    }
+
+    // 第二个单元格与第一个同一行，不再写行键（4字节长度 + 5字节行键）
+    codec::BatchWriter distinct;
+    distinct.add("row-1", "cf", "a", "1", 10);
+    distinct.add("row-9", "cf", "b", "22", 11);
+    distinct.add("row-2", "meta", "c", "", codec::LATEST_TIMESTAMP);
+    CHECK_EQ(distinct.size() - writer.size(), (size_t)9);
+}
+
+TEST(cellCodecReadsTruncatedValues) {
+    codec::BatchWriter writer;
+    writer.add("r", "cf", "q", "abc", 1);
+    std::vector<uint8_t> batch = writer.finish();
+    batch[8] |= codec::FLAG_TRUNCATED;
+    uint8_t fullLength[4] = {0, 0, 0x10, 0};
+    batch.insert(batch.end(), fullLength, fullLength + 4);
+
+    codec::BatchReader reader(batch.data(), batch.size());
+    codec::CellView cell;
+    CHECK(reader.next(cell));
+    CHECK_EQ(cell.valueLength, (uint32_t)3);
+    CHECK_EQ(cell.fullValueLength, (uint32_t)4096);
+    CHECK(!reader.next(cell));
+    CHECK(!reader.hasError());
+}
+
+TEST(cellCodecRejectsMalformedBatches) {
+    codec::BatchWriter writer;
+    writer.add("r", "cf", "q", "value", 1);
+    std::vector<uint8_t> batch = writer.finish();
+
+    std::vector<uint8_t> badMagic = batch;
+    badMagic[0] = 'X';
+    codec::BatchReader magicReader(badMagic.data(), badMagic.size());
+    CHECK(magicReader.hasError());
+
+    codec::BatchReader shortReader(batch.data(), batch.size() - 2);
+    codec::CellView cell;
+    CHECK(!shortReader.next(cell));
+    CHECK_CONTAINS(shortReader.error(), "不完整");
+
+    std::vector<uint8_t> sameRow = batch;
+    sameRow[8] = codec::FLAG_SAME_ROW;
+    codec::BatchReader sameRowReader(sameRow.data(), sameRow.size());
+    CHECK(!sameRowReader.next(cell));
+    CHECK(sameRowReader.hasError());
+}
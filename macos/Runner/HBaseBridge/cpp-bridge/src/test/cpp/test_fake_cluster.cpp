@@ -0,0 +1,124 @@
+#include "bridge_test.h"
+#include "cell_codec.h"
+#include "fake_cluster.h"
+#include "scanner_reader.h"
+#include "table_writer.h"
+
+#include <string>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+// 扫描整个范围，结果为 "行/列族:列名@时间戳=值" 列表
+std::vector<std::string> scanAll(const ScanRange& range) {
+    std::vector<std::string> cells;
+    ScannerReader reader;
+    std::string error;
+    if (!reader.open(range, error)) {
+        cells.push_back("error: " + error);
+        return cells;
+    }
+    std::vector<uint8_t> batch;
+    while (reader.next(batch, error)) {
+        codec::BatchReader batchReader(batch.data(), batch.size());
+        codec::CellView cell;
+        while (batchReader.next(cell)) {
+            cells.push_back(std::string(cell.row, cell.rowLength) + "/" + std::string(cell.family, cell.familyLength)
+                            + ":" + std::string(cell.qualifier, cell.qualifierLength) + "@"
+                            + std::to_string((long long)cell.timestamp) + "="
+                            + std::string(cell.value, cell.valueLength));
+        }
+    }
+    return cells;
+}
+
+ScanRange tableRange(const std::string& table) {
+    ScanRange range;
+    range.tableName = table;
+    return range;
+}
+
+} // namespace
+
+TEST(fakeClusterScansRangesAndVersions) {
+    test::resetCluster();
+    test::putCell("", "t", "r1", "cf", "a", 10, "v10");
+    test::putCell("", "t", "r1", "cf", "a", 20, "v20");
+    test::putCell("", "t", "r2", "cf", "a", 10, "x");
+    test::putCell("", "t", "r3", "cf", "b", 10, "y");
+
+    std::vector<std::string> cells = scanAll(tableRange("t"));
+    CHECK_EQ(cells.size(), (size_t)3);
+    CHECK_EQ(cells[0], std::string("r1/cf:a@20=v20"));
+
+    ScanRange range = tableRange("t");
+    range.startRow = "r2";
+    range.stopRow = "r3";
+    cells = scanAll(range);
+    CHECK_EQ(cells.size(), (size_t)1);
+    CHECK_EQ(cells[0], std::string("r2/cf:a@10=x"));
+
+    range = tableRange("t");
+    range.prefix = "r3";
+    cells = scanAll(range);
+    CHECK_EQ(cells.size(), (size_t)1);
+    CHECK_EQ(cells[0], std::string("r3/cf:b@10=y"));
+
+    range = tableRange("t");
+    range.maxVersions = 2;
+    range.maxTime = 20;
+    range.reversed = true;
+    cells = scanAll(range);
+    CHECK_EQ(cells.size(), (size_t)3);
+    CHECK_EQ(cells[0], std::string("r3/cf:b@10=y"));
+    CHECK_EQ(cells[2], std::string("r1/cf:a@10=v10"));
+
+    cells = scanAll(tableRange("missing"));
+    CHECK_EQ(cells.size(), (size_t)1);
+    CHECK_CONTAINS(cells[0], "error");
+}
+
+TEST(fakeClusterSplitsByRegion) {
+    test::resetCluster();
+    test::putCell("", "t", "a", "cf", "q", 1, "1");
+    test::putCell("", "t", "m", "cf", "q", 1, "2");
+    test::putCell("", "t", "z", "cf", "q", 1, "3");
+    std::vector<std::string> keys;
+    keys.push_back("g");
+    keys.push_back("p");
+    test::setSplits("", "t", keys);
+
+    std::vector<ScanRange> splits;
+    std::string error;
+    CHECK(splitByRegion(tableRange("t"), splits, error));
+    CHECK_EQ(splits.size(), (size_t)3);
+    if (splits.size() == 3) {
+        CHECK_EQ(splits[1].splitStart, std::string("67"));
+        CHECK_EQ(splits[1].splitStop, std::string("70"));
+        std::vector<std::string> cells = scanAll(splits[1]);
+        CHECK_EQ(cells.size(), (size_t)1);
+        CHECK_EQ(cells[0], std::string("m/cf:q@1=2"));
+    }
+
+    ScanRange range = tableRange("t");
+    range.prefix = "m";
+    CHECK(splitByRegion(range, splits, error));
+    CHECK_EQ(splits.size(), (size_t)1);
+}
+
+TEST(fakeClusterWritesBatches) {
+    test::resetCluster();
+    codec::BatchWriter writer;
+    writer.add("r1", "cf", "a", "1", 5);
+    writer.add("r1", "cf", "b", "2", 5);
+    writer.add("r2", "cf", "a", "3", 5);
+    TableWriter tableWriter("t", "peer");
+    CHECK(tableWriter.isValid());
+    CHECK_EQ(tableWriter.write(writer.finish()), 2);
+
+    std::vector<test::FakeCell> cells = test::tableCells("peer", "t");
+    CHECK_EQ(cells.size(), (size_t)3);
+    CHECK(test::tableCells("", "t").empty());
+}
@@ -0,0 +1,9 @@
+#include "bridge_test.h"
+#include "jni_support.h"
+
+using namespace bridge;
+
+TEST(jniCallsFailWithoutJvm) {
+    CHECK(currentEnv() == nullptr);
+    CHECK(callStaticString("HBaseBridge", "getRegions", "(Ljava/lang/String;)Ljava/lang/String;", nullptr) == nullptr);
+}
@@ -0,0 +1,25 @@
+#include "bridge_test.h"
+#include "large_cell.h"
+
+#include <string>
+
+using namespace bridge;
+
+TEST(previewLengthKeepsUtf8Characters) {
+    CHECK_EQ(cells::previewBytes(), (uint32_t)(64 << 10));
+    CHECK_EQ(cells::previewLength("short", 5), (uint32_t)5);
+
+    // 3字节的汉字，65536 = 3 * 21845 + 1，截断点落在第21846个字的第二个字节
+    std::string chinese;
+    for (int i = 0; i < 30000; ++i) {
+        chinese += "中";
+    }
+    CHECK_EQ(cells::previewLength(chinese.data(), (uint32_t)chinese.size()), (uint32_t)65535);
+
+    std::string ascii(70000, 'a');
+    CHECK_EQ(cells::previewLength(ascii.data(), (uint32_t)ascii.size()), (uint32_t)65536);
+
+    // 不是UTF-8的二进制值最多退3字节，否则按阈值截断
+    std::string binary(70000, '\x80');
+    CHECK_EQ(cells::previewLength(binary.data(), (uint32_t)binary.size()), (uint32_t)65536);
+}
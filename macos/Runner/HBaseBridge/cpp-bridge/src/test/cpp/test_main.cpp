@@ -0,0 +1,95 @@
+#include "bridge_test.h"
+#include "bridge_log.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ftw.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace bridge {
+namespace test {
+
+namespace {
+
+struct TestCase {
+    const char* name;
+    TestFunction function;
+};
+
+std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+int failures = 0;
+std::string currentDirectory;
+
+int removeEntry(const char* path, const struct stat*, int, struct FTW*) {
+    return remove(path);
+}
+
+} // namespace
+
+Registrar::Registrar(const char* name, TestFunction function) {
+    TestCase test = {name, function};
+    registry().push_back(test);
+}
+
+void fail(const char* file, int line, const std::string& message) {
+    ++failures;
+    fprintf(stderr, "  %s:%d: 检查失败: %s\n", file, line, message.c_str());
+}
+
+void checkContains(const std::string& text, const std::string& part, const char* textExpression,
+                   const char* file, int line) {
+    if (text.find(part) == std::string::npos) {
+        fail(file, line, std::string(textExpression) + " 不包含 " + part + "\n      实际: " + text);
+    }
+}
+
+std::string tempPath(const std::string& name) {
+    if (currentDirectory.empty()) {
+        const char* base = getenv("TMPDIR");
+        std::string pattern = std::string(base != nullptr && base[0] != '\0' ? base : "/tmp") + "/bridge_test_XXXXXX";
+        std::vector<char> buffer(pattern.begin(), pattern.end());
+        buffer.push_back('\0');
+        if (mkdtemp(buffer.data()) == nullptr) {
+            fail(__FILE__, __LINE__, "无法创建临时目录: " + pattern);
+            return name;
+        }
+        currentDirectory = buffer.data();
+    }
+    return currentDirectory + "/" + name;
+}
+
+} // namespace test
+} // namespace bridge
+
+int main(int argc, char** argv) {
+    // 被测模块的日志只在失败时有用，默认只输出警告以上
+    bridge::log::setLevel(bridge::log::LEVEL_WARN);
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    int failed = 0;
+    std::vector<bridge::test::TestCase>& tests = bridge::test::registry();
+    for (size_t i = 0; i < tests.size(); ++i) {
+        if (filter != nullptr && strstr(tests[i].name, filter) == nullptr) {
+            continue;
+        }
+        int before = bridge::test::failures;
+        tests[i].function();
+        if (!bridge::test::currentDirectory.empty()) {
+            nftw(bridge::test::currentDirectory.c_str(), bridge::test::removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+            bridge::test::currentDirectory.clear();
+        }
+        bool ok = bridge::test::failures == before;
+        printf("[%s] %s\n", ok ? "  OK  " : " FAIL ", tests[i].name);
+        ++run;
+        failed += ok ? 0 : 1;
+    }
+    printf("%d 个用例，%d 个失败\n", run, failed);
+    return failed == 0 && run > 0 ? 0 : 1;
+}
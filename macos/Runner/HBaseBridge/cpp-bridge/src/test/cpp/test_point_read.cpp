@@ -0,0 +1,21 @@
+#include "bridge_test.h"
+#include "point_read.h"
+
+#include <string>
+
+using namespace bridge;
+
+TEST(pointReadsDefaultToSingleAttempt) {
+    PointReadOptions options;
+    CHECK(!options.hedge);
+    CHECK_EQ(options.maxRetries, 0);
+
+    std::string error;
+    CHECK(parsePointReadOptions("hedge=true;maxRetries=2", options, error));
+    CHECK(options.hedge);
+    CHECK_EQ(options.maxRetries, 2);
+    CHECK_EQ(options.percentile, 95);
+
+    CHECK(!parsePointReadOptions("maxRetries=11", options, error));
+    CHECK(!parsePointReadOptions("backoffMs=500;maxBackoffMs=100", options, error));
+}
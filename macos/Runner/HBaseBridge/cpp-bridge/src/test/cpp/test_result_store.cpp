@@ -0,0 +1,133 @@
+#include "bridge_test.h"
+#include "cell_codec.h"
+#include "fake_cluster.h"
+#include "result_store.h"
+
+#include <string>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+ScanRange tableRange() {
+    ScanRange range;
+    range.tableName = "t";
+    range.batchRows = 2;
+    return range;
+}
+
+void fillStore(results::ResultStore& store, uint64_t maxRows) {
+    jobs::Job job(1, "results");
+    std::string error;
+    CHECK(results::fill(store, tableRange(), maxRows, job, error));
+    CHECK_EQ(error, std::string());
+}
+
+} // namespace
+
+TEST(resultStoreFillsColumns) {
+    test::resetCluster();
+    test::putCell("", "t", "r1", "cf", "a", 10, "a1");
+    test::putCell("", "t", "r2", "cf", "b", 10, "b2");
+    test::putCell("", "t", "r3", "cf", "a", 12, "a3");
+    test::putCell("", "t", "r3", "cf", "b", 11, "b3");
+
+    results::ResultStore store;
+    fillStore(store, 0);
+    std::string info = store.infoJson();
+    CHECK_CONTAINS(info, "{\"rows\":3,\"columns\":[\"cf:a\",\"cf:b\"],\"complete\":true,");
+    CHECK_CONTAINS(info, "\"truncated\":false,\"maxTimestamp\":12}");
+    CHECK_EQ(store.rowsJson(1, 10, 0, 2),
+             std::string("{\"firstRow\":1,\"rows\":[[\"r2\",null,\"b2\"],[\"r3\",\"a3\",\"b3\"]]}"));
+    CHECK_EQ(store.rowsJson(0, 1, 1, 5), std::string("{\"firstRow\":0,\"rows\":[[\"r1\",null]]}"));
+    CHECK_EQ(store.rowsJson(5, 1, 0, 2), std::string("{\"firstRow\":5,\"rows\":[]}"));
+
+    // 行数上限
+    results::ResultStore limited;
+    fillStore(limited, 2);
+    CHECK_CONTAINS(limited.infoJson(), "{\"rows\":2,");
+}
+
+TEST(resultStoreRefreshRequiresCompleteFill) {
+    results::ResultStore store;
+    ScanRange range = tableRange();
+    store.setSource(range, 0);
+    std::string error;
+    CHECK(!store.beginRefresh(range, error));
+    CHECK_CONTAINS(error, "仍在填充");
+
+    store.markComplete();
+    CHECK(store.beginRefresh(range, error));
+    CHECK(!store.beginRefresh(range, error));
+    CHECK_CONTAINS(error, "正在刷新");
+    store.endRefresh();
+    CHECK(store.beginRefresh(range, error));
+    store.endRefresh();
+}
+
+TEST(resultStoreMergesNewerCells) {
+    test::resetCluster();
+    test::putCell("", "t", "r1", "cf", "a", 10, "a1");
+    test::putCell("", "t", "r3", "cf", "a", 20, "a3");
+    results::ResultStore store;
+    fillStore(store, 0);
+
+    ScanRange range;
+    std::string error;
+    CHECK(store.beginRefresh(range, error));
+    // 下界收紧到已见到的最大时间戳（含）
+    CHECK_EQ(range.minTime, (int64_t)20);
+    CHECK_EQ(range.tableName, std::string("t"));
+    store.endRefresh();
+
+    codec::BatchWriter writer;
+    writer.add("r1", "cf", "a", "old", 5);    // 更旧的版本，忽略
+    writer.add("r1", "cf", "b", "b1", 21);    // 已有行中的新列
+    writer.add("r2", "cf", "a", "a2", 21);    // 新行追加在末尾
+    writer.add("r3", "cf", "a", "a3", 20);    // 同一时间戳同一值，不算更新
+    writer.add("r3", "cf", "a", "a3new", 22); // 更新
+    results::MergeStats stats;
+    store.merge(writer.finish(), stats, error);
+    CHECK_EQ(error, std::string());
+    CHECK_EQ(stats.newRows, (uint64_t)1);
+    CHECK_EQ(stats.newCells, (uint64_t)2);
+    CHECK_EQ(stats.updatedCells, (uint64_t)1);
+    CHECK_EQ(stats.skippedRows, (uint64_t)0);
+    CHECK_EQ(store.rowsJson(0, 3, 0, 2), std::string("{\"firstRow\":0,\"rows\":[[\"r1\",\"a1\",\"b1\"],"
+        "[\"r3\",\"a3new\",null],[\"r2\",\"a2\",null]]}"));
+    CHECK_CONTAINS(store.infoJson(), "\"maxTimestamp\":22");
+
+    // 再次合并时按行键找到刷新追加的行
+    writer.clear();
+    writer.add("r2", "cf", "b", "b2", 23);
+    results::MergeStats again;
+    store.merge(writer.finish(), again, error);
+    CHECK_EQ(again.newRows, (uint64_t)0);
+    CHECK_EQ(again.newCells, (uint64_t)1);
+    CHECK_EQ(store.rowsJson(2, 1, 0, 2), std::string("{\"firstRow\":2,\"rows\":[[\"r2\",\"a2\",\"b2\"]]}"));
+}
+
+TEST(resultStoreRefreshScansOnlyNewWrites) {
+    test::resetCluster();
+    test::putCell("", "t", "r1", "cf", "a", 10, "a1");
+    test::putCell("", "t", "r2", "cf", "a", 10, "a2");
+    results::ResultStore store;
+    fillStore(store, 2);
+
+    test::putCell("", "t", "r1", "cf", "a", 15, "a1new");
+    test::putCell("", "t", "r0", "cf", "a", 15, "a0");
+    test::putCell("", "t", "r2", "cf", "a", 5, "stale"); // 显式指定较早时间戳的写入看不到
+    jobs::Job job(2, "refresh");
+    std::string error;
+    CHECK(results::refresh(store, job, error));
+    CHECK_CONTAINS(job.toJson(), "\"result\":{\"newRows\":0,\"newCells\":0,\"updatedCells\":1,\"skippedRows\":1,"
+        "\"minTime\":10}");
+    CHECK_EQ(store.rowsJson(0, 5, 0, 1), std::string("{\"firstRow\":0,\"rows\":[[\"r1\",\"a1new\"],[\"r2\",\"a2\"]]}"));
+
+    // 没有新写入时只重扫边界上的cell
+    jobs::Job idle(3, "refresh");
+    CHECK(results::refresh(store, idle, error));
+    CHECK_CONTAINS(idle.toJson(), "\"result\":{\"newRows\":0,\"newCells\":0,\"updatedCells\":0,\"skippedRows\":1,"
+        "\"minTime\":15}");
+}
@@ -0,0 +1,184 @@
+#include "bridge_test.h"
+#include "cell_codec.h"
+#include "result_store.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+// 每行 cf:v 一列，value为空指针时该行没有这一列；另有 cf:k 列为行序号
+void fillRows(results::ResultStore& store, const std::vector<const char*>& values) {
+    codec::BatchWriter writer;
+    for (size_t i = 0; i < values.size(); ++i) {
+        char row[16];
+        snprintf(row, sizeof(row), "r%06d", (int)i);
+        writer.add(row, "cf", "k", std::to_string(i), 1);
+        if (values[i] != nullptr) {
+            writer.add(row, "cf", "v", values[i], 1);
+        }
+    }
+    std::string error;
+    store.append(writer.finish(), 0, error);
+    CHECK_EQ(error, std::string());
+    store.markComplete();
+}
+
+// 应用视图，返回视图中各行的行键（以空格分隔）
+std::string viewRows(results::ResultStore& store, const std::string& text) {
+    results::ViewSpec spec;
+    std::string error;
+    uint64_t rows = 0;
+    if (!results::parseViewSpec(text, spec, error) || !store.applyView(spec, rows, error)) {
+        return "error: " + error;
+    }
+    std::string json = store.rowsJson(0, (uint32_t)rows, 0, 0);
+    std::string keys;
+    for (size_t pos = json.find("[\"r"); pos != std::string::npos; pos = json.find("[\"r", pos + 1)) {
+        keys += (keys.empty() ? "" : " ") + json.substr(pos + 2, 7);
+    }
+    return keys;
+}
+
+} // namespace
+
+TEST(parseViewSpecValidates) {
+    results::ViewSpec spec;
+    std::string error;
+    CHECK(results::parseViewSpec("sort=cf:v;type=long;order=desc;filter=cf:v|gt|3;filter=cf:w|exists;threads=2",
+                                 spec, error));
+    CHECK_EQ(spec.sortColumn, std::string("cf:v"));
+    CHECK(spec.sortType == results::VALUE_LONG);
+    CHECK(spec.descending);
+    CHECK_EQ(spec.filters.size(), (size_t)2);
+    CHECK_EQ(spec.threads, 2);
+
+    results::ViewSpec bad;
+    CHECK(!results::parseViewSpec("order=up", bad, error));
+    CHECK_CONTAINS(error, "order=up");
+    CHECK(!results::parseViewSpec("filter=cf:v|like|x", bad, error));
+    CHECK(!results::parseViewSpec("filter=cf:v|exists|x", bad, error));
+    CHECK(!results::parseViewSpec("filter=cf:v|eq", bad, error));
+    CHECK(!results::parseViewSpec("type=float", bad, error));
+    CHECK(results::parseViewSpec("threads=8", bad, error));
+    CHECK(!results::parseViewSpec("threads=9", bad, error));
+    CHECK_CONTAINS(error, "threads=9");
+    CHECK(!results::parseViewSpec("group=cf:v", bad, error));
+    CHECK_CONTAINS(error, "未知的视图选项");
+}
+
+TEST(resultViewSortsByType) {
+    std::vector<const char*> values;
+    values.push_back("10");
+    values.push_back("9");
+    values.push_back(nullptr);
+    values.push_back("-3");
+    values.push_back("100");
+    results::ResultStore store;
+    fillRows(store, values);
+
+    // auto：全部可按long解析，按数值排序；缺少的值在最后
+    CHECK_EQ(viewRows(store, "sort=cf:v"), std::string("r000003 r000001 r000000 r000004 r000002"));
+    CHECK_EQ(viewRows(store, "sort=cf:v;order=desc"), std::string("r000004 r000000 r000001 r000003 r000002"));
+    CHECK_EQ(viewRows(store, "sort=cf:v;type=string"), std::string("r000003 r000000 r000004 r000001 r000002"));
+    CHECK_EQ(viewRows(store, "sort=rowkey;order=desc"), std::string("r000004 r000003 r000002 r000001 r000000"));
+    // 空规格恢复扫描顺序
+    CHECK_EQ(viewRows(store, ""), std::string("r000000 r000001 r000002 r000003 r000004"));
+    CHECK_CONTAINS(viewRows(store, "sort=cf:none"), "结果集中没有列");
+}
+
+TEST(resultViewAutoFallsBackToDoubleAndString) {
+    std::vector<const char*> values;
+    values.push_back("2.5");
+    values.push_back("1");
+    values.push_back("abc");
+    values.push_back("-0.5");
+    values.push_back("ABD");
+    results::ResultStore store;
+    fillRows(store, values);
+
+    // 指定double时无法解析的值排在最后
+    CHECK_EQ(viewRows(store, "sort=cf:v;type=double"), std::string("r000003 r000001 r000000 r000002 r000004"));
+    CHECK_EQ(viewRows(store, "sort=cf:v;type=double;order=desc"),
+             std::string("r000000 r000001 r000003 r000002 r000004"));
+    // auto：有文本时按string比较，忽略大小写
+    CHECK_EQ(viewRows(store, "sort=cf:v"), std::string("r000003 r000001 r000000 r000002 r000004"));
+    CHECK_EQ(viewRows(store, "sort=cf:v;type=bytes"), std::string("r000003 r000001 r000000 r000004 r000002"));
+}
+
+TEST(resultViewFilters) {
+    std::vector<const char*> values;
+    values.push_back("apple");
+    values.push_back("12");
+    values.push_back(nullptr);
+    values.push_back("7");
+    values.push_back("pineapple");
+    results::ResultStore store;
+    fillRows(store, values);
+
+    CHECK_EQ(viewRows(store, "filter=cf:v|gt|7"), std::string("r000001"));
+    CHECK_EQ(viewRows(store, "filter=cf:v|le|12"), std::string("r000001 r000003"));
+    CHECK_EQ(viewRows(store, "filter=cf:v|ne|7"), std::string("r000001"));
+    CHECK_EQ(viewRows(store, "filter=cf:v|contains|apple"), std::string("r000000 r000004"));
+    CHECK_EQ(viewRows(store, "filter=cf:v|prefix|app"), std::string("r000000"));
+    CHECK_EQ(viewRows(store, "filter=cf:v|missing"), std::string("r000002"));
+    CHECK_EQ(viewRows(store, "filter=cf:v|eq|Apple|string"), std::string("r000000"));
+    CHECK_EQ(viewRows(store, "filter=cf:v|exists;filter=cf:k|ge|3;sort=cf:k;order=desc"),
+             std::string("r000004 r000003"));
+    CHECK_CONTAINS(viewRows(store, "filter=cf:v|gt|x|long"), "不是有效的数字");
+
+    uint64_t rows = 0;
+    std::string error;
+    results::ViewSpec spec;
+    CHECK(results::parseViewSpec("filter=cf:v|exists", spec, error));
+    CHECK(store.applyView(spec, rows, error));
+    CHECK_EQ(rows, (uint64_t)4);
+    CHECK_CONTAINS(store.infoJson(), "\"viewRows\":4");
+}
+
+TEST(resultViewUsesColumnFormats) {
+    // 8字节大端long：按字节比较时负数排在最后
+    codec::BatchWriter writer;
+    const int64_t numbers[] = {300, -2, 5};
+    for (int i = 0; i < 3; ++i) {
+        std::string value(8, '\0');
+        for (int b = 0; b < 8; ++b) {
+            value[b] = (char)(((uint64_t)numbers[i] >> (56 - 8 * b)) & 0xff);
+        }
+        writer.add("r00000" + std::to_string(i), "cf", "n", value, 1);
+    }
+    results::ResultStore store;
+    std::string error;
+    store.append(writer.finish(), 0, error);
+    store.markComplete();
+
+    CHECK_EQ(viewRows(store, "sort=cf:n;type=bytes"), std::string("r000002 r000000 r000001"));
+    CHECK(store.setFormats("cf:n=long", error));
+    CHECK_EQ(viewRows(store, "sort=cf:n;type=long"), std::string("r000001 r000002 r000000"));
+    CHECK_EQ(viewRows(store, "filter=cf:n|lt|10"), std::string("r000001 r000002"));
+}
+
+TEST(resultViewParallelMatchesSerial) {
+    // 超过并行阈值，分段排序后归并；大量重复值按行号兜底，结果与线程数无关
+    std::vector<std::string> text(100000);
+    std::vector<const char*> values(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        text[i] = i % 1000 == 0 ? std::string("n/a") : std::to_string((i * 7919) % 997);
+        values[i] = i % 4999 == 0 ? nullptr : text[i].c_str();
+    }
+    results::ResultStore store;
+    fillRows(store, values);
+
+    std::string serial = viewRows(store, "sort=cf:v;type=long;threads=1");
+    CHECK_EQ(viewRows(store, "sort=cf:v;type=long;threads=5"), serial);
+    CHECK_EQ(serial.substr(0, 15), std::string("r000997 r001994"));
+    // 缺少的值与无法解析的值在最后，按行号排列
+    CHECK_EQ(serial.substr(serial.size() - 7), std::string("r099980"));
+
+    std::string filtered = viewRows(store, "filter=cf:v|lt|10;sort=cf:v;order=desc;threads=1");
+    CHECK_EQ(viewRows(store, "filter=cf:v|lt|10;sort=cf:v;order=desc;threads=3"), filtered);
+    CHECK_EQ(filtered.size(), (size_t)1000 * 8 - 1);
+}
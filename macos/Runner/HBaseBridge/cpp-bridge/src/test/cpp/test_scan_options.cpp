@@ -0,0 +1,38 @@
+#include "bridge_test.h"
+#include "scanner_reader.h"
+
+#include <string>
+
+using namespace bridge;
+
+TEST(scanOptionsParseVersionsAndTimeRange) {
+    ScanRange range;
+    std::string error;
+    CHECK(parseVersionOptions("versions=3;minTime=100;maxTime=200", range, error));
+    CHECK_EQ(range.maxVersions, 3);
+    CHECK_EQ(range.minTime, (int64_t)100);
+    CHECK_EQ(range.maxTime, (int64_t)200);
+
+    ScanRange single;
+    CHECK(parseVersionOptions("timestamp=42", single, error));
+    CHECK_EQ(single.minTime, (int64_t)42);
+    CHECK_EQ(single.maxTime, (int64_t)43);
+
+    ScanRange empty;
+    CHECK(parseVersionOptions("", empty, error));
+    CHECK_EQ(empty.maxVersions, 1);
+}
+
+TEST(scanOptionsRejectInvalidValues) {
+    ScanRange range;
+    std::string error;
+    CHECK(!parseVersionOptions("versions=0", range, error));
+    CHECK_CONTAINS(error, "versions=0");
+    CHECK(!parseVersionOptions("minTime=200;maxTime=100", range, error));
+    CHECK(!parseVersionOptions("maxTime=abc", range, error));
+    CHECK(!parseVersionOptions("limit=5", range, error));
+    CHECK_CONTAINS(error, "未知的版本选项");
+
+    bool ok = true;
+    CHECK(!parseVersionOption("caching", "5", range, ok));
+}
@@ -0,0 +1,164 @@
+#include "bridge_test.h"
+#include "fake_cluster.h"
+#include "snapshot_store.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+// 3000行，每行两列，约600KiB，写入后有多个数据块
+void fillTable() {
+    test::resetCluster();
+    std::string padding(200, 'x');
+    for (int i = 0; i < 3000; ++i) {
+        char row[16];
+        snprintf(row, sizeof(row), "r%04d", i);
+        test::putCell("", "t", row, "cf", "a", 1, "a" + std::to_string(i));
+        test::putCell("", "t", row, "cf", "pad", 1, padding);
+    }
+}
+
+bool append(const std::string& path, const std::string& table, const std::string& startRow,
+            const std::string& stopRow, std::string& error) {
+    ScanRange range;
+    range.tableName = table;
+    range.startRow = startRow;
+    range.stopRow = stopRow;
+    jobs::Job job(1, "snapshot");
+    return snapshot::appendRange(path, range, job, error);
+}
+
+std::string readFile(const std::string& path) {
+    std::string content;
+    FILE* file = fopen(path.c_str(), "rb");
+    char buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.append(buffer, n);
+    }
+    fclose(file);
+    return content;
+}
+
+// 写到新路径，避免命中已打开快照的缓存
+std::string writeCopy(const std::string& name, const std::string& content) {
+    std::string path = test::tempPath(name);
+    FILE* file = fopen(path.c_str(), "wb");
+    fwrite(content.data(), 1, content.size(), file);
+    fclose(file);
+    return path;
+}
+
+} // namespace
+
+TEST(snapshotRoundTrip) {
+    fillTable();
+    std::string path = test::tempPath("t.snap");
+    std::string error;
+    CHECK(append(path, "t", "", "", error));
+
+    std::string tableName;
+    std::vector<snapshot::RangeInfo> ranges;
+    uint64_t fileBytes = 0;
+    uint64_t liveBytes = 0;
+    CHECK(snapshot::describe(path, tableName, ranges, fileBytes, liveBytes, error));
+    CHECK_EQ(tableName, std::string("t"));
+    CHECK_EQ(ranges.size(), (size_t)1);
+    if (ranges.size() == 1) {
+        CHECK_EQ(ranges[0].rows, (uint64_t)3000);
+        CHECK_EQ(ranges[0].cells, (uint64_t)6000);
+        CHECK(ranges[0].blocks.size() > 1);
+        CHECK_EQ(liveBytes, ranges[0].storedBytes);
+        CHECK(liveBytes < fileBytes);
+    }
+
+    // 从稀疏索引定位到中间的数据块
+    std::string json;
+    CHECK(snapshot::readRows(path, "r2500", "r2502", "", 0, json, error));
+    CHECK_EQ(json.substr(0, 60), std::string("[{\"row\":\"r2500\",\"families\":{\"cf\":{\"a\":\"a2500\",\"pad\":\"xxxxxxx"));
+    CHECK_CONTAINS(json, "{\"row\":\"r2501\"");
+    CHECK(json.find("r2502") == std::string::npos);
+
+    CHECK(snapshot::readRows(path, "", "", "r00", 3, json, error));
+    CHECK_CONTAINS(json, "\"r0002\"");
+    CHECK(json.find("r0003") == std::string::npos);
+
+    CHECK(snapshot::readRows(path, "zzz", "", "", 0, json, error));
+    CHECK_EQ(json, std::string("[]"));
+}
+
+TEST(snapshotRangesCoverQueries) {
+    fillTable();
+    std::string path = test::tempPath("t.snap");
+    std::string error;
+    CHECK(append(path, "t", "r1000", "r2000", error));
+
+    std::string json;
+    CHECK(snapshot::readRows(path, "r1500", "r1501", "", 0, json, error));
+    CHECK_CONTAINS(json, "a1500");
+    CHECK(!snapshot::readRows(path, "r0500", "r1500", "", 0, json, error));
+    CHECK_CONTAINS(error, "没有覆盖");
+    CHECK(!snapshot::readRows(path, "r1500", "", "", 0, json, error));
+
+    // 新范围覆盖旧范围后，旧范围的数据块成为垃圾
+    CHECK(append(path, "t", "r0000", "r2500", error));
+    std::string tableName;
+    std::vector<snapshot::RangeInfo> ranges;
+    uint64_t fileBytes = 0;
+    uint64_t liveBytes = 0;
+    CHECK(snapshot::describe(path, tableName, ranges, fileBytes, liveBytes, error));
+    CHECK_EQ(ranges.size(), (size_t)1);
+    CHECK(liveBytes * 10 < fileBytes * 9);
+    CHECK(snapshot::readRows(path, "r0500", "r1500", "", 1, json, error));
+    CHECK_CONTAINS(json, "a500");
+
+    CHECK(!append(path, "other", "", "", error));
+    CHECK_CONTAINS(error, "不能写入表 other");
+}
+
+TEST(snapshotRejectsCorruptFiles) {
+    fillTable();
+    std::string path = test::tempPath("t.snap");
+    std::string error;
+    CHECK(append(path, "t", "", "", error));
+    std::string content = readFile(path);
+    std::string json;
+
+    CHECK(!snapshot::readRows(test::tempPath("missing.snap"), "", "", "", 0, json, error));
+    CHECK_CONTAINS(error, "不存在");
+
+    std::string truncated = writeCopy("truncated.snap", content.substr(0, content.size() - 5));
+    CHECK(!snapshot::readRows(truncated, "", "", "", 0, json, error));
+    CHECK_CONTAINS(error, "损坏或未写完");
+
+    std::string tiny = writeCopy("tiny.snap", "HBS1");
+    CHECK(!snapshot::readRows(tiny, "", "", "", 0, json, error));
+    CHECK_CONTAINS(error, "不是有效的快照文件");
+
+    // 文件尾之前是索引，改动其中一个字节时校验和不符
+    std::string badIndex = content;
+    badIndex[badIndex.size() - 20] ^= 0x55;
+    CHECK(!snapshot::readRows(writeCopy("index.snap", badIndex), "", "", "", 0, json, error));
+    CHECK_CONTAINS(error, "损坏或未写完");
+
+    // 第一个数据块紧跟文件头（"HBS1" 版本 表名长度 表名）
+    std::string badBlock = content;
+    size_t firstBlock = 4 + 4 + 4 + 1;
+    CHECK_EQ(badBlock.substr(firstBlock, 4), std::string("BLK1"));
+    badBlock[firstBlock + 100] ^= 0x55;
+    std::string badBlockPath = writeCopy("block.snap", badBlock);
+    CHECK(!snapshot::readRows(badBlockPath, "r0000", "r0001", "", 0, json, error));
+    CHECK_CONTAINS(error, "数据块损坏");
+    // 只读后面的数据块时不受影响
+    CHECK(snapshot::readRows(badBlockPath, "r2999", "", "", 0, json, error));
+    CHECK_CONTAINS(json, "a2999");
+
+    // 损坏的文件在追加时重新创建
+    CHECK(append(truncated, "t", "r0000", "r0010", error));
+    CHECK(snapshot::readRows(truncated, "r0005", "r0006", "", 0, json, error));
+    CHECK_CONTAINS(json, "a5");
+}
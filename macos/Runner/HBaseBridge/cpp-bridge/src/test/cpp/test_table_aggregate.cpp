@@ -0,0 +1,116 @@
+#include "bridge_test.h"
+#include "fake_cluster.h"
+#include "table_aggregate.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+void putValue(const std::string& row, const std::string& value) {
+    test::putCell("", "t", row, "cf", "n", 1, value);
+}
+
+// 执行聚合，返回任务结果JSON（失败时为 "error: ..."）
+std::string aggregate(const std::string& text) {
+    AggregateOptions options;
+    options.range.tableName = "t";
+    options.column = "cf:n";
+    std::string error;
+    if (!parseAggregateOptions(text, options, error)) {
+        return "error: " + error;
+    }
+    jobs::Job job(1, "aggregate");
+    if (!runAggregate(options, job, error)) {
+        return "error: " + error;
+    }
+    std::string json = job.toJson();
+    size_t start = json.find("\"result\":");
+    return start == std::string::npos ? json : json.substr(start + 9, json.find('}', start) - start - 8);
+}
+
+std::vector<std::string> splitKeys(const char* first, const char* second) {
+    std::vector<std::string> keys;
+    keys.push_back(first);
+    keys.push_back(second);
+    return keys;
+}
+
+} // namespace
+
+TEST(aggregateMergesRegions) {
+    test::resetCluster();
+    for (int i = 1; i <= 100; ++i) {
+        char row[16];
+        snprintf(row, sizeof(row), "r%03d", i);
+        putValue(row, std::to_string(i));
+    }
+    putValue("r200", "n/a");
+    test::putCell("", "t", "r201", "cf", "other", 1, "5");
+    test::setSplits("", "t", splitKeys("r030", "r070"));
+
+    CHECK_EQ(aggregate("threads=2"), std::string("{\"column\":\"cf:n\",\"regions\":3,\"rows\":101,\"values\":100,"
+        "\"invalid\":1,\"count\":100,\"sum\":5050,\"min\":1,\"max\":100,\"avg\":50.5}"));
+    CHECK_EQ(aggregate("ops=count,max"), std::string("{\"column\":\"cf:n\",\"regions\":3,\"rows\":101,\"values\":100,"
+        "\"invalid\":1,\"count\":100,\"max\":100}"));
+}
+
+TEST(aggregateOverflowsToDouble) {
+    test::resetCluster();
+    putValue("a", "9223372036854775807");
+    putValue("b", "10");
+    putValue("c", "-5");
+    CHECK_EQ(aggregate("ops=sum,min,max"), std::string("{\"column\":\"cf:n\",\"regions\":1,\"rows\":3,\"values\":3,"
+        "\"invalid\":0,\"sum\":9.2233720368547758e+18,\"min\":-5,\"max\":9223372036854775807}"));
+
+    // 各Region的部分和都没有溢出，合并时溢出
+    test::resetCluster();
+    putValue("a", "9223372036854775807");
+    putValue("m", "9223372036854775807");
+    putValue("z", "-9223372036854775808");
+    test::setSplits("", "t", splitKeys("h", "p"));
+    CHECK_EQ(aggregate("ops=sum,avg"), std::string("{\"column\":\"cf:n\",\"regions\":3,\"rows\":3,\"values\":3,"
+        "\"invalid\":0,\"sum\":9.2233720368547758e+18,\"avg\":3.0744573456182584e+18}"));
+}
+
+TEST(aggregateMixesLongAndDouble) {
+    test::resetCluster();
+    putValue("a", "2");
+    putValue("b", "1.5");
+    putValue("c", "-0.25");
+    CHECK_EQ(aggregate("ops=sum,min,max"), std::string("{\"column\":\"cf:n\",\"regions\":1,\"rows\":3,\"values\":3,"
+        "\"invalid\":0,\"sum\":3.25,\"min\":-0.25,\"max\":2}"));
+
+    test::resetCluster();
+    putValue("a", "text");
+    CHECK_EQ(aggregate(""), std::string("{\"column\":\"cf:n\",\"regions\":1,\"rows\":1,\"values\":0,"
+        "\"invalid\":1,\"count\":0,\"sum\":0,\"min\":null,\"max\":null,\"avg\":null}"));
+}
+
+TEST(aggregateDecodesBinaryLongs) {
+    test::resetCluster();
+    putValue("a", std::string("\x00\x00\x00\x00\x00\x00\x01\x00", 8));
+    putValue("b", std::string("\xff\xff\xff\xff\xff\xff\xff\xfe", 8));
+    putValue("c", "short");
+    CHECK_EQ(aggregate("type=long;ops=sum,min"), std::string("{\"column\":\"cf:n\",\"regions\":1,\"rows\":3,"
+        "\"values\":2,\"invalid\":1,\"sum\":254,\"min\":-2}"));
+}
+
+TEST(aggregateRejectsBadOptions) {
+    test::resetCluster();
+    putValue("a", "1");
+    CHECK_CONTAINS(aggregate("ops=median"), "聚合选项取值无效");
+    CHECK_CONTAINS(aggregate("type=hex"), "聚合选项取值无效");
+    CHECK_CONTAINS(aggregate("window=5"), "未知的聚合选项");
+
+    AggregateOptions options;
+    options.range.tableName = "t";
+    options.column = "n";
+    jobs::Job job(1, "aggregate");
+    std::string error;
+    CHECK(!runAggregate(options, job, error));
+    CHECK_CONTAINS(error, "family:qualifier");
+}
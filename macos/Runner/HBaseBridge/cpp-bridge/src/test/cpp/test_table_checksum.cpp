@@ -0,0 +1,182 @@
+#include "bridge_test.h"
+#include "fake_cluster.h"
+#include "table_checksum.h"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+std::string rowKey(int i) {
+    char row[16];
+    snprintf(row, sizeof(row), "r%05d", i);
+    return row;
+}
+
+// 两个集群上相同的表，Region划分不同
+void fillClusters(int rows) {
+    test::resetCluster();
+    for (int i = 0; i < rows; ++i) {
+        test::putCell("", "t", rowKey(i), "cf", "a", 1, "v" + std::to_string(i));
+        test::putCell("dr", "t", rowKey(i), "cf", "a", 1, "v" + std::to_string(i));
+    }
+    std::vector<std::string> keys;
+    keys.push_back(rowKey(rows / 3));
+    keys.push_back(rowKey(rows * 2 / 3));
+    test::setSplits("", "t", keys);
+    keys.clear();
+    keys.push_back(rowKey(rows / 2));
+    test::setSplits("dr", "t", keys);
+}
+
+// 计算校验树写入name，返回任务结果JSON
+std::string checksum(const std::string& cluster, const std::string& name, const std::string& extra = "") {
+    ChecksumOptions options;
+    options.range.tableName = "t";
+    std::string error;
+    if (!parseChecksumOptions("leafRows=16;fanout=4;threads=2;cluster=" + cluster + ";path=" + test::tempPath(name)
+                              + extra, options, error)) {
+        return "error: " + error;
+    }
+    jobs::Job job(1, "checksum");
+    if (!runChecksum(options, job, error)) {
+        return "error: " + error;
+    }
+    return job.toJson();
+}
+
+std::string compare(uint32_t maxRanges) {
+    std::string json;
+    std::string error;
+    if (!compareChecksumFiles(test::tempPath("a.tree"), test::tempPath("b.tree"), maxRanges, json, error)) {
+        return "error: " + error;
+    }
+    return json;
+}
+
+// 对比结果中的差异范围，null为空串
+std::vector<std::pair<std::string, std::string> > ranges(const std::string& json) {
+    std::vector<std::pair<std::string, std::string> > result;
+    size_t pos = json.find("\"ranges\":[");
+    while ((pos = json.find("{\"start\":", pos)) != std::string::npos) {
+        std::string bounds[2];
+        size_t value = pos + 9;
+        for (int i = 0; i < 2; ++i) {
+            if (json[value] == '"') {
+                size_t close = json.find('"', value + 1);
+                bounds[i] = json.substr(value + 1, close - value - 1);
+                value = close + 1;
+            } else {
+                value += 4; // null
+            }
+            value += 7; // ,"end":
+        }
+        result.push_back(std::make_pair(bounds[0], bounds[1]));
+        pos = value;
+    }
+    return result;
+}
+
+bool contains(const std::pair<std::string, std::string>& range, const std::string& row) {
+    return range.first <= row && (range.second.empty() || row < range.second);
+}
+
+std::string summary(const std::string& jobJson, const char* field) {
+    size_t start = jobJson.find(std::string("\"") + field + "\":");
+    return start == std::string::npos ? std::string() : jobJson.substr(start, jobJson.find(',', start) - start);
+}
+
+} // namespace
+
+TEST(checksumTreesMatchAcrossRegionLayouts) {
+    fillClusters(3000);
+    std::string a = checksum("", "a.tree");
+    std::string b = checksum("dr", "b.tree");
+    CHECK_CONTAINS(a, "\"rows\":3000");
+    CHECK_EQ(summary(a, "hash"), summary(b, "hash"));
+    CHECK(summary(a, "hash") != std::string());
+    CHECK_EQ(compare(10), std::string("{\"status\":\"success\",\"equal\":true,\"rows\":[3000,3000],\"ranges\":[],"
+                                      "\"truncated\":false}"));
+}
+
+TEST(checksumComparisonLocatesChangedRows) {
+    fillClusters(3000);
+    test::putCell("dr", "t", rowKey(1234), "cf", "a", 1, "changed");
+    checksum("", "a.tree");
+    checksum("dr", "b.tree");
+    std::string json = compare(10);
+    CHECK_CONTAINS(json, "\"equal\":false,\"rows\":[3000,3000]");
+    std::vector<std::pair<std::string, std::string> > found = ranges(json);
+    CHECK_EQ(found.size(), (size_t)1);
+    if (found.size() == 1) {
+        CHECK(contains(found[0], rowKey(1234)));
+        // 只展开到叶子：范围远小于整张表
+        CHECK(found[0].first > rowKey(1000));
+        CHECK(!found[0].second.empty() && found[0].second < rowKey(1500));
+    }
+
+    // 时间戳默认不参与哈希
+    fillClusters(3000);
+    test::putCell("dr", "t", rowKey(10), "cf", "a", 5, "v10");
+    test::putCell("", "t", rowKey(10), "cf", "a", 5, "v10");
+    test::putCell("dr", "t", rowKey(20), "cf", "a", 7, "v20");
+    checksum("", "a.tree");
+    checksum("dr", "b.tree");
+    CHECK_CONTAINS(compare(10), "\"equal\":true");
+    checksum("", "a.tree", ";timestamps=true");
+    checksum("dr", "b.tree", ";timestamps=true");
+    found = ranges(compare(10));
+    CHECK_EQ(found.size(), (size_t)1);
+    if (found.size() == 1) {
+        CHECK(contains(found[0], rowKey(20)));
+    }
+}
+
+TEST(checksumComparisonReportsMissingRows) {
+    fillClusters(3000);
+    test::putCell("", "t", rowKey(2999) + "x", "cf", "a", 1, "extra");
+    test::putCell("dr", "t", "a", "cf", "a", 1, "before the first row");
+    checksum("", "a.tree");
+    checksum("dr", "b.tree");
+    std::string json = compare(10);
+    CHECK_CONTAINS(json, "\"rows\":[3001,3001]");
+    std::vector<std::pair<std::string, std::string> > found = ranges(json);
+    CHECK_EQ(found.size(), (size_t)2);
+    if (found.size() == 2) {
+        // 第一个范围从范围起点开始，最后一个到范围终点为止
+        CHECK_EQ(found[0].first, std::string());
+        CHECK(contains(found[0], "a"));
+        CHECK(contains(found[1], rowKey(2999) + "x"));
+        CHECK_EQ(found[1].second, std::string());
+    }
+}
+
+TEST(checksumComparisonTruncates) {
+    fillClusters(3000);
+    for (int i = 100; i < 3000; i += 500) {
+        test::putCell("dr", "t", rowKey(i), "cf", "a", 1, "changed");
+    }
+    checksum("", "a.tree");
+    checksum("dr", "b.tree");
+    CHECK_EQ(ranges(compare(10)).size(), (size_t)6);
+    std::string json = compare(2);
+    CHECK_EQ(ranges(json).size(), (size_t)2);
+    CHECK_CONTAINS(json, "\"truncated\":true");
+}
+
+TEST(checksumRejectsIncompatibleFiles) {
+    fillClusters(100);
+    checksum("", "a.tree");
+    checksum("dr", "b.tree", ";leafRows=32");
+    CHECK_CONTAINS(compare(10), "leafRows或fanout不同");
+
+    FILE* file = fopen(test::tempPath("b.tree").c_str(), "w");
+    fputs("{\"table\":\"t\"\n", file);
+    fclose(file);
+    CHECK_CONTAINS(compare(10), "error: 校验树文件");
+    CHECK_CONTAINS(checksum("", "c.tree", ";leafRows=10"), "校验选项取值无效");
+}
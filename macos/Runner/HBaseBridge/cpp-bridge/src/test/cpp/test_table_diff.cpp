@@ -0,0 +1,140 @@
+#include "bridge_test.h"
+#include "fake_cluster.h"
+#include "hash_util.h"
+#include "table_diff.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+struct HashVector {
+    std::string input;
+    uint64_t seed;
+    uint64_t expected;
+};
+
+// xxHash参考实现的XXH64结果
+std::vector<HashVector> referenceVectors() {
+    std::string digits;
+    while (digits.size() < 70) {
+        digits += "0123456789";
+    }
+    HashVector vectors[] = {
+        {"", 0, 0xef46db3751d8e999ULL},
+        {"a", 0, 0xd24ec4f1a98c6e5bULL},
+        {"abc", 0, 0x44bc2cf5ad770999ULL},
+        {"Nobody inspects the spammish repetition", 0, 0xfbcea83c8a378bf1ULL},
+        {digits, 0, 0x4916a0f3f0e1c781ULL},
+        {"xxhash", 20141025, 0xb559b98d844e0635ULL},
+    };
+    return std::vector<HashVector>(vectors, vectors + sizeof(vectors) / sizeof(vectors[0]));
+}
+
+std::string readFile(const std::string& path) {
+    std::string content;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return content;
+    }
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.append(buffer, n);
+    }
+    fclose(file);
+    return content;
+}
+
+std::string diff(const std::string& text) {
+    DiffOptions options;
+    options.source.tableName = "t";
+    options.target = options.source;
+    std::string error;
+    if (!parseDiffOptions(text, options, error)) {
+        return "error: " + error;
+    }
+    jobs::Job job(1, "diff");
+    if (!runDiff(options, job, error)) {
+        return "error: " + error;
+    }
+    std::string json = job.toJson();
+    size_t start = json.find("\"result\":");
+    // 结果以keys数组结尾
+    return start == std::string::npos ? json : json.substr(start + 9, json.find("]}", start) - start - 7);
+}
+
+// 源集群（主连接）与目标集群 "dr" 上的同名表，范围内有相同、改动、只在一侧的行
+void fillClusters() {
+    test::resetCluster();
+    for (int i = 0; i < 50; ++i) {
+        char row[16];
+        snprintf(row, sizeof(row), "r%02d", i);
+        test::putCell("", "t", row, "cf", "a", 1, "v" + std::to_string(i));
+        test::putCell("dr", "t", row, "cf", "a", i % 10 == 0 ? 2 : 1, "v" + std::to_string(i));
+    }
+    test::putCell("dr", "t", "r05", "cf", "a", 3, "changed");
+    test::putCell("", "t", "r17", "cf", "b", 1, "extra");
+    test::putCell("", "t", "r30x", "cf", "a", 1, "source only");
+    test::putCell("dr", "t", "r44x", "cf", "a", 1, "target only");
+    test::putCell("dr", "t", "zz", "cf", "a", 1, "target only");
+    std::vector<std::string> keys;
+    keys.push_back("r20");
+    keys.push_back("r40");
+    test::setSplits("", "t", keys);
+}
+
+} // namespace
+
+TEST(xxh64MatchesReferenceVectors) {
+    std::vector<HashVector> vectors = referenceVectors();
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        const HashVector& vector = vectors[i];
+        CHECK_EQ(hash::xxh64(vector.input.data(), vector.input.size(), vector.seed), vector.expected);
+
+        // 流式接口按不同的分段输入，结果相同
+        for (size_t step = 1; step <= 33; step += 8) {
+            hash::Xxh64 state(vector.seed);
+            for (size_t pos = 0; pos < vector.input.size(); pos += step) {
+                state.update(vector.input.data() + pos, std::min(step, vector.input.size() - pos));
+            }
+            CHECK_EQ(state.digest(), vector.expected);
+        }
+    }
+}
+
+TEST(diffMergesSourceAndTargetRows) {
+    fillClusters();
+    CHECK_EQ(diff("targetCluster=dr;threads=2"),
+             std::string("{\"source\":\"t\",\"target\":\"t\",\"regions\":3,\"rows\":53,\"same\":48,\"changed\":2,"
+                         "\"onlySource\":1,\"onlyTarget\":2,\"cells\":5,\"keys\":[\"r05\",\"r17\",\"r30x\",\"r44x\",\"zz\"]}"));
+
+    // 时间戳不同也算差异：r00,r10..r40 的时间戳不同
+    CHECK_CONTAINS(diff("targetCluster=dr;timestamps=true;maxKeys=3"),
+                   "\"same\":43,\"changed\":7,\"onlySource\":1,\"onlyTarget\":2,\"cells\":10,"
+                   "\"keys\":[\"r00\",\"r05\",\"r10\"]}");
+
+    CHECK_CONTAINS(diff(""), "两侧是同一张表");
+    CHECK_CONTAINS(diff("columns=cf:b;targetCluster=dr"), "\"rows\":1,\"same\":0,\"changed\":0,\"onlySource\":1");
+}
+
+TEST(diffWritesDifferingRows) {
+    fillClusters();
+    std::string path = test::tempPath("diff.ndjson");
+    CHECK_CONTAINS(diff("targetCluster=dr;threads=1;path=" + path), "\"changed\":2");
+    std::string content = readFile(path);
+    CHECK_CONTAINS(content, "{\"row\":\"r05\",\"status\":\"changed\",\"cells\":[{\"column\":\"cf:a\",\"source\":\"v5\","
+                            "\"target\":\"changed\"}]}\n");
+    CHECK_CONTAINS(content, "{\"row\":\"r17\",\"status\":\"changed\",\"cells\":[{\"column\":\"cf:b\",\"source\":\"extra\","
+                            "\"target\":null}]}\n");
+    CHECK_CONTAINS(content, "{\"row\":\"zz\",\"status\":\"onlyTarget\",\"cells\":[{\"column\":\"cf:a\",\"source\":null,"
+                            "\"target\":\"target only\"}]}\n");
+    CHECK_EQ((size_t)std::count(content.begin(), content.end(), '\n'), (size_t)5);
+
+    CHECK_CONTAINS(diff("mode=fast"), "error");
+}
@@ -0,0 +1,65 @@
+#include "bridge_test.h"
+#include "fake_cluster.h"
+#include "table_export.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace bridge;
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::ostringstream out;
+    out << in.rdbuf();
+    return out.str();
+}
+
+bool fileExists(const std::string& path) {
+    std::ifstream in(path.c_str());
+    return in.good();
+}
+
+} // namespace
+
+TEST(exportWritesCsvInRowOrder) {
+    test::resetCluster();
+    for (int i = 0; i < 500; ++i) {
+        char row[16];
+        snprintf(row, sizeof(row), "r%04d", i);
+        test::putCell("", "t", row, "cf", "q", 7, i == 3 ? "a,\"b\"" : "v");
+    }
+    ExportOptions options;
+    options.range.tableName = "t";
+    options.range.batchRows = 64;
+    options.path = test::tempPath("out.csv");
+    options.format = EXPORT_CSV;
+    options.encoderThreads = 3;
+    jobs::Job job(1, "export");
+    std::string error;
+    CHECK(runExport(options, job, error));
+    CHECK_EQ(job.rows.load(), (uint64_t)500);
+    CHECK(!fileExists(options.path + ".part"));
+
+    std::string csv = readFile(options.path);
+    CHECK_EQ(csv.find("row,family,qualifier,timestamp,value\n"), (size_t)0);
+    CHECK_CONTAINS(csv, "r0003,cf,q,7,\"a,\"\"b\"\"\"\n");
+    CHECK(csv.find("r0100,") < csv.find("r0101,"));
+    CHECK(csv.find("r0498,") < csv.find("r0499,"));
+}
+
+TEST(exportFailsForMissingTable) {
+    test::resetCluster();
+    ExportOptions options;
+    options.range.tableName = "missing";
+    options.path = test::tempPath("out.ndjson");
+    options.format = EXPORT_NDJSON;
+    jobs::Job job(1, "export");
+    std::string error;
+    CHECK(!runExport(options, job, error));
+    CHECK(!error.empty());
+    CHECK(!fileExists(options.path));
+    CHECK(!fileExists(options.path + ".part"));
+}
@@ -0,0 +1,90 @@
+#include "bridge_test.h"
+#include "fake_cluster.h"
+#include "table_generator.h"
+
+#include <string>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+// 生成结果去掉时间戳（写入时取当前时间），只比较行键、列与值
+std::vector<std::string> generatedCells(const std::string& table) {
+    std::vector<test::FakeCell> cells = test::tableCells("", table);
+    std::vector<std::string> out;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        out.push_back(cells[i].row + "/" + cells[i].family + ":" + cells[i].qualifier + "=" + cells[i].value);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(generatorParsesSpec) {
+    gen::Spec spec;
+    std::string error;
+    CHECK(gen::parseSpec("rows=500;families=cf,meta;qualifiers=2-6;values=uniform:8:32;keys=salted:4;seed=9",
+                         spec, error));
+    CHECK_EQ(spec.rows, (uint64_t)500);
+    CHECK_EQ(spec.families.size(), (size_t)2);
+    CHECK_EQ(spec.minQualifiers, (uint32_t)2);
+    CHECK_EQ(spec.maxQualifiers, (uint32_t)6);
+    CHECK(spec.valueDistribution == gen::VALUES_UNIFORM);
+    CHECK(spec.keyPattern == gen::KEYS_SALTED);
+    CHECK_EQ(spec.keyBuckets, (uint32_t)4);
+
+    gen::Spec bad;
+    CHECK(!gen::parseSpec("rows=abc", bad, error));
+    CHECK(!error.empty());
+    error.clear();
+    CHECK(!gen::parseSpec("colour=blue", bad, error));
+    CHECK(!error.empty());
+}
+
+TEST(generatorIsDeterministicAcrossThreads) {
+    test::resetCluster();
+    gen::Spec spec;
+    std::string error;
+    CHECK(gen::parseSpec("rows=300;qualifiers=1-5;values=lognormal:16:1;keys=hashed;seed=7;batchRows=37;threads=1",
+                         spec, error));
+    gen::Stats stats;
+    CHECK(gen::generate("one", spec, stats, error));
+    CHECK_EQ(stats.rows, (uint64_t)300);
+
+    spec.threads = 4;
+    gen::Stats parallel;
+    CHECK(gen::generate("four", spec, parallel, error));
+    CHECK_EQ(parallel.cells, stats.cells);
+    CHECK_EQ(parallel.bytes, stats.bytes);
+
+    std::vector<std::string> one = generatedCells("one");
+    CHECK_EQ(one.size(), (size_t)stats.cells);
+    CHECK(one == generatedCells("four"));
+
+    spec.seed = 8;
+    gen::Stats other;
+    CHECK(gen::generate("other", spec, other, error));
+    CHECK(one != generatedCells("other"));
+}
+
+TEST(generatorRunsAsCancellableJob) {
+    test::resetCluster();
+    gen::Spec spec;
+    std::string error;
+    CHECK(gen::parseSpec("rows=200;qualifiers=2;values=fixed:8;batchRows=50;threads=2", spec, error));
+    jobs::Job job(1, "generate");
+    CHECK(gen::runGenerate("progress", spec, job, error));
+    CHECK_EQ(job.rows.load(), (uint64_t)200);
+    CHECK_EQ(job.cells.load(), (uint64_t)400);
+    CHECK_EQ(job.totalRows.load(), (int64_t)200);
+    CHECK_EQ(generatedCells("progress").size(), (size_t)400);
+    CHECK_CONTAINS(job.toJson(), "\"rows\":200,\"cells\":400");
+
+    // 取消后不再写入新的批次
+    jobs::Job cancelled(2, "generate");
+    cancelled.requestCancel();
+    CHECK(!gen::runGenerate("cancelled", spec, cancelled, error));
+    CHECK_EQ(cancelled.rows.load(), (uint64_t)0);
+    CHECK(generatedCells("cancelled").empty());
+}
@@ -0,0 +1,205 @@
+#include "bridge_test.h"
+#include "fake_cluster.h"
+#include "table_import.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+std::vector<std::string> parseOne(const std::string& text, char delimiter, bool quoting, size_t& next,
+                                  bool& malformed) {
+    std::vector<std::string> fields;
+    next = parseRecord(text.data(), 0, text.size(), delimiter, quoting, fields, malformed);
+    return fields;
+}
+
+void writeFile(const std::string& path, const std::string& content) {
+    FILE* file = fopen(path.c_str(), "wb");
+    fwrite(content.data(), 1, content.size(), file);
+    fclose(file);
+}
+
+} // namespace
+
+TEST(parseRecordSplitsPlainFields) {
+    size_t next = 0;
+    bool malformed = true;
+    std::string text = "a,b,,c\r\nnext";
+    std::vector<std::string> fields = parseOne(text, ',', true, next, malformed);
+    CHECK(!malformed);
+    CHECK_EQ(fields.size(), (size_t)4);
+    if (fields.size() == 4) {
+        CHECK_EQ(fields[2], std::string());
+        CHECK_EQ(fields[3], std::string("c"));
+    }
+    CHECK_EQ(next, text.find("next"));
+
+    // 最后一条记录没有换行
+    text = "x,y";
+    fields = parseOne(text, ',', true, next, malformed);
+    CHECK_EQ(fields.size(), (size_t)2);
+    CHECK_EQ(next, text.size());
+}
+
+TEST(parseRecordHandlesQuotes) {
+    size_t next = 0;
+    bool malformed = true;
+    std::string text = "\"a,b\",\"say \"\"hi\"\"\",\"line1\nline2\"\nrest";
+    std::vector<std::string> fields = parseOne(text, ',', true, next, malformed);
+    CHECK(!malformed);
+    CHECK_EQ(fields.size(), (size_t)3);
+    if (fields.size() == 3) {
+        CHECK_EQ(fields[0], std::string("a,b"));
+        CHECK_EQ(fields[1], std::string("say \"hi\""));
+        CHECK_EQ(fields[2], std::string("line1\nline2"));
+    }
+    CHECK_EQ(next, text.find("rest"));
+
+    // tsv不处理引号
+    text = "\"a\"\tb\n";
+    fields = parseOne(text, '\t', false, next, malformed);
+    CHECK(!malformed);
+    CHECK_EQ(fields[0], std::string("\"a\""));
+}
+
+TEST(parseRecordFlagsMalformedQuotes) {
+    size_t next = 0;
+    bool malformed = false;
+    std::string text = "\"ab\"x,c\nnext";
+    std::vector<std::string> fields = parseOne(text, ',', true, next, malformed);
+    CHECK(malformed);
+    CHECK_EQ(fields.size(), (size_t)2);
+    CHECK_EQ(next, text.find("next"));
+
+    malformed = false;
+    text = "\"never closed,c\n";
+    parseOne(text, ',', true, next, malformed);
+    CHECK(malformed);
+    CHECK_EQ(next, text.size());
+}
+
+TEST(splitChunksStartsAtRecordBoundaries) {
+    std::string text = "r1,aaaa\nr2,bbbb\nr3,cccc\nr4,dddd\n";
+    std::vector<size_t> starts = splitChunks(text.data(), 0, text.size(), 10, false);
+    CHECK_EQ(starts.size(), (size_t)2);
+    for (size_t i = 1; i < starts.size(); ++i) {
+        CHECK_EQ(text[starts[i] - 1], '\n');
+    }
+
+    // 只有一块
+    starts = splitChunks(text.data(), 0, text.size(), 1 << 20, false);
+    CHECK_EQ(starts.size(), (size_t)1);
+}
+
+TEST(splitChunksSkipsNewlinesInsideQuotes) {
+    std::string text = "r1,\"a\nb\nc\nd\"\nr2,x\nr3,y\n";
+    std::vector<size_t> starts = splitChunks(text.data(), 0, text.size(), 2, true);
+    CHECK_EQ(starts.size(), (size_t)3);
+    if (starts.size() == 3) {
+        CHECK_EQ(starts[1], text.find("r2"));
+        CHECK_EQ(starts[2], text.find("r3"));
+    }
+
+    // 不处理引号时按换行切分
+    starts = splitChunks(text.data(), 0, text.size(), 2, false);
+    CHECK_EQ(starts[1], text.find("b\n"));
+}
+
+TEST(runImportWritesChunksInParallel) {
+    test::resetCluster();
+    std::string content = "row,cf:a,b\n";
+    for (int i = 0; i < 200; ++i) {
+        char line[64];
+        snprintf(line, sizeof(line), "r%03d,\"v%d\nx\",%d\n", i, i, i);
+        content += line;
+    }
+    content += "bad,\"unclosed\n";
+    ImportOptions options;
+    options.tableName = "imported";
+    options.path = test::tempPath("input.csv");
+    writeFile(options.path, content);
+    std::string error;
+    CHECK(parseImportOptions("threads=4;batchRows=7;family=other", options, error));
+    options.chunkBytes = 256;
+
+    jobs::Job job(1, "import");
+    CHECK(runImport(options, job, error));
+    CHECK_EQ(job.rows.load(), (uint64_t)200);
+    CHECK_EQ(job.errors.load(), (uint64_t)1);
+
+    std::vector<test::FakeCell> cells = test::tableCells("", "imported");
+    CHECK_EQ(cells.size(), (size_t)400);
+    if (cells.size() == 400) {
+        CHECK_EQ(cells[0].row, std::string("r000"));
+        CHECK_EQ(cells[0].family, std::string("cf"));
+        CHECK_EQ(cells[0].value, std::string("v0\nx"));
+        CHECK_EQ(cells[1].family, std::string("other"));
+        CHECK_EQ(cells[399].value, std::string("199"));
+    }
+}
+
+TEST(runImportReadsNdjson) {
+    test::resetCluster();
+    ImportOptions options;
+    options.tableName = "imported";
+    options.path = test::tempPath("input.ndjson");
+    writeFile(options.path,
+              "{\"row\":\"r1\",\"families\":{\"cf\":{\"a\":\"1\",\"b\":\"2\"}}}\n"
+              "{\"row\":\"r2\",\"name\":\"x\"}\n");
+    std::string error;
+    CHECK(parseImportOptions("", options, error));
+    CHECK(options.format == IMPORT_NDJSON);
+
+    jobs::Job job(1, "import");
+    CHECK(runImport(options, job, error));
+    std::vector<test::FakeCell> cells = test::tableCells("", "imported");
+    CHECK_EQ(cells.size(), (size_t)3);
+    if (cells.size() == 3) {
+        CHECK_EQ(cells[1].value, std::string("2"));
+        // 扁平对象：其余字段写入默认列族
+        CHECK_EQ(cells[2].row, std::string("r2"));
+        CHECK_EQ(cells[2].family + ":" + cells[2].qualifier, std::string("cf:name"));
+    }
+
+    CHECK(!parseImportOptions("format=xml", options, error));
+}
+
+TEST(runImportRejectsUnpairedSurrogates) {
+    test::resetCluster();
+    ImportOptions options;
+    options.tableName = "surrogates";
+    options.path = test::tempPath("surrogates.ndjson");
+    writeFile(options.path,
+              "{\"row\":\"r1\",\"name\":\"\\ud83d\\ude00\"}\n"
+              "{\"row\":\"r2\",\"name\":\"\\ud83d\"}\n"
+              "{\"row\":\"r3\",\"name\":\"\\ud83d\\u0041\"}\n"
+              "{\"row\":\"r4\",\"name\":\"\\ude00\"}\n");
+    std::string error;
+    CHECK(parseImportOptions("", options, error));
+
+    jobs::Job job(1, "import");
+    CHECK(runImport(options, job, error));
+    CHECK_EQ(job.errors.load(), (uint64_t)3);
+    std::vector<test::FakeCell> cells = test::tableCells("", "surrogates");
+    CHECK_EQ(cells.size(), (size_t)1);
+    if (cells.size() == 1) {
+        CHECK_EQ(cells[0].value, std::string("\xf0\x9f\x98\x80"));
+    }
+}
+
+TEST(importOptionsRequireUnsignedNumbers) {
+    ImportOptions options;
+    std::string error;
+    CHECK(parseImportOptions("maxErrors=5", options, error));
+    CHECK_EQ(options.maxErrors, (uint64_t)5);
+    CHECK(!parseImportOptions("maxErrors=-1", options, error));
+    CHECK(!parseImportOptions("maxErrors= 5", options, error));
+    CHECK(!parseImportOptions("maxErrors=+5", options, error));
+    CHECK(!parseImportOptions("maxErrors=99999999999999999999", options, error));
+    CHECK_EQ(options.maxErrors, (uint64_t)5);
+}
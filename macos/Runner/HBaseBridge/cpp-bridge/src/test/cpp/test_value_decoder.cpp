@@ -0,0 +1,182 @@
+#include "bridge_test.h"
+#include "value_decoder.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace bridge;
+
+namespace {
+
+// Bytes.toBytes(long/int/double)：定长大端
+std::string bigEndian(uint64_t bits, int bytes) {
+    std::string out(bytes, '\0');
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = (char)((bits >> (8 * (bytes - 1 - i))) & 0xff);
+    }
+    return out;
+}
+
+std::string doubleBytes(double value) {
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    return bigEndian(bits, 8);
+}
+
+std::string render(decode::Format format, const std::vector<std::string>& values, size_t missing = (size_t)-1) {
+    std::vector<const char*> data;
+    std::vector<uint32_t> lengths;
+    for (size_t i = 0; i < values.size(); ++i) {
+        data.push_back(i == missing ? nullptr : values[i].data());
+        lengths.push_back(i == missing ? 0 : (uint32_t)values[i].size());
+    }
+    std::string out;
+    std::vector<size_t> ends;
+    decode::renderColumn(format, data.data(), lengths.data(), values.size(), out, ends);
+    CHECK_EQ(ends.size(), values.size());
+    CHECK_EQ(ends.empty() ? (size_t)0 : ends.back(), out.size());
+    return out;
+}
+
+} // namespace
+
+TEST(decodeParsesFormatNames) {
+    const char* names[] = {"auto", "text", "binary", "hex", "long", "int", "double"};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        decode::Format format;
+        CHECK(decode::parseFormat(names[i], format));
+        CHECK_EQ(std::string(decode::formatName(format)), std::string(names[i]));
+    }
+    decode::Format format;
+    CHECK(!decode::parseFormat("float", format));
+}
+
+TEST(decodeReadsFixedWidthNumbers) {
+    int64_t longValue = 0;
+    std::string bytes = bigEndian((uint64_t)-42, 8);
+    CHECK(decode::readLong(bytes.data(), 8, longValue));
+    CHECK_EQ(longValue, (int64_t)-42);
+    CHECK(!decode::readLong(bytes.data(), 7, longValue));
+
+    int32_t intValue = 0;
+    bytes = bigEndian(0x7fffffff, 4);
+    CHECK(decode::readInt(bytes.data(), 4, intValue));
+    CHECK_EQ(intValue, (int32_t)2147483647);
+    CHECK(!decode::readInt(bytes.data(), 8, intValue));
+
+    double doubleValue = 0;
+    bytes = doubleBytes(-1.5);
+    CHECK(decode::readDouble(bytes.data(), 8, doubleValue));
+    CHECK_EQ(doubleValue, -1.5);
+}
+
+TEST(decodeParsesNumberText) {
+    int64_t value = 0;
+    CHECK(decode::parseLongText(" -123 ", 6, value));
+    CHECK_EQ(value, (int64_t)-123);
+    CHECK(decode::parseLongText("+9223372036854775807", 20, value));
+    CHECK_EQ(value, std::numeric_limits<int64_t>::max());
+    CHECK(decode::parseLongText("-9223372036854775808", 20, value));
+    CHECK_EQ(value, std::numeric_limits<int64_t>::min());
+    CHECK(!decode::parseLongText("9223372036854775808", 19, value));
+    CHECK(!decode::parseLongText("12a", 3, value));
+    CHECK(!decode::parseLongText("", 0, value));
+    CHECK(!decode::parseLongText("1.5", 3, value));
+
+    double number = 0;
+    CHECK(decode::parseDoubleText("1.5e3", 5, number));
+    CHECK_EQ(number, 1500.0);
+    CHECK(!decode::parseDoubleText("nan", 3, number));
+    CHECK(!decode::parseDoubleText("1.5x", 4, number));
+    // 长度之外的字节不参与解析
+    CHECK(decode::parseDoubleText("2.25junk", 4, number));
+    CHECK_EQ(number, 2.25);
+}
+
+TEST(decodeReadsNumbersByColumnFormat) {
+    int64_t value = 0;
+    std::string bytes = bigEndian(7, 8);
+    CHECK(decode::asLong(decode::FORMAT_LONG, bytes.data(), 8, value));
+    CHECK_EQ(value, (int64_t)7);
+    bytes = bigEndian((uint32_t)-5, 4);
+    CHECK(decode::asLong(decode::FORMAT_INT, bytes.data(), 4, value));
+    CHECK_EQ(value, (int64_t)-5);
+    CHECK(decode::asLong(decode::FORMAT_AUTO, "17", 2, value));
+    CHECK_EQ(value, (int64_t)17);
+    bytes = doubleBytes(3.0);
+    CHECK(!decode::asLong(decode::FORMAT_DOUBLE, bytes.data(), 8, value));
+
+    double number = 0;
+    CHECK(decode::asDouble(decode::FORMAT_DOUBLE, bytes.data(), 8, number));
+    CHECK_EQ(number, 3.0);
+    bytes = bigEndian(9, 8);
+    CHECK(decode::asDouble(decode::FORMAT_LONG, bytes.data(), 8, number));
+    CHECK_EQ(number, 9.0);
+    CHECK(decode::asDouble(decode::FORMAT_TEXT, "0.5", 3, number));
+    CHECK_EQ(number, 0.5);
+}
+
+TEST(decodeChecksPrintableUtf8) {
+    CHECK(decode::isPrintableUtf8("plain\ttext\n", 11));
+    std::string chinese = "中文";
+    CHECK(decode::isPrintableUtf8(chinese.data(), chinese.size()));
+    CHECK(!decode::isPrintableUtf8("a\x01", 2));
+    CHECK(!decode::isPrintableUtf8("\xc3", 1));
+    CHECK(!decode::isPrintableUtf8("\xe4\xb8", 2));
+    CHECK(!decode::isPrintableUtf8("\xff\xfe", 2));
+}
+
+TEST(decodeAppendsEscapedText) {
+    std::string out;
+    decode::appendBinary(out, "key-\x00\x7f\"\\ok", 10);
+    CHECK_EQ(out, std::string("key-\\\\x00\\\\x7F\\\"\\\\x5Cok"));
+
+    // 超过8字节的可打印段整段复制
+    out.clear();
+    decode::appendBinary(out, "0123456789abcdef\n", 17);
+    CHECK_EQ(out, std::string("0123456789abcdef\\\\x0A"));
+
+    out.clear();
+    decode::appendHex(out, "\x00\xab\x10", 3);
+    CHECK_EQ(out, std::string("00ab10"));
+
+    out.clear();
+    std::string chinese = "值\"q\"";
+    decode::appendAuto(out, chinese.data(), chinese.size());
+    CHECK_EQ(out, std::string("值\\\"q\\\""));
+    out.clear();
+    decode::appendAuto(out, "\x01\x02", 2);
+    CHECK_EQ(out, std::string("\\\\x01\\\\x02"));
+}
+
+TEST(decodeRendersColumns) {
+    std::vector<std::string> values;
+    values.push_back(bigEndian(1234567890123ULL, 8));
+    values.push_back(bigEndian((uint64_t)-1, 8));
+    values.push_back("short");
+    values.push_back("unused");
+    CHECK_EQ(render(decode::FORMAT_LONG, values, 3), std::string("\"1234567890123\"\"-1\"\"short\"null"));
+
+    values.clear();
+    values.push_back(bigEndian((uint32_t)-7, 4));
+    values.push_back(bigEndian(7, 8));
+    CHECK_EQ(render(decode::FORMAT_INT, values), std::string("\"-7\"\"\\\\x00\\\\x00\\\\x00\\\\x00\\\\x00\\\\x00\\\\x00\\\\x07\""));
+
+    values.clear();
+    values.push_back(doubleBytes(0.1));
+    values.push_back(doubleBytes(-2.0));
+    // 最短往返表示，整数值带 .0（与Java的Double.toString一致）
+    CHECK_EQ(render(decode::FORMAT_DOUBLE, values), std::string("\"0.1\"\"-2.0\""));
+
+    values.clear();
+    values.push_back("ab");
+    values.push_back("\xff");
+    CHECK_EQ(render(decode::FORMAT_HEX, values), std::string("\"6162\"\"ff\""));
+    CHECK_EQ(render(decode::FORMAT_AUTO, values), std::string("\"ab\"\"\\\\xFF\""));
+    CHECK_EQ(render(decode::FORMAT_TEXT, values), std::string("\"ab\"\"\xef\xbf\xbd\""));
+
+    values.clear();
+    CHECK_EQ(render(decode::FORMAT_LONG, values), std::string());
+}
@@ -0,0 +1,84 @@
+package com.hbasegui.bridge;
+
+import java.io.PrintWriter;
+import java.io.StringWriter;
+
+/**
+ * Java层分级日志。由C++层注册 nativeLog 后，日志进入C++的异步队列统一输出；
+ * 未注册时（例如单独运行Java代码）退回到System.err。
+ * 级别定义与C++层 bridge::log::Level 保持一致，默认WARN。
+ */
+final class BridgeLog {
+    static final int TRACE = 0;
+    static final int DEBUG = 1;
+    static final int INFO = 2;
+    static final int WARN = 3;
+    static final int ERROR = 4;
+    static final int OFF = 5;
+
+    private static final String[] LEVEL_NAMES = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "OFF"};
+
+    private static volatile int level = WARN;
+    private static volatile boolean nativeSink = false;
+
+    private BridgeLog() {
+    }
+
+    /** 由C++层在注册nativeLog后调用，同时同步日志级别 */
+    static void attachNative(int nativeLevel) {
+        level = nativeLevel;
+        nativeSink = true;
+    }
+
+    static boolean isEnabled(int messageLevel) {
+        return messageLevel >= level;
+    }
+
+    static boolean isDebugEnabled() {
+        return DEBUG >= level;
+    }
+
+    static void debug(String message) {
+        log(DEBUG, message, null);
+    }
+
+    static void info(String message) {
+        log(INFO, message, null);
+    }
+
+    static void warn(String message) {
+        log(WARN, message, null);
+    }
+
+    static void error(String message, Throwable error) {
+        log(ERROR, message, error);
+    }
+
+    private static void log(int messageLevel, String message, Throwable error) {
+        if (messageLevel < level) {
+            return;
+        }
+        String text = message;
+        if (error != null) {
+            // 只有DEBUG级别才输出完整堆栈，否则只保留异常摘要
+            if (isDebugEnabled()) {
+                StringWriter stack = new StringWriter();
+                error.printStackTrace(new PrintWriter(stack));
+                text = message + "\n" + stack;
+            } else {
+                text = message + ": " + error;
+            }
+        }
+        if (nativeSink) {
+            try {
+                nativeLog(messageLevel, text);
+                return;
+            } catch (UnsatisfiedLinkError e) {
+                nativeSink = false;
+            }
+        }
+        System.err.println("[" + LEVEL_NAMES[messageLevel] + "] [java-bridge] " + text);
+    }
+
+    private static native void nativeLog(int level, String message);
+}
@@ -0,0 +1,126 @@
+package com.hbasegui.bridge;
+
+import org.json.JSONObject;
+
+import java.util.concurrent.ConcurrentLinkedQueue;
+
+/**
+ * Java层调用链追踪。由C++层开启并下发请求ID，事件写入每线程环形缓冲区，
+ * 导出时转换为Chrome trace事件，与C++层事件合并到同一个文件中。
+ */
+final class BridgeTrace {
+    private static final int RING_CAPACITY = 16384;
+    // 非C++附加线程使用的tid偏移，避免与C++层分配的tid冲突
+    private static final int JAVA_TID_BASE = 1000000;
+
+    private static volatile boolean enabled = false;
+    // C++追踪时钟与System.nanoTime()之间的偏移量
+    private static volatile long clockOffsetNanos = 0;
+
+    private static final ConcurrentLinkedQueue<Ring> RINGS = new ConcurrentLinkedQueue<>();
+    private static final ThreadLocal<Ring> LOCAL_RING = new ThreadLocal<Ring>() {
+        @Override
+        protected Ring initialValue() {
+            Ring ring = new Ring(Thread.currentThread());
+            RINGS.add(ring);
+            return ring;
+        }
+    };
+
+    private BridgeTrace() {
+    }
+
+    private static final class Ring {
+        final String threadName;
+        final int javaTid;
+        final String[] names = new String[RING_CAPACITY];
+        final long[] starts = new long[RING_CAPACITY];
+        final long[] durations = new long[RING_CAPACITY];
+        final long[] requestIds = new long[RING_CAPACITY];
+        final int[] tids = new int[RING_CAPACITY];
+        long head = 0;
+        // 由C++层设置，当前线程所处理的请求
+        long requestId = 0;
+        int nativeTid = 0;
+
+        Ring(Thread thread) {
+            this.threadName = thread.getName();
+            this.javaTid = JAVA_TID_BASE + (int) thread.getId();
+        }
+
+        synchronized void push(String name, long start, long duration) {
+            int slot = (int) (head % RING_CAPACITY);
+            names[slot] = name;
+            starts[slot] = start;
+            durations[slot] = duration;
+            requestIds[slot] = requestId;
+            tids[slot] = nativeTid != 0 ? nativeTid : javaTid;
+            head++;
+        }
+
+        synchronized void drain(StringBuilder out, int pid) {
+            long count = Math.min(head, RING_CAPACITY);
+            for (long i = head - count; i < head; i++) {
+                int slot = (int) (i % RING_CAPACITY);
+                if (out.length() > 0) {
+                    out.append(',');
+                }
+                out.append("{\"name\":").append(JSONObject.quote(names[slot]))
+                   .append(",\"cat\":\"java\",\"ph\":\"X\"")
+                   .append(",\"ts\":").append(starts[slot] / 1000.0)
+                   .append(",\"dur\":").append(durations[slot] / 1000.0)
+                   .append(",\"pid\":").append(pid)
+                   .append(",\"tid\":").append(tids[slot])
+                   .append(",\"args\":{\"request_id\":").append(requestIds[slot]).append("}}");
+                names[slot] = null;
+            }
+            head = 0;
+        }
+    }
+
+    static boolean isEnabled() {
+        return enabled;
+    }
+
+    /** 由C++层调用：开关追踪并以C++时钟读数校准偏移量 */
+    static void enable(boolean on, long nativeNowNanos) {
+        clockOffsetNanos = nativeNowNanos - System.nanoTime();
+        enabled = on;
+    }
+
+    /** 由C++层调用：设置当前线程的请求ID与C++线程ID */
+    static void setRequest(long requestId, int nativeTid) {
+        Ring ring = LOCAL_RING.get();
+        ring.requestId = requestId;
+        ring.nativeTid = nativeTid;
+    }
+
+    /** 开始一段Span，返回开始时间；未开启时返回0 */
+    static long begin() {
+        return enabled ? System.nanoTime() : 0;
+    }
+
+    /** 结束一段Span */
+    static void end(String name, long start) {
+        if (start == 0 || !enabled) {
+            return;
+        }
+        long now = System.nanoTime();
+        LOCAL_RING.get().push(name, start + clockOffsetNanos, now - start);
+    }
+
+    /** 由C++层调用：导出所有事件（逗号分隔的JSON对象）并清空缓冲区 */
+    static String drainJson(int pid) {
+        StringBuilder out = new StringBuilder();
+        for (Ring ring : RINGS) {
+            if (out.length() > 0) {
+                out.append(',');
+            }
+            out.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":").append(pid)
+               .append(",\"tid\":").append(ring.javaTid)
+               .append(",\"args\":{\"name\":").append(JSONObject.quote("java:" + ring.threadName)).append("}}");
+            ring.drain(out, pid);
+        }
+        return out.toString();
+    }
+}
@@ -0,0 +1,175 @@
+package com.hbasegui.bridge;
+
+import org.apache.hadoop.hbase.Cell;
+import org.apache.hadoop.hbase.client.Put;
+import org.apache.hadoop.hbase.client.Result;
+import org.apache.hadoop.hbase.util.Bytes;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+
+/**
+ * 与C++层 bridge::codec 对应的单元格批次二进制格式（大端序），
+ * 格式说明见 cell_codec.h。
+ */
+final class CellCodec {
+    static final int BATCH_MAGIC = 0x48424331; // "HBC1"
+
+    static final int FLAG_SAME_ROW = 0x01;
+    static final int FLAG_TRUNCATED = 0x02;
+
+    static final byte TYPE_PUT = 4;
+
+    private CellCodec() {
+    }
+
+    /** 批次编码器，追加Result后由toByteArray得到完整批次 */
+    static final class Writer {
+        private byte[] buffer;
+        private int size;
+        private int cellCount;
+        private int rowCount;
+        private byte[] lastRowArray;
+        private int lastRowOffset;
+        private int lastRowLength = -1;
+
+        Writer(int initialCapacity) {
+            buffer = new byte[Math.max(initialCapacity, 64)];
+            clear();
+        }
+
+        void clear() {
+            size = 0;
+            cellCount = 0;
+            rowCount = 0;
+            lastRowArray = null;
+            lastRowLength = -1;
+            putInt(BATCH_MAGIC);
+            putInt(0);
+        }
+
+        int size() {
+            return size;
+        }
+
+        int cellCount() {
+            return cellCount;
+        }
+
+        int rowCount() {
+            return rowCount;
+        }
+
+        void add(Result result) {
+            for (Cell cell : result.rawCells()) {
+                add(cell);
+            }
+            rowCount++;
+        }
+
+        void add(Cell cell) {
+            boolean sameRow = lastRowArray != null && Bytes.equals(lastRowArray, lastRowOffset, lastRowLength,
+                    cell.getRowArray(), cell.getRowOffset(), cell.getRowLength());
+            ensure(1 + 4 + cell.getRowLength() + 1 + cell.getFamilyLength() + 4 + cell.getQualifierLength()
+                    + 8 + 1 + 4 + cell.getValueLength());
+            buffer[size++] = (byte) (sameRow ? FLAG_SAME_ROW : 0);
+            if (!sameRow) {
+                putInt(cell.getRowLength());
+                putBytes(cell.getRowArray(), cell.getRowOffset(), cell.getRowLength());
+                lastRowArray = cell.getRowArray();
+                lastRowOffset = cell.getRowOffset();
+                lastRowLength = cell.getRowLength();
+            }
+            buffer[size++] = cell.getFamilyLength();
+            putBytes(cell.getFamilyArray(), cell.getFamilyOffset(), cell.getFamilyLength());
+            putInt(cell.getQualifierLength());
+            putBytes(cell.getQualifierArray(), cell.getQualifierOffset(), cell.getQualifierLength());
+            putLong(cell.getTimestamp());
+            buffer[size++] = cell.getTypeByte();
+            putInt(cell.getValueLength());
+            putBytes(cell.getValueArray(), cell.getValueOffset(), cell.getValueLength());
+            cellCount++;
+        }
+
+        byte[] toByteArray() {
+            byte[] batch = Arrays.copyOf(buffer, size);
+            ByteBuffer.wrap(batch).putInt(4, cellCount);
+            return batch;
+        }
+
+        private void ensure(int bytes) {
+            if (size + bytes > buffer.length) {
+                buffer = Arrays.copyOf(buffer, Math.max(buffer.length * 2, size + bytes));
+            }
+        }
+
+        private void putInt(int v) {
+            ensure(4);
+            buffer[size++] = (byte) (v >>> 24);
+            buffer[size++] = (byte) (v >>> 16);
+            buffer[size++] = (byte) (v >>> 8);
+            buffer[size++] = (byte) v;
+        }
+
+        private void putLong(long v) {
+            putInt((int) (v >>> 32));
+            putInt((int) v);
+        }
+
+        private void putBytes(byte[] src, int offset, int length) {
+            System.arraycopy(src, offset, buffer, size, length);
+            size += length;
+        }
+    }
+
+    /** 把批次解码为Put列表，同一行的连续单元格合并为一个Put */
+    static List<Put> decodePuts(byte[] batch) throws IOException {
+        ByteBuffer buffer = ByteBuffer.wrap(batch);
+        try {
+            if (buffer.getInt() != BATCH_MAGIC) {
+                throw new IOException("Invalid cell batch (bad magic)");
+            }
+            int cellCount = buffer.getInt();
+            List<Put> puts = new ArrayList<>();
+            Put current = null;
+            for (int i = 0; i < cellCount; i++) {
+                int flags = buffer.get() & 0xff;
+                if ((flags & FLAG_SAME_ROW) == 0) {
+                    current = new Put(readBytes(buffer, buffer.getInt()));
+                    puts.add(current);
+                } else if (current == null) {
+                    throw new IOException("Invalid cell batch (first cell has no row)");
+                }
+                byte[] family = readBytes(buffer, buffer.get() & 0xff);
+                byte[] qualifier = readBytes(buffer, buffer.getInt());
+                long timestamp = buffer.getLong();
+                byte type = buffer.get();
+                byte[] value = readBytes(buffer, buffer.getInt());
+                if ((flags & FLAG_TRUNCATED) != 0) {
+                    throw new IOException("Truncated cells cannot be written");
+                }
+                if (type != TYPE_PUT) {
+                    throw new IOException("Unsupported cell type in write batch: " + type);
+                }
+                // 时间戳为Long.MAX_VALUE（HConstants.LATEST_TIMESTAMP）时由服务端取当前时间
+                current.addColumn(family, qualifier, timestamp, value);
+            }
+            return puts;
+        } catch (RuntimeException e) {
+            // BufferUnderflowException等：批次数据不完整
+            throw new IOException("Invalid cell batch: " + e, e);
+        }
+    }
+
+    private static byte[] readBytes(ByteBuffer buffer, int length) {
+        if (length < 0 || length > buffer.remaining()) {
+            throw new IllegalArgumentException("length " + length + " exceeds batch");
+        }
+        int from = buffer.position();
+        buffer.position(from + length);
+        return Arrays.copyOfRange(buffer.array(), from, from + length);
+    }
+}
@@ -1,150 +1,776 @@
 package com.hbasegui.bridge;
 
-import org.apache.hadoop.conf.Configuration;
-import org.apache.hadoop.hbase.HBaseConfiguration;
-import org.apache.hadoop.hbase.TableName;
+import org.apache.hadoop.hbase.Cell;
 import org.apache.hadoop.hbase.client.*;
+import org.apache.hadoop.hbase.filter.ColumnPaginationFilter;
+import org.apache.hadoop.hbase.filter.KeyOnlyFilter;
 import org.apache.hadoop.hbase.filter.PrefixFilter;
 import org.apache.hadoop.hbase.util.Bytes;
 import org.json.JSONArray;
 import org.json.JSONObject;
 
 import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.*;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.atomic.AtomicLong;
 
 public class HBaseBridge {
-    private static Connection connection = null;
-    private static Admin admin = null;
+    private static TableBackend backend = null;
+    // 按名称连接的其他集群（如容灾集群），用于跨集群对比等只读扫描
+    private static final ConcurrentHashMap<String, TableBackend> peers = new ConcurrentHashMap<>();
+    // getTableData/queryTableData单次返回的数据上限（行键与值的字节数），0表示不限
+    private static volatile long queryBytesLimit = 64L << 20;
+    private static final AtomicLong truncatedQueries = new AtomicLong();
 
     public static boolean connect(String zkQuorum, String zkNode) {
         try {
-            System.out.println("【HBase连接】开始连接HBase...");
-            System.out.println("【HBase连接】ZooKeeper地址: " + zkQuorum);
-            System.out.println("【HBase连接】ZooKeeper节点: " + zkNode);
+            if (BridgeLog.isEnabled(BridgeLog.INFO)) {
+                BridgeLog.info("【HBase连接】开始连接HBase，ZooKeeper地址: " + zkQuorum + "，节点: " + zkNode);
+            }
 
-            Configuration config = HBaseConfiguration.create();
-            config.set("hbase.zookeeper.quorum", zkQuorum);
-            config.set("zookeeper.znode.parent", zkNode);
+            long span = BridgeTrace.begin();
+            backend = TableBackend.open(zkQuorum, zkNode);
+            BridgeTrace.end("java.connect", span);
 
-            connection = ConnectionFactory.createConnection(config);
-            admin = connection.getAdmin();
+            BridgeLog.info("【HBase连接】连接成功");
+            return true;
+        } catch (IOException e) {
+            BridgeLog.error("【HBase连接】连接失败", e);
+            return false;
+        }
+    }
 
-            System.out.println("【HBase连接】连接成功");
+    /** 以名称连接另一个集群，同名的旧连接会被关闭 */
+    public static boolean connectPeer(String name, String zkQuorum, String zkNode) {
+        try {
+            BridgeLog.info("【HBase连接】连接集群 " + name + "，ZooKeeper地址: " + zkQuorum + "，节点: " + zkNode);
+            long span = BridgeTrace.begin();
+            TableBackend previous = peers.put(name, TableBackend.open(zkQuorum, zkNode));
+            BridgeTrace.end("java.connectPeer", span);
+            if (previous != null) {
+                previous.close();
+            }
             return true;
         } catch (IOException e) {
-            System.err.println("【HBase连接】连接失败: " + e.getMessage());
-            e.printStackTrace();
+            BridgeLog.error("【HBase连接】连接集群 " + name + " 失败", e);
             return false;
         }
     }
 
+    public static void disconnectPeer(String name) {
+        TableBackend peer = peers.remove(name);
+        if (peer == null) {
+            return;
+        }
+        try {
+            peer.close();
+            BridgeLog.info("【HBase连接】已断开集群 " + name);
+        } catch (IOException e) {
+            BridgeLog.error("【HBase连接】断开集群 " + name + " 失败", e);
+        }
+    }
+
+    /** 集群名为空时是主连接，否则是connectPeer建立的连接 */
+    private static TableBackend backendFor(String cluster) throws IOException {
+        if (cluster == null || cluster.isEmpty()) {
+            return backend;
+        }
+        TableBackend peer = peers.get(cluster);
+        if (peer == null) {
+            throw new IOException("未连接的集群: " + cluster);
+        }
+        return peer;
+    }
+
     public static void disconnect() {
         try {
-            if (admin != null) {
-                admin.close();
+            for (String name : new ArrayList<>(peers.keySet())) {
+                disconnectPeer(name);
             }
-            if (connection != null) {
-                connection.close();
+            if (backend != null) {
+                backend.close();
+                backend = null;
             }
-            System.out.println("【HBase连接】已断开连接");
+            BridgeLog.info("【HBase连接】已断开连接");
         } catch (IOException e) {
-            System.err.println("【HBase连接】断开连接失败: " + e.getMessage());
-            e.printStackTrace();
+            BridgeLog.error("【HBase连接】断开连接失败", e);
         }
     }
 
     public static String listTables() {
         try {
-            System.out.println("【HBase操作】开始获取表列表...");
-            List<String> tableNames = new ArrayList<>();
-            for (TableName tableName : admin.listTableNames()) {
-                tableNames.add(tableName.getNameAsString());
-            }
+            BridgeLog.debug("【HBase操作】开始获取表列表...");
+            long span = BridgeTrace.begin();
+            List<String> tableNames = backend.listTables();
+            BridgeTrace.end("java.listTableNames", span);
             JSONArray jsonArray = new JSONArray(tableNames);
-            System.out.println("【HBase操作】获取表列表成功，数量: " + tableNames.size());
+            if (BridgeLog.isDebugEnabled()) {
+                BridgeLog.debug("【HBase操作】获取表列表成功，数量: " + tableNames.size());
+            }
             return jsonArray.toString();
         } catch (IOException e) {
-            System.err.println("【HBase操作】获取表列表失败: " + e.getMessage());
-            e.printStackTrace();
+            BridgeLog.error("【HBase操作】获取表列表失败", e);
             return "[]";
         }
     }
 
     public static String getTableData(String tableName, String startRow, String endRow, int limit, String filterPrefix) {
         try {
-            System.out.println("【HBase操作】开始获取表数据...");
-            System.out.println("【HBase操作】表名: " + tableName);
-            System.out.println("【HBase操作】起始行: " + startRow);
-            System.out.println("【HBase操作】结束行: " + endRow);
-            System.out.println("【HBase操作】限制数量: " + limit);
-            System.out.println("【HBase操作】过滤前缀: " + filterPrefix);
+            if (BridgeLog.isDebugEnabled()) {
+                BridgeLog.debug("【HBase操作】开始获取表数据，表名: " + tableName + "，起始行: " + startRow
+                        + "，结束行: " + endRow + "，限制数量: " + limit + "，过滤前缀: " + filterPrefix);
+            }
+
+            long openSpan = BridgeTrace.begin();
+            Scan scan = buildScan(startRow, endRow, filterPrefix);
+            scan.setLimit(limit);
+            limitRowColumns(scan);
+
+            ResultScanner scanner = backend.getScanner(tableName, scan);
+            BridgeTrace.end("java.scan.open", openSpan);
+
+            long iterateSpan = BridgeTrace.begin();
+            JSONArray jsonArray = new JSONArray();
+            int count = 0;
+            long bytes = 0;
 
-            Table table = connection.getTable(TableName.valueOf(tableName));
-            Scan scan = new Scan();
-            
-            if (startRow != null && !startRow.isEmpty()) {
-                scan.withStartRow(Bytes.toBytes(startRow));
+            for (Result result : scanner) {
+                jsonArray.put(limitedRowToJson(result));
+
+                if (++count >= limit) {
+                    break;
+                }
+                bytes += resultBytes(result);
+                if (overQueryLimit(bytes)) {
+                    BridgeLog.warn("【HBase操作】获取表数据超过 " + queryBytesLimit + " 字节，只返回前 " + count + " 行，表名: " + tableName);
+                    break;
+                }
             }
-            if (endRow != null && !endRow.isEmpty()) {
-                scan.withStopRow(Bytes.toBytes(endRow));
+
+            scanner.close();
+            BridgeTrace.end("java.scan.iterate", iterateSpan);
+
+            if (BridgeLog.isDebugEnabled()) {
+                BridgeLog.debug("【HBase操作】获取表数据成功，数量: " + count);
             }
-            if (filterPrefix != null && !filterPrefix.isEmpty()) {
-                scan.setRowPrefixFilter(Bytes.toBytes(filterPrefix));
+            long encodeSpan = BridgeTrace.begin();
+            String json = jsonArray.toString();
+            BridgeTrace.end("java.json.encode", encodeSpan);
+            return json;
+        } catch (IOException e) {
+            BridgeLog.error("【HBase操作】获取表数据失败", e);
+            return "[]";
+        }
+    }
+
+    /**
+     * 可取消的getTableData：扫描登记在取消令牌token下（0为不使用），取消或超时时扫描器被立即关闭，
+     * 已读取的行随即丢弃。返回 {"code":0,"status":"ok","rows":[...]}，
+     * 中止时返回 {"code":-2|-3,...}，其他失败返回 {"code":-1,...}
+     */
+    public static String queryTableData(String tableName, String startRow, String endRow, int limit,
+                                        String filterPrefix, long token) {
+        OperationTokens.Token operation = OperationTokens.get(token);
+        ResultScanner scanner = null;
+        try {
+            if (operation != null) {
+                operation.check();
             }
+            Scan scan = buildScan(startRow, endRow, filterPrefix);
             scan.setLimit(limit);
+            limitRowColumns(scan);
+            long openSpan = BridgeTrace.begin();
+            scanner = backend.getScanner(tableName, scan);
+            BridgeTrace.end("java.scan.open", openSpan);
+            OperationTokens.attach(operation, scanner);
 
-            ResultScanner scanner = table.getScanner(scan);
-            JSONArray jsonArray = new JSONArray();
+            long iterateSpan = BridgeTrace.begin();
+            JSONArray rows = new JSONArray();
             int count = 0;
+            long bytes = 0;
+            boolean truncated = false;
+            while (count < limit) {
+                if (operation != null) {
+                    operation.check();
+                }
+                Result result = scanner.next();
+                if (result == null) {
+                    break;
+                }
+                rows.put(limitedRowToJson(result));
+                count++;
+                bytes += resultBytes(result);
+                if (count < limit && overQueryLimit(bytes)) {
+                    truncated = true;
+                    break;
+                }
+            }
+            // 被取消关闭的扫描器返回null，不能当作扫描结束
+            if (operation != null) {
+                operation.check();
+            }
+            BridgeTrace.end("java.scan.iterate", iterateSpan);
 
-            for (Result result : scanner) {
-                JSONObject rowJson = new JSONObject();
-                rowJson.put("row", Bytes.toString(result.getRow()));
-
-                JSONObject familiesJson = new JSONObject();
-                for (Map.Entry<byte[], NavigableMap<byte[], byte[]>> familyEntry : result.getNoVersionMap().entrySet()) {
-                    String family = Bytes.toString(familyEntry.getKey());
-                    JSONObject qualifiersJson = new JSONObject();
-
-                    for (Map.Entry<byte[], byte[]> qualifierEntry : familyEntry.getValue().entrySet()) {
-                        String qualifier = Bytes.toString(qualifierEntry.getKey());
-                        String value = Bytes.toString(qualifierEntry.getValue());
-                        qualifiersJson.put(qualifier, value);
+            JSONObject json = new JSONObject();
+            json.put("code", OperationTokens.OK);
+            json.put("status", "ok");
+            json.put("rows", rows);
+            if (truncated) {
+                json.put("truncated", true);
+            }
+            return json.toString();
+        } catch (IOException e) {
+            // 取消导致的扫描器异常按令牌状态报告
+            int code = operation != null ? operation.status() : OperationTokens.OK;
+            JSONObject json = new JSONObject();
+            if (code != OperationTokens.OK) {
+                json.put("code", code);
+                json.put("status", code == OperationTokens.DEADLINE_EXCEEDED ? "deadlineExceeded" : "cancelled");
+                json.put("error", new OperationTokens.AbortedException(code).getMessage());
+            } else {
+                BridgeLog.error("【HBase操作】查询表数据失败，表名: " + tableName, e);
+                json.put("code", -1);
+                json.put("status", "error");
+                json.put("error", String.valueOf(e.getMessage()));
+            }
+            return json.toString();
+        } finally {
+            if (scanner != null) {
+                OperationTokens.detach(operation, scanner);
+                scanner.close();
+            }
+        }
+    }
+
+    /**
+     * 读取一行（family/qualifier为空时取整个列族/整行），经过对冲与重试（见 {@link PointReads}）。
+     * 返回 {"status":"success","data":{"row":..,"families":{..}},"stale":..}，行不存在时没有data
+     */
+    public static String getRow(String tableName, String rowKey, String family, String qualifier) {
+        JSONObject json = new JSONObject();
+        try {
+            long span = BridgeTrace.begin();
+            Get get = new Get(Bytes.toBytes(rowKey));
+            if (family != null && !family.isEmpty()) {
+                if (qualifier != null && !qualifier.isEmpty()) {
+                    get.addColumn(Bytes.toBytes(family), Bytes.toBytes(qualifier));
+                } else {
+                    get.addFamily(Bytes.toBytes(family));
+                }
+            }
+            Result result = PointReads.get(backend, tableName, get);
+            BridgeTrace.end("java.getRow", span);
+            json.put("status", "success");
+            if (!result.isEmpty()) {
+                json.put("data", rowToJson(result));
+            }
+            json.put("stale", result.isStale());
+        } catch (IOException e) {
+            BridgeLog.error("【HBase操作】读取行失败，表名: " + tableName, e);
+            json.put("status", "error");
+            json.put("message", String.valueOf(e.getMessage()));
+        }
+        return json.toString();
+    }
+
+    /**
+     * 按列分页读取一行（见 {@link WideRows}）：family为空时依次读取各列族，cursor为上一页返回的nextCursor（空为从头开始），
+     * 每页最多limit列。返回 {"status":"success","row":..,"columns":[..],"nextCursor":..}
+     */
+    public static String getRowColumns(String tableName, String rowKey, String family, String cursor, int limit) {
+        try {
+            long span = BridgeTrace.begin();
+            String json = WideRows.page(backend, tableName, rowKey, family, cursor, Math.max(1, limit));
+            BridgeTrace.end("java.getRowColumns", span);
+            return json;
+        } catch (IOException e) {
+            BridgeLog.error("【HBase操作】分页读取行失败，表名: " + tableName + "，行键: " + rowKey, e);
+            JSONObject json = new JSONObject();
+            json.put("status", "error");
+            json.put("message", String.valueOf(e.getMessage()));
+            return json.toString();
+        }
+    }
+
+    /** 设置浏览接口中值的预览字节数，<=0表示不截断 */
+    public static void configurePreview(int previewBytes) {
+        LargeCells.previewBytes = Math.max(0, previewBytes);
+    }
+
+    /** 打开一个单元格供分块读取（见 {@link LargeCells}），返回单元格ID，不存在时返回0，出错返回-1 */
+    public static long openCell(String tableName, String rowKey, String family, String qualifier) {
+        try {
+            long span = BridgeTrace.begin();
+            long id = LargeCells.open(backend, tableName, rowKey, family, qualifier);
+            BridgeTrace.end("java.cell.open", span);
+            return id;
+        } catch (IOException e) {
+            BridgeLog.error("【HBase操作】读取单元格失败，表名: " + tableName + "，行键: " + rowKey, e);
+            return -1;
+        }
+    }
+
+    public static long getCellLength(long cellId) {
+        return LargeCells.length(cellId);
+    }
+
+    /** 从offset开始复制到C++层的直接缓冲区，返回复制的字节数，单元格未打开时返回-1 */
+    public static int readCell(long cellId, long offset, ByteBuffer target) {
+        return LargeCells.read(cellId, offset, target);
+    }
+
+    public static void closeCell(long cellId) {
+        LargeCells.close(cellId);
+    }
+
+    /**
+     * 带版本与时间范围的getTableData：每行返回 {"row":..,"cells":[{"family":..,"qualifier":..,"timestamp":..,"value":..},..]}，
+     * 每列最多versions个版本，只包含时间范围[minTime, maxTime)内的版本（0为不限）
+     */
+    public static String getTableVersions(String tableName, String startRow, String endRow, int limit,
+                                          String filterPrefix, int versions, long minTime, long maxTime) {
+        try {
+            long span = BridgeTrace.begin();
+            Scan scan = buildScan(startRow, endRow, filterPrefix);
+            scan.setLimit(limit);
+            applyVersions(scan, versions, minTime, maxTime);
+            JSONArray rows = new JSONArray();
+            long bytes = 0;
+            try (ResultScanner scanner = backend.getScanner(tableName, scan)) {
+                for (Result result; rows.length() < limit && (result = scanner.next()) != null; ) {
+                    rows.put(versionsToJson(result));
+                    bytes += resultBytes(result);
+                    if (overQueryLimit(bytes)) {
+                        BridgeLog.warn("【HBase操作】读取多版本数据超过 " + queryBytesLimit + " 字节，只返回前 "
+                                + rows.length() + " 行，表名: " + tableName);
+                        break;
                     }
+                }
+            }
+            BridgeTrace.end("java.scan.versions", span);
+            return rows.toString();
+        } catch (IOException e) {
+            BridgeLog.error("【HBase操作】读取多版本数据失败，表名: " + tableName, e);
+            return "[]";
+        }
+    }
 
-                    familiesJson.put(family, qualifiersJson);
+    /** 读取一行的多个版本（family/qualifier为空时取整个列族/整行），返回 {"status":"success","data":{"row":..,"cells":[..]}} */
+    public static String getRowVersions(String tableName, String rowKey, String family, String qualifier,
+                                        int versions, long minTime, long maxTime) {
+        JSONObject json = new JSONObject();
+        try {
+            long span = BridgeTrace.begin();
+            Get get = new Get(Bytes.toBytes(rowKey));
+            if (family != null && !family.isEmpty()) {
+                if (qualifier != null && !qualifier.isEmpty()) {
+                    get.addColumn(Bytes.toBytes(family), Bytes.toBytes(qualifier));
+                } else {
+                    get.addFamily(Bytes.toBytes(family));
                 }
-                rowJson.put("families", familiesJson);
-                jsonArray.put(rowJson);
+            }
+            applyVersions(get, versions, minTime, maxTime);
+            Result result = backend.get(tableName, get);
+            BridgeTrace.end("java.getRowVersions", span);
+            json.put("status", "success");
+            if (!result.isEmpty()) {
+                json.put("data", versionsToJson(result));
+            }
+        } catch (IOException e) {
+            BridgeLog.error("【HBase操作】读取多版本行失败，表名: " + tableName, e);
+            json.put("status", "error");
+            json.put("message", String.valueOf(e.getMessage()));
+        }
+        return json.toString();
+    }
 
-                if (++count >= limit) {
-                    break;
+    public static void configurePointReads(boolean hedge, int percentile, long minHedgeMs, int maxRetries,
+                                           long backoffMs, long maxBackoffMs) {
+        PointReads.configure(hedge, percentile, minHedgeMs, maxRetries, backoffMs, maxBackoffMs);
+    }
+
+    public static String getPointReadStats() {
+        return PointReads.statsJson();
+    }
+
+    /** 设置getTableData/queryTableData单次返回的数据上限（字节），<=0表示不限 */
+    public static void configureMemory(long queryBytes) {
+        queryBytesLimit = Math.max(0, queryBytes);
+    }
+
+    /** JVM堆的使用情况与被截断的查询次数 */
+    public static String getJvmMemoryStats() {
+        Runtime runtime = Runtime.getRuntime();
+        JSONObject json = new JSONObject();
+        json.put("heapUsed", runtime.totalMemory() - runtime.freeMemory());
+        json.put("heapCommitted", runtime.totalMemory());
+        json.put("heapMax", runtime.maxMemory());
+        json.put("queryBytes", queryBytesLimit);
+        json.put("truncatedQueries", truncatedQueries.get());
+        return json.toString();
+    }
+
+    /** 中止C++层的操作（取消或超时），关闭登记的扫描 */
+    public static void abortOperation(long token, long code) {
+        OperationTokens.abort(token, (int) code);
+    }
+
+    public static void setOperationDeadline(long token, long timeoutMs) {
+        OperationTokens.setDeadline(token, timeoutMs);
+    }
+
+    public static void releaseOperation(long token) {
+        OperationTokens.release(token);
+    }
+
+    // 一行在JSON中占用的大致字节数（行键、列名与值）
+    private static long resultBytes(Result result) {
+        long bytes = result.getRow() != null ? result.getRow().length : 0;
+        for (Cell cell : result.rawCells()) {
+            bytes += cell.getFamilyLength() + cell.getQualifierLength() + cell.getValueLength();
+        }
+        return bytes;
+    }
+
+    private static boolean overQueryLimit(long bytes) {
+        long limit = queryBytesLimit;
+        if (limit > 0 && bytes >= limit) {
+            truncatedQueries.incrementAndGet();
+            return true;
+        }
+        return false;
+    }
+
+    // 每行最多取ROW_COLUMNS+1列（多取的一列用于判断是否被截断），宽行不会整行传到客户端
+    private static void limitRowColumns(Scan scan) {
+        scan.setFilter(new ColumnPaginationFilter(WideRows.ROW_COLUMNS + 1, 0));
+    }
+
+    // 超过ROW_COLUMNS列的行只返回前ROW_COLUMNS列，并给出继续分页读取（getRowColumns）的游标
+    private static JSONObject limitedRowToJson(Result result) {
+        Cell[] cells = result.rawCells();
+        if (cells.length <= WideRows.ROW_COLUMNS) {
+            return rowToJson(result);
+        }
+        JSONObject json = rowToJson(Result.create(Arrays.copyOf(cells, WideRows.ROW_COLUMNS)));
+        json.put("columnsTruncated", true);
+        json.put("nextCursor", WideRows.cursor(cells[WideRows.ROW_COLUMNS - 1]));
+        return json;
+    }
+
+    private static JSONObject rowToJson(Result result) {
+        JSONObject rowJson = new JSONObject();
+        rowJson.put("row", Bytes.toString(result.getRow()));
+
+        JSONObject familiesJson = new JSONObject();
+        // 超过预览阈值的值只返回前面部分，完整长度记在truncated中（"family:qualifier" -> 字节数）
+        int preview = LargeCells.previewBytes;
+        JSONObject truncated = null;
+        for (Map.Entry<byte[], NavigableMap<byte[], byte[]>> familyEntry : result.getNoVersionMap().entrySet()) {
+            String family = Bytes.toString(familyEntry.getKey());
+            JSONObject qualifiersJson = new JSONObject();
+
+            for (Map.Entry<byte[], byte[]> qualifierEntry : familyEntry.getValue().entrySet()) {
+                String qualifier = Bytes.toString(qualifierEntry.getKey());
+                byte[] bytes = qualifierEntry.getValue();
+                String value;
+                if (preview > 0 && bytes.length > preview) {
+                    value = Bytes.toString(bytes, 0, LargeCells.previewLength(bytes, 0, bytes.length, preview));
+                    if (truncated == null) {
+                        truncated = new JSONObject();
+                    }
+                    truncated.put(family + ":" + qualifier, bytes.length);
+                } else {
+                    value = Bytes.toString(bytes);
                 }
+                qualifiersJson.put(qualifier, value);
             }
 
-            scanner.close();
-            table.close();
+            familiesJson.put(family, qualifiersJson);
+        }
+        rowJson.put("families", familiesJson);
+        if (truncated != null) {
+            rowJson.put("truncated", truncated);
+        }
+        return rowJson;
+    }
+
+    /** versions>1时读取多个版本；minTime与maxTime都为0时不限时间范围，maxTime为0时不限上界 */
+    private static void applyVersions(Scan scan, int versions, long minTime, long maxTime) throws IOException {
+        if (versions > 1) {
+            scan.readVersions(versions);
+        }
+        if (minTime > 0 || maxTime > 0) {
+            scan.setTimeRange(minTime, maxTime > 0 ? maxTime : Long.MAX_VALUE);
+        }
+    }
+
+    private static void applyVersions(Get get, int versions, long minTime, long maxTime) throws IOException {
+        if (versions > 1) {
+            get.readVersions(versions);
+        }
+        if (minTime > 0 || maxTime > 0) {
+            get.setTimeRange(minTime, maxTime > 0 ? maxTime : Long.MAX_VALUE);
+        }
+    }
+
+    /** 一行的所有版本：{"row":..,"cells":[{"family":..,"qualifier":..,"timestamp":..,"value":..},..]}，同一列从新到旧 */
+    private static JSONObject versionsToJson(Result result) {
+        JSONObject rowJson = new JSONObject();
+        rowJson.put("row", Bytes.toString(result.getRow()));
+        int preview = LargeCells.previewBytes;
+        JSONArray cells = new JSONArray();
+        for (Cell cell : result.rawCells()) {
+            JSONObject cellJson = new JSONObject();
+            cellJson.put("family", Bytes.toString(cell.getFamilyArray(), cell.getFamilyOffset(), cell.getFamilyLength()));
+            cellJson.put("qualifier", Bytes.toString(cell.getQualifierArray(), cell.getQualifierOffset(),
+                    cell.getQualifierLength()));
+            cellJson.put("timestamp", cell.getTimestamp());
+            int length = cell.getValueLength();
+            if (preview > 0 && length > preview) {
+                cellJson.put("value", Bytes.toString(cell.getValueArray(), cell.getValueOffset(),
+                        LargeCells.previewLength(cell.getValueArray(), cell.getValueOffset(), length, preview)));
+                cellJson.put("length", length);
+            } else {
+                cellJson.put("value", Bytes.toString(cell.getValueArray(), cell.getValueOffset(), length));
+            }
+            cells.put(cellJson);
+        }
+        rowJson.put("cells", cells);
+        return rowJson;
+    }
+
+    private static Scan buildScan(String startRow, String endRow, String filterPrefix) {
+        Scan scan = new Scan();
+        if (startRow != null && !startRow.isEmpty()) {
+            scan.withStartRow(Bytes.toBytes(startRow));
+        }
+        if (endRow != null && !endRow.isEmpty()) {
+            scan.withStopRow(Bytes.toBytes(endRow));
+        }
+        if (filterPrefix != null && !filterPrefix.isEmpty()) {
+            scan.setRowPrefixFilter(Bytes.toBytes(filterPrefix));
+        }
+        return scan;
+    }
+
+    /**
+     * 与buildScan相同的范围 [startRow, endRow) 与前缀，反向扫描。
+     * 反向扫描的起点是较大的行键，setRowPrefixFilter设置的起止行不适用，这里按前缀换算为
+     * (前缀之后的第一个行键, 前缀] 的反向范围
+     */
+    private static Scan buildReversedScan(String startRow, String endRow, String filterPrefix) {
+        Scan scan = new Scan();
+        scan.setReversed(true);
+        if (endRow != null && !endRow.isEmpty()) {
+            scan.withStartRow(Bytes.toBytes(endRow), false);
+        }
+        if (startRow != null && !startRow.isEmpty()) {
+            scan.withStopRow(Bytes.toBytes(startRow), true);
+        }
+        if (filterPrefix != null && !filterPrefix.isEmpty()) {
+            byte[] prefix = Bytes.toBytes(filterPrefix);
+            byte[] after = prefixEnd(prefix);
+            if (after.length > 0) {
+                scan.withStartRow(after, false);
+            }
+            scan.withStopRow(prefix, true);
+            scan.setFilter(new PrefixFilter(prefix));
+        }
+        return scan;
+    }
 
-            System.out.println("【HBase操作】获取表数据成功，数量: " + count);
+    /** 大于所有以prefix开头的行键的最小行键，前缀全为0xFF时返回空数组（不限） */
+    private static byte[] prefixEnd(byte[] prefix) {
+        for (int i = prefix.length - 1; i >= 0; i--) {
+            if (prefix[i] != (byte) 0xFF) {
+                byte[] end = Arrays.copyOf(prefix, i + 1);
+                end[i]++;
+                return end;
+            }
+        }
+        return new byte[0];
+    }
+
+    /**
+     * 打开一个按批拉取的扫描会话（用于导出等全表扫描），返回会话ID，失败返回-1。
+     * 全表扫描不填充服务端块缓存，避免挤掉在线业务的热点数据。
+     * 反向扫描见 {@link #buildReversedScan}
+     */
+    public static long openScanner(ScanOptions options) {
+        String tableName = options.tableName;
+        String columns = options.columns;
+        String splitStart = options.splitStart;
+        String splitStop = options.splitStop;
+        boolean reversed = options.reversed;
+        try {
+            long span = BridgeTrace.begin();
+            Scan scan = reversed ? buildReversedScan(options.startRow, options.stopRow, options.prefix)
+                    : buildScan(options.startRow, options.stopRow, options.prefix);
+            applyVersions(scan, options.versions, options.minTime, options.maxTime);
+            scan.setCaching(options.caching);
+            scan.setCacheBlocks(false);
+            if (columns != null && !columns.isEmpty()) {
+                for (String column : columns.split(",")) {
+                    int colon = column.indexOf(':');
+                    if (colon < 0) {
+                        scan.addFamily(Bytes.toBytes(column));
+                    } else {
+                        scan.addColumn(Bytes.toBytes(column.substring(0, colon)), Bytes.toBytes(column.substring(colon + 1)));
+                    }
+                }
+            }
+            if (splitStart != null && !splitStart.isEmpty()) {
+                if (reversed) {
+                    scan.withStopRow(Bytes.fromHex(splitStart), true);
+                } else {
+                    scan.withStartRow(Bytes.fromHex(splitStart));
+                }
+            }
+            if (splitStop != null && !splitStop.isEmpty()) {
+                if (reversed) {
+                    scan.withStartRow(Bytes.fromHex(splitStop), false);
+                } else {
+                    scan.withStopRow(Bytes.fromHex(splitStop));
+                }
+            }
+            long id = ScannerSessions.open(backendFor(options.cluster).getScanner(tableName, scan), options.token);
+            BridgeTrace.end("java.scan.open", span);
+            return id;
+        } catch (IOException e) {
+            BridgeLog.error("【HBase操作】打开扫描失败，表名: " + tableName, e);
+            return -1;
+        }
+    }
+
+    /** 拉取下一批数据（CellCodec格式），扫描结束返回null，出错时抛出异常由C++层处理 */
+    public static byte[] nextBatch(long scannerId, int maxRows, int maxBytes) throws IOException {
+        long span = BridgeTrace.begin();
+        byte[] batch = ScannerSessions.next(scannerId, maxRows, maxBytes);
+        BridgeTrace.end("java.scan.nextBatch", span);
+        return batch;
+    }
+
+    public static void closeScanner(long scannerId) {
+        ScannerSessions.close(scannerId);
+    }
+
+    public static String getRegions(String tableName) {
+        try {
+            long span = BridgeTrace.begin();
+            JSONArray jsonArray = new JSONArray();
+            for (TableBackend.Region region : backend.getRegions(tableName)) {
+                JSONObject regionJson = new JSONObject();
+                regionJson.put("start", Bytes.toStringBinary(region.startKey));
+                regionJson.put("end", Bytes.toStringBinary(region.endKey));
+                regionJson.put("server", region.server);
+                jsonArray.put(regionJson);
+            }
+            BridgeTrace.end("java.getRegions", span);
+            if (BridgeLog.isDebugEnabled()) {
+                BridgeLog.debug("【HBase操作】获取Region列表成功，表名: " + tableName + "，数量: " + jsonArray.length());
+            }
             return jsonArray.toString();
         } catch (IOException e) {
-            System.err.println("【HBase操作】获取表数据失败: " + e.getMessage());
-            e.printStackTrace();
+            BridgeLog.error("【HBase操作】获取Region列表失败", e);
             return "[]";
         }
     }
 
+    /**
+     * 把扫描范围按Region切分，供C++层按Region并行扫描。每行一个切分 "起始键,结束键"，
+     * 键为十六进制的原始字节，空表示无界；范围与任何Region都不相交时返回空串。失败返回null
+     */
+    public static String getScanSplits(String tableName, String startRow, String endRow, String filterPrefix) {
+        return getScanSplits(tableName, startRow, endRow, filterPrefix, "");
+    }
+
+    /** 同上，按cluster集群（空为主连接）中该表的Region切分 */
+    public static String getScanSplits(String tableName, String startRow, String endRow, String filterPrefix, String cluster) {
+        try {
+            long span = BridgeTrace.begin();
+            Scan scan = buildScan(startRow, endRow, filterPrefix);
+            byte[] start = scan.getStartRow();
+            byte[] stop = scan.getStopRow();
+            StringBuilder splits = new StringBuilder();
+            for (TableBackend.Region region : backendFor(cluster).getRegions(tableName)) {
+                byte[] splitStart = Bytes.compareTo(region.startKey, start) > 0 ? region.startKey : start;
+                byte[] splitStop = stop.length == 0
+                        || (region.endKey.length != 0 && Bytes.compareTo(region.endKey, stop) < 0) ? region.endKey : stop;
+                if (splitStop.length != 0 && Bytes.compareTo(splitStart, splitStop) >= 0) {
+                    continue;
+                }
+                splits.append(Bytes.toHex(splitStart)).append(',').append(Bytes.toHex(splitStop)).append('\n');
+            }
+            BridgeTrace.end("java.getScanSplits", span);
+            return splits.toString();
+        } catch (IOException e) {
+            BridgeLog.error("【HBase操作】切分扫描范围失败，表名: " + tableName, e);
+            return null;
+        }
+    }
+
+    /**
+     * 检查范围内sinceMs之后是否有写入（含删除标记），供本地快照判断是否过期。
+     * 原始扫描只取一个键，时间范围让服务端跳过更早的存储文件。
+     * 返回1表示有变化，0表示没有，-1表示检查失败
+     */
+    public static int hasChangesSince(String tableName, String startRow, String endRow, String filterPrefix, long sinceMs) {
+        try {
+            long span = BridgeTrace.begin();
+            Scan scan = buildScan(startRow, endRow, filterPrefix);
+            scan.setRaw(true);
+            scan.setTimeRange(sinceMs, Long.MAX_VALUE);
+            scan.setFilter(new KeyOnlyFilter());
+            scan.setLimit(1);
+            scan.setCaching(1);
+            scan.setCacheBlocks(false);
+            boolean changed;
+            try (ResultScanner scanner = backend.getScanner(tableName, scan)) {
+                changed = scanner.next() != null;
+            }
+            BridgeTrace.end("java.hasChangesSince", span);
+            return changed ? 1 : 0;
+        } catch (IOException e) {
+            BridgeLog.error("【HBase操作】检查数据变化失败，表名: " + tableName, e);
+            return -1;
+        }
+    }
+
+    /**
+     * 批量写入：batch为CellCodec格式的单元格批次。
+     * 返回写入的行数，失败返回-1（供C++层的生成器、导入等高吞吐写入使用）
+     */
+    public static int putCells(String tableName, byte[] batch) {
+        return putCells(tableName, batch, "");
+    }
+
+    /** 同上，写入cluster集群（connectPeer的集群名，空为主连接），供跨集群复制使用 */
+    public static int putCells(String tableName, byte[] batch, String cluster) {
+        try {
+            long span = BridgeTrace.begin();
+            List<Put> puts = CellCodec.decodePuts(batch);
+            BridgeTrace.end("java.putCells.decode", span);
+
+            span = BridgeTrace.begin();
+            backendFor(cluster).put(tableName, puts);
+            BridgeTrace.end("java.putCells.write", span);
+            return puts.size();
+        } catch (IOException e) {
+            BridgeLog.error("【HBase操作】批量写入失败，表名: " + tableName, e);
+            return -1;
+        }
+    }
+
     public static String executeCommand(String tableName, String command, String rowKey, String family, String qualifier, String value) {
         try {
-            System.out.println("【HBase操作】开始执行命令...");
-            System.out.println("【HBase操作】表名: " + tableName);
-            System.out.println("【HBase操作】命令: " + command);
-            System.out.println("【HBase操作】行键: " + rowKey);
-            System.out.println("【HBase操作】列族: " + family);
-            System.out.println("【HBase操作】列限定符: " + qualifier);
-            System.out.println("【HBase操作】值: " + value);
+            if (BridgeLog.isDebugEnabled()) {
+                BridgeLog.debug("【HBase操作】开始执行命令，表名: " + tableName + "，命令: " + command
+                        + "，行键: " + rowKey + "，列族: " + family + "，列限定符: " + qualifier);
+            }
 
-            Table table = connection.getTable(TableName.valueOf(tableName));
+            long span = BridgeTrace.begin();
             JSONObject result = new JSONObject();
 
             switch (command.toLowerCase()) {
@@ -157,26 +783,12 @@ public class HBaseBridge {
                             get.addFamily(Bytes.toBytes(family));
                         }
                     }
-                    Result getResult = table.get(get);
+                    Result getResult = PointReads.get(backend, tableName, get);
                     if (!getResult.isEmpty()) {
-                        JSONObject rowJson = new JSONObject();
-                        rowJson.put("row", Bytes.toString(getResult.getRow()));
-
-                        JSONObject familiesJson = new JSONObject();
-                        for (Map.Entry<byte[], NavigableMap<byte[], byte[]>> familyEntry : getResult.getNoVersionMap().entrySet()) {
-                            String fam = Bytes.toString(familyEntry.getKey());
-                            JSONObject qualifiersJson = new JSONObject();
-
-                            for (Map.Entry<byte[], byte[]> qualifierEntry : familyEntry.getValue().entrySet()) {
-                                String qual = Bytes.toString(qualifierEntry.getKey());
-                                String val = Bytes.toString(qualifierEntry.getValue());
-                                qualifiersJson.put(qual, val);
-                            }
-
-                            familiesJson.put(fam, qualifiersJson);
+                        result.put("data", rowToJson(getResult));
+                        if (getResult.isStale()) {
+                            result.put("stale", true);
                         }
-                        rowJson.put("families", familiesJson);
-                        result.put("data", rowJson);
                     }
                     break;
 
@@ -184,7 +796,7 @@ public class HBaseBridge {
                     Put put = new Put(Bytes.toBytes(rowKey));
                     if (family != null && !family.isEmpty() && qualifier != null && !qualifier.isEmpty() && value != null) {
                         put.addColumn(Bytes.toBytes(family), Bytes.toBytes(qualifier), Bytes.toBytes(value));
-                        table.put(put);
+                        backend.put(tableName, Collections.singletonList(put));
                         result.put("status", "success");
                     } else {
                         result.put("status", "error");
@@ -201,7 +813,7 @@ public class HBaseBridge {
                             delete.addFamily(Bytes.toBytes(family));
                         }
                     }
-                    table.delete(delete);
+                    backend.delete(tableName, Collections.singletonList(delete));
                     result.put("status", "success");
                     break;
 
@@ -210,12 +822,11 @@ public class HBaseBridge {
                     result.put("message", "Unsupported command: " + command);
             }
 
-            table.close();
-            System.out.println("【HBase操作】命令执行完成");
+            BridgeTrace.end("java.executeCommand", span);
+            BridgeLog.debug("【HBase操作】命令执行完成");
             return result.toString();
         } catch (IOException e) {
-            System.err.println("【HBase操作】命令执行失败: " + e.getMessage());
-            e.printStackTrace();
+            BridgeLog.error("【HBase操作】命令执行失败", e);
             JSONObject errorResult = new JSONObject();
             errorResult.put("status", "error");
             errorResult.put("message", e.getMessage());
@@ -0,0 +1,136 @@
+package com.hbasegui.bridge;
+
+import org.apache.hadoop.conf.Configuration;
+import org.apache.hadoop.hbase.HBaseConfiguration;
+import org.apache.hadoop.hbase.HRegionLocation;
+import org.apache.hadoop.hbase.TableName;
+import org.apache.hadoop.hbase.client.*;
+import org.apache.hadoop.hbase.client.metrics.ScanMetrics;
+import org.apache.hadoop.hbase.util.Bytes;
+
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * 访问真实HBase集群的后端
+ */
+final class HBaseTableBackend implements TableBackend {
+    private final Connection connection;
+    private final Admin admin;
+
+    private HBaseTableBackend(Connection connection, Admin admin) {
+        this.connection = connection;
+        this.admin = admin;
+    }
+
+    static HBaseTableBackend open(String zkQuorum, String zkNode) throws IOException {
+        Configuration config = HBaseConfiguration.create();
+        config.set("hbase.zookeeper.quorum", zkQuorum);
+        config.set("zookeeper.znode.parent", zkNode);
+
+        Connection connection = ConnectionFactory.createConnection(config);
+        return new HBaseTableBackend(connection, connection.getAdmin());
+    }
+
+    @Override
+    public List<String> listTables() throws IOException {
+        List<String> tableNames = new ArrayList<>();
+        for (TableName tableName : admin.listTableNames()) {
+            tableNames.add(tableName.getNameAsString());
+        }
+        return tableNames;
+    }
+
+    @Override
+    public List<Region> getRegions(String tableName) throws IOException {
+        List<Region> regions = new ArrayList<>();
+        try (RegionLocator locator = connection.getRegionLocator(TableName.valueOf(tableName))) {
+            for (HRegionLocation location : locator.getAllRegionLocations()) {
+                RegionInfo info = location.getRegion();
+                String server = location.getServerName() != null ? location.getServerName().toString() : "";
+                regions.add(new Region(info.getStartKey(), info.getEndKey(), server));
+            }
+        }
+        return regions;
+    }
+
+    @Override
+    public List<String> getFamilies(String tableName) throws IOException {
+        List<String> families = new ArrayList<>();
+        // getColumnFamilyNames按字节序返回
+        for (byte[] family : admin.getDescriptor(TableName.valueOf(tableName)).getColumnFamilyNames()) {
+            families.add(Bytes.toString(family));
+        }
+        return families;
+    }
+
+    @Override
+    public ResultScanner getScanner(String tableName, Scan scan) throws IOException {
+        final Table table = connection.getTable(TableName.valueOf(tableName));
+        final ResultScanner scanner;
+        try {
+            scanner = table.getScanner(scan);
+        } catch (IOException e) {
+            table.close();
+            throw e;
+        }
+        // 关闭扫描器时一并关闭Table
+        return new ResultScanner() {
+            @Override
+            public Result next() throws IOException {
+                return scanner.next();
+            }
+
+            @Override
+            public void close() {
+                scanner.close();
+                try {
+                    table.close();
+                } catch (IOException e) {
+                    BridgeLog.error("【HBase操作】关闭表失败", e);
+                }
+            }
+
+            @Override
+            public boolean renewLease() {
+                return scanner.renewLease();
+            }
+
+            @Override
+            public ScanMetrics getScanMetrics() {
+                return scanner.getScanMetrics();
+            }
+        };
+    }
+
+    @Override
+    public Result get(String tableName, Get get) throws IOException {
+        try (Table table = connection.getTable(TableName.valueOf(tableName))) {
+            return table.get(get);
+        }
+    }
+
+    @Override
+    public void put(String tableName, List<Put> puts) throws IOException {
+        try (Table table = connection.getTable(TableName.valueOf(tableName))) {
+            table.put(puts);
+        }
+    }
+
+    @Override
+    public void delete(String tableName, List<Delete> deletes) throws IOException {
+        try (Table table = connection.getTable(TableName.valueOf(tableName))) {
+            table.delete(deletes);
+        }
+    }
+
+    @Override
+    public void close() throws IOException {
+        try {
+            admin.close();
+        } finally {
+            connection.close();
+        }
+    }
+}
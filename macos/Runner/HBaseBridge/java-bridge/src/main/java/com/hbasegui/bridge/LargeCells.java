@@ -0,0 +1,83 @@
+package com.hbasegui.bridge;
+
+import org.apache.hadoop.hbase.client.Get;
+import org.apache.hadoop.hbase.client.Result;
+import org.apache.hadoop.hbase.util.Bytes;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * 大值的预览阈值与按需读取。
+ * HBase的Get总是返回整个值，打开时取一次并保留到关闭，C++层随后按偏移分块复制到自己的缓冲区或文件。
+ */
+final class LargeCells {
+    private static final ConcurrentHashMap<Long, byte[]> OPEN = new ConcurrentHashMap<>();
+    private static final AtomicLong NEXT_ID = new AtomicLong(1);
+
+    /** 浏览接口中值的预览字节数，0表示不截断（默认，调用setValuePreview后生效） */
+    static volatile int previewBytes = 0;
+
+    private LargeCells() {
+    }
+
+    /**
+     * 值[offset, offset+length)按preview截断后的长度：截断点落在UTF-8多字节字符中间时退到该字符之前，
+     * 最多退3字节（非UTF-8的二进制值不会因此缩短太多）
+     */
+    static int previewLength(byte[] value, int offset, int length, int preview) {
+        if (preview <= 0 || length <= preview) {
+            return length;
+        }
+        int cut = preview;
+        while (cut > 0 && preview - cut < 3 && (value[offset + cut] & 0xC0) == 0x80) {
+            cut--;
+        }
+        return (value[offset + cut] & 0xC0) == 0x80 ? preview : cut;
+    }
+
+    /** 读取family:qualifier的最新版本，返回单元格ID，不存在时返回0 */
+    static long open(TableBackend backend, String tableName, String rowKey, String family, String qualifier)
+            throws IOException {
+        byte[] familyBytes = Bytes.toBytes(family);
+        byte[] qualifierBytes = Bytes.toBytes(qualifier);
+        Get get = new Get(Bytes.toBytes(rowKey));
+        get.addColumn(familyBytes, qualifierBytes);
+        Result result = backend.get(tableName, get);
+        byte[] value = result.getValue(familyBytes, qualifierBytes);
+        if (value == null) {
+            return 0;
+        }
+        long id = NEXT_ID.getAndIncrement();
+        OPEN.put(id, value);
+        BridgeLog.debug("【单元格】打开 " + tableName + " " + rowKey + " " + family + ":" + qualifier
+                + "，" + value.length + " 字节");
+        return id;
+    }
+
+    /** 单元格的完整长度，未打开时返回-1 */
+    static long length(long id) {
+        byte[] value = OPEN.get(id);
+        return value != null ? value.length : -1;
+    }
+
+    /** 从offset开始复制到target（从position起，最多remaining字节），返回复制的字节数，未打开时返回-1 */
+    static int read(long id, long offset, ByteBuffer target) {
+        byte[] value = OPEN.get(id);
+        if (value == null) {
+            return -1;
+        }
+        if (offset >= value.length) {
+            return 0;
+        }
+        int count = (int) Math.min(target.remaining(), value.length - offset);
+        target.put(value, (int) offset, count);
+        return count;
+    }
+
+    static void close(long id) {
+        OPEN.remove(id);
+    }
+}
@@ -0,0 +1,630 @@
+package com.hbasegui.bridge;
+
+import org.apache.hadoop.hbase.Cell;
+import org.apache.hadoop.hbase.CellComparator;
+import org.apache.hadoop.hbase.CellUtil;
+import org.apache.hadoop.hbase.HConstants;
+import org.apache.hadoop.hbase.KeyValue;
+import org.apache.hadoop.hbase.client.Delete;
+import org.apache.hadoop.hbase.client.Get;
+import org.apache.hadoop.hbase.client.Put;
+import org.apache.hadoop.hbase.client.Result;
+import org.apache.hadoop.hbase.client.ResultScanner;
+import org.apache.hadoop.hbase.client.Scan;
+import org.apache.hadoop.hbase.client.metrics.ScanMetrics;
+import org.apache.hadoop.hbase.filter.Filter;
+import org.apache.hadoop.hbase.io.TimeRange;
+import org.apache.hadoop.hbase.util.Bytes;
+
+import java.io.IOException;
+import java.io.InterruptedIOException;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Map;
+import java.util.NavigableSet;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentSkipListMap;
+import java.util.concurrent.ConcurrentSkipListSet;
+import java.util.concurrent.ThreadLocalRandom;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * 进程内的HBase替身后端，供测试与基准测试使用，不需要ZooKeeper与集群。
+ *
+ * 地址格式：memory://名称?splitRows=100000&amp;latencyMs=1&amp;jitterMs=0&amp;versions=1&amp;caching=100
+ * <ul>
+ *   <li>同名地址共享同一份数据，可以模拟多个集群（例如 memory://prod 与 memory://dr）</li>
+ *   <li>splitRows：Region行数超过该值时按中位行键分裂，模拟真实的Region切分</li>
+ *   <li>splits：预分区的切分键，逗号分隔（Bytes.toStringBinary格式）</li>
+ *   <li>latencyMs/jitterMs：每次模拟RPC注入的固定延迟与随机抖动</li>
+ *   <li>versions：每列保留的版本数，与列族VERSIONS属性含义相同</li>
+ * </ul>
+ * 数据按HBase的Cell顺序保存在跳表中，扫描支持起止行、列投影、时间范围、多版本、
+ * 过滤器、批量（部分行）、反向扫描以及行数限制。
+ */
+final class MemoryTableBackend implements TableBackend {
+    static final String SCHEME = "memory://";
+
+    private static final int DEFAULT_CACHING = 100;
+    private static final ConcurrentHashMap<String, Cluster> CLUSTERS = new ConcurrentHashMap<>();
+
+    private final Cluster cluster;
+
+    private MemoryTableBackend(Cluster cluster) {
+        this.cluster = cluster;
+    }
+
+    static MemoryTableBackend open(String address) {
+        String rest = address.substring(SCHEME.length());
+        String name = rest;
+        Map<String, String> params = new HashMap<>();
+        int query = rest.indexOf('?');
+        if (query >= 0) {
+            name = rest.substring(0, query);
+            for (String pair : rest.substring(query + 1).split("&")) {
+                int eq = pair.indexOf('=');
+                if (eq > 0) {
+                    params.put(pair.substring(0, eq), pair.substring(eq + 1));
+                }
+            }
+        }
+        final Map<String, String> options = params;
+        Cluster cluster = CLUSTERS.computeIfAbsent(name, key -> new Cluster(options));
+        // 再次连接同名集群时允许调整延迟等参数
+        cluster.configure(params);
+        BridgeLog.info("【内存后端】连接内存集群: " + name);
+        return new MemoryTableBackend(cluster);
+    }
+
+    /** 一个内存“集群”，包含若干张表和注入延迟的配置 */
+    private static final class Cluster {
+        final ConcurrentHashMap<String, MemoryTable> tables = new ConcurrentHashMap<>();
+        volatile long splitRows = 100000;
+        volatile long latencyMicros = 0;
+        volatile long jitterMicros = 0;
+        volatile int versions = 1;
+        volatile int caching = DEFAULT_CACHING;
+        volatile List<byte[]> presplit = Collections.emptyList();
+
+        Cluster(Map<String, String> params) {
+            configure(params);
+        }
+
+        void configure(Map<String, String> params) {
+            if (params.containsKey("splitRows")) {
+                splitRows = Math.max(1, Long.parseLong(params.get("splitRows")));
+            }
+            if (params.containsKey("latencyMs")) {
+                latencyMicros = (long) (Double.parseDouble(params.get("latencyMs")) * 1000);
+            }
+            if (params.containsKey("jitterMs")) {
+                jitterMicros = (long) (Double.parseDouble(params.get("jitterMs")) * 1000);
+            }
+            if (params.containsKey("versions")) {
+                versions = Math.max(1, Integer.parseInt(params.get("versions")));
+            }
+            if (params.containsKey("caching")) {
+                caching = Math.max(1, Integer.parseInt(params.get("caching")));
+            }
+            if (params.containsKey("splits")) {
+                List<byte[]> keys = new ArrayList<>();
+                for (String key : params.get("splits").split(",")) {
+                    if (!key.isEmpty()) {
+                        keys.add(Bytes.toBytesBinary(key));
+                    }
+                }
+                presplit = keys;
+            }
+        }
+
+        MemoryTable table(String name, boolean create) throws IOException {
+            MemoryTable table = tables.get(name);
+            if (table == null) {
+                if (!create) {
+                    throw new IOException("Table not found: " + name);
+                }
+                // 与真实集群不同，写入不存在的表时自动建表，方便生成测试数据
+                table = tables.computeIfAbsent(name, key -> new MemoryTable(key, presplit));
+            }
+            return table;
+        }
+
+        /** 模拟一次RPC的网络与服务端耗时 */
+        void rpc() throws IOException {
+            long micros = latencyMicros;
+            if (jitterMicros > 0) {
+                micros += ThreadLocalRandom.current().nextLong(jitterMicros + 1);
+            }
+            if (micros <= 0) {
+                return;
+            }
+            try {
+                Thread.sleep(micros / 1000, (int) (micros % 1000) * 1000);
+            } catch (InterruptedException e) {
+                Thread.currentThread().interrupt();
+                throw new InterruptedIOException("Interrupted during simulated RPC");
+            }
+        }
+    }
+
+    /** 一张内存表：所有Cell按CellComparator排序，Region只是行键空间上的切分点 */
+    private static final class MemoryTable {
+        final String name;
+        final ConcurrentSkipListSet<Cell> cells = new ConcurrentSkipListSet<>(CellComparator.getInstance());
+        // 内存表没有建表时声明的列族，记录写入过的列族（按字节序）
+        final ConcurrentSkipListSet<byte[]> families = new ConcurrentSkipListSet<>(Bytes.BYTES_COMPARATOR);
+        // Region起始键 -> 该Region的大致行数（第一个Region起始键为空数组）
+        final ConcurrentSkipListMap<byte[], AtomicLong> regions = new ConcurrentSkipListMap<>(Bytes.BYTES_COMPARATOR);
+
+        MemoryTable(String name, List<byte[]> presplit) {
+            this.name = name;
+            regions.put(HConstants.EMPTY_START_ROW, new AtomicLong());
+            for (byte[] key : presplit) {
+                regions.put(key, new AtomicLong());
+            }
+        }
+
+        byte[] regionStart(byte[] row) {
+            return regions.floorKey(row);
+        }
+
+        /** 行所在Region的结束键，最后一个Region返回空数组 */
+        byte[] regionEnd(byte[] row) {
+            byte[] end = regions.higherKey(row);
+            return end != null ? end : HConstants.EMPTY_END_ROW;
+        }
+
+        boolean rowExists(byte[] row) {
+            Cell first = cells.ceiling(firstOnRow(row));
+            return first != null && CellUtil.matchingRows(first, row);
+        }
+
+        void maybeSplit(byte[] row, long splitRows) {
+            byte[] start = regionStart(row);
+            AtomicLong count = regions.get(start);
+            if (count == null || count.get() <= splitRows) {
+                return;
+            }
+            synchronized (this) {
+                if (count.get() <= splitRows) {
+                    return;
+                }
+                byte[] end = regionEnd(row);
+                NavigableSet<Cell> range = end.length == 0
+                        ? cells.tailSet(firstOnRow(start), true)
+                        : cells.subSet(firstOnRow(start), true, firstOnRow(end), false);
+                List<byte[]> rows = new ArrayList<>();
+                byte[] previous = null;
+                for (Cell cell : range) {
+                    if (previous == null || !CellUtil.matchingRows(cell, previous)) {
+                        previous = CellUtil.cloneRow(cell);
+                        rows.add(previous);
+                    }
+                }
+                if (rows.size() < 2) {
+                    return;
+                }
+                byte[] middle = rows.get(rows.size() / 2);
+                count.set(rows.size() / 2);
+                regions.put(middle, new AtomicLong(rows.size() - rows.size() / 2));
+                BridgeLog.debug("【内存后端】表 " + name + " 在行 " + Bytes.toStringBinary(middle) + " 处分裂Region");
+            }
+        }
+    }
+
+    private static KeyValue firstOnRow(byte[] row) {
+        return new KeyValue(row, null, null, HConstants.LATEST_TIMESTAMP, KeyValue.Type.Maximum);
+    }
+
+    private static KeyValue lastOnRow(byte[] row) {
+        return new KeyValue(row, null, null, HConstants.OLDEST_TIMESTAMP, KeyValue.Type.Minimum);
+    }
+
+    private static KeyValue firstOnColumn(byte[] row, byte[] family, byte[] qualifier) {
+        return new KeyValue(row, family, qualifier, HConstants.LATEST_TIMESTAMP, KeyValue.Type.Maximum);
+    }
+
+    private static KeyValue lastOnColumn(byte[] row, byte[] family, byte[] qualifier) {
+        return new KeyValue(row, family, qualifier, HConstants.OLDEST_TIMESTAMP, KeyValue.Type.Minimum);
+    }
+
+    @Override
+    public List<String> listTables() throws IOException {
+        cluster.rpc();
+        List<String> names = new ArrayList<>(cluster.tables.keySet());
+        Collections.sort(names);
+        return names;
+    }
+
+    @Override
+    public List<Region> getRegions(String tableName) throws IOException {
+        cluster.rpc();
+        MemoryTable table = cluster.table(tableName, false);
+        List<Region> result = new ArrayList<>();
+        List<byte[]> starts = new ArrayList<>(table.regions.keySet());
+        for (int i = 0; i < starts.size(); i++) {
+            byte[] end = i + 1 < starts.size() ? starts.get(i + 1) : HConstants.EMPTY_END_ROW;
+            result.add(new Region(starts.get(i), end, "memory-rs" + (i % 3) + ",16020,0"));
+        }
+        return result;
+    }
+
+    @Override
+    public List<String> getFamilies(String tableName) throws IOException {
+        cluster.rpc();
+        List<String> result = new ArrayList<>();
+        for (byte[] family : cluster.table(tableName, false).families) {
+            result.add(Bytes.toString(family));
+        }
+        return result;
+    }
+
+    @Override
+    public ResultScanner getScanner(String tableName, Scan scan) throws IOException {
+        return new MemoryScanner(cluster, cluster.table(tableName, false), scan);
+    }
+
+    @Override
+    public Result get(String tableName, Get get) throws IOException {
+        cluster.rpc();
+        MemoryTable table = cluster.table(tableName, false);
+        Scan scan = new Scan(get);
+        List<Cell> rowCells = new ArrayList<>(table.cells.subSet(firstOnRow(get.getRow()), true,
+                lastOnRow(get.getRow()), true));
+        List<Cell> kept = applyScan(scan, rowCells);
+        return kept == null || kept.isEmpty() ? Result.EMPTY_RESULT : Result.create(kept);
+    }
+
+    @Override
+    public void put(String tableName, List<Put> puts) throws IOException {
+        cluster.rpc();
+        MemoryTable table = cluster.table(tableName, true);
+        long now = System.currentTimeMillis();
+        for (Put put : puts) {
+            byte[] row = put.getRow();
+            boolean newRow = !table.rowExists(row);
+            for (byte[] family : put.getFamilyCellMap().keySet()) {
+                table.families.add(family);
+            }
+            for (List<Cell> familyCells : put.getFamilyCellMap().values()) {
+                for (Cell cell : familyCells) {
+                    long ts = cell.getTimestamp() == HConstants.LATEST_TIMESTAMP ? now : cell.getTimestamp();
+                    KeyValue kv = new KeyValue(row, CellUtil.cloneFamily(cell), CellUtil.cloneQualifier(cell),
+                            ts, KeyValue.Type.Put, CellUtil.cloneValue(cell));
+                    // 同一时间戳的写入覆盖旧值
+                    table.cells.remove(kv);
+                    table.cells.add(kv);
+                    trimVersions(table, kv);
+                }
+            }
+            if (newRow) {
+                table.regions.floorEntry(row).getValue().incrementAndGet();
+                table.maybeSplit(row, cluster.splitRows);
+            }
+        }
+    }
+
+    /** 每列只保留最新的versions个版本 */
+    private void trimVersions(MemoryTable table, KeyValue kv) {
+        byte[] row = CellUtil.cloneRow(kv);
+        byte[] family = CellUtil.cloneFamily(kv);
+        byte[] qualifier = CellUtil.cloneQualifier(kv);
+        NavigableSet<Cell> column = table.cells.subSet(firstOnColumn(row, family, qualifier), true,
+                lastOnColumn(row, family, qualifier), true);
+        int seen = 0;
+        Iterator<Cell> it = column.iterator();
+        while (it.hasNext()) {
+            it.next();
+            if (++seen > cluster.versions) {
+                it.remove();
+            }
+        }
+    }
+
+    @Override
+    public void delete(String tableName, List<Delete> deletes) throws IOException {
+        cluster.rpc();
+        MemoryTable table = cluster.table(tableName, false);
+        for (Delete delete : deletes) {
+            byte[] row = delete.getRow();
+            boolean existed = table.rowExists(row);
+            NavigableSet<Cell> rowCells = table.cells.subSet(firstOnRow(row), true, lastOnRow(row), true);
+            if (delete.getFamilyCellMap().isEmpty()) {
+                // 删除整行
+                rowCells.clear();
+            } else {
+                for (List<Cell> markers : delete.getFamilyCellMap().values()) {
+                    for (Cell marker : markers) {
+                        applyDeleteMarker(rowCells, marker);
+                    }
+                }
+            }
+            if (existed && !table.rowExists(row)) {
+                table.regions.floorEntry(row).getValue().decrementAndGet();
+            }
+        }
+    }
+
+    private static void applyDeleteMarker(NavigableSet<Cell> rowCells, Cell marker) {
+        byte[] family = CellUtil.cloneFamily(marker);
+        long ts = marker.getTimestamp();
+        Cell.Type type = marker.getType();
+        Iterator<Cell> it = rowCells.iterator();
+        boolean deletedLatest = false;
+        while (it.hasNext()) {
+            Cell cell = it.next();
+            if (!CellUtil.matchingFamily(cell, family)) {
+                continue;
+            }
+            if (type == Cell.Type.DeleteFamily) {
+                if (cell.getTimestamp() <= ts) {
+                    it.remove();
+                }
+            } else if (CellUtil.matchingQualifier(cell, marker)) {
+                if (type == Cell.Type.DeleteColumn) {
+                    if (cell.getTimestamp() <= ts) {
+                        it.remove();
+                    }
+                } else if (ts == HConstants.LATEST_TIMESTAMP) {
+                    // Delete.addColumn不带时间戳：只删除最新版本
+                    if (!deletedLatest) {
+                        it.remove();
+                        deletedLatest = true;
+                    }
+                } else if (cell.getTimestamp() == ts) {
+                    it.remove();
+                }
+            }
+        }
+    }
+
+    @Override
+    public void close() {
+        // 数据保留在进程内，便于后续同名连接继续使用
+    }
+
+    /**
+     * 按Scan的列投影、时间范围、版本数与过滤器处理一行的Cell。
+     * 返回null表示整行被过滤器排除。
+     */
+    private static List<Cell> applyScan(Scan scan, List<Cell> rowCells) throws IOException {
+        if (rowCells.isEmpty()) {
+            return rowCells;
+        }
+        Map<byte[], NavigableSet<byte[]>> familyMap = scan.getFamilyMap();
+        TimeRange timeRange = scan.getTimeRange();
+        int maxVersions = scan.getMaxVersions();
+        Filter filter = scan.getFilter();
+
+        if (filter != null) {
+            filter.reset();
+            if (filter.filterRowKey(rowCells.get(0))) {
+                return null;
+            }
+        }
+
+        List<Cell> kept = new ArrayList<>();
+        Cell previous = null;
+        int versionsOfColumn = 0;
+        boolean skipColumn = false;
+        for (Cell cell : rowCells) {
+            boolean sameColumn = previous != null && CellUtil.matchingColumn(cell, previous);
+            if (!sameColumn) {
+                versionsOfColumn = 0;
+                skipColumn = false;
+            }
+            previous = cell;
+            if (skipColumn || !inFamilyMap(familyMap, cell) || !timeRange.withinTimeRange(cell.getTimestamp())) {
+                continue;
+            }
+            if (versionsOfColumn >= maxVersions) {
+                continue;
+            }
+            if (filter != null) {
+                Filter.ReturnCode code = filter.filterCell(cell);
+                if (code == Filter.ReturnCode.NEXT_ROW) {
+                    break;
+                }
+                if (code == Filter.ReturnCode.SKIP || code == Filter.ReturnCode.SEEK_NEXT_USING_HINT) {
+                    continue;
+                }
+                if (code == Filter.ReturnCode.NEXT_COL) {
+                    skipColumn = true;
+                    continue;
+                }
+                kept.add(filter.transformCell(cell));
+                versionsOfColumn++;
+                if (code == Filter.ReturnCode.INCLUDE_AND_NEXT_COL) {
+                    skipColumn = true;
+                } else if (code == Filter.ReturnCode.INCLUDE_AND_SEEK_NEXT_ROW) {
+                    break;
+                }
+            } else {
+                kept.add(cell);
+                versionsOfColumn++;
+            }
+        }
+
+        if (filter != null) {
+            filter.filterRowCells(kept);
+            if (filter.hasFilterRow() && filter.filterRow()) {
+                return null;
+            }
+        }
+        return kept;
+    }
+
+    private static boolean inFamilyMap(Map<byte[], NavigableSet<byte[]>> familyMap, Cell cell) {
+        if (familyMap == null || familyMap.isEmpty()) {
+            return true;
+        }
+        for (Map.Entry<byte[], NavigableSet<byte[]>> entry : familyMap.entrySet()) {
+            if (!CellUtil.matchingFamily(cell, entry.getKey())) {
+                continue;
+            }
+            NavigableSet<byte[]> qualifiers = entry.getValue();
+            if (qualifiers == null || qualifiers.isEmpty()) {
+                return true;
+            }
+            for (byte[] qualifier : qualifiers) {
+                if (CellUtil.matchingQualifier(cell, qualifier)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * 内存扫描器：每取caching行、或跨越Region边界时模拟一次RPC
+     */
+    private static final class MemoryScanner implements ResultScanner {
+        private final Cluster cluster;
+        private final MemoryTable table;
+        private final Scan scan;
+        private final Iterator<Cell> cells;
+        private final int caching;
+        private final int batch;
+        private final int limit;
+
+        private Cell pending;
+        private byte[] currentRegion;
+        private int rowsInRpc;
+        private int rowsReturned;
+        private boolean finished;
+        private final List<Result> partials = new ArrayList<>();
+
+        MemoryScanner(Cluster cluster, MemoryTable table, Scan scan) {
+            this.cluster = cluster;
+            this.table = table;
+            this.scan = scan;
+            this.caching = scan.getCaching() > 0 ? scan.getCaching() : cluster.caching;
+            this.batch = scan.getBatch();
+            this.limit = scan.getLimit();
+
+            byte[] start = scan.getStartRow();
+            if (scan.isReversed()) {
+                NavigableSet<Cell> range = start.length == 0
+                        ? table.cells.descendingSet()
+                        : table.cells.headSet(scan.includeStartRow() ? lastOnRow(start) : firstOnRow(start),
+                                scan.includeStartRow()).descendingSet();
+                this.cells = range.iterator();
+            } else {
+                NavigableSet<Cell> range = start.length == 0
+                        ? table.cells
+                        : table.cells.tailSet(scan.includeStartRow() ? firstOnRow(start) : lastOnRow(start),
+                                scan.includeStartRow());
+                this.cells = range.iterator();
+            }
+        }
+
+        private boolean pastStopRow(Cell cell) {
+            byte[] stop = scan.getStopRow();
+            if (stop.length == 0) {
+                return false;
+            }
+            int cmp = Bytes.compareTo(cell.getRowArray(), cell.getRowOffset(), cell.getRowLength(),
+                    stop, 0, stop.length);
+            if (scan.isReversed()) {
+                cmp = -cmp;
+            }
+            return scan.includeStopRow() ? cmp > 0 : cmp >= 0;
+        }
+
+        private List<Cell> nextRowCells() {
+            if (pending == null) {
+                if (!cells.hasNext()) {
+                    return null;
+                }
+                pending = cells.next();
+            }
+            if (pastStopRow(pending)) {
+                return null;
+            }
+            List<Cell> row = new ArrayList<>();
+            row.add(pending);
+            pending = null;
+            while (cells.hasNext()) {
+                Cell cell = cells.next();
+                if (!CellUtil.matchingRows(cell, row.get(0))) {
+                    pending = cell;
+                    break;
+                }
+                row.add(cell);
+            }
+            if (scan.isReversed()) {
+                Collections.reverse(row);
+            }
+            return row;
+        }
+
+        /** 每批caching行或进入新Region时计为一次RPC */
+        private void accountRpc(byte[] row) throws IOException {
+            byte[] start = table.regionStart(row);
+            if (currentRegion == null || !Bytes.equals(start, currentRegion) || rowsInRpc >= caching) {
+                cluster.rpc();
+                rowsInRpc = 0;
+                currentRegion = start;
+            }
+            rowsInRpc++;
+        }
+
+        @Override
+        public Result next() throws IOException {
+            if (!partials.isEmpty()) {
+                return partials.remove(0);
+            }
+            while (!finished) {
+                if (limit > 0 && rowsReturned >= limit) {
+                    finished = true;
+                    break;
+                }
+                Filter filter = scan.getFilter();
+                if (filter != null && filter.filterAllRemaining()) {
+                    finished = true;
+                    break;
+                }
+                List<Cell> rowCells = nextRowCells();
+                if (rowCells == null) {
+                    finished = true;
+                    break;
+                }
+                accountRpc(CellUtil.cloneRow(rowCells.get(0)));
+                List<Cell> kept = applyScan(scan, rowCells);
+                if (kept == null || kept.isEmpty()) {
+                    continue;
+                }
+                rowsReturned++;
+                if (batch <= 0 || kept.size() <= batch) {
+                    return Result.create(kept);
+                }
+                // 按batch把宽行拆成多个部分结果
+                for (int from = 0; from < kept.size(); from += batch) {
+                    int to = Math.min(from + batch, kept.size());
+                    partials.add(Result.create(new ArrayList<>(kept.subList(from, to)), null, false, to < kept.size()));
+                }
+                return partials.remove(0);
+            }
+            return null;
+        }
+
+        @Override
+        public void close() {
+            finished = true;
+            partials.clear();
+        }
+
+        @Override
+        public boolean renewLease() {
+            return !finished;
+        }
+
+        @Override
+        public ScanMetrics getScanMetrics() {
+            return null;
+        }
+    }
+}
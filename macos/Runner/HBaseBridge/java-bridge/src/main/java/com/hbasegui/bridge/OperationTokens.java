@@ -0,0 +1,160 @@
+package com.hbasegui.bridge;
+
+import java.io.Closeable;
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.ScheduledFuture;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * 与C++层cancel::Token对应的取消令牌（ID由C++层分配）。扫描器等资源登记在令牌下，
+ * 取消或到达截止时间时立即关闭，阻塞在RPC中的扫描也会尽快返回；之后的检查抛出 {@link AbortedException}。
+ * 令牌在第一次使用时创建，操作结束时由C++层释放。
+ */
+final class OperationTokens {
+    static final int OK = 0;
+    static final int CANCELLED = -2;
+    static final int DEADLINE_EXCEEDED = -3;
+
+    private static final ConcurrentHashMap<Long, Token> TOKENS = new ConcurrentHashMap<>();
+    private static final ScheduledExecutorService TIMER = Executors.newSingleThreadScheduledExecutor(runnable -> {
+        Thread thread = new Thread(runnable, "hbase-bridge-deadline");
+        thread.setDaemon(true);
+        return thread;
+    });
+
+    private OperationTokens() {
+    }
+
+    /** 操作被取消或超时 */
+    static final class AbortedException extends IOException {
+        final int code;
+
+        AbortedException(int code) {
+            super(code == DEADLINE_EXCEEDED ? "操作超过截止时间" : "操作已取消");
+            this.code = code;
+        }
+    }
+
+    static final class Token {
+        private volatile int status = OK;
+        private final List<Closeable> resources = new ArrayList<>();
+        private ScheduledFuture<?> deadline;
+
+        int status() {
+            return status;
+        }
+
+        void check() throws AbortedException {
+            int current = status;
+            if (current != OK) {
+                throw new AbortedException(current);
+            }
+        }
+    }
+
+    /** id<=0表示不使用令牌，返回null */
+    static Token get(long id) {
+        return id <= 0 ? null : TOKENS.computeIfAbsent(id, key -> new Token());
+    }
+
+    /** 把资源登记在令牌下；令牌已中止时立即关闭资源并抛出异常 */
+    static void attach(Token token, Closeable resource) throws AbortedException {
+        if (token == null) {
+            return;
+        }
+        synchronized (token) {
+            if (token.status == OK) {
+                token.resources.add(resource);
+                return;
+            }
+        }
+        closeQuietly(resource);
+        token.check();
+    }
+
+    static void detach(Token token, Closeable resource) {
+        if (token != null) {
+            synchronized (token) {
+                token.resources.remove(resource);
+            }
+        }
+    }
+
+    /**
+     * 中止操作并关闭登记的资源，已中止时不变。令牌不存在（还没有登记过资源或已释放）时什么都不做：
+     * 释放之后到达的取消不能重新创建令牌，否则登记永远不会被移除；还没有登记资源的操作由C++层在批次之前检查
+     */
+    static void abort(long id, int code) {
+        Token token = id <= 0 ? null : TOKENS.get(id);
+        if (token == null) {
+            return;
+        }
+        List<Closeable> toClose;
+        synchronized (token) {
+            if (token.status != OK) {
+                return;
+            }
+            token.status = code;
+            if (token.deadline != null) {
+                token.deadline.cancel(false);
+                token.deadline = null;
+            }
+            toClose = new ArrayList<>(token.resources);
+            token.resources.clear();
+        }
+        BridgeLog.info("【操作】" + id + (code == DEADLINE_EXCEEDED ? " 超过截止时间" : " 已取消")
+                + "，关闭 " + toClose.size() + " 个扫描");
+        for (Closeable resource : toClose) {
+            closeQuietly(resource);
+        }
+    }
+
+    /**
+     * 从现在起timeoutMs毫秒后中止，<=0取消已有的截止时间。
+     * 带截止时间的操作在打开第一个扫描之前就设置定时器，所以要设置截止时间时令牌不存在则创建；
+     * 取消截止时间时令牌不存在则什么都不做。C++层释放令牌之后不再调用这里（见cancel_token.cpp）
+     */
+    static void setDeadline(long id, long timeoutMs) {
+        if (id <= 0) {
+            return;
+        }
+        Token token = timeoutMs > 0 ? get(id) : TOKENS.get(id);
+        if (token == null) {
+            return;
+        }
+        synchronized (token) {
+            if (token.deadline != null) {
+                token.deadline.cancel(false);
+                token.deadline = null;
+            }
+            if (timeoutMs > 0 && token.status == OK) {
+                token.deadline = TIMER.schedule(() -> abort(id, DEADLINE_EXCEEDED), timeoutMs, TimeUnit.MILLISECONDS);
+            }
+        }
+    }
+
+    static void release(long id) {
+        Token token = TOKENS.remove(id);
+        if (token != null) {
+            synchronized (token) {
+                if (token.deadline != null) {
+                    token.deadline.cancel(false);
+                    token.deadline = null;
+                }
+            }
+        }
+    }
+
+    private static void closeQuietly(Closeable resource) {
+        try {
+            resource.close();
+        } catch (IOException | RuntimeException e) {
+            BridgeLog.debug("【操作】关闭资源失败: " + e);
+        }
+    }
+}
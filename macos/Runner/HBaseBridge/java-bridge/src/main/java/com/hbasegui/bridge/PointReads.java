@@ -0,0 +1,257 @@
+package com.hbasegui.bridge;
+
+import org.apache.hadoop.hbase.DoNotRetryIOException;
+import org.apache.hadoop.hbase.client.Consistency;
+import org.apache.hadoop.hbase.client.Get;
+import org.apache.hadoop.hbase.client.Result;
+import org.json.JSONObject;
+
+import java.io.IOException;
+import java.io.InterruptedIOException;
+import java.util.Arrays;
+import java.util.concurrent.Callable;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.FutureTask;
+import java.util.concurrent.LinkedBlockingQueue;
+import java.util.concurrent.ThreadLocalRandom;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * 单行读取（get）的对冲与重试。默认都关闭，即直接读主副本一次。
+ * 开启后：主副本请求超过对冲阈值（近期主副本延迟的百分位数，不低于minHedgeMs）仍未返回时，
+ * 再向只读副本发一个timeline一致性的请求，先成功的结果胜出，另一个被取消；
+ * 两条路径都失败时按指数退避（带随机抖动）重试，最多maxRetries次。
+ * 副本返回的结果可能落后于主副本（Result.isStale()），统计中单独计数。
+ * 表没有开启Region副本时对冲请求会失败，此时只等待主副本。
+ */
+final class PointReads {
+    // 近期主副本延迟（微秒）的环形窗口，用于计算对冲阈值
+    private static final int WINDOW = 1024;
+    // 样本不足时使用的阈值
+    private static final int MIN_SAMPLES = 20;
+    private static final long INITIAL_HEDGE_MICROS = 50_000;
+
+    private static volatile boolean hedgeEnabled = false;
+    private static volatile int percentile = 95;
+    private static volatile long minHedgeMicros = 5_000;
+    private static volatile int maxRetries = 0;
+    private static volatile long backoffMillis = 50;
+    private static volatile long maxBackoffMillis = 1000;
+
+    private static final long[] primaryLatencies = new long[WINDOW];
+    private static long primarySamples = 0;
+    private static volatile long hedgeThresholdMicros = INITIAL_HEDGE_MICROS;
+
+    private static final long[] totalLatencies = new long[WINDOW];
+    private static long totalSamples = 0;
+
+    private static final AtomicLong requests = new AtomicLong();
+    private static final AtomicLong primaryWins = new AtomicLong();
+    private static final AtomicLong replicaWins = new AtomicLong();
+    private static final AtomicLong hedged = new AtomicLong();
+    private static final AtomicLong staleResults = new AtomicLong();
+    private static final AtomicLong retries = new AtomicLong();
+    private static final AtomicLong failures = new AtomicLong();
+
+    private static final ExecutorService EXECUTOR = Executors.newCachedThreadPool(runnable -> {
+        Thread thread = new Thread(runnable, "hbase-bridge-get");
+        thread.setDaemon(true);
+        return thread;
+    });
+
+    private PointReads() {
+    }
+
+    static void configure(boolean hedge, int newPercentile, long minHedgeMs, int newMaxRetries,
+                          long newBackoffMs, long newMaxBackoffMs) {
+        percentile = Math.max(1, Math.min(99, newPercentile));
+        minHedgeMicros = Math.max(0, minHedgeMs) * 1000;
+        maxRetries = Math.max(0, newMaxRetries);
+        backoffMillis = Math.max(1, newBackoffMs);
+        maxBackoffMillis = Math.max(backoffMillis, newMaxBackoffMs);
+        hedgeEnabled = hedge;
+        synchronized (primaryLatencies) {
+            updateThreshold();
+        }
+        BridgeLog.info("【单行读取】对冲" + (hedge ? "开启" : "关闭") + "，p" + percentile + "，最多重试 " + maxRetries + " 次");
+    }
+
+    /** 读取一行；对冲或重试只影响延迟，不改变读取的内容 */
+    static Result get(TableBackend backend, String tableName, Get get) throws IOException {
+        requests.incrementAndGet();
+        long start = System.nanoTime();
+        IOException last = null;
+        for (int attempt = 0; attempt <= maxRetries; attempt++) {
+            if (attempt > 0) {
+                retries.incrementAndGet();
+                sleepBackoff(attempt);
+            }
+            try {
+                Result result = hedgeEnabled ? hedgedGet(backend, tableName, get) : primaryGet(backend, tableName, get);
+                record(totalLatencies, (System.nanoTime() - start) / 1000, false);
+                return result;
+            } catch (DoNotRetryIOException e) {
+                failures.incrementAndGet();
+                throw e;
+            } catch (InterruptedIOException e) {
+                failures.incrementAndGet();
+                throw e;
+            } catch (IOException e) {
+                last = e;
+                BridgeLog.debug("【单行读取】第 " + (attempt + 1) + " 次失败，表名: " + tableName + "，" + e);
+            }
+        }
+        failures.incrementAndGet();
+        throw last;
+    }
+
+    private static Result primaryGet(TableBackend backend, String tableName, Get get) throws IOException {
+        long start = System.nanoTime();
+        Result result = backend.get(tableName, get);
+        record(primaryLatencies, (System.nanoTime() - start) / 1000, true);
+        primaryWins.incrementAndGet();
+        return result;
+    }
+
+    private static Result hedgedGet(TableBackend backend, String tableName, Get get) throws IOException {
+        LinkedBlockingQueue<Future<Result>> done = new LinkedBlockingQueue<>();
+        final long start = System.nanoTime();
+        Future<Result> primary = submit(done, () -> {
+            Result result = backend.get(tableName, get);
+            record(primaryLatencies, (System.nanoTime() - start) / 1000, true);
+            return result;
+        });
+        Future<Result> replica = null;
+        try {
+            Future<Result> first = done.poll(hedgeThresholdMicros, TimeUnit.MICROSECONDS);
+            if (first == null) {
+                hedged.incrementAndGet();
+                Get replicaGet = new Get(get);
+                replicaGet.setConsistency(Consistency.TIMELINE);
+                replicaGet.setReplicaId(1);
+                replica = submit(done, () -> backend.get(tableName, replicaGet));
+                first = done.take();
+            }
+            IOException failure = null;
+            int pending = replica != null ? 2 : 1;
+            while (true) {
+                try {
+                    Result result = first.get();
+                    if (first == primary) {
+                        primaryWins.incrementAndGet();
+                    } else {
+                        replicaWins.incrementAndGet();
+                        if (result.isStale()) {
+                            staleResults.incrementAndGet();
+                        }
+                    }
+                    return result;
+                } catch (ExecutionException e) {
+                    // 副本失败（例如表没有副本）时继续等主副本，反之亦然
+                    if (failure == null || first == primary) {
+                        failure = e.getCause() instanceof IOException ? (IOException) e.getCause()
+                                : new IOException(e.getCause());
+                    }
+                }
+                if (--pending == 0) {
+                    throw failure;
+                }
+                first = done.take();
+            }
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new InterruptedIOException("单行读取被中断");
+        } finally {
+            // 副本胜出时主副本尚未返回：已等待的时间是其延迟的下限，也记入窗口，
+            // 否则阈值只反映较快完成的请求，慢请求越多对冲反而越早
+            if (primary.cancel(true)) {
+                record(primaryLatencies, (System.nanoTime() - start) / 1000, true);
+            }
+            if (replica != null) {
+                replica.cancel(true);
+            }
+        }
+    }
+
+    private static Future<Result> submit(LinkedBlockingQueue<Future<Result>> done, Callable<Result> call) {
+        // 结束时把自己放入队列，调用方按完成顺序取
+        FutureTask<Result> task = new FutureTask<Result>(call) {
+            @Override
+            protected void done() {
+                done.add(this);
+            }
+        };
+        EXECUTOR.execute(task);
+        return task;
+    }
+
+    /** 等待 min(maxBackoff, backoff*2^(attempt-1)) 的 50%~100%（随机抖动，避免重试同时到达） */
+    private static void sleepBackoff(int attempt) throws InterruptedIOException {
+        long ceiling = Math.min(maxBackoffMillis, backoffMillis << Math.min(attempt - 1, 20));
+        long sleep = ceiling / 2 + ThreadLocalRandom.current().nextLong(ceiling / 2 + 1);
+        try {
+            Thread.sleep(sleep);
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new InterruptedIOException("单行读取被中断");
+        }
+    }
+
+    private static void record(long[] window, long micros, boolean primary) {
+        synchronized (window) {
+            long samples = primary ? primarySamples++ : totalSamples++;
+            window[(int) (samples % WINDOW)] = micros;
+            // 每64个样本重新计算一次阈值
+            if (primary && samples % 64 == MIN_SAMPLES % 64) {
+                updateThreshold();
+            }
+        }
+    }
+
+    // 调用方持有primaryLatencies的锁
+    private static void updateThreshold() {
+        if (primarySamples < MIN_SAMPLES) {
+            hedgeThresholdMicros = Math.max(minHedgeMicros, INITIAL_HEDGE_MICROS);
+            return;
+        }
+        hedgeThresholdMicros = Math.max(minHedgeMicros, quantile(primaryLatencies, primarySamples, percentile));
+    }
+
+    private static long quantile(long[] window, long samples, int pct) {
+        int count = (int) Math.min(samples, WINDOW);
+        if (count == 0) {
+            return 0;
+        }
+        long[] sorted = Arrays.copyOf(window, count);
+        Arrays.sort(sorted);
+        return sorted[Math.min(count - 1, (int) ((long) count * pct / 100))];
+    }
+
+    static String statsJson() {
+        JSONObject json = new JSONObject();
+        json.put("hedge", hedgeEnabled);
+        json.put("percentile", percentile);
+        json.put("maxRetries", maxRetries);
+        json.put("hedgeThresholdMs", hedgeThresholdMicros / 1000.0);
+        json.put("requests", requests.get());
+        json.put("primaryWins", primaryWins.get());
+        json.put("replicaWins", replicaWins.get());
+        json.put("hedged", hedged.get());
+        json.put("staleResults", staleResults.get());
+        json.put("retries", retries.get());
+        json.put("failures", failures.get());
+        synchronized (totalLatencies) {
+            json.put("p50Ms", quantile(totalLatencies, totalSamples, 50) / 1000.0);
+            json.put("p95Ms", quantile(totalLatencies, totalSamples, 95) / 1000.0);
+            json.put("p99Ms", quantile(totalLatencies, totalSamples, 99) / 1000.0);
+        }
+        synchronized (primaryLatencies) {
+            json.put("primaryP95Ms", quantile(primaryLatencies, primarySamples, 95) / 1000.0);
+        }
+        return json.toString();
+    }
+}
@@ -0,0 +1,33 @@
+package com.hbasegui.bridge;
+
+/**
+ * {@link HBaseBridge#openScanner} 的扫描参数，与C++层的ScanRange一一对应，
+ * 由C++层（scanner_reader.cpp）创建后逐个字段填写。字符串为空表示不限。
+ */
+public final class ScanOptions {
+    public String tableName = "";
+    public String startRow = "";
+    public String stopRow = "";
+    /** 行键前缀，非空时取代startRow/stopRow */
+    public String prefix = "";
+    /** 每次RPC返回的行数 */
+    public int caching = 1000;
+    /** 投影列 "cf:q,cf"，在服务端过滤，不需要的列不会传到客户端 */
+    public String columns = "";
+    /** 限定在getScanSplits返回的一个切分内（十六进制的原始字节边界） */
+    public String splitStart = "";
+    public String splitStop = "";
+    /** connectPeer的集群名，空为主连接 */
+    public String cluster = "";
+    /** C++层的取消令牌ID（0为不登记），取消或超时时扫描器被立即关闭 */
+    public long token;
+    /** 每列最多返回的版本数，以及时间范围 [minTime, maxTime)（见 HBaseBridge.applyVersions） */
+    public int versions = 1;
+    public long minTime;
+    public long maxTime;
+    /** 从范围末端向前扫描 */
+    public boolean reversed;
+
+    public ScanOptions() {
+    }
+}
@@ -0,0 +1,82 @@
+package com.hbasegui.bridge;
+
+import org.apache.hadoop.hbase.client.Result;
+import org.apache.hadoop.hbase.client.ResultScanner;
+
+import java.io.IOException;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * 供C++层按批拉取的扫描会话。每次nextBatch返回一个CellCodec格式的批次，
+ * 数据不经过JSON，也不会一次性驻留在JVM中。
+ * 会话可以登记在取消令牌下（见 {@link OperationTokens}），取消时扫描器被立即关闭。
+ */
+final class ScannerSessions {
+    private static final ConcurrentHashMap<Long, Session> SESSIONS = new ConcurrentHashMap<>();
+    private static final AtomicLong NEXT_ID = new AtomicLong(1);
+
+    private ScannerSessions() {
+    }
+
+    private static final class Session {
+        final ResultScanner scanner;
+        final OperationTokens.Token token;
+        final CellCodec.Writer writer = new CellCodec.Writer(64 * 1024);
+        boolean exhausted;
+
+        Session(ResultScanner scanner, OperationTokens.Token token) {
+            this.scanner = scanner;
+            this.token = token;
+        }
+    }
+
+    /** tokenId为C++层的取消令牌ID，0为不登记 */
+    static long open(ResultScanner scanner, long tokenId) throws IOException {
+        OperationTokens.Token token = OperationTokens.get(tokenId);
+        OperationTokens.attach(token, scanner);
+        long id = NEXT_ID.getAndIncrement();
+        SESSIONS.put(id, new Session(scanner, token));
+        return id;
+    }
+
+    /** 读取至多maxRows行或约maxBytes字节，扫描结束时返回null */
+    static byte[] next(long id, int maxRows, int maxBytes) throws IOException {
+        Session session = SESSIONS.get(id);
+        if (session == null) {
+            throw new IOException("Unknown scanner: " + id);
+        }
+        // 同一会话只由一个C++线程拉取，这里的同步只是防御性的
+        synchronized (session) {
+            if (session.exhausted) {
+                return null;
+            }
+            CellCodec.Writer writer = session.writer;
+            writer.clear();
+            while (writer.rowCount() < maxRows && writer.size() < maxBytes) {
+                if (session.token != null) {
+                    session.token.check();
+                }
+                Result result = session.scanner.next();
+                if (result == null) {
+                    // 被取消关闭的扫描器也返回null，不能当作扫描结束
+                    if (session.token != null) {
+                        session.token.check();
+                    }
+                    session.exhausted = true;
+                    break;
+                }
+                writer.add(result);
+            }
+            return writer.cellCount() == 0 ? null : writer.toByteArray();
+        }
+    }
+
+    static void close(long id) {
+        Session session = SESSIONS.remove(id);
+        if (session != null) {
+            OperationTokens.detach(session.token, session.scanner);
+            session.scanner.close();
+        }
+    }
+}
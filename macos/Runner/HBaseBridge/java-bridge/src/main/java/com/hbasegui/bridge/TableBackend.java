@@ -0,0 +1,55 @@
+package com.hbasegui.bridge;
+
+import org.apache.hadoop.hbase.client.Delete;
+import org.apache.hadoop.hbase.client.Get;
+import org.apache.hadoop.hbase.client.Put;
+import org.apache.hadoop.hbase.client.Result;
+import org.apache.hadoop.hbase.client.ResultScanner;
+import org.apache.hadoop.hbase.client.Scan;
+
+import java.io.Closeable;
+import java.io.IOException;
+import java.util.List;
+
+/**
+ * 桥接层访问表数据的后端。真实集群使用 {@link HBaseTableBackend}，
+ * 以 memory:// 开头的地址使用进程内的 {@link MemoryTableBackend}，用于测试与基准测试。
+ */
+interface TableBackend extends Closeable {
+
+    /** 表的一个Region（起止键为空数组表示无界） */
+    final class Region {
+        final byte[] startKey;
+        final byte[] endKey;
+        final String server;
+
+        Region(byte[] startKey, byte[] endKey, String server) {
+            this.startKey = startKey;
+            this.endKey = endKey;
+            this.server = server;
+        }
+    }
+
+    List<String> listTables() throws IOException;
+
+    List<Region> getRegions(String tableName) throws IOException;
+
+    /** 表的列族名，按字节序排列 */
+    List<String> getFamilies(String tableName) throws IOException;
+
+    ResultScanner getScanner(String tableName, Scan scan) throws IOException;
+
+    Result get(String tableName, Get get) throws IOException;
+
+    void put(String tableName, List<Put> puts) throws IOException;
+
+    void delete(String tableName, List<Delete> deletes) throws IOException;
+
+    /** 根据连接地址选择后端 */
+    static TableBackend open(String zkQuorum, String zkNode) throws IOException {
+        if (zkQuorum != null && zkQuorum.startsWith(MemoryTableBackend.SCHEME)) {
+            return MemoryTableBackend.open(zkQuorum);
+        }
+        return HBaseTableBackend.open(zkQuorum, zkNode);
+    }
+}
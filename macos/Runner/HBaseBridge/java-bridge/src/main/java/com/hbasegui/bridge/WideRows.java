@@ -0,0 +1,120 @@
+package com.hbasegui.bridge;
+
+import org.apache.hadoop.hbase.Cell;
+import org.apache.hadoop.hbase.CellUtil;
+import org.apache.hadoop.hbase.client.Result;
+import org.apache.hadoop.hbase.client.ResultScanner;
+import org.apache.hadoop.hbase.client.Scan;
+import org.apache.hadoop.hbase.filter.ColumnPaginationFilter;
+import org.apache.hadoop.hbase.util.Bytes;
+import org.json.JSONArray;
+import org.json.JSONObject;
+
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * 宽行（一行有大量列）按列分页读取。
+ * 每页是对单行的一次扫描：addFamily限定列族，ColumnPaginationFilter从游标之后取limit+1列
+ * （多取的一列只用来判断是否还有下一页），setBatch/setAllowPartialResults让服务端按块返回，
+ * 整行不会一次性物化在一个Result中。
+ * 游标为 "列族:列名"（列名为Bytes.toStringBinary格式，列族名不能含冒号），表示上一页的最后一列。
+ * 不指定列族时按表的列族顺序逐个列族读取。
+ */
+final class WideRows {
+    /** getTableData等整行返回的接口中每行最多返回的列数，超出部分通过游标分页读取 */
+    static final int ROW_COLUMNS = 1000;
+    /** 每个部分结果（一次RPC）最多的Cell数 */
+    private static final int CELLS_PER_RESULT = 1000;
+
+    private WideRows() {
+    }
+
+    /** 单元格所在列作为游标 */
+    static String cursor(Cell cell) {
+        return Bytes.toString(CellUtil.cloneFamily(cell)) + ":" + Bytes.toStringBinary(CellUtil.cloneQualifier(cell));
+    }
+
+    /**
+     * 读取一页列：返回 {"status":"success","row":..,"columns":[{"family":..,"qualifier":..,"value":..,"timestamp":..},..],
+     * "nextCursor":..}，没有更多列时nextCursor为null
+     */
+    static String page(TableBackend backend, String tableName, String rowKey, String family, String cursor, int limit)
+            throws IOException {
+        byte[] row = Bytes.toBytes(rowKey);
+        String cursorFamily = null;
+        byte[] cursorQualifier = null;
+        if (cursor != null && !cursor.isEmpty()) {
+            int colon = cursor.indexOf(':');
+            if (colon <= 0) {
+                throw new IOException("列游标格式错误: " + cursor);
+            }
+            cursorFamily = cursor.substring(0, colon);
+            cursorQualifier = Bytes.toBytesBinary(cursor.substring(colon + 1));
+        }
+
+        List<String> families = new ArrayList<>();
+        if (family != null && !family.isEmpty()) {
+            families.add(family);
+        } else {
+            for (String name : backend.getFamilies(tableName)) {
+                if (cursorFamily == null || name.compareTo(cursorFamily) >= 0) {
+                    families.add(name);
+                }
+            }
+        }
+
+        JSONArray columns = new JSONArray();
+        Cell last = null;
+        boolean more = false;
+        for (String name : families) {
+            int remaining = limit - columns.length();
+            if (remaining <= 0) {
+                // 本页已满，后面的列族可能还有列
+                more = true;
+                break;
+            }
+            // 游标所在列族从游标之后开始（列名后接0x00即为严格大于的最小列名）
+            ColumnPaginationFilter filter = name.equals(cursorFamily)
+                    ? new ColumnPaginationFilter(remaining + 1, Bytes.add(cursorQualifier, new byte[]{0}))
+                    : new ColumnPaginationFilter(remaining + 1, 0);
+            Scan scan = new Scan().withStartRow(row).withStopRow(row, true);
+            scan.addFamily(Bytes.toBytes(name));
+            scan.setFilter(filter);
+            scan.setBatch(Math.min(remaining + 1, CELLS_PER_RESULT));
+            scan.setAllowPartialResults(true);
+            scan.setCaching(1);
+            try (ResultScanner scanner = backend.getScanner(tableName, scan)) {
+                for (Result result; (result = scanner.next()) != null; ) {
+                    for (Cell cell : result.rawCells()) {
+                        if (columns.length() == limit) {
+                            more = true;
+                            break;
+                        }
+                        JSONObject column = new JSONObject();
+                        column.put("family", name);
+                        column.put("qualifier", Bytes.toString(CellUtil.cloneQualifier(cell)));
+                        column.put("value", Bytes.toString(CellUtil.cloneValue(cell)));
+                        column.put("timestamp", cell.getTimestamp());
+                        columns.put(column);
+                        last = cell;
+                    }
+                    if (more) {
+                        break;
+                    }
+                }
+            }
+            if (more) {
+                break;
+            }
+        }
+
+        JSONObject json = new JSONObject();
+        json.put("status", "success");
+        json.put("row", rowKey);
+        json.put("columns", columns);
+        json.put("nextCursor", more && last != null ? cursor(last) : JSONObject.NULL);
+        return json.toString();
+    }
+}
@@ -0,0 +1,282 @@
+package com.hbasegui.bridge;
+
+import org.apache.hadoop.hbase.Cell;
+import org.apache.hadoop.hbase.CellUtil;
+import org.apache.hadoop.hbase.client.Delete;
+import org.apache.hadoop.hbase.client.Get;
+import org.apache.hadoop.hbase.client.Put;
+import org.apache.hadoop.hbase.client.Result;
+import org.apache.hadoop.hbase.client.ResultScanner;
+import org.apache.hadoop.hbase.client.Scan;
+import org.apache.hadoop.hbase.util.Bytes;
+import org.junit.Test;
+
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.List;
+import java.util.UUID;
+
+import static org.junit.Assert.assertArrayEquals;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNull;
+import static org.junit.Assert.assertTrue;
+import static org.junit.Assert.fail;
+
+/**
+ * MemoryTableBackend的扫描、多版本、反向扫描、删除与Region分裂。
+ * 同名地址共享数据，每个用例使用独立的集群名。
+ */
+public class MemoryTableBackendTest {
+    private static final String TABLE = "t";
+    private static final byte[] F = Bytes.toBytes("f");
+    private static final byte[] G = Bytes.toBytes("g");
+    private static final byte[] A = Bytes.toBytes("a");
+    private static final byte[] B = Bytes.toBytes("b");
+
+    private static MemoryTableBackend open(String params) {
+        return MemoryTableBackend.open(MemoryTableBackend.SCHEME + "test-" + UUID.randomUUID() + params);
+    }
+
+    private static String row(int i) {
+        return String.format("r%02d", i);
+    }
+
+    /** 写入 r00..r(count-1)，每行 f:a=v<i> 与 g:b=w<i> */
+    private static void fill(MemoryTableBackend backend, int count) throws IOException {
+        List<Put> puts = new ArrayList<>();
+        for (int i = 0; i < count; i++) {
+            puts.add(new Put(Bytes.toBytes(row(i)))
+                    .addColumn(F, A, Bytes.toBytes("v" + i))
+                    .addColumn(G, B, Bytes.toBytes("w" + i)));
+        }
+        backend.put(TABLE, puts);
+    }
+
+    private static List<String> scanRows(MemoryTableBackend backend, Scan scan) throws IOException {
+        List<String> rows = new ArrayList<>();
+        try (ResultScanner scanner = backend.getScanner(TABLE, scan)) {
+            for (Result result : scanner) {
+                rows.add(Bytes.toString(result.getRow()));
+            }
+        }
+        return rows;
+    }
+
+    private static List<String> range(int from, int to) {
+        List<String> rows = new ArrayList<>();
+        for (int i = from; i < to; i++) {
+            rows.add(row(i));
+        }
+        return rows;
+    }
+
+    private static List<Long> timestamps(List<Cell> cells) {
+        List<Long> result = new ArrayList<>();
+        for (Cell cell : cells) {
+            result.add(cell.getTimestamp());
+        }
+        return result;
+    }
+
+    @Test
+    public void scanRespectsStartAndStopRows() throws IOException {
+        MemoryTableBackend backend = open("");
+        fill(backend, 20);
+
+        assertEquals(range(0, 20), scanRows(backend, new Scan()));
+        assertEquals(range(5, 10), scanRows(backend,
+                new Scan().withStartRow(Bytes.toBytes(row(5))).withStopRow(Bytes.toBytes(row(10)))));
+        assertEquals(range(6, 11), scanRows(backend,
+                new Scan().withStartRow(Bytes.toBytes(row(5)), false).withStopRow(Bytes.toBytes(row(10)), true)));
+        // 起止行不存在时按字节序定位
+        assertEquals(range(5, 10), scanRows(backend,
+                new Scan().withStartRow(Bytes.toBytes("r04~")).withStopRow(Bytes.toBytes("r09~"))));
+        assertEquals(range(10, 20), scanRows(backend, new Scan().setRowPrefixFilter(Bytes.toBytes("r1"))));
+        assertEquals(Collections.emptyList(), scanRows(backend, new Scan().withStartRow(Bytes.toBytes("s"))));
+    }
+
+    @Test
+    public void scanAppliesLimitProjectionAndBatch() throws IOException {
+        MemoryTableBackend backend = open("");
+        fill(backend, 20);
+
+        assertEquals(range(0, 3), scanRows(backend, new Scan().setLimit(3)));
+
+        try (ResultScanner scanner = backend.getScanner(TABLE, new Scan().addColumn(F, A))) {
+            Result result = scanner.next();
+            assertEquals(1, result.rawCells().length);
+            assertEquals("v0", Bytes.toString(result.getValue(F, A)));
+            assertNull(result.getValue(G, B));
+        }
+        try (ResultScanner scanner = backend.getScanner(TABLE, new Scan().addFamily(G))) {
+            Result result = scanner.next();
+            assertEquals(1, result.rawCells().length);
+            assertEquals("w0", Bytes.toString(result.getValue(G, B)));
+        }
+
+        // 宽行按batch拆成多个部分结果
+        Put wide = new Put(Bytes.toBytes("wide"));
+        for (int q = 0; q < 5; q++) {
+            wide.addColumn(F, Bytes.toBytes("q" + q), Bytes.toBytes(q));
+        }
+        backend.put(TABLE, Collections.singletonList(wide));
+        Scan batched = new Scan().withStartRow(Bytes.toBytes("wide")).setBatch(2);
+        try (ResultScanner scanner = backend.getScanner(TABLE, batched)) {
+            assertEquals(2, scanner.next().rawCells().length);
+            assertEquals(2, scanner.next().rawCells().length);
+            assertEquals(1, scanner.next().rawCells().length);
+            assertNull(scanner.next());
+        }
+    }
+
+    @Test
+    public void versionsAndTimeRanges() throws IOException {
+        MemoryTableBackend backend = open("?versions=3");
+        byte[] row = Bytes.toBytes("r");
+        for (long ts = 1; ts <= 5; ts++) {
+            backend.put(TABLE, Collections.singletonList(new Put(row).addColumn(F, A, ts, Bytes.toBytes("v" + ts))));
+        }
+
+        // 只保留最新的3个版本，默认只读最新版本
+        Result latest = backend.get(TABLE, new Get(row));
+        assertEquals("v5", Bytes.toString(latest.getValue(F, A)));
+        assertEquals(1, latest.rawCells().length);
+
+        Result all = backend.get(TABLE, new Get(row).readVersions(10));
+        assertEquals(Arrays.asList(5L, 4L, 3L), timestamps(all.getColumnCells(F, A)));
+
+        try (ResultScanner scanner = backend.getScanner(TABLE, new Scan().readVersions(2))) {
+            assertEquals(Arrays.asList(5L, 4L), timestamps(scanner.next().getColumnCells(F, A)));
+        }
+
+        // 时间范围 [4, 5)
+        Scan ranged = new Scan().readVersions(10).setTimeRange(4, 5);
+        try (ResultScanner scanner = backend.getScanner(TABLE, ranged)) {
+            assertEquals(Collections.singletonList(4L), timestamps(scanner.next().getColumnCells(F, A)));
+            assertNull(scanner.next());
+        }
+        // 范围内没有cell的行不返回
+        assertEquals(Collections.emptyList(), scanRows(backend, new Scan().setTimeRange(10, 20)));
+
+        // 同一时间戳再次写入覆盖旧值
+        backend.put(TABLE, Collections.singletonList(new Put(row).addColumn(F, A, 5, Bytes.toBytes("again"))));
+        Result overwritten = backend.get(TABLE, new Get(row).readVersions(10));
+        assertEquals(Arrays.asList(5L, 4L, 3L), timestamps(overwritten.getColumnCells(F, A)));
+        assertEquals("again", Bytes.toString(overwritten.getValue(F, A)));
+    }
+
+    @Test
+    public void reversedScan() throws IOException {
+        MemoryTableBackend backend = open("?splitRows=4");
+        fill(backend, 20);
+
+        List<String> expected = range(0, 20);
+        Collections.reverse(expected);
+        assertEquals(expected, scanRows(backend, new Scan().setReversed(true)));
+
+        // 反向扫描时起始行在后、结束行在前，结束行不包含
+        Scan bounded = new Scan().setReversed(true)
+                .withStartRow(Bytes.toBytes(row(9))).withStopRow(Bytes.toBytes(row(4)));
+        assertEquals(Arrays.asList(row(9), row(8), row(7), row(6), row(5)), scanRows(backend, bounded));
+
+        assertEquals(Arrays.asList(row(19), row(18)), scanRows(backend, new Scan().setReversed(true).setLimit(2)));
+
+        // 行内的cell仍按正常顺序排列
+        try (ResultScanner scanner = backend.getScanner(TABLE, new Scan().setReversed(true))) {
+            Cell[] cells = scanner.next().rawCells();
+            assertEquals(2, cells.length);
+            assertTrue(CellUtil.matchingFamily(cells[0], F));
+            assertTrue(CellUtil.matchingFamily(cells[1], G));
+        }
+    }
+
+    @Test
+    public void deletes() throws IOException {
+        MemoryTableBackend backend = open("?versions=3");
+        fill(backend, 5);
+        byte[] r1 = Bytes.toBytes(row(1));
+        byte[] r2 = Bytes.toBytes(row(2));
+        byte[] r3 = Bytes.toBytes(row(3));
+        backend.put(TABLE, Arrays.asList(
+                new Put(r1).addColumn(F, B, 10, Bytes.toBytes("old")),
+                new Put(r1).addColumn(F, B, 20, Bytes.toBytes("new"))));
+
+        // 整行删除
+        backend.delete(TABLE, Collections.singletonList(new Delete(Bytes.toBytes(row(0)))));
+        assertEquals(range(1, 5), scanRows(backend, new Scan()));
+
+        // 不带时间戳的addColumn只删除最新版本
+        backend.delete(TABLE, Collections.singletonList(new Delete(r1).addColumn(F, B)));
+        assertEquals("old", Bytes.toString(backend.get(TABLE, new Get(r1)).getValue(F, B)));
+
+        // addColumns删除该列的所有版本
+        backend.delete(TABLE, Collections.singletonList(new Delete(r1).addColumns(F, B)));
+        Result afterColumns = backend.get(TABLE, new Get(r1));
+        assertNull(afterColumns.getValue(F, B));
+        assertEquals("v1", Bytes.toString(afterColumns.getValue(F, A)));
+
+        // 删除列族保留其他列族
+        backend.delete(TABLE, Collections.singletonList(new Delete(r2).addFamily(F)));
+        Result afterFamily = backend.get(TABLE, new Get(r2));
+        assertNull(afterFamily.getValue(F, A));
+        assertEquals("w2", Bytes.toString(afterFamily.getValue(G, B)));
+
+        // 删光所有列后行不再出现
+        backend.delete(TABLE, Collections.singletonList(new Delete(r3).addFamily(F).addFamily(G)));
+        assertTrue(backend.get(TABLE, new Get(r3)).isEmpty());
+        assertEquals(Arrays.asList(row(1), row(2), row(4)), scanRows(backend, new Scan()));
+    }
+
+    @Test
+    public void regionsSplitAsRowsGrow() throws IOException {
+        MemoryTableBackend backend = open("?splitRows=10");
+        for (int i = 0; i < 50; i++) {
+            backend.put(TABLE, Collections.singletonList(
+                    new Put(Bytes.toBytes(row(i))).addColumn(F, A, Bytes.toBytes(i))));
+        }
+
+        List<TableBackend.Region> regions = backend.getRegions(TABLE);
+        assertTrue("regions: " + regions.size(), regions.size() > 1);
+        // Region首尾相接并覆盖整个行键空间
+        assertEquals(0, regions.get(0).startKey.length);
+        assertEquals(0, regions.get(regions.size() - 1).endKey.length);
+        for (int i = 0; i + 1 < regions.size(); i++) {
+            assertArrayEquals(regions.get(i).endKey, regions.get(i + 1).startKey);
+            assertTrue(Bytes.compareTo(regions.get(i).startKey, regions.get(i + 1).startKey) < 0);
+        }
+
+        // 按Region分段扫描拼起来与整表扫描一致
+        List<String> pieced = new ArrayList<>();
+        for (TableBackend.Region region : regions) {
+            pieced.addAll(scanRows(backend, new Scan().withStartRow(region.startKey).withStopRow(region.endKey)));
+        }
+        assertEquals(range(0, 50), pieced);
+        assertEquals(range(0, 50), scanRows(backend, new Scan().setCaching(3)));
+    }
+
+    @Test
+    public void presplitRegions() throws IOException {
+        MemoryTableBackend backend = open("?splits=r10,r20");
+        fill(backend, 30);
+        List<TableBackend.Region> regions = backend.getRegions(TABLE);
+        assertEquals(3, regions.size());
+        assertEquals("r10", Bytes.toString(regions.get(0).endKey));
+        assertEquals("r20", Bytes.toString(regions.get(1).endKey));
+        assertEquals(Arrays.asList("f", "g"), backend.getFamilies(TABLE));
+        assertEquals(Collections.singletonList(TABLE), backend.listTables());
+    }
+
+    @Test
+    public void missingTable() {
+        MemoryTableBackend backend = open("");
+        try {
+            backend.getScanner("missing", new Scan());
+            fail("expected IOException");
+        } catch (IOException e) {
+            assertFalse(e.getMessage().isEmpty());
+        }
+    }
+}